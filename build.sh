@@ -60,6 +60,9 @@ function printHelp {
     echo "  --fpgaopencl      Compile with support for Intel PAC D5005 FPGA"
     echo "  --mpi             Compile with support for MPI"
     echo "  --no-papi         Compile without support for PAPI"
+    echo "  --kernel-isa-variants <levels>"
+    echo "                    Additionally compile the kernels for the given comma-separated ISA levels"
+    echo "                    (e.g., 'x86-64-v3,x86-64-v4'), the best one is selected at start-up"
 }
 
 #******************************************************************************
@@ -450,6 +453,7 @@ BUILD_FPGAOPENCL="-DUSE_FPGAOPENCL=OFF"
 BUILD_DEBUG="-DCMAKE_BUILD_TYPE=Release"
 BUILD_MPI="-DUSE_MPI=OFF"
 BUILD_PAPI="-DUSE_PAPI=ON"
+KERNEL_ISA_VARIANTS=""
 WITH_DEPS=1
 WITH_SUBMODULE_UPDATE=1
 
@@ -502,6 +506,11 @@ while [[ $# -gt 0 ]]; do
         echo not using PAPI
         export BUILD_PAPI="-DUSE_PAPI=OFF"
         ;;
+    --kernel-isa-variants)
+        KERNEL_ISA_VARIANTS=${1//,/;}
+        echo building kernel variants for "$KERNEL_ISA_VARIANTS"
+        shift
+        ;;
     --debug)
         echo building DEBUG version
         export BUILD_DEBUG="-DCMAKE_BUILD_TYPE=Debug"
@@ -1016,7 +1025,8 @@ daphne_msg "Build Daphne"
 
 cmake -S "$projectRoot" -B "$daphneBuildDir" -G Ninja -DANTLR_VERSION="$antlrVersion" \
     -DCMAKE_PREFIX_PATH="$installPrefix" \
-    $BUILD_CUDA $BUILD_FPGAOPENCL $BUILD_DEBUG $BUILD_MPI $BUILD_PAPI
+    $BUILD_CUDA $BUILD_FPGAOPENCL $BUILD_DEBUG $BUILD_MPI $BUILD_PAPI \
+    -DKERNEL_ISA_VARIANTS="$KERNEL_ISA_VARIANTS"
 
 cmake --build "$daphneBuildDir" --target "$target"
 
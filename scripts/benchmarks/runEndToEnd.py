@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+
+# Copyright 2024 The DAPHNE Consortium
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Runs the end-to-end DaphneDSL benchmarks in this directory and writes their
+timings (as reported by `daphne --timing`) and throughputs as JSON.
+
+Usage (from the repository's root directory):
+    python3 scripts/benchmarks/runEndToEnd.py [--daphne bin/daphne] [--scale 1.0]
+        [--repetitions 3] [--output results.json] [-- extra daphne arguments]
+"""
+
+import argparse
+import json
+import os
+import platform
+import statistics
+import subprocess
+import sys
+import time
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+
+# name, script, arguments as functions of the scale, number of processed rows
+BENCHMARKS = [
+    ("linearRegression", "linearRegression.daph",
+     lambda s: {"r": int(1000000 * s), "c": 100}, lambda a: a["r"]),
+    ("kmeans", "kmeans.daph",
+     lambda s: {"r": int(100000 * s), "c": 10, "f": 50, "i": 10}, lambda a: a["r"] * a["i"]),
+    ("pagerank", "pagerank.daph",
+     lambda s: {"n": int(20000 * s), "s": 0.001, "i": 10}, lambda a: a["n"] * a["i"]),
+    ("sqlAggregation", "sqlAggregation.daph",
+     lambda s: {"r": int(1000000 * s), "g": 1000}, lambda a: a["r"]),
+]
+
+
+def runOnce(daphne, script, args, extraArgs):
+    cmd = [daphne, "--timing"] + extraArgs + [script] + [f"{k}={v}" for k, v in args.items()]
+    proc = subprocess.run(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, text=True)
+    if proc.returncode != 0:
+        raise RuntimeError(f"{' '.join(cmd)} failed with exit code {proc.returncode}:\n{proc.stderr}")
+    # --timing prints a single JSON object as the last line on stderr.
+    for line in reversed(proc.stderr.splitlines()):
+        if line.startswith("{") and "execution_seconds" in line:
+            return json.loads(line)
+    raise RuntimeError(f"{' '.join(cmd)} did not report its timing")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Runs the end-to-end DaphneDSL benchmarks.")
+    parser.add_argument("--daphne", default="bin/daphne")
+    parser.add_argument("--scale", type=float, default=1.0, help="factor for the default problem sizes")
+    parser.add_argument("--repetitions", type=int, default=3)
+    parser.add_argument("--output", default="-", help="JSON file for the results (default stdout)")
+    parser.add_argument("--filter", default="", help="only run benchmarks whose name contains this string")
+    parser.add_argument("extraArgs", nargs="*", help="further arguments for daphne, e.g., --vec")
+    args = parser.parse_args()
+
+    results = []
+    for name, script, genArgs, genRows in BENCHMARKS:
+        if args.filter not in name:
+            continue
+        scriptArgs = genArgs(args.scale)
+        runs = [runOnce(args.daphne, os.path.join(SCRIPT_DIR, script), scriptArgs, args.extraArgs)
+                for _ in range(args.repetitions)]
+        execSeconds = statistics.median(r["execution_seconds"] for r in runs)
+        rows = genRows(scriptArgs)
+        results.append({
+            "name": name,
+            "arguments": scriptArgs,
+            "daphne_arguments": args.extraArgs,
+            "repetitions": runs,
+            "median_execution_seconds": execSeconds,
+            "median_total_seconds": statistics.median(r["total_seconds"] for r in runs),
+            "rows": rows,
+            "throughput_rows_per_s": rows / execSeconds if execSeconds > 0 else 0,
+        })
+        print(f"{name}: {execSeconds:.3f} s", file=sys.stderr)
+
+    doc = {
+        "timestamp": int(time.time()),
+        "machine": platform.node(),
+        "cpu_count": os.cpu_count(),
+        "benchmarks": results,
+    }
+    if args.output == "-":
+        json.dump(doc, sys.stdout, indent=2)
+        print()
+    else:
+        with open(args.output, "w") as f:
+            json.dump(doc, f, indent=2)
+
+
+if __name__ == "__main__":
+    main()
@@ -24,11 +24,16 @@
 #include <util/LogConfig.h>
 #include <util/DaphneLogger.h>
 class DaphneLogger;
+class IRecompiler;
+class LineageCache;
+class BufferManager;
+class Structure;
 
 #include <vector>
 #include <string>
 #include <memory>
 #include <map>
+#include <unordered_map>
 #include <limits>
 #include <filesystem>
 
@@ -43,6 +48,17 @@ struct DaphneUserConfig {
     bool use_obj_ref_mgnt = true;
     bool use_ipa_const_propa = true;
     bool use_phy_op_selection = true;
+    bool use_matmul_chain_opt = true;
+    bool use_adaptive_recompilation = false;
+    bool use_lineage_reuse = false;
+    // maximum number of bytes of the results kept for lineage-based reuse
+    size_t lineage_cache_size = size_t(1) << 30;
+    // maximum number of bytes of large intermediates kept in memory before
+    // they are spilled to disk (0 for no budget)
+    size_t memory_budget = 0;
+    // directory for the spilled intermediates (the system's temporary
+    // directory if empty)
+    std::string spill_dir;
     bool use_mlir_codegen = false;
     int  matmul_vec_size_bits = 0;
     bool matmul_tile = false;
@@ -61,6 +77,21 @@ struct DaphneUserConfig {
     bool debugMultiThreading = false;
     bool use_fpgaopencl = false;
     bool enable_profiling = false;
+    bool use_mmap_io = false;
+    // number of rows per block when writing .dbdf files, 0 for a single block
+    size_t dbdf_block_rows = 0;
+    bool csv_full_precision = false;
+    // store the MNC sketch of written matrices for sparsity estimation
+    bool write_mnc_sketch = false;
+    // cache the meta data inferred from CSV files in .meta files next to them
+    bool write_inferred_meta = false;
+    bool use_streaming = false;
+    // number of rows per chunk when streaming a file through a pipeline
+    size_t streaming_chunk_rows = 1 << 16;
+    bool scheduling_telemetry = false;
+    bool autotune_scheduling = false;
+    // history of the scheduling autotuner, persisted across runs
+    std::string autotune_file = ".daphne_scheduling_history.json";
 
     bool debug_llvm = false;
     bool explain_kernels = false;
@@ -76,6 +107,9 @@ struct DaphneUserConfig {
     bool explain_obj_ref_mgnt = false;
     bool explain_mlir_codegen = false;
     bool statistics = false;
+    bool perf_counters = false;
+    bool enable_tracing = false;
+    std::string trace_file;
 
     bool force_cuda = false;
 
@@ -108,15 +142,37 @@ struct DaphneUserConfig {
     
     
     std::string libdir = "{exedir}/../lib";
+    // ISA level of the kernel libraries: "auto" (best level supported by the
+    // host CPU), "generic", or a particular level like "x86-64-v3"
+    std::string kernel_isa = "auto";
+    // optimization level (0-3) of the JIT-compiled code
+    unsigned jit_opt_level = 2;
     std::map<std::string, std::vector<std::string>> daphnedsl_import_paths;
 
 
     // TODO Maybe the DaphneLib result should better reside in the DaphneContext,
     // but having it here is simpler for now.
     DaphneLibResult* result_struct = nullptr;
+    // The data objects bound by name in a session (see DaphneSession), which
+    // scripts access via loadSessionInput().
+    const std::unordered_map<std::string, Structure*>* session_inputs = nullptr;
+    // The data objects a script in a session stores via storeSessionInput(),
+    // which the session binds once the script has finished.
+    std::unordered_map<std::string, Structure*>* session_outputs = nullptr;
     
     KernelCatalog kernelCatalog;
 
+    // Re-compiles function calls at run-time when the properties of their
+    // arguments were unknown at compile-time (see use_adaptive_recompilation).
+    IRecompiler* recompiler = nullptr;
+    // The cache of the results reused based on their lineage (see
+    // use_lineage_reuse); passed to the kernels through the config, since they
+    // live in a separate library.
+    LineageCache* lineage_cache = nullptr;
+    // Spills large intermediates to disk to stay within the memory budget
+    // (see memory_budget).
+    BufferManager* buffer_manager = nullptr;
+
     /**
      * @brief Replaces the prefix `"{exedir}/"` in the field `libdir` by the path
      * of the directory in which the currently running executable resides.
@@ -14,8 +14,22 @@
  * limitations under the License.
  */
 
+#include <api/cli/DaphneUserConfig.h>
+#include <api/cli/StatusCode.h>
 #include <api/daphnelib/DaphneLibResult.h>
+#include <api/internal/DaphneSession.h>
 #include <api/internal/daphne_internal.h>
+#include <parser/config/ConfigParser.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/datastructures/ValueTypeCode.h>
+
+#include <spdlog/spdlog.h>
+
+#include <exception>
+#include <memory>
+
+#include <cstdint>
 
 /**
  * @brief This is *the* DaphneLibResult instance.
@@ -37,4 +51,89 @@ extern "C" int daphne(const char* libDirPath, const char* scriptPath) {
     int argc = 4;
 
     return mainInternal(argc, argv, &daphneLibRes);
-}
\ No newline at end of file
+}
+
+// ****************************************************************************
+// Sessions
+// ****************************************************************************
+
+/**
+ * @brief Creates a session (see `DaphneSession`), which keeps DAPHNE warm
+ * across scripts.
+ *
+ * @param libDirPath The path to the kernel libraries.
+ * @param configFile The path to a DAPHNE configuration file, or `nullptr`.
+ * @return The session, or `nullptr` if it could not be created.
+ */
+extern "C" DaphneSession * daphneCreateSession(const char * libDirPath, const char * configFile) {
+    try {
+        DaphneUserConfig cfg{};
+        if(configFile && ConfigParser::fileExists(configFile))
+            ConfigParser::readUserConfig(configFile, cfg);
+        cfg.libdir = libDirPath;
+        return new DaphneSession(cfg);
+    }
+    catch(std::exception & e) {
+        spdlog::error("Could not create session: {}", e.what());
+        return nullptr;
+    }
+}
+
+/**
+ * @brief Destroys the given session and all data objects bound to it.
+ */
+extern "C" void daphneDestroySession(DaphneSession * session) {
+    delete session;
+}
+
+template<typename VT>
+static void bindMatrix(DaphneSession * session, const char * name, uint64_t address, int64_t rows, int64_t cols) {
+    // The memory is owned by the caller, which must keep it alive while it is
+    // bound.
+    auto * mat = DataObjectFactory::create<DenseMatrix<VT>>(
+            rows, cols, std::shared_ptr<VT[]>(reinterpret_cast<VT *>(address), [](VT *) {})
+    );
+    session->bindInput(name, mat);
+    DataObjectFactory::destroy(mat);
+}
+
+/**
+ * @brief Binds a dense matrix in the caller's memory (e.g., a numpy array) to
+ * the given name in the session, without copying it.
+ *
+ * @return A status code (see `StatusCode`).
+ */
+extern "C" int daphneSessionBindMatrix(DaphneSession * session, const char * name, uint64_t address,
+                                       int64_t rows, int64_t cols, int64_t vtc) {
+    switch(static_cast<ValueTypeCode>(vtc)) {
+        case ValueTypeCode::SI8:  bindMatrix<int8_t>  (session, name, address, rows, cols); break;
+        case ValueTypeCode::SI32: bindMatrix<int32_t> (session, name, address, rows, cols); break;
+        case ValueTypeCode::SI64: bindMatrix<int64_t> (session, name, address, rows, cols); break;
+        case ValueTypeCode::UI8:  bindMatrix<uint8_t> (session, name, address, rows, cols); break;
+        case ValueTypeCode::UI32: bindMatrix<uint32_t>(session, name, address, rows, cols); break;
+        case ValueTypeCode::UI64: bindMatrix<uint64_t>(session, name, address, rows, cols); break;
+        case ValueTypeCode::F32:  bindMatrix<float>   (session, name, address, rows, cols); break;
+        case ValueTypeCode::F64:  bindMatrix<double>  (session, name, address, rows, cols); break;
+        default:
+            spdlog::error("Unsupported value type code for session input: {}", vtc);
+            return StatusCode::EXECUTION_ERROR;
+    }
+    return StatusCode::SUCCESS;
+}
+
+/**
+ * @brief Unbinds the data object bound to the given name in the session.
+ */
+extern "C" void daphneSessionUnbind(DaphneSession * session, const char * name) {
+    session->unbindInput(name);
+}
+
+/**
+ * @brief Executes the given DaphneDSL source code in the session, storing its
+ * result in *the* DaphneLibResult instance.
+ *
+ * @return A status code (see `StatusCode`).
+ */
+extern "C" int daphneSessionExecute(DaphneSession * session, const char * script) {
+    return session->execute(script, {}, &daphneLibRes);
+}
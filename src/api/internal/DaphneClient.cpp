@@ -0,0 +1,95 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <api/internal/DaphneClient.h>
+#include <api/internal/DaphneServer.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+DaphneClient::DaphneClient(const std::string & socketPath) {
+    sockaddr_un addr{};
+    if(socketPath.size() >= sizeof(addr.sun_path))
+        throw std::runtime_error("socket path `" + socketPath + "` is too long");
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0)
+        throw std::runtime_error(std::string("could not create socket: ") + std::strerror(errno));
+    if(::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+        const std::string msg = std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error("could not connect to DAPHNE server at `" + socketPath + "`: " + msg);
+    }
+}
+
+DaphneClient::~DaphneClient() {
+    if(fd >= 0)
+        ::close(fd);
+}
+
+DaphneClient::Response DaphneClient::request(const std::string & cmd, const std::string & name, const std::string & body) {
+    DaphneServerProtocol::send(fd, cmd + ' ' + (name.empty() ? "-" : name) + ' ' + std::to_string(body.size()), body);
+
+    DaphneServerProtocol::Message msg;
+    if(!DaphneServerProtocol::receive(fd, msg, 1))
+        throw std::runtime_error("the DAPHNE server closed the connection");
+    Response res;
+    res.ok = msg.header[0] == "OK";
+    for(size_t i = 2; i < msg.header.size(); i++) {
+        const size_t pos = msg.header[i].find('=');
+        if(pos != std::string::npos)
+            res.info[msg.header[i].substr(0, pos)] = msg.header[i].substr(pos + 1);
+    }
+    res.body = std::move(msg.body);
+    return res;
+}
+
+DaphneClient::Response DaphneClient::execute(const std::string & script,
+                                             const std::unordered_map<std::string, std::string> & scriptArgs) {
+    return request("EXEC", "", DaphneServerProtocol::formatArgs(scriptArgs) + '\n' + script);
+}
+
+DaphneClient::Response DaphneClient::prepare(const std::string & id, const std::string & script) {
+    return request("PREPARE", id, script);
+}
+
+DaphneClient::Response DaphneClient::run(const std::string & id,
+                                         const std::unordered_map<std::string, std::string> & scriptArgs) {
+    return request("RUN", id, DaphneServerProtocol::formatArgs(scriptArgs));
+}
+
+DaphneClient::Response DaphneClient::unbind(const std::string & name) {
+    return request("UNBIND", name, "");
+}
+
+DaphneClient::Response DaphneClient::list() {
+    return request("LIST", "", "");
+}
+
+DaphneClient::Response DaphneClient::stats() {
+    return request("STATS", "", "");
+}
+
+DaphneClient::Response DaphneClient::shutdown() {
+    return request("SHUTDOWN", "", "");
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief A client for a `DaphneServer` on the local machine.
+ *
+ * See `DaphneServerProtocol` for the supported requests.
+ */
+class DaphneClient {
+    int fd = -1;
+
+public:
+    /**
+     * @brief A response of the server.
+     */
+    struct Response {
+        bool ok = false;
+        // The key-value pairs of the response header, e.g., the status code
+        // and statistics of a script execution.
+        std::unordered_map<std::string, std::string> info;
+        // The standard output of the script, or the requested information.
+        std::string body;
+    };
+
+    /**
+     * @brief Connects to the server listening on the given socket.
+     */
+    explicit DaphneClient(const std::string & socketPath);
+
+    ~DaphneClient();
+
+    DaphneClient(const DaphneClient &) = delete;
+    DaphneClient & operator=(const DaphneClient &) = delete;
+
+    Response execute(const std::string & script, const std::unordered_map<std::string, std::string> & scriptArgs = {});
+    Response prepare(const std::string & id, const std::string & script);
+    Response run(const std::string & id, const std::unordered_map<std::string, std::string> & scriptArgs = {});
+    Response unbind(const std::string & name);
+    Response list();
+    Response stats();
+    Response shutdown();
+
+    /**
+     * @brief Sends an arbitrary request and waits for the response.
+     */
+    Response request(const std::string & cmd, const std::string & name, const std::string & body);
+};
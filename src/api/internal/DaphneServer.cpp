@@ -0,0 +1,331 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <api/internal/DaphneServer.h>
+
+#include <api/cli/StatusCode.h>
+#include <runtime/local/datastructures/Frame.h>
+#include <runtime/local/datastructures/Structure.h>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// ****************************************************************************
+// DaphneServerProtocol
+// ****************************************************************************
+
+static bool readExact(int fd, char * buf, size_t len) {
+    size_t done = 0;
+    while(done < len) {
+        ssize_t n = ::read(fd, buf + done, len - done);
+        if(n == 0)
+            return false;
+        if(n < 0) {
+            if(errno == EINTR)
+                continue;
+            throw std::runtime_error(std::string("could not read from socket: ") + std::strerror(errno));
+        }
+        done += n;
+    }
+    return true;
+}
+
+static void writeAll(int fd, const char * buf, size_t len) {
+    size_t done = 0;
+    while(done < len) {
+        // A peer that closed the connection must not raise SIGPIPE, which
+        // would terminate the server with all its resident data.
+        ssize_t n = ::send(fd, buf + done, len - done, MSG_NOSIGNAL);
+        if(n < 0) {
+            if(errno == EINTR)
+                continue;
+            throw std::runtime_error(std::string("could not write to socket: ") + std::strerror(errno));
+        }
+        done += n;
+    }
+}
+
+bool DaphneServerProtocol::receive(int fd, Message & msg, size_t lengthPos) {
+    std::string line;
+    char c;
+    while(true) {
+        if(!readExact(fd, &c, 1)) {
+            if(line.empty())
+                return false;
+            throw std::runtime_error("connection closed in the middle of a message");
+        }
+        if(c == '\n')
+            break;
+        line += c;
+    }
+
+    msg.header.clear();
+    std::istringstream words(line);
+    for(std::string word; words >> word;)
+        msg.header.push_back(word);
+    if(msg.header.size() <= lengthPos)
+        throw std::runtime_error("malformed message header: `" + line + "`");
+
+    size_t length;
+    try {
+        length = std::stoull(msg.header[lengthPos]);
+    }
+    catch(std::exception &) {
+        throw std::runtime_error("malformed message length: `" + msg.header[lengthPos] + "`");
+    }
+    msg.body.resize(length);
+    if(length && !readExact(fd, msg.body.data(), length))
+        throw std::runtime_error("connection closed in the middle of a message");
+    return true;
+}
+
+void DaphneServerProtocol::send(int fd, const std::string & headerLine, const std::string & body) {
+    const std::string header = headerLine + '\n';
+    writeAll(fd, header.data(), header.size());
+    writeAll(fd, body.data(), body.size());
+}
+
+std::string DaphneServerProtocol::formatArgs(const std::unordered_map<std::string, std::string> & scriptArgs) {
+    std::string str;
+    for(auto & arg : scriptArgs)
+        str += arg.first + '=' + arg.second + '\n';
+    return str;
+}
+
+std::unordered_map<std::string, std::string> DaphneServerProtocol::parseArgs(const std::string & str) {
+    std::unordered_map<std::string, std::string> scriptArgs;
+    std::istringstream lines(str);
+    for(std::string line; std::getline(lines, line);) {
+        if(line.empty())
+            continue;
+        const size_t pos = line.find('=');
+        if(pos == std::string::npos)
+            throw std::runtime_error("script arguments must be specified as name=value, but got `" + line + "`");
+        scriptArgs[line.substr(0, pos)] = line.substr(pos + 1);
+    }
+    return scriptArgs;
+}
+
+// ****************************************************************************
+// DaphneServer
+// ****************************************************************************
+
+namespace {
+    /**
+     * @brief Closes a file descriptor when going out of scope.
+     */
+    struct FdCloser {
+        int fd;
+        ~FdCloser() { ::close(fd); }
+    };
+
+    /**
+     * @brief Redirects the standard output of the process to the given file
+     * descriptor for the lifetime of this object, also if an exception is
+     * thrown meanwhile.
+     */
+    class StdoutRedirect {
+        int savedFd;
+
+    public:
+        explicit StdoutRedirect(int fd) {
+            std::cout.flush();
+            std::fflush(stdout);
+            savedFd = ::dup(STDOUT_FILENO);
+            if(savedFd < 0)
+                throw std::runtime_error(std::string("could not duplicate stdout: ") + std::strerror(errno));
+            ::dup2(fd, STDOUT_FILENO);
+        }
+
+        ~StdoutRedirect() {
+            std::cout.flush();
+            std::fflush(stdout);
+            ::dup2(savedFd, STDOUT_FILENO);
+            ::close(savedFd);
+        }
+
+        StdoutRedirect(const StdoutRedirect &) = delete;
+        StdoutRedirect & operator=(const StdoutRedirect &) = delete;
+    };
+}
+
+DaphneServer::DaphneServer(DaphneSession & session, std::string socketPath)
+        : session(session), socketPath(std::move(socketPath)) {
+}
+
+int DaphneServer::run() {
+    sockaddr_un addr{};
+    if(socketPath.size() >= sizeof(addr.sun_path)) {
+        spdlog::error("socket path `{}` is too long", socketPath);
+        return StatusCode::EXECUTION_ERROR;
+    }
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    int listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listenFd < 0) {
+        spdlog::error("could not create socket: {}", std::strerror(errno));
+        return StatusCode::EXECUTION_ERROR;
+    }
+    // Remove a stale socket of a previous server.
+    ::unlink(socketPath.c_str());
+    if(::bind(listenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 || ::listen(listenFd, 16) < 0) {
+        spdlog::error("could not listen on socket `{}`: {}", socketPath, std::strerror(errno));
+        ::close(listenFd);
+        return StatusCode::EXECUTION_ERROR;
+    }
+    spdlog::info("DAPHNE server listening on {}", socketPath);
+
+    while(!shutdownRequested) {
+        int fd = ::accept(listenFd, nullptr, nullptr);
+        if(fd < 0) {
+            if(errno == EINTR)
+                continue;
+            spdlog::error("could not accept connection: {}", std::strerror(errno));
+            break;
+        }
+        try {
+            serveConnection(fd);
+        }
+        catch(std::exception & e) {
+            spdlog::warn("dropped connection: {}", e.what());
+        }
+        ::close(fd);
+    }
+
+    ::close(listenFd);
+    ::unlink(socketPath.c_str());
+    return shutdownRequested ? StatusCode::SUCCESS : StatusCode::EXECUTION_ERROR;
+}
+
+void DaphneServer::serveConnection(int fd) {
+    DaphneServerProtocol::Message req;
+    while(!shutdownRequested && DaphneServerProtocol::receive(fd, req, 2)) {
+        numRequests++;
+        const std::string & cmd = req.header[0];
+        const std::string & name = req.header[1];
+        std::pair<std::string, std::string> res;
+        try {
+            if(cmd == "EXEC") {
+                // The script arguments are terminated by an empty line.
+                const size_t pos = (!req.body.empty() && req.body[0] == '\n') ? 0 : req.body.find("\n\n");
+                if(pos == std::string::npos)
+                    throw std::runtime_error("EXEC expects the script arguments, an empty line, and the script");
+                const size_t argsLen = pos ? pos + 1 : 0;
+                res = execute(req.body.substr(argsLen + 1), DaphneServerProtocol::parseArgs(req.body.substr(0, argsLen)));
+            }
+            else if(cmd == "PREPARE") {
+                preparedScripts[name] = req.body;
+                res = {"OK", ""};
+            }
+            else if(cmd == "RUN") {
+                auto it = preparedScripts.find(name);
+                if(it == preparedScripts.end())
+                    throw std::runtime_error("there is no prepared script `" + name + "`");
+                res = execute(it->second, DaphneServerProtocol::parseArgs(req.body));
+            }
+            else if(cmd == "UNBIND") {
+                if(!session.getInput(name))
+                    throw std::runtime_error("there is no data object named `" + name + "`");
+                session.unbindInput(name);
+                res = {"OK", ""};
+            }
+            else if(cmd == "LIST") {
+                std::vector<std::string> names;
+                for(auto & input : session.getInputs())
+                    names.push_back(input.first);
+                std::sort(names.begin(), names.end());
+                std::stringstream body;
+                for(auto & n : names) {
+                    const Structure * obj = session.getInput(n);
+                    body << n << ' ' << (dynamic_cast<const Frame *>(obj) ? "frame" : "matrix") << ' '
+                         << obj->getNumRows() << ' ' << obj->getNumCols() << '\n';
+                }
+                res = {"OK", body.str()};
+            }
+            else if(cmd == "STATS") {
+                std::stringstream body;
+                body << "requests=" << numRequests << '\n'
+                     << "resident_objects=" << session.getInputs().size() << '\n'
+                     << "prepared_scripts=" << preparedScripts.size() << '\n'
+                     << "compiled_scripts=" << session.getNumCompiledScripts() << '\n'
+                     << "cache_hits=" << session.getNumCacheHits() << '\n'
+                     << "cache_misses=" << session.getNumCacheMisses() << '\n';
+                res = {"OK", body.str()};
+            }
+            else if(cmd == "SHUTDOWN") {
+                shutdownRequested = true;
+                res = {"OK", ""};
+            }
+            else
+                throw std::runtime_error("unknown command `" + cmd + "`");
+        }
+        catch(std::exception & e) {
+            res = {"ERROR", std::string(e.what()) + '\n'};
+        }
+        // The length goes right after the status.
+        const size_t pos = res.first.find(' ');
+        const std::string status = res.first.substr(0, pos);
+        const std::string rest = (pos == std::string::npos) ? "" : res.first.substr(pos);
+        DaphneServerProtocol::send(fd, status + ' ' + std::to_string(res.second.size()) + rest, res.second);
+    }
+}
+
+std::pair<std::string, std::string> DaphneServer::execute(
+        const std::string & script, const std::unordered_map<std::string, std::string> & scriptArgs) {
+    // Capture the script's standard output in a temporary file, to send it
+    // back to the client.
+    char tmpPath[] = "/tmp/daphne-server-XXXXXX";
+    int tmpFd = ::mkstemp(tmpPath);
+    if(tmpFd < 0)
+        throw std::runtime_error(std::string("could not create temporary file: ") + std::strerror(errno));
+    ::unlink(tmpPath);
+    FdCloser tmpFdCloser{tmpFd};
+
+    int status;
+    std::string output;
+    {
+        StdoutRedirect redirect(tmpFd);
+        status = session.execute(script, scriptArgs);
+    }
+
+    const off_t len = ::lseek(tmpFd, 0, SEEK_END);
+    output.resize(len > 0 ? len : 0);
+    ::lseek(tmpFd, 0, SEEK_SET);
+    if(!output.empty() && !readExact(tmpFd, output.data(), output.size()))
+        output.clear();
+
+    const DaphneSession::ExecutionStats & stats = session.getLastStats();
+    std::stringstream header;
+    header << (status == StatusCode::SUCCESS ? "OK" : "ERROR")
+           << " status=" << status
+           << " cache_hit=" << stats.cacheHit
+           << " compilation_seconds=" << stats.compileSeconds
+           << " execution_seconds=" << stats.executeSeconds;
+    return {header.str(), output};
+}
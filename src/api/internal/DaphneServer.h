@@ -0,0 +1,102 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <api/internal/DaphneSession.h>
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief The wire format shared by `DaphneServer` and `DaphneClient`.
+ *
+ * Each request is a header line `<COMMAND> <name> <length>` followed by a body
+ * of `<length>` bytes; `-` stands for no name. Each response is a header line
+ * `<OK|ERROR> <length> [<key>=<value> ...]` followed by a body of `<length>`
+ * bytes. The commands are:
+ *
+ * - `EXEC - <length>`: executes a script; the body consists of the script
+ *   arguments (one `name=value` per line), an empty line, and the script.
+ * - `PREPARE <id> <length>`: stores the script in the body under the given id.
+ * - `RUN <id> <length>`: executes a prepared script; the body consists of the
+ *   script arguments (one `name=value` per line).
+ * - `UNBIND <name> 0`: unbinds a resident data object.
+ * - `LIST - 0`: lists the resident data objects (`name kind rows cols` per
+ *   line).
+ * - `STATS - 0`: returns the statistics of the session.
+ * - `SHUTDOWN - 0`: stops the server.
+ *
+ * `EXEC` and `RUN` respond with the script's standard output as the body and
+ * the status code and per-request statistics in the header.
+ */
+struct DaphneServerProtocol {
+    struct Message {
+        // The words of the header line.
+        std::vector<std::string> header;
+        std::string body;
+    };
+
+    /**
+     * @brief Reads a message from the given socket.
+     *
+     * @return `false` if the peer closed the connection before the message.
+     */
+    static bool receive(int fd, Message & msg, size_t lengthPos);
+
+    static void send(int fd, const std::string & headerLine, const std::string & body);
+
+    static std::string formatArgs(const std::unordered_map<std::string, std::string> & scriptArgs);
+
+    static std::unordered_map<std::string, std::string> parseArgs(const std::string & str);
+};
+
+/**
+ * @brief A daemon serving DaphneDSL scripts on a local Unix domain socket.
+ *
+ * All requests are executed in one `DaphneSession`, such that compiled scripts
+ * are cached and data objects stay resident across requests. Scripts make data
+ * objects resident via `storeSessionInput(obj, "name")` and access them via
+ * `loadSessionInput("name", ...)`. Requests are served one at a time.
+ */
+class DaphneServer {
+    DaphneSession & session;
+    const std::string socketPath;
+    std::unordered_map<std::string, std::string> preparedScripts;
+    size_t numRequests = 0;
+    bool shutdownRequested = false;
+
+    void serveConnection(int fd);
+
+    /**
+     * @brief Executes the script in the session, returning the response
+     * header and the script's standard output.
+     */
+    std::pair<std::string, std::string> execute(
+            const std::string & script, const std::unordered_map<std::string, std::string> & scriptArgs);
+
+public:
+    DaphneServer(DaphneSession & session, std::string socketPath);
+
+    /**
+     * @brief Serves requests until a client sends `SHUTDOWN`.
+     *
+     * @return A status code (see `StatusCode`).
+     */
+    int run();
+};
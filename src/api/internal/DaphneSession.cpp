@@ -0,0 +1,271 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <api/internal/DaphneSession.h>
+
+#include <api/cli/StatusCode.h>
+#include <compiler/execution/AdaptiveRecompiler.h>
+#include <compiler/execution/DaphneIrExecutor.h>
+#include <ir/daphneir/Daphne.h>
+#include <parser/catalog/KernelCatalogParser.h>
+#include <parser/daphnedsl/DaphneDSLParser.h>
+#include <parser/metadata/MetaDataParser.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/datastructures/Frame.h>
+#include <runtime/local/datastructures/Structure.h>
+#include <util/BufferManager.h>
+#include <util/DaphneLogger.h>
+#include <util/LineageCache.h>
+
+#include "mlir/ExecutionEngine/ExecutionEngine.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/OwningOpRef.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <map>
+#include <sstream>
+#include <typeinfo>
+#include <utility>
+
+DaphneSession::DaphneSession(const DaphneUserConfig & cfg, bool selectMatrixRepr, size_t maxCompiledScripts)
+        : maxCompiledScripts(std::max<size_t>(maxCompiledScripts, 1)) {
+    DaphneUserConfig userConfig = cfg;
+    userConfig.resolveLibDir();
+    if(!userConfig.log_ptr)
+        logger = std::make_unique<DaphneLogger>(userConfig);
+
+    // The same runtime services as for a single script (see startDAPHNE()),
+    // but kept alive for all scripts of the session.
+    if(userConfig.use_adaptive_recompilation) {
+        recompiler = std::make_unique<AdaptiveRecompiler>(selectMatrixRepr, userConfig);
+        userConfig.recompiler = recompiler.get();
+    }
+    if(userConfig.use_lineage_reuse)
+        userConfig.lineage_cache = &LineageCache::instance();
+    MetaDataParser::setWriteInferredMetaData(userConfig.write_inferred_meta);
+    if(userConfig.memory_budget && !userConfig.use_mlir_codegen && !userConfig.use_mlir_hybrid_codegen) {
+        BufferManager::instance().configure(userConfig.memory_budget, userConfig.spill_dir);
+        userConfig.buffer_manager = &BufferManager::instance();
+    }
+
+    // The compiled scripts refer to the configuration of the executor, which
+    // must, thus, outlive them.
+    executor = std::make_unique<DaphneIrExecutor>(selectMatrixRepr, userConfig);
+    DaphneUserConfig & execConfig = executor->getUserConfig();
+    execConfig.session_inputs = &inputs;
+    execConfig.session_outputs = &pendingInputs;
+
+    KernelCatalogParser kcp(executor->getContext(), execConfig.kernel_isa);
+    kcp.parseKernelCatalog(execConfig.libdir + "/catalog.json", execConfig.kernelCatalog);
+    if(execConfig.use_cuda)
+        kcp.parseKernelCatalog(execConfig.libdir + "/CUDAcatalog.json", execConfig.kernelCatalog);
+}
+
+DaphneSession::~DaphneSession() {
+    // The compiled scripts must be released before the executor (and its MLIR
+    // context).
+    compiledScripts.clear();
+    clearInputs();
+    for(auto & pending : pendingInputs)
+        DataObjectFactory::destroy(pending.second);
+    DaphneUserConfig & cfg = executor->getUserConfig();
+    if(cfg.lineage_cache)
+        cfg.lineage_cache->clear();
+    if(cfg.buffer_manager)
+        cfg.buffer_manager->clear();
+}
+
+void DaphneSession::addKernelCatalog(const std::string & catalogPath) {
+    DaphneUserConfig & cfg = executor->getUserConfig();
+    KernelCatalogParser kcp(executor->getContext(), cfg.kernel_isa);
+    kcp.parseKernelCatalog(catalogPath, cfg.kernelCatalog);
+}
+
+DaphneUserConfig & DaphneSession::getUserConfig() {
+    return executor->getUserConfig();
+}
+
+void DaphneSession::bindInput(const std::string & name, Structure * obj) {
+    obj->increaseRefCounter();
+    unbindInput(name);
+    inputs[name] = obj;
+}
+
+void DaphneSession::unbindInput(const std::string & name) {
+    auto it = inputs.find(name);
+    if(it == inputs.end())
+        return;
+    DataObjectFactory::destroy(it->second);
+    inputs.erase(it);
+}
+
+void DaphneSession::clearInputs() {
+    for(auto & input : inputs)
+        DataObjectFactory::destroy(input.second);
+    inputs.clear();
+}
+
+Structure * DaphneSession::getInput(const std::string & name) const {
+    auto it = inputs.find(name);
+    return it == inputs.end() ? nullptr : it->second;
+}
+
+std::string DaphneSession::makeKey(const std::string & script,
+                                   const std::unordered_map<std::string, std::string> & scriptArgs) {
+    // The script arguments are compiled into the script as constants.
+    std::stringstream key;
+    for(auto & arg : std::map<std::string, std::string>(scriptArgs.begin(), scriptArgs.end()))
+        key << arg.first << '=' << arg.second << '\n';
+    key << '\n' << script;
+    return key.str();
+}
+
+std::string DaphneSession::getTypeSignature(const std::string & name) const {
+    const Structure * obj = getInput(name);
+    if(!obj)
+        return "";
+    std::stringstream sig;
+    if(auto frm = dynamic_cast<const Frame *>(obj)) {
+        sig << "Frame";
+        for(size_t c = 0; c < frm->getNumCols(); c++)
+            sig << ' ' << static_cast<int>(frm->getColumnType(c)) << ':' << frm->getLabels()[c];
+    }
+    else
+        sig << typeid(*obj).name();
+    return sig.str();
+}
+
+std::pair<int, DaphneSession::CompiledScript> DaphneSession::compile(
+        const std::string & script, const std::unordered_map<std::string, std::string> & scriptArgs) {
+    mlir::MLIRContext * mctx = executor->getContext();
+    mlir::OpBuilder builder(mctx);
+    auto loc = mlir::FileLineColLoc::get(builder.getStringAttr("session"), 0, 0);
+    mlir::OwningOpRef<mlir::ModuleOp> moduleOp(mlir::ModuleOp::create(loc));
+    auto * body = moduleOp->getBody();
+    builder.setInsertionPoint(body, body->begin());
+
+    DaphneDSLParser parser(scriptArgs, executor->getUserConfig());
+    try {
+        parser.parseStr(builder, script, "session");
+    }
+    catch(std::exception & e) {
+        spdlog::error("While parsing: {}", e.what());
+        return {StatusCode::PARSER_ERROR, {}};
+    }
+
+    CompiledScript compiled;
+    moduleOp->walk([&](mlir::daphne::LoadSessionInputOp op) {
+        if(auto co = op.getInputName().getDefiningOp<mlir::daphne::ConstantOp>())
+            if(auto name = co.getValue().dyn_cast<mlir::StringAttr>())
+                compiled.inputSignatures.emplace_back(name.str(), getTypeSignature(name.str()));
+    });
+
+    try {
+        if(!executor->runPasses(*moduleOp))
+            return {StatusCode::PASS_ERROR, {}};
+    }
+    catch(std::exception & e) {
+        spdlog::error("Lowering pipeline error: {}", e.what());
+        return {StatusCode::PASS_ERROR, {}};
+    }
+
+    try {
+        compiled.engine = executor->createExecutionEngine(*moduleOp);
+        if(!compiled.engine)
+            return {StatusCode::EXECUTION_ERROR, {}};
+        return {StatusCode::SUCCESS, std::move(compiled)};
+    }
+    catch(std::exception & e) {
+        spdlog::error("Execution error: {}", e.what());
+        return {StatusCode::EXECUTION_ERROR, {}};
+    }
+}
+
+int DaphneSession::execute(const std::string & script,
+                           const std::unordered_map<std::string, std::string> & scriptArgs,
+                           DaphneLibResult * res) {
+    using clock = std::chrono::high_resolution_clock;
+    lastStats = ExecutionStats();
+
+    const std::string key = makeKey(script, scriptArgs);
+    auto it = compiledScripts.find(key);
+    if(it != compiledScripts.end() && std::all_of(
+            it->second.inputSignatures.begin(), it->second.inputSignatures.end(),
+            [this](const std::pair<std::string, std::string> & sig) { return getTypeSignature(sig.first) == sig.second; }
+    )) {
+        numCacheHits++;
+        lastStats.cacheHit = true;
+    }
+    else {
+        numCacheMisses++;
+        clock::time_point tpBegComp = clock::now();
+        auto compiled = compile(script, scriptArgs);
+        lastStats.compileSeconds = std::chrono::duration<double>(clock::now() - tpBegComp).count();
+        if(compiled.first != StatusCode::SUCCESS)
+            return compiled.first;
+        if(it != compiledScripts.end())
+            // The types of the session inputs have changed since the script
+            // was compiled.
+            it->second = std::move(compiled.second);
+        else {
+            if(compiledScripts.size() >= maxCompiledScripts) {
+                compiledScripts.erase(compiledScriptsOrder.front());
+                compiledScriptsOrder.pop_front();
+            }
+            it = compiledScripts.emplace(key, std::move(compiled.second)).first;
+            compiledScriptsOrder.push_back(key);
+        }
+    }
+
+    DaphneUserConfig & cfg = executor->getUserConfig();
+    cfg.result_struct = res;
+    int status = StatusCode::SUCCESS;
+    clock::time_point tpBegExec = clock::now();
+    try {
+        auto error = it->second.engine->invoke("main");
+        if(error) {
+            spdlog::error("JIT-Engine invocation failed: {}", llvm::toString(std::move(error)));
+            status = StatusCode::EXECUTION_ERROR;
+        }
+    }
+    catch(std::exception & e) {
+        spdlog::error("Execution error: {}", e.what());
+        status = StatusCode::EXECUTION_ERROR;
+    }
+    lastStats.executeSeconds = std::chrono::duration<double>(clock::now() - tpBegExec).count();
+    cfg.result_struct = nullptr;
+
+    for(auto & pending : pendingInputs) {
+        if(status == StatusCode::SUCCESS)
+            bindInput(pending.first, pending.second);
+        DataObjectFactory::destroy(pending.second);
+    }
+    pendingInputs.clear();
+
+    // Cached results may depend on the session inputs, which can be rebound
+    // before the next execution.
+    if(cfg.lineage_cache)
+        cfg.lineage_cache->clear();
+    if(cfg.buffer_manager)
+        cfg.buffer_manager->clear();
+
+    return status;
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <api/cli/DaphneUserConfig.h>
+#include <api/daphnelib/DaphneLibResult.h>
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <unordered_map>
+
+class AdaptiveRecompiler;
+class DaphneIrExecutor;
+class DaphneLogger;
+class Structure;
+namespace mlir {
+    class ExecutionEngine;
+}
+
+/**
+ * @brief A long-lived DAPHNE instance that executes DaphneDSL scripts
+ * repeatedly.
+ *
+ * `mainInternal()` sets up DAPHNE from scratch for each script. A session
+ * instead creates the MLIR context, parses the kernel catalog and sets up the
+ * runtime services only once. Furthermore, it caches the compiled scripts by
+ * their source code and arguments, such that executing the same script again
+ * skips parsing and compilation.
+ *
+ * Data objects can be bound to the session by name (by the caller or by a
+ * script via `storeSessionInput(obj, "name")`) and stay resident across
+ * executions. Scripts access them via `loadSessionInput("name",
+ * valueTypeCode)` or `loadSessionInput("name")`, whose shape is only known at
+ * run-time. Thus, a compiled script can be reused for other inputs with the
+ * same names and types.
+ */
+class DaphneSession {
+    std::unique_ptr<DaphneLogger> logger;
+    std::unique_ptr<AdaptiveRecompiler> recompiler;
+    std::unique_ptr<DaphneIrExecutor> executor;
+
+    std::unordered_map<std::string, Structure *> inputs;
+
+    /**
+     * @brief The data objects stored by the running script via
+     * `storeSessionInput()`, which are bound once it has finished.
+     */
+    std::unordered_map<std::string, Structure *> pendingInputs;
+
+    struct CompiledScript {
+        std::unique_ptr<mlir::ExecutionEngine> engine;
+        /**
+         * @brief The type signatures (see `getTypeSignature()`) of the session
+         * inputs the script loads, at the time of its compilation.
+         *
+         * Scripts that load inputs without a value type code are compiled for
+         * their data and value types, and must be recompiled when these change.
+         */
+        std::vector<std::pair<std::string, std::string>> inputSignatures;
+    };
+
+    /**
+     * @brief The compiled scripts by their source code and arguments (see
+     * `makeKey()`); evicted in the order of their insertion.
+     */
+    std::unordered_map<std::string, CompiledScript> compiledScripts;
+    std::deque<std::string> compiledScriptsOrder;
+    size_t maxCompiledScripts;
+
+    size_t numCacheHits = 0;
+    size_t numCacheMisses = 0;
+
+public:
+    /**
+     * @brief Statistics on the execution of a single script.
+     */
+    struct ExecutionStats {
+        bool cacheHit = false;
+        double compileSeconds = 0;
+        double executeSeconds = 0;
+    };
+
+private:
+    ExecutionStats lastStats;
+
+    static std::string makeKey(const std::string & script,
+                               const std::unordered_map<std::string, std::string> & scriptArgs);
+
+    /**
+     * @brief Returns a string identifying the data type, value type(s), and
+     * frame labels of the session input with the given name, or an empty
+     * string if there is no such input.
+     */
+    std::string getTypeSignature(const std::string & name) const;
+
+    /**
+     * @brief Parses and compiles the given script.
+     *
+     * @return The status code and, on success, the compiled script.
+     */
+    std::pair<int, CompiledScript> compile(
+            const std::string & script, const std::unordered_map<std::string, std::string> & scriptArgs);
+
+public:
+    static constexpr size_t DEFAULT_MAX_COMPILED_SCRIPTS = 64;
+
+    /**
+     * @brief Creates a session with the given configuration.
+     *
+     * @param cfg The configuration, whose `libdir` must point to the kernel
+     * libraries.
+     * @param selectMatrixRepr Whether to select the matrix representations
+     * (dense/sparse) automatically (see `--select-matrix-repr`).
+     * @param maxCompiledScripts The maximum number of compiled scripts kept.
+     */
+    explicit DaphneSession(const DaphneUserConfig & cfg, bool selectMatrixRepr = false,
+                           size_t maxCompiledScripts = DEFAULT_MAX_COMPILED_SCRIPTS);
+
+    ~DaphneSession();
+
+    DaphneSession(const DaphneSession &) = delete;
+    DaphneSession & operator=(const DaphneSession &) = delete;
+
+    /**
+     * @brief Registers the kernels of an additional kernel catalog (see
+     * `--kernel-ext`).
+     */
+    void addKernelCatalog(const std::string & catalogPath);
+
+    /**
+     * @brief Binds the data object to the given name, replacing any data
+     * object bound to it before.
+     *
+     * The session holds its own reference to the data object until it is
+     * unbound.
+     */
+    void bindInput(const std::string & name, Structure * obj);
+
+    /**
+     * @brief Unbinds the data object bound to the given name, if any.
+     */
+    void unbindInput(const std::string & name);
+
+    /**
+     * @brief Unbinds all data objects.
+     */
+    void clearInputs();
+
+    /**
+     * @brief Returns the data object bound to the given name, or `nullptr`.
+     */
+    Structure * getInput(const std::string & name) const;
+
+    /**
+     * @brief Executes the given DaphneDSL script, compiling it only if it was
+     * not executed with the same arguments before.
+     *
+     * @param script The source code of the script.
+     * @param scriptArgs The arguments of the script (see `daphne name=value`).
+     * @param res Where the script stores its result via
+     * `saveDaphneLibResult()`, or `nullptr`.
+     * The data objects the script stores via `storeSessionInput()` are bound
+     * once it has finished successfully.
+     *
+     * @return A status code (see `StatusCode`).
+     */
+    int execute(const std::string & script,
+                const std::unordered_map<std::string, std::string> & scriptArgs = {},
+                DaphneLibResult * res = nullptr);
+
+    size_t getNumCompiledScripts() const { return compiledScripts.size(); }
+    size_t getNumCacheHits() const { return numCacheHits; }
+    size_t getNumCacheMisses() const { return numCacheMisses; }
+    const ExecutionStats & getLastStats() const { return lastStats; }
+    const std::unordered_map<std::string, Structure *> & getInputs() const { return inputs; }
+
+    /**
+     * @brief The configuration used by all scripts executed in this session.
+     */
+    DaphneUserConfig & getUserConfig();
+};
@@ -20,17 +20,26 @@
     #include "runtime/distributed/worker/MPIWorker.h"
 #endif
 #include <api/cli/StatusCode.h>
+#include <api/internal/DaphneClient.h>
+#include <api/internal/DaphneServer.h>
+#include <api/internal/DaphneSession.h>
 #include <api/internal/daphne_internal.h>
 #include <api/cli/DaphneUserConfig.h>
 #include <api/daphnelib/DaphneLibResult.h>
 #include <parser/daphnedsl/DaphneDSLParser.h>
+#include "compiler/execution/AdaptiveRecompiler.h"
 #include "compiler/execution/DaphneIrExecutor.h"
 #include <runtime/local/vectorized/LoadPartitioning.h>
 #include <parser/catalog/KernelCatalogParser.h>
 #include <parser/config/ConfigParser.h>
+#include <parser/metadata/MetaDataParser.h>
+#include <util/BufferManager.h>
 #include <util/DaphneLogger.h>
 #include <util/KernelDispatchMapping.h>
+#include <util/LineageCache.h>
+#include <util/PerfCounters.h>
 #include <util/Statistics.h>
+#include <util/Tracer.h>
 
 #include "mlir/ExecutionEngine/ExecutionEngine.h"
 #include "mlir/IR/Builders.h"
@@ -41,9 +50,12 @@
     #include <runtime/local/kernels/CUDA/HostUtils.h>
 #endif
 
+#include <algorithm>
 #include <chrono>
 #include <exception>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 
@@ -207,6 +219,29 @@ int startDAPHNE(int argc, const char** argv, DaphneLibResult* daphneLibRes, int
             "vec", cat(schedulingOptions),
             desc("Enable vectorized execution engine")
     );
+    static opt<bool> useStreaming(
+            "streaming", cat(schedulingOptions),
+            desc("Stream vectorized pipelines that aggregate over a CSV or DAPHNE binary file through chunks of rows "
+                 "instead of reading the whole file first (requires --vec)")
+    );
+    static opt<size_t> streamingChunkRows(
+            "streaming-chunk-rows", cat(schedulingOptions),
+            desc("Number of rows read from the file per chunk when streaming (see --streaming)"),
+            init(0)
+    );
+    static opt<bool> schedulingTelemetry(
+            "scheduling-telemetry", cat(schedulingOptions),
+            desc("Print the tasks, busy/wait times and steals of each worker per vectorized pipeline as JSON")
+    );
+    static opt<bool> autotuneScheduling(
+            "autotune-scheduling", cat(schedulingOptions),
+            desc("Choose the partitioning scheme, grain size and batch size of vectorized pipelines based on "
+                 "their run times in earlier executions (overrides --partitioning and --grain-size)")
+    );
+    static opt<string> autotuneFile(
+            "autotune-file", cat(schedulingOptions),
+            desc("File storing the history of the scheduling autotuner (see --autotune-scheduling)")
+    );
     static opt<bool> useDistributedRuntime(
         "distributed", cat(daphneOptions),
         desc("Enable distributed runtime")
@@ -245,6 +280,41 @@ int startDAPHNE(int argc, const char** argv, DaphneLibResult* daphneLibRes, int
             "no-phy-op-selection", cat(daphneOptions),
             desc("Switch off physical operator selection, use default kernels for all operations")
     );
+    static opt<bool> noMatMulChainOpt(
+            "no-matmul-chain-opt", cat(daphneOptions),
+            desc("Switch off the reordering of chains of matrix multiplications")
+    );
+    static opt<bool> adaptiveRecompilation(
+            "adaptive-recompilation", cat(daphneOptions),
+            desc(
+                    "Re-compile calls of functions whose arguments have unknown "
+                    "shapes at run-time for the actual shapes"
+            )
+    );
+    static opt<bool> lineageReuse(
+            "lineage-reuse", cat(daphneOptions),
+            desc(
+                    "Reuse the results of expensive kernels (e.g., matrix multiplications) "
+                    "for repeated computations on the same data, identified by their lineage"
+            )
+    );
+    static opt<size_t> lineageCacheSize(
+            "lineage-cache-size", cat(daphneOptions),
+            desc("Maximum number of bytes of the results kept for reuse (see --lineage-reuse)"),
+            init(0)
+    );
+    static opt<size_t> memoryBudget(
+            "memory-budget", cat(daphneOptions),
+            desc(
+                    "Maximum number of bytes of large intermediates kept in memory; operations estimated "
+                    "to exceed it are executed block-wise, and cold intermediates are spilled to disk"
+            ),
+            init(0)
+    );
+    static opt<string> spillDir(
+            "spill-dir", cat(daphneOptions),
+            desc("The directory for intermediates spilled to disk (see --memory-budget)")
+    );
     static opt<bool> selectMatrixRepr(
             "select-matrix-repr", cat(daphneOptions),
             desc(
@@ -271,6 +341,19 @@ int startDAPHNE(int argc, const char** argv, DaphneLibResult* daphneLibRes, int
                 "(typically, but not necessarily, along with the kernel shared libraries)"
             )
     );
+    static opt<string> kernelIsa(
+            "kernel-isa", cat(daphneOptions),
+            desc(
+                "The ISA level of the kernel libraries to use: auto (the best level supported "
+                "by this CPU, default), generic, or a level like x86-64-v3 (requires kernel "
+                "libraries built with --kernel-isa-variants)"
+            )
+    );
+    static opt<int> jitOptLevel(
+            "jit-opt-level", cat(daphneOptions),
+            desc("The optimization level (0-3) of the JIT-compiled code (default: 2)"),
+            init(-1)
+    );
 
     static opt<bool> mlirCodegen(
         "mlir-codegen", cat(daphneOptions),
@@ -315,6 +398,32 @@ int startDAPHNE(int argc, const char** argv, DaphneLibResult* daphneLibRes, int
         "mlir-hybrid-codegen", cat(daphneOptions),
         desc("Enables prototypical hybrid code generation combining pre-compiled kernels and MLIR code generation.")
     );
+    static opt<bool> mmapIO(
+        "mmap-io", cat(daphneOptions),
+        desc("Memory-map dense matrices when reading DAPHNE binary files (.dbdf) instead of copying them.")
+    );
+    static opt<size_t> dbdfBlockRows(
+        "dbdf-block-rows", cat(daphneOptions),
+        desc("Write DAPHNE binary files (.dbdf) as blocks of this many rows with a block index, in parallel "
+             "(0 for a single block)."),
+        init(0)
+    );
+    static opt<bool> csvFullPrecision(
+        "csv-full-precision", cat(daphneOptions),
+        desc("Write floating-point values to CSV files with all significant digits (shortest representation that "
+             "reads back to the same value) instead of six decimal places.")
+    );
+    static opt<bool> writeMncSketch(
+        "write-mnc-sketch", cat(daphneOptions),
+        desc("Store the number of non-zeros and the MNC sketch (non-zeros per row and column) of matrices written "
+             "by write(), such that the compiler can estimate the sparsity of computations on them when they are "
+             "read again.")
+    );
+    static opt<bool> writeInferredMeta(
+        "write-inferred-meta", cat(daphneOptions),
+        desc("Cache the meta data inferred from CSV files without meta data file in a meta data file next to them, "
+             "which later runs reuse as long as the CSV file does not change.")
+    );
     static opt<string> kernelExt(
         "kernel-ext", cat(daphneOptions),
         desc("Additional kernel extension to register (path to a kernel catalog JSON file).")
@@ -375,6 +484,17 @@ int startDAPHNE(int argc, const char** argv, DaphneLibResult* daphneLibRes, int
         "statistics", cat(daphneOptions),
         desc("Enables runtime statistics output."));
 
+    static opt<bool> enablePerfCounters(
+        "perf-counters", cat(daphneOptions),
+        desc("Counts hardware events (cycles, instructions, cache and branch misses) per kernel via "
+             "perf_event_open and prints them after the execution"));
+
+    static opt<string> traceFile(
+        "trace", cat(daphneOptions),
+        desc("Records every kernel call and vectorized task and writes the events to the given file "
+             "in the Chrome trace format (viewable in Perfetto or chrome://tracing)"),
+        value_desc("filename"));
+
     static opt<bool> enableProfiling (
             "enable-profiling", cat(daphneOptions),
             desc("Enable profiling support")
@@ -383,10 +503,23 @@ int startDAPHNE(int argc, const char** argv, DaphneLibResult* daphneLibRes, int
             "timing", cat(daphneOptions),
             desc("Enable timing of high-level steps (start-up, parsing, compilation, execution) and print the times to stderr in JSON format")
     );
+    static opt<string> serverSocket(
+            "server", cat(daphneOptions),
+            desc("Run as a server that executes the DaphneDSL scripts sent by clients (see --connect) in one "
+                 "session, keeping compiled scripts and stored data objects across requests; listens on the "
+                 "given Unix domain socket instead of executing a script"),
+            value_desc("socket")
+    );
+    static opt<string> connectSocket(
+            "connect", cat(daphneOptions),
+            desc("Send the script to the DAPHNE server listening on the given Unix domain socket (see --server) "
+                 "and print its output"),
+            value_desc("socket")
+    );
 
     // Positional arguments ---------------------------------------------------
     
-    static opt<string> inputFile(Positional, desc("script"), Required);
+    static opt<string> inputFile(Positional, desc("script"));
     static llvm::cl::list<string> scriptArgs2(ConsumeAfter, desc("[arguments]"));
 
     // ------------------------------------------------------------------------
@@ -406,6 +539,8 @@ int startDAPHNE(int argc, const char** argv, DaphneLibResult* daphneLibRes, int
             "  daphne --vec example.daphne x=1 y=2.2 z=\"foo\"\n"
             "  daphne --vec --args x=1,y=2.2,z=\"foo\" example.daphne\n"
             "  daphne --vec --args x=1,y=2.2 example.daphne z=\"foo\"\n"
+            "  daphne --server /tmp/daphne.sock\n"
+            "  daphne --connect /tmp/daphne.sock example.daphne x=1\n"
     );
     SetVersionPrinter(&printVersion);
     ParseCommandLineOptions(
@@ -417,6 +552,11 @@ int startDAPHNE(int argc, const char** argv, DaphneLibResult* daphneLibRes, int
     // Process parsed arguments
     // ************************************************************************
 
+    if(inputFile.empty() && serverSocket.empty()) {
+        spdlog::error("no script specified");
+        return StatusCode::PARSER_ERROR;
+    }
+
     try {
         if (configFile != configFileInitValue && ConfigParser::fileExists(configFile)) {
             ConfigParser::readUserConfig(configFile, user_config);
@@ -436,6 +576,17 @@ int startDAPHNE(int argc, const char** argv, DaphneLibResult* daphneLibRes, int
     user_config.use_obj_ref_mgnt = !noObjRefMgnt;
     user_config.use_ipa_const_propa = !noIPAConstPropa;
     user_config.use_phy_op_selection = !noPhyOpSelection;
+    user_config.use_matmul_chain_opt = !noMatMulChainOpt;
+    if(adaptiveRecompilation)
+        user_config.use_adaptive_recompilation = true;
+    if(lineageReuse)
+        user_config.use_lineage_reuse = true;
+    if(lineageCacheSize)
+        user_config.lineage_cache_size = lineageCacheSize;
+    if(memoryBudget)
+        user_config.memory_budget = memoryBudget;
+    if(!spillDir.getValue().empty())
+        user_config.spill_dir = spillDir.getValue();
     user_config.use_mlir_codegen = mlirCodegen;
     user_config.matmul_vec_size_bits = matmul_vec_size_bits;
     user_config.matmul_tile = matmul_tile;
@@ -454,6 +605,10 @@ int startDAPHNE(int argc, const char** argv, DaphneLibResult* daphneLibRes, int
     if(!libDir.getValue().empty())
         user_config.libdir = libDir.getValue();
     user_config.resolveLibDir();
+    if(!kernelIsa.getValue().empty())
+        user_config.kernel_isa = kernelIsa.getValue();
+    if(jitOptLevel >= 0)
+        user_config.jit_opt_level = std::min(jitOptLevel.getValue(), 3);
 
     user_config.taskPartitioningScheme = taskPartitioningScheme;
     user_config.queueSetupScheme = queueSetupScheme;
@@ -520,6 +675,11 @@ int startDAPHNE(int argc, const char** argv, DaphneLibResult* daphneLibRes, int
     }
 
     user_config.statistics = enableStatistics;
+    user_config.perf_counters = enablePerfCounters;
+    if(!traceFile.empty()) {
+        user_config.enable_tracing = true;
+        user_config.trace_file = traceFile;
+    }
 
     if(user_config.use_distributed && distributedBackEndSetup==ALLOCATION_TYPE::DIST_MPI)
     {
@@ -556,6 +716,27 @@ int startDAPHNE(int argc, const char** argv, DaphneLibResult* daphneLibRes, int
         user_config.use_fpgaopencl = true;
     }
 
+    if(mmapIO)
+        user_config.use_mmap_io = true;
+    if(dbdfBlockRows)
+        user_config.dbdf_block_rows = dbdfBlockRows;
+    if(csvFullPrecision)
+        user_config.csv_full_precision = true;
+    if(writeMncSketch)
+        user_config.write_mnc_sketch = true;
+    if(writeInferredMeta)
+        user_config.write_inferred_meta = true;
+    if(useStreaming)
+        user_config.use_streaming = true;
+    if(streamingChunkRows)
+        user_config.streaming_chunk_rows = streamingChunkRows;
+    if(schedulingTelemetry)
+        user_config.scheduling_telemetry = true;
+    if(autotuneScheduling)
+        user_config.autotune_scheduling = true;
+    if(!autotuneFile.empty())
+        user_config.autotune_file = autotuneFile;
+
     if(enableProfiling) {
 #ifndef USE_PAPI
         throw std::runtime_error("you are trying to use profiling, but daphne was built with --no-papi\n");
@@ -578,10 +759,77 @@ int startDAPHNE(int argc, const char** argv, DaphneLibResult* daphneLibRes, int
         return StatusCode::PARSER_ERROR;
     }
 
+    // ************************************************************************
+    // Client/server mode
+    // ************************************************************************
+
+    if(!connectSocket.empty()) {
+        try {
+            std::ifstream ifs(inputFile);
+            if(!ifs.good())
+                throw std::runtime_error("could not open file `" + inputFile + "`");
+            std::stringstream script;
+            script << ifs.rdbuf();
+
+            DaphneClient client(connectSocket);
+            DaphneClient::Response res = client.execute(script.str(), scriptArgsFinal);
+            std::cout << res.body << std::flush;
+            if(timing)
+                std::cerr << "{\"cache_hit\": " << res.info["cache_hit"]
+                          << ", \"compilation_seconds\": " << res.info["compilation_seconds"]
+                          << ", \"execution_seconds\": " << res.info["execution_seconds"] << "}" << std::endl;
+            if(!res.info.count("status")) {
+                spdlog::error("DAPHNE server: {}", res.body);
+                return StatusCode::EXECUTION_ERROR;
+            }
+            return std::stoi(res.info["status"]);
+        }
+        catch(std::exception & e) {
+            spdlog::error("Client error: {}", e.what());
+            return StatusCode::EXECUTION_ERROR;
+        }
+    }
+
+    if(!serverSocket.empty()) {
+        try {
+            DaphneSession session(user_config, selectMatrixRepr);
+            if(!kernelExt.empty())
+                session.addKernelCatalog(kernelExt);
+            DaphneServer server(session, serverSocket);
+            return server.run();
+        }
+        catch(std::exception & e) {
+            spdlog::error("Server error: {}", e.what());
+            return StatusCode::EXECUTION_ERROR;
+        }
+    }
+
     // ************************************************************************
     // Create DaphneIrExecutor and get MLIR context
     // ************************************************************************
 
+    // The recompiler must outlive the code compiled by the executor, since
+    // this code may call it.
+    std::unique_ptr<AdaptiveRecompiler> recompiler;
+    if(user_config.use_adaptive_recompilation) {
+        recompiler = std::make_unique<AdaptiveRecompiler>(selectMatrixRepr, user_config);
+        user_config.recompiler = recompiler.get();
+    }
+    if(user_config.use_lineage_reuse)
+        user_config.lineage_cache = &LineageCache::instance();
+    MetaDataParser::setWriteInferredMetaData(user_config.write_inferred_meta);
+    if(user_config.memory_budget) {
+        // Code generated by the MLIR-based codegen accesses the values of data
+        // objects between kernel calls, where they could be spilled.
+        if(user_config.use_mlir_codegen || user_config.use_mlir_hybrid_codegen)
+            spdlog::warn("spilling to disk is not supported with --mlir-codegen, "
+                         "the memory budget is only used for planning");
+        else {
+            BufferManager::instance().configure(user_config.memory_budget, user_config.spill_dir);
+            user_config.buffer_manager = &BufferManager::instance();
+        }
+    }
+
     // Creates an MLIR context and loads the required MLIR dialects.
     DaphneIrExecutor executor(selectMatrixRepr, user_config);
     mlir::MLIRContext * mctx = executor.getContext();
@@ -592,7 +840,7 @@ int startDAPHNE(int argc, const char** argv, DaphneLibResult* daphneLibRes, int
 
     KernelCatalog & kc = executor.getUserConfig().kernelCatalog;
     // kc.dump();
-    KernelCatalogParser kcp(mctx);
+    KernelCatalogParser kcp(mctx, user_config.kernel_isa);
     kcp.parseKernelCatalog(user_config.libdir + "/catalog.json", kc);
     if(user_config.use_cuda)
         kcp.parseKernelCatalog(user_config.libdir + "/CUDAcatalog.json", kc);
@@ -698,6 +946,29 @@ int startDAPHNE(int argc, const char** argv, DaphneLibResult* daphneLibRes, int
     if (user_config.statistics)
         Statistics::instance().dumpStatistics(KernelDispatchMapping::instance());
 
+    if (user_config.perf_counters)
+        PerfCounters::instance().dumpCounters(KernelDispatchMapping::instance());
+
+    if (user_config.enable_tracing)
+        Tracer::instance().exportChromeTrace(user_config.trace_file, KernelDispatchMapping::instance());
+
+    if (user_config.lineage_cache) {
+        if (user_config.statistics)
+            user_config.lineage_cache->dumpStatistics();
+        // Release the cached results, which were created by this run.
+        user_config.lineage_cache->clear();
+        user_config.lineage_cache = nullptr;
+    }
+
+    if (user_config.buffer_manager) {
+        if (user_config.statistics)
+            user_config.buffer_manager->dumpStatistics();
+        // Remove the spill files and restore the intermediates that are still
+        // used (e.g., as DaphneLib results).
+        user_config.buffer_manager->clear();
+        user_config.buffer_manager = nullptr;
+    }
+
     return StatusCode::SUCCESS;
 }
 
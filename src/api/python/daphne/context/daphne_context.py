@@ -32,7 +32,8 @@ from daphne.operator.nodes.while_loop import WhileLoop
 from daphne.operator.nodes.do_while_loop import DoWhileLoop
 from daphne.operator.nodes.multi_return import MultiReturn
 from daphne.operator.operation_node import OperationNode
-from daphne.utils.consts import VALID_INPUT_TYPES, VALID_COMPUTED_TYPES, TMP_PATH, F64, F32, SI64, SI32, SI8, UI64, UI32, UI8
+from daphne.utils.consts import VALID_INPUT_TYPES, VALID_COMPUTED_TYPES, TMP_PATH, PROTOTYPE_PATH, F64, F32, SI64, SI32, SI8, UI64, UI32, UI8
+from daphne.utils.daphnelib import DaphneLib
 
 import numpy as np
 import pandas as pd
@@ -45,14 +46,59 @@ try:
 except ImportError as e:
     tf = e
 
+import os
 import time
+import uuid
 from typing import Sequence, Dict, Union, List, Callable, Tuple, Optional, Iterable
 
 class DaphneContext(object):
     _functions: dict
+    _session: Optional[int]
+    _persisted: list
+    _persist_counter: int
+    _persist_prefix: str
     
-    def __init__(self):
+    def __init__(self, use_session: bool = False, config_file: Optional[str] = None):
+        """Creates a new DaphneContext.
+        :param use_session: Whether to execute all scripts in one persistent DAPHNE session (True), which keeps
+            the compiler warm and reuses the compiled code of repeated scripts, or to start DAPHNE anew for each
+            `compute()` (False).
+        :param config_file: The path to a DAPHNE configuration file for the session.
+        """
         self._functions = dict()
+        self._session = None
+        self._persisted = []
+        self._persist_counter = 0
+        # Persisted results are stored in a directory shared by all processes,
+        # so their names must be unique per process and context.
+        self._persist_prefix = f"P{os.getpid()}_{uuid.uuid4().hex}_"
+        if use_session:
+            self._session = DaphneLib.daphneCreateSession(
+                str.encode(PROTOTYPE_PATH), str.encode(config_file) if config_file is not None else None)
+            if not self._session:
+                raise RuntimeError("could not create a DAPHNE session")
+
+    def close(self) -> None:
+        """Destroys the session of this context, if any, including all data bound to it, or removes the files
+        of the results persisted without a session."""
+        if self._session is not None:
+            DaphneLib.daphneDestroySession(self._session)
+            self._session = None
+            # The results of persisted nodes were kept in the session.
+            for node in self._persisted:
+                node._materialized = False
+        else:
+            # The results of persisted nodes were written to files.
+            for node in list(self._persisted):
+                node.unpersist()
+
+    def __del__(self):
+        self.close()
+
+    def _next_persist_name(self, node) -> str:
+        self._persisted.append(node)
+        self._persist_counter += 1
+        return f"{self._persist_prefix}{self._persist_counter - 1}"
 
     def readMatrix(self, file: str) -> Matrix:
         """Reads a matrix from a file.
@@ -124,7 +170,12 @@ class DaphneContext(object):
                 # TODO Raise an error here?
                 print("unsupported numpy dtype")
 
-            res = Matrix(self, 'receiveFromNumpy', [upper, lower, rows, cols, vtc], local_data=mat)
+            if self._session is not None:
+                # The array is bound to the session under its variable name when the script is executed.
+                # Thus, the script does not contain its address and its compiled code can be reused.
+                res = Matrix(self, 'loadSessionInput', ['"{file_name}"', vtc], local_data=mat)
+            else:
+                res = Matrix(self, 'receiveFromNumpy', [upper, lower, rows, cols, vtc], local_data=mat)
         else:
             # Data transfer via a file.
             data_path_param = "\"" + TMP_PATH + "/{file_name}.csv\""
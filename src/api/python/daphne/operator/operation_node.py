@@ -54,6 +54,8 @@ class OperationNode(DAGNode):
     _output_types: Optional[Iterable[VALID_INPUT_TYPES]]
     _source_node: Optional["DAGNode"]
     _brackets: bool
+    _persist_name: Optional[str]
+    _materialized: bool
     data: Optional[Union[pd.DataFrame, np.array]]
 
     def __init__(self, daphne_context,operation:str, 
@@ -77,6 +79,59 @@ class OperationNode(DAGNode):
         self._is_python_local_data = is_python_local_data
         self._brackets = brackets
         self._output_type = output_type
+        self._persist_name = None
+        self._materialized = False
+
+    def persist(self) -> 'OperationNode':
+        """
+        Marks this node for reuse across compute() calls. The first script computing the node keeps its result
+        (in the session of the DaphneContext, if any, or in a temporary file otherwise), and all later scripts
+        read it from there instead of recomputing the node and its inputs.
+
+        :return: This node, to allow chaining.
+        """
+        if self._output_type not in (OutputType.MATRIX, OutputType.FRAME):
+            raise TypeError("only matrices and frames can be persisted")
+        if self._persist_name is None:
+            self._persist_name = self.daphne_context._next_persist_name(self)
+        return self
+
+    def unpersist(self) -> None:
+        """
+        Releases the result kept by persist(). Later scripts compute the node again.
+        """
+        if self._persist_name is None:
+            return
+        if self._materialized:
+            session = self.daphne_context._session
+            if session is not None:
+                DaphneLib.daphneSessionUnbind(session, str.encode(self._persist_name))
+            else:
+                path = self._persist_path()
+                for f in (path, path + ".meta", path + ".mnc"):
+                    if os.path.exists(f):
+                        os.remove(f)
+        self.daphne_context._persisted = [n for n in self.daphne_context._persisted if n is not self]
+        self._persist_name = None
+        self._materialized = False
+
+    def _persist_path(self) -> str:
+        ext = "dbdf" if self._output_type == OutputType.MATRIX else "csv"
+        return f"{TMP_PATH}/{self._persist_name}.{ext}"
+
+    def persist_code_line(self, var_name: str) -> str:
+        """Returns the DaphneDSL code keeping the result of this node for later scripts."""
+        if self.daphne_context._session is not None:
+            return f'storeSessionInput({var_name}, "{self._persist_name}");'
+        write = "writeMatrix" if self._output_type == OutputType.MATRIX else "writeFrame"
+        return f'{write}({var_name}, "{self._persist_path()}");'
+
+    def materialized_code_line(self, var_name: str) -> str:
+        """Returns the DaphneDSL code reading the result kept by an earlier script."""
+        if self.daphne_context._session is not None:
+            return f'{var_name}=loadSessionInput("{self._persist_name}");'
+        read = "readMatrix" if self._output_type == OutputType.MATRIX else "readFrame"
+        return f'{var_name}={read}("{self._persist_path()}");'
 
     def compute(self, type="shared memory", verbose=False, asTensorFlow=False, asPyTorch=False, shape=None, useIndexColumn=False):
         """
@@ -56,6 +56,10 @@ class NestedDaphneDSLScript(DaphneDSLScript):
             dag_node._source_node.nested_level += 1
         return super()._dfs_dag_nodes(dag_node)
 
+    def _keeps_persisted_nodes(self) -> bool:
+        # The body of a loop or branch may run several times or not at all.
+        return False
+
     def _next_unique_var(self)->str:
         var_id = self._variable_counter
         self._variable_counter += 1
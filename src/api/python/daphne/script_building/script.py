@@ -37,6 +37,7 @@ class DaphneDSLScript:
     daphnedsl_script :str
     inputs: Dict[str, DAGNode]
     out_var_name:List[str]
+    persisted: List[DAGNode]
     _variable_counter: int
 
     def __init__(self, context) -> None:
@@ -44,6 +45,7 @@ class DaphneDSLScript:
         self.daphnedsl_script = ''
         self.inputs = {}
         self.out_var_name = []
+        self.persisted = []
         self._variable_counter = 0
     
     def build_code(self, dag_root: DAGNode, type="shared memory"):
@@ -89,6 +91,19 @@ class DaphneDSLScript:
         self._variable_counter = 0
 
     def execute(self):
+        session = self.daphne_context._session
+        if session is not None:
+            res = self._execute_in_session(session)
+        else:
+            res = self._execute_script_file()
+        # Only now the persisted nodes are available to later scripts.
+        if res == 0:
+            for node in self.persisted:
+                node._materialized = True
+        self.persisted = []
+
+    def _execute_script_file(self) -> int:
+
         temp_out_path = os.path.join(TMP_PATH, "tmpdaphne.daphne")
         temp_out_file = open(temp_out_path, "w")
         temp_out_file.writelines(self.daphnedsl_script)
@@ -97,6 +112,28 @@ class DaphneDSLScript:
         #os.environ['OPENBLAS_NUM_THREADS'] = '1'
         res = DaphneLib.daphne(ctypes.c_char_p(str.encode(PROTOTYPE_PATH)), ctypes.c_char_p(str.encode(temp_out_path)))
         #os.environ['OPENBLAS_NUM_THREADS'] = '32'
+        return res
+
+    def _execute_in_session(self, session) -> int:
+        """Executes the script in the persistent session of the context, binding the numpy arrays it loads
+        as session inputs for the time of the execution.
+        """
+        bound = []
+        try:
+            for var_name, input_node in self.inputs.items():
+                if input_node.operation != "loadSessionInput":
+                    continue
+                mat = input_node._np_array
+                rows = mat.shape[0]
+                cols = 1 if mat.ndim == 1 else mat.shape[1]
+                vtc = input_node.unnamed_input_nodes[1]
+                DaphneLib.daphneSessionBindMatrix(session, str.encode(var_name), mat.ctypes.data, rows, cols, vtc)
+                bound.append(var_name)
+            res = DaphneLib.daphneSessionExecute(session, str.encode(self.daphnedsl_script))
+        finally:
+            for var_name in bound:
+                DaphneLib.daphneSessionUnbind(session, str.encode(var_name))
+        return res
 
     def _dfs_dag_nodes(self, dag_node: VALID_INPUT_TYPES)->str:
         """Uses Depth-First-Search to create code from DAG
@@ -112,6 +149,13 @@ class DaphneDSLScript:
         # in the script, therefore reuse.
         if dag_node.daphnedsl_name != "":
             return dag_node.daphnedsl_name
+
+        # Persisted nodes computed by an earlier script are read instead of
+        # being computed again (together with all their inputs).
+        if getattr(dag_node, "_materialized", False):
+            dag_node.daphnedsl_name = self._next_unique_var()
+            self.add_code(dag_node.materialized_code_line(dag_node.daphnedsl_name))
+            return dag_node.daphnedsl_name
         
         if dag_node._source_node is not None:
             self._dfs_dag_nodes(dag_node._source_node)
@@ -137,8 +181,15 @@ class DaphneDSLScript:
         code_line = dag_node.code_line(
             dag_node.daphnedsl_name, unnamed_input_vars, named_input_vars)
         self.add_code(code_line)
+        if getattr(dag_node, "_persist_name", None) is not None and self._keeps_persisted_nodes():
+            self.add_code(dag_node.persist_code_line(dag_node.daphnedsl_name))
+            self.persisted.append(dag_node)
         return dag_node.daphnedsl_name
 
+    def _keeps_persisted_nodes(self) -> bool:
+        """Whether persisted nodes computed by this script are kept for later scripts."""
+        return True
+
     def add_input_from_python(self, var_name: str, input_var: DAGNode) -> None:
         """Add an input for our preparedScript. Should only be executed for data that is python local.
         :param var_name: name of variable
@@ -33,3 +33,15 @@ class DaphneLibResult(ctypes.Structure):
 
 DaphneLib = ctypes.CDLL(os.path.join(PROTOTYPE_PATH, DAPHNELIB_FILENAME))
 DaphneLib.getResult.restype = DaphneLibResult
+
+# Sessions (see DaphneSession).
+DaphneLib.daphneCreateSession.restype = ctypes.c_void_p
+DaphneLib.daphneCreateSession.argtypes = [ctypes.c_char_p, ctypes.c_char_p]
+DaphneLib.daphneDestroySession.restype = None
+DaphneLib.daphneDestroySession.argtypes = [ctypes.c_void_p]
+DaphneLib.daphneSessionBindMatrix.restype = ctypes.c_int
+DaphneLib.daphneSessionBindMatrix.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_uint64, ctypes.c_int64, ctypes.c_int64, ctypes.c_int64]
+DaphneLib.daphneSessionUnbind.restype = None
+DaphneLib.daphneSessionUnbind.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+DaphneLib.daphneSessionExecute.restype = ctypes.c_int
+DaphneLib.daphneSessionExecute.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
@@ -20,12 +20,40 @@
 
 #include <mlir/IR/Types.h>
 
+#include <cstddef>
 #include <iostream>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+/**
+ * @brief Stores information on a named variant of a kernel, i.e., an
+ * alternative implementation with the same signature, which is selected at
+ * run-time (see `KernelVariantSelector`).
+ */
+struct KernelVariantInfo {
+    /**
+     * @brief The name of the variant (e.g., `blas` or `naive`).
+     */
+    const std::string name;
+
+    /**
+     * @brief Hints on the regime in which the variant may be competitive:
+     * the range of the total number of input cells and the maximum sparsity
+     * of the inputs.
+     */
+    const size_t minCells;
+    const size_t maxCells;
+    const double maxSparsity;
+
+    KernelVariantInfo(const std::string name, size_t minCells, size_t maxCells, double maxSparsity) :
+        name(name), minCells(minCells), maxCells(maxCells), maxSparsity(maxSparsity)
+    {
+        //
+    }
+};
+
 /**
  * @brief Stores information on a single kernel.
  */
@@ -60,14 +88,22 @@ struct KernelInfo {
      */
     const std::string libPath;
 
+    /**
+     * @brief The variants among which the kernel function selects per call, or
+     * an empty vector if it has only one implementation.
+     */
+    const std::vector<KernelVariantInfo> variants;
+
     KernelInfo(
         const std::string kernelFuncName,
         const std::vector<mlir::Type> resTypes,
         const std::vector<mlir::Type> argTypes,
         const std::string backend,
-        const std::string libPath
+        const std::string libPath,
+        const std::vector<KernelVariantInfo> variants = {}
     ) :
-        kernelFuncName(kernelFuncName), resTypes(resTypes), argTypes(argTypes), backend(backend), libPath(libPath)
+        kernelFuncName(kernelFuncName), resTypes(resTypes), argTypes(argTypes), backend(backend), libPath(libPath),
+        variants(variants)
     {
         //
     }
@@ -108,6 +144,9 @@ class KernelCatalog {
                     os << ", ";
             }
             os << ") for backend `" << ki.backend  << "` (in `" << ki.libPath << "`)" << std::endl;
+            for(const KernelVariantInfo & kvi : ki.variants)
+                os << "    - variant `" << kvi.name << "` for " << kvi.minCells << " to " << kvi.maxCells
+                    << " input cells up to sparsity " << kvi.maxSparsity << std::endl;
         }
     }
 
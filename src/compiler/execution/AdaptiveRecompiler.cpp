@@ -0,0 +1,187 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <compiler/execution/AdaptiveRecompiler.h>
+#include <ir/daphneir/Daphne.h>
+#include <parser/catalog/KernelCatalogParser.h>
+#include <runtime/local/datastructures/CSRMatrix.h>
+#include <runtime/local/datastructures/Structure.h>
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Parser/Parser.h"
+
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    /**
+     * @brief Returns the number of non-zeros of the given structure if it is a
+     * sparse matrix, or -1 otherwise.
+     */
+    ssize_t getNumNonZerosIfSparse(const Structure * arg) {
+        if(auto m = dynamic_cast<const CSRMatrix<double> *>(arg))
+            return m->getNumNonZeros();
+        if(auto m = dynamic_cast<const CSRMatrix<float> *>(arg))
+            return m->getNumNonZeros();
+        if(auto m = dynamic_cast<const CSRMatrix<int64_t> *>(arg))
+            return m->getNumNonZeros();
+        if(auto m = dynamic_cast<const CSRMatrix<int32_t> *>(arg))
+            return m->getNumNonZeros();
+        if(auto m = dynamic_cast<const CSRMatrix<uint64_t> *>(arg))
+            return m->getNumNonZeros();
+        if(auto m = dynamic_cast<const CSRMatrix<uint32_t> *>(arg))
+            return m->getNumNonZeros();
+        if(auto m = dynamic_cast<const CSRMatrix<uint8_t> *>(arg))
+            return m->getNumNonZeros();
+        return -1;
+    }
+}
+
+AdaptiveRecompiler::AdaptiveRecompiler(bool selectMatrixRepresentations, const DaphneUserConfig & cfg)
+        : selectMatrixRepresentations(selectMatrixRepresentations), cfg(cfg) {
+    // Calls inside the re-compiled functions may be re-compiled again.
+    this->cfg.recompiler = this;
+}
+
+DaphneIrExecutor & AdaptiveRecompiler::getExecutor() {
+    if(!executor) {
+        executor = std::make_unique<DaphneIrExecutor>(selectMatrixRepresentations, cfg);
+        KernelCatalog & kc = executor->getUserConfig().kernelCatalog;
+        KernelCatalogParser kcp(executor->getContext(), cfg.kernel_isa);
+        kcp.parseKernelCatalog(cfg.libdir + "/catalog.json", kc);
+        if(cfg.use_cuda)
+            kcp.parseKernelCatalog(cfg.libdir + "/CUDAcatalog.json", kc);
+    }
+    return *executor;
+}
+
+std::shared_ptr<AdaptiveRecompiler::CompiledFunction> AdaptiveRecompiler::compile(
+        const char * irCode, const std::vector<ArgProperties> * argProps
+) {
+    DaphneIrExecutor & exec = getExecutor();
+    auto cf = std::make_shared<CompiledFunction>();
+
+    cf->module = mlir::parseSourceString<mlir::ModuleOp>(irCode, exec.getContext());
+    if(!cf->module)
+        throw std::runtime_error("AdaptiveRecompiler: failed to parse the IR of a re-compiled call");
+    auto mainFunc = cf->module->lookupSymbol<mlir::func::FuncOp>("main");
+    if(!mainFunc)
+        throw std::runtime_error("AdaptiveRecompiler: the IR of a re-compiled call has no `main` function");
+
+    // Specialize the argument types of the entry function for the actual
+    // properties of the arguments. The SpecializeGenericFunctionsPass
+    // propagates them into the called function.
+    if(argProps) {
+        std::vector<mlir::Type> argTys;
+        for(size_t i = 0; i < mainFunc.getNumArguments(); i++) {
+            mlir::BlockArgument arg = mainFunc.getArgument(i);
+            const ArgProperties & props = (*argProps)[i];
+            mlir::Type t = arg.getType();
+            if(auto mt = t.dyn_cast<mlir::daphne::MatrixType>()) {
+                mt = mt.withShape(props.numRows, props.numCols).withSparsity(props.sparsity);
+                if(props.isSparse)
+                    mt = mt.withRepresentation(mlir::daphne::MatrixRepresentation::Sparse);
+                t = mt;
+            }
+            else if(auto ft = t.dyn_cast<mlir::daphne::FrameType>())
+                t = ft.withShape(props.numRows, props.numCols);
+            arg.setType(t);
+            argTys.push_back(t);
+        }
+        mainFunc.setType(mlir::FunctionType::get(
+                exec.getContext(), argTys, mainFunc.getFunctionType().getResults()
+        ));
+    }
+
+    if(!exec.runPasses(cf->module.get()))
+        throw std::runtime_error("AdaptiveRecompiler: failed to compile a re-compiled call");
+    cf->engine = exec.createExecutionEngine(cf->module.get());
+    if(!cf->engine)
+        throw std::runtime_error("AdaptiveRecompiler: failed to create the JIT-execution engine for a re-compiled call");
+    return cf;
+}
+
+void AdaptiveRecompiler::call(Structure ** res, size_t numRes, const Structure ** args, size_t numArgs,
+                              const char * irCode) {
+    // Capture the actual properties of the arguments.
+    std::vector<ArgProperties> argProps;
+    std::stringstream key;
+    key << static_cast<const void *>(irCode);
+    for(size_t i = 0; i < numArgs; i++) {
+        const ssize_t numRows = args[i]->getNumRows();
+        const ssize_t numCols = args[i]->getNumCols();
+        const ssize_t nnz = getNumNonZerosIfSparse(args[i]);
+        double sparsity = -1.0;
+        if(nnz > 0) {
+            // Round to two significant digits.
+            sparsity = static_cast<double>(nnz) / (numRows * numCols);
+            const double unit = std::pow(10.0, std::floor(std::log10(sparsity)) - 1);
+            sparsity = std::round(sparsity / unit) * unit;
+        }
+        else if(nnz == 0)
+            sparsity = 0.0;
+        argProps.push_back({numRows, numCols, sparsity, nnz != -1});
+        key << '|' << numRows << 'x' << numCols;
+        if(nnz != -1)
+            key << 's' << sparsity;
+    }
+
+    std::shared_ptr<CompiledFunction> cf;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = cache.find(key.str());
+        if(it != cache.end())
+            cf = it->second;
+        else if(numVersions[irCode] < MAX_VERSIONS_PER_CALL) {
+            cf = compile(irCode, &argProps);
+            cache[key.str()] = cf;
+            numVersions[irCode]++;
+        }
+        else {
+            // Too many specializations of this call, use a generic version.
+            std::stringstream genericKey;
+            genericKey << static_cast<const void *>(irCode) << "|generic";
+            auto & genericCf = cache[genericKey.str()];
+            if(!genericCf)
+                genericCf = compile(irCode, nullptr);
+            cf = genericCf;
+        }
+    }
+
+    // The entry function takes one pointer per argument and writes its
+    // results to consecutive pointers.
+    std::vector<void *> inputs;
+    for(size_t i = 0; i < numArgs; i++)
+        inputs.push_back(const_cast<Structure *>(args[i]));
+    std::vector<void *> outputs(numRes, nullptr);
+    std::vector<void *> packedInputsOutputs;
+    for(size_t i = 0; i < numArgs; i++)
+        packedInputsOutputs.push_back(&inputs[i]);
+    for(size_t i = 0; i < numRes; i++)
+        packedInputsOutputs.push_back(&outputs[i]);
+
+    auto error = cf->engine->invokePacked("main", packedInputsOutputs);
+    if(error)
+        throw std::runtime_error(
+                "AdaptiveRecompiler: invocation of a re-compiled call failed: " +
+                llvm::toString(std::move(error))
+        );
+
+    for(size_t i = 0; i < numRes; i++)
+        res[i] = static_cast<Structure *>(outputs[i]);
+}
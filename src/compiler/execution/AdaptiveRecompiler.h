@@ -0,0 +1,84 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <api/cli/DaphneUserConfig.h>
+#include <compiler/execution/DaphneIrExecutor.h>
+#include <runtime/local/context/IRecompiler.h>
+
+#include "mlir/ExecutionEngine/ExecutionEngine.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/OwningOpRef.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Re-compiles functions at run-time for the actual properties of their
+ * arguments (see AdaptiveRecompilationPass).
+ *
+ * The IR of a call is compiled once per combination of the arguments' shapes,
+ * representations, and (for sparse matrices) sparsities, and the compiled code
+ * is cached. The sparsity is rounded to two significant digits to avoid a new
+ * compilation for every small change of the number of non-zeros. Sparsities of
+ * dense matrices are not determined, since that would require a scan of the
+ * data on every call.
+ *
+ * To bound the compilation overhead for calls in loops with ever-changing
+ * shapes, at most `MAX_VERSIONS_PER_CALL` specializations are created per
+ * call. Beyond that, the call is compiled once more without specializing the
+ * argument types and that version is reused.
+ */
+class AdaptiveRecompiler : public IRecompiler {
+public:
+    static constexpr size_t MAX_VERSIONS_PER_CALL = 16;
+
+    AdaptiveRecompiler(bool selectMatrixRepresentations, const DaphneUserConfig & cfg);
+
+    void call(Structure ** res, size_t numRes, const Structure ** args, size_t numArgs,
+              const char * irCode) override;
+
+private:
+    struct CompiledFunction {
+        mlir::OwningOpRef<mlir::ModuleOp> module;
+        std::unique_ptr<mlir::ExecutionEngine> engine;
+    };
+
+    struct ArgProperties {
+        ssize_t numRows;
+        ssize_t numCols;
+        // -1.0 if unknown
+        double sparsity;
+        bool isSparse;
+    };
+
+    bool selectMatrixRepresentations;
+    DaphneUserConfig cfg;
+
+    std::mutex mtx;
+    // Created on the first call, guarded by mtx.
+    std::unique_ptr<DaphneIrExecutor> executor;
+    std::unordered_map<std::string, std::shared_ptr<CompiledFunction>> cache;
+    std::unordered_map<const char *, size_t> numVersions;
+
+    DaphneIrExecutor & getExecutor();
+
+    std::shared_ptr<CompiledFunction> compile(const char * irCode, const std::vector<ArgProperties> * argProps);
+};
@@ -23,9 +23,14 @@
 #include <mlir/Dialect/LLVMIR/LLVMDialect.h>
 #include <mlir/Dialect/LLVMIR/Transforms/Passes.h>
 
+#include <algorithm>
 #include <filesystem>
+#include <memory>
 
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/IR/Module.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Target/TargetMachine.h"
 #include "mlir/Conversion/AffineToStandard/AffineToStandard.h"
 #include "mlir/Conversion/LinalgToLLVM/LinalgToLLVM.h"
 #include "mlir/Conversion/MathToLLVM/MathToLLVM.h"
@@ -108,6 +113,12 @@ bool DaphneIrExecutor::runPasses(mlir::ModuleOp module) {
         if (userConfig_.explain_property_inference)
             pm.addPass(mlir::daphne::createPrintIRPass("IR after inference:"));
 
+        // Calls of functions whose arguments still have unknown shapes are
+        // compiled at run-time, once the actual shapes are known.
+        if (userConfig_.use_adaptive_recompilation &&
+            userConfig_.recompiler != nullptr)
+            pm.addPass(mlir::daphne::createAdaptiveRecompilationPass());
+
         try {
             if (failed(pm.run(module))) {
                 module->dump();
@@ -131,6 +142,12 @@ bool DaphneIrExecutor::runPasses(mlir::ModuleOp module) {
     pm.addNestedPass<mlir::func::FuncOp>(mlir::daphne::createInferencePass());
     pm.addPass(mlir::createCanonicalizerPass());
 
+    // Reorder chains of matrix multiplications based on the inferred shapes
+    // and sparsities, before the physical representations are chosen.
+    if (userConfig_.use_matmul_chain_opt)
+        pm.addNestedPass<mlir::func::FuncOp>(
+            mlir::daphne::createMatMulChainOptimizationPass());
+
     if (selectMatrixRepresentations_)
         pm.addNestedPass<mlir::func::FuncOp>(
             mlir::daphne::createSelectMatrixRepresentationsPass(userConfig_));
@@ -139,8 +156,15 @@ bool DaphneIrExecutor::runPasses(mlir::ModuleOp module) {
             "IR after selecting matrix representations:"));
 
     if (userConfig_.use_phy_op_selection) {
-        pm.addPass(mlir::daphne::createPhyOperatorSelectionPass());
+        pm.addPass(mlir::daphne::createPhyOperatorSelectionPass(userConfig_));
         pm.addPass(mlir::createCSEPass());
+        // The fused aggregations are neither vectorizable nor available on
+        // GPUs, while vectorized pipelines already share the scan of their
+        // input among sibling aggregations.
+        if (!userConfig_.use_vectorized_exec && !userConfig_.use_distributed &&
+            !userConfig_.use_cuda)
+            pm.addNestedPass<mlir::func::FuncOp>(
+                mlir::daphne::createFuseAggregationsPass());
     }
     if (userConfig_.explain_phy_op_selection)
         pm.addPass(mlir::daphne::createPrintIRPass(
@@ -161,6 +185,25 @@ bool DaphneIrExecutor::runPasses(mlir::ModuleOp module) {
         pm.addNestedPass<mlir::func::FuncOp>(
             mlir::daphne::createVectorizeComputationsPass());
         pm.addPass(mlir::createCanonicalizerPass());
+        // Streaming replaces the read of a pipeline input by reading it
+        // chunk-wise inside the pipeline, which the distributed runtime does
+        // not support.
+        if (userConfig_.use_streaming && !userConfig_.use_distributed)
+            pm.addNestedPass<mlir::func::FuncOp>(
+                mlir::daphne::createStreamPipelinesPass());
+    }
+    else if (userConfig_.memory_budget) {
+        // Operations estimated to exceed the memory budget are executed in
+        // vectorized pipelines, which process their inputs in row blocks,
+        // without materializing the intermediates inside a pipeline.
+        pm.addNestedPass<mlir::func::FuncOp>(
+            mlir::daphne::createVectorizeComputationsPass(
+                userConfig_.memory_budget));
+        pm.addPass(mlir::createCanonicalizerPass());
+        // As above, streaming is not supported by the distributed runtime.
+        if (userConfig_.use_streaming && !userConfig_.use_distributed)
+            pm.addNestedPass<mlir::func::FuncOp>(
+                mlir::daphne::createStreamPipelinesPass());
     }
     if (userConfig_.explain_vectorized)
         pm.addPass(mlir::daphne::createPrintIRPass("IR after vectorization:"));
@@ -238,11 +281,35 @@ bool DaphneIrExecutor::runPasses(mlir::ModuleOp module) {
 std::unique_ptr<mlir::ExecutionEngine> DaphneIrExecutor::createExecutionEngine(
     mlir::ModuleOp module) {
     if (!module) return nullptr;
-    // An optimization pipeline to use within the execution engine.
-    unsigned optLevel = 0;
-    unsigned sizeLevel = 0;
-    llvm::TargetMachine *targetMachine = nullptr;
-    auto optPipeline = mlir::makeOptimizingTransformer(optLevel, sizeLevel, targetMachine);
+    // An optimization pipeline to use within the execution engine, tuned to
+    // the CPU of this host (such that, e.g., the loop vectorizer may use all
+    // available vector extensions).
+    const unsigned optLevel = std::min(userConfig_.jit_opt_level, 3u);
+    const unsigned sizeLevel = 0;
+    // The LLVM enum values correspond to the optimization levels 0-3.
+    const auto codeGenOptLevel = static_cast<llvm::CodeGenOpt::Level>(optLevel);
+    std::shared_ptr<llvm::TargetMachine> targetMachine;
+    if(auto tmBuilder = llvm::orc::JITTargetMachineBuilder::detectHost()) {
+        tmBuilder->setCodeGenOptLevel(codeGenOptLevel);
+        if(auto tm = tmBuilder->createTargetMachine())
+            targetMachine = std::move(tm.get());
+        else
+            llvm::consumeError(tm.takeError());
+    }
+    else
+        llvm::consumeError(tmBuilder.takeError());
+    auto optimize = mlir::makeOptimizingTransformer(optLevel, sizeLevel, targetMachine.get());
+    // The transformer may be invoked lazily, so it co-owns the target machine.
+    auto optPipeline = [targetMachine, optimize](llvm::Module * m) -> llvm::Error {
+        if(targetMachine)
+            // Let the code generation use the host CPU's features as well.
+            for(llvm::Function & f : *m)
+                if(!f.isDeclaration()) {
+                    f.addFnAttr("target-cpu", targetMachine->getTargetCPU());
+                    f.addFnAttr("target-features", targetMachine->getTargetFeatureString());
+                }
+        return optimize(m);
+    };
 
     // Determine the actually used kernels libraries.
     std::vector<llvm::StringRef> sharedLibRefs;
@@ -266,7 +333,7 @@ std::unique_ptr<mlir::ExecutionEngine> DaphneIrExecutor::createExecutionEngine(
     mlir::ExecutionEngineOptions options;
     options.llvmModuleBuilder = nullptr;
     options.transformer = optPipeline;
-    options.jitCodeGenOptLevel = llvm::CodeGenOpt::Level::Default;
+    options.jitCodeGenOptLevel = codeGenOptLevel;
     options.sharedLibPaths = llvm::ArrayRef<llvm::StringRef>(sharedLibRefs);
     options.enableObjectDump = true;
     options.enableGDBNotificationListener = true;
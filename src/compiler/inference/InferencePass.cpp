@@ -73,8 +73,8 @@ namespace {
             const ssize_t nr2 = mat2.getNumRows();
             const ssize_t nc1 = mat1.getNumCols();
             const ssize_t nc2 = mat2.getNumCols();
-            const ssize_t sp1 = mat1.getSparsity();
-            const ssize_t sp2 = mat2.getSparsity();
+            const double sp1 = mat1.getSparsity();
+            const double sp2 = mat2.getSparsity();
             const daphne::MatrixRepresentation repr1 = mat1.getRepresentation();
             const daphne::MatrixRepresentation repr2 = mat2.getRepresentation();
             return daphne::MatrixType::get(
@@ -134,6 +134,11 @@ namespace {
  */
 class InferencePass : public PassWrapper<InferencePass, OperationPass<func::FuncOp>> {
     daphne::InferenceConfig cfg;
+    /**
+     * @brief The MNC sketches derived during the current run of this pass,
+     * which does not erase any operations.
+     */
+    daphne::MncSketchCache sketchCache;
 
     /**
      * @brief Sets all properties of all results of the given operation to unknown
@@ -228,7 +233,7 @@ class InferencePass : public PassWrapper<InferencePass, OperationPass<func::Func
             }
             if (cfg.sparsityInference && returnsUnknownSparsity(op)) {
                 // Try to infer the sparsity of all results of this operation.
-                std::vector<double> sparsities = daphne::tryInferSparsity(op);
+                std::vector<double> sparsities = daphne::tryInferSparsity(op, &sketchCache);
                 const size_t numRes = op->getNumResults();
                 if(sparsities.size() != numRes)
                     throw ErrorHandler::compilerError(op, "InferencePass",
@@ -494,9 +499,11 @@ public:
         try {
             f.walk<WalkOrder::PreOrder>(walkOp);
         } catch (std::runtime_error &re) {
+            sketchCache.clear();
             throw ErrorHandler::rethrowError(
                 "InferencePass.cpp:" + std::to_string(__LINE__), re.what());
         }
+        sketchCache.clear();
         // infer function return types
         f.setType(FunctionType::get(&getContext(),
             f.getFunctionType().getInputs(),
@@ -0,0 +1,208 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ir/daphneir/Daphne.h"
+#include "ir/daphneir/Passes.h"
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/SymbolTable.h"
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace mlir;
+
+/**
+ * @brief Defers the compilation of function calls whose arguments have
+ * unknown shapes to run-time.
+ *
+ * Property inference runs once before execution. When the shape of a matrix
+ * depends on the data (e.g., after a filter, or when it is updated in a
+ * loop), the called function is specialized for unknown shapes, and all
+ * shape-dependent optimizations (e.g., the physical operator selection, the
+ * reordering of matrix multiplication chains, or vectorization) fall back to
+ * their generic variants for the entire function body.
+ *
+ * This pass replaces each such `GenericCallOp` by a `RecompileCallOp`, which
+ * carries the IR of a module consisting of the called function, all functions
+ * it calls (transitively), and an entry function `main` forwarding its
+ * arguments to the called function. At run-time, the kernel of the
+ * `RecompileCallOp` hands this IR to the `IRecompiler` in the user config,
+ * which sets the argument types of `main` to the actual properties of the
+ * arguments (shape, sparsity, representation), runs the entire compilation
+ * pipeline on the module, and caches the compiled code.
+ *
+ * Only calls whose arguments and results are all data objects (with results
+ * being matrices of the same value type) are considered, since the arguments
+ * and results are passed to the kernel as variadic packs of structures.
+ */
+namespace
+{
+    bool hasUnknownShape(Type t) {
+        if(auto mt = t.dyn_cast<daphne::MatrixType>())
+            return mt.getNumRows() == -1 || mt.getNumCols() == -1;
+        if(auto ft = t.dyn_cast<daphne::FrameType>())
+            return ft.getNumRows() == -1 || ft.getNumCols() == -1;
+        return false;
+    }
+
+    bool isRecompilable(daphne::GenericCallOp op) {
+        if(op->getNumResults() == 0)
+            return false;
+        if(!llvm::all_of(op->getOperandTypes(), [](Type t) {
+            return llvm::isa<daphne::MatrixType, daphne::FrameType>(t);
+        }))
+            return false;
+        // All results must share the same matrix type (apart from the
+        // properties) to be returned in a single variadic result.
+        auto mt0 = op->getResult(0).getType().dyn_cast<daphne::MatrixType>();
+        if(!mt0)
+            return false;
+        for(Type t : op->getResultTypes()) {
+            auto mt = t.dyn_cast<daphne::MatrixType>();
+            if(!mt || mt.withSameElementTypeAndRepr() != mt0.withSameElementTypeAndRepr())
+                return false;
+        }
+        return llvm::any_of(op->getOperandTypes(), hasUnknownShape);
+    }
+
+    /**
+     * @brief Removes all properties from the given type, such that the
+     * function argument it belongs to is specialized again at run-time.
+     */
+    Type withoutProperties(Type t) {
+        if(auto mt = t.dyn_cast<daphne::MatrixType>())
+            return mt.withSameElementTypeAndRepr();
+        if(auto ft = t.dyn_cast<daphne::FrameType>())
+            return ft.withSameColumnTypes();
+        return t;
+    }
+
+    /**
+     * @brief Collects the given function and all functions it calls
+     * (transitively).
+     */
+    void collectCallees(ModuleOp module, func::FuncOp f, std::vector<func::FuncOp> & funcs,
+                        std::set<Operation *> & visited) {
+        if(!visited.insert(f).second)
+            return;
+        funcs.push_back(f);
+        f.walk([&](Operation * op) {
+            StringRef callee;
+            if(auto co = llvm::dyn_cast<daphne::GenericCallOp>(op))
+                callee = co.getCallee();
+            else if(auto mo = llvm::dyn_cast<daphne::MapOp>(op))
+                callee = mo.getFunc();
+            else
+                return;
+            if(auto cf = module.lookupSymbol<func::FuncOp>(callee))
+                collectCallees(module, cf, funcs, visited);
+        });
+    }
+
+    /**
+     * @brief Creates the textual IR of a module, which calls the function
+     * called by the given op from its entry function `main`.
+     */
+    std::string createRecompilationModule(ModuleOp module, daphne::GenericCallOp op) {
+        OpBuilder builder(op->getContext());
+        Location loc = op.getLoc();
+        OwningOpRef<ModuleOp> stub = ModuleOp::create(loc);
+        builder.setInsertionPointToEnd(stub->getBody());
+
+        // Copy the called function and its callees.
+        std::vector<func::FuncOp> funcs;
+        std::set<Operation *> visited;
+        collectCallees(module, module.lookupSymbol<func::FuncOp>(op.getCallee()), funcs, visited);
+        for(func::FuncOp f : funcs) {
+            auto fc = llvm::cast<func::FuncOp>(builder.clone(*f.getOperation()));
+            if(fc.getSymName() != op.getCallee())
+                continue;
+            // Turn the called function into a template again, such that it
+            // gets specialized for the actual argument types.
+            std::vector<Type> argTys;
+            for(BlockArgument arg : fc.getArguments()) {
+                arg.setType(withoutProperties(arg.getType()));
+                argTys.push_back(arg.getType());
+            }
+            fc.setType(builder.getFunctionType(argTys, fc.getFunctionType().getResults()));
+        }
+
+        // Create the entry function, whose argument types are replaced by the
+        // actual ones at run-time.
+        auto mainTy = builder.getFunctionType(op->getOperandTypes(), op->getResultTypes());
+        auto mainFunc = builder.create<func::FuncOp>(loc, "main", mainTy);
+        Block * b = mainFunc.addEntryBlock();
+        builder.setInsertionPointToStart(b);
+        auto co = builder.create<daphne::GenericCallOp>(
+                loc, op.getCallee(), ValueRange(b->getArguments()), op->getResultTypes()
+        );
+        builder.create<daphne::ReturnOp>(loc, co->getResults());
+
+        std::string s;
+        llvm::raw_string_ostream stream(s);
+        stub->print(stream);
+        return stream.str();
+    }
+
+    struct AdaptiveRecompilationPass : public PassWrapper<AdaptiveRecompilationPass, OperationPass<ModuleOp>> {
+        void runOnOperation() final;
+
+        StringRef getArgument() const final { return "adaptive-recompilation"; }
+        StringRef getDescription() const final {
+            return "Defers the compilation of function calls with unknown argument shapes to run-time";
+        }
+    };
+}
+
+void AdaptiveRecompilationPass::runOnOperation()
+{
+    ModuleOp module = getOperation();
+
+    // Collect the calls first, since rewriting a call erases it.
+    std::vector<daphne::GenericCallOp> calls;
+    module.walk([&](daphne::GenericCallOp op) {
+        if(isRecompilable(op))
+            calls.push_back(op);
+    });
+
+    std::set<std::string> callees;
+    for(daphne::GenericCallOp op : calls) {
+        OpBuilder builder(op);
+        Value ir = builder.create<daphne::ConstantOp>(op.getLoc(), createRecompilationModule(module, op));
+        auto rco = builder.create<daphne::RecompileCallOp>(
+                op.getLoc(), op->getResultTypes(), ir, op->getOperands()
+        );
+        op->replaceAllUsesWith(rco->getResults());
+        callees.insert(op.getCallee().str());
+        op->erase();
+    }
+
+    // Remove the called functions if they are not called anymore.
+    for(const std::string & callee : callees) {
+        auto f = module.lookupSymbol<func::FuncOp>(callee);
+        if(f && SymbolTable::symbolKnownUseEmpty(f, module))
+            f.erase();
+    }
+}
+
+std::unique_ptr<Pass> daphne::createAdaptiveRecompilationPass()
+{
+    return std::make_unique<AdaptiveRecompilationPass>();
+}
@@ -114,8 +114,12 @@ void DistributePipelinesPass::runOnOperation()
     {
         // TODO Carefully decide if this pipeline shall be distributed, e.g.,
         // based on physical input size. For now, all pipelines are distributed
-        // (false means this pipeline is illegal and must be rewritten).
-        return false;
+        // (false means this pipeline is illegal and must be rewritten), except
+        // for those splitting inputs by columns, which the distributed runtime
+        // does not support yet.
+        return llvm::any_of(op.getSplits(), [](Attribute split) {
+            return split.cast<daphne::VectorSplitAttr>().getValue() == daphne::VectorSplit::COLS;
+        });
     });
 
     patterns.add<DistributePipelines>(&getContext());
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ir/daphneir/Daphne.h"
+#include "ir/daphneir/Passes.h"
+
+#include <runtime/local/kernels/AggOpCode.h>
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/TypeSwitch.h"
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+using namespace mlir;
+
+/**
+ * @brief Merges sibling row/column aggregations of the same matrix into a
+ * single `MultiAggRowOp`/`MultiAggColOp`.
+ *
+ * Scripts often compute several statistics of the same matrix, e.g.,
+ * `mean(X, 1)`, `stddev(X, 1)`, `min(X, 1)`, and `max(X, 1)` for feature
+ * scaling. Each of these aggregations scans the entire matrix, and `VAR` and
+ * `STDDEV` even scan it twice. The fused op scans it only once. Its result
+ * contains one row (column) per aggregation, which is sliced out for each of
+ * the original ops.
+ *
+ * Only dense matrices of floating-point values are considered, since the
+ * fused kernels compute all aggregations in floating-point. For `f32`, the
+ * positional aggregations `IDXMIN`/`IDXMAX` are not fused, since `f32` cannot
+ * represent all row indexes exactly.
+ */
+namespace
+{
+    struct AggInfo {
+        AggOpCode opCode;
+        bool isCol;
+    };
+
+    std::optional<AggInfo> getAggInfo(Operation * op) {
+        return llvm::TypeSwitch<Operation *, std::optional<AggInfo>>(op)
+            .Case<daphne::RowAggSumOp>([](auto) { return AggInfo{AggOpCode::SUM, false}; })
+            .Case<daphne::RowAggMinOp>([](auto) { return AggInfo{AggOpCode::MIN, false}; })
+            .Case<daphne::RowAggMaxOp>([](auto) { return AggInfo{AggOpCode::MAX, false}; })
+            .Case<daphne::RowAggIdxMinOp>([](auto) { return AggInfo{AggOpCode::IDXMIN, false}; })
+            .Case<daphne::RowAggIdxMaxOp>([](auto) { return AggInfo{AggOpCode::IDXMAX, false}; })
+            .Case<daphne::RowAggMeanOp>([](auto) { return AggInfo{AggOpCode::MEAN, false}; })
+            .Case<daphne::RowAggStddevOp>([](auto) { return AggInfo{AggOpCode::STDDEV, false}; })
+            .Case<daphne::RowAggVarOp>([](auto) { return AggInfo{AggOpCode::VAR, false}; })
+            .Case<daphne::ColAggSumOp>([](auto) { return AggInfo{AggOpCode::SUM, true}; })
+            .Case<daphne::ColAggMinOp>([](auto) { return AggInfo{AggOpCode::MIN, true}; })
+            .Case<daphne::ColAggMaxOp>([](auto) { return AggInfo{AggOpCode::MAX, true}; })
+            .Case<daphne::ColAggIdxMinOp>([](auto) { return AggInfo{AggOpCode::IDXMIN, true}; })
+            .Case<daphne::ColAggIdxMaxOp>([](auto) { return AggInfo{AggOpCode::IDXMAX, true}; })
+            .Case<daphne::ColAggMeanOp>([](auto) { return AggInfo{AggOpCode::MEAN, true}; })
+            .Case<daphne::ColAggStddevOp>([](auto) { return AggInfo{AggOpCode::STDDEV, true}; })
+            .Case<daphne::ColAggVarOp>([](auto) { return AggInfo{AggOpCode::VAR, true}; })
+            .Default([](Operation *) { return std::nullopt; });
+    }
+
+    bool isFusable(Value arg, AggOpCode opCode) {
+        auto mt = arg.getType().dyn_cast<daphne::MatrixType>();
+        if(!mt || mt.getRepresentation() != daphne::MatrixRepresentation::Dense)
+            return false;
+        Type vt = mt.getElementType();
+        if(vt.isF64())
+            return true;
+        if(vt.isF32())
+            return opCode != AggOpCode::IDXMIN && opCode != AggOpCode::IDXMAX;
+        return false;
+    }
+
+    /**
+     * @brief Replaces the given aggregations of `arg` by one fused op.
+     */
+    void fuse(Value arg, bool isCol, const std::vector<std::pair<Operation *, AggOpCode>> & aggOps) {
+        int64_t aggs = 0;
+        for(auto & [op, opCode] : aggOps)
+            aggs |= AggOpCodeUtils::getMultiAggBit(opCode);
+        // Nothing to gain from a single aggregation (identical ops have
+        // already been merged by CSE).
+        if(aggOps.size() < 2 || (aggs & (aggs - 1)) == 0)
+            return;
+
+        // The position of each aggregation in the result of the fused op.
+        std::map<AggOpCode, int64_t> positions;
+        for(auto & [op, opCode] : aggOps)
+            positions[opCode] = 0;
+        int64_t numAggs = 0;
+        for(auto & [opCode, pos] : positions)
+            pos = numAggs++;
+
+        // Insert the fused op before the first of the aggregations (the walk
+        // visits the ops of a block in order).
+        Operation * first = aggOps.front().first;
+        OpBuilder builder(first);
+        Location loc = first->getLoc();
+
+        auto argTy = arg.getType().cast<daphne::MatrixType>();
+        auto fusedTy = argTy.withSparsity(-1.0);
+        Type fusedVt = fusedTy.getElementType();
+        Value aggsVal = builder.create<daphne::ConstantOp>(loc, aggs);
+        Value fused;
+        if(isCol)
+            fused = builder.create<daphne::MultiAggColOp>(
+                    loc, fusedTy.withShape(numAggs, argTy.getNumCols()), arg, aggsVal
+            );
+        else
+            fused = builder.create<daphne::MultiAggRowOp>(
+                    loc, fusedTy.withShape(argTy.getNumRows(), numAggs), arg, aggsVal
+            );
+
+        // Replace each aggregation by the corresponding slice of the fused
+        // result, cast to the original result type if necessary (e.g., for
+        // the positions of IDXMIN/IDXMAX).
+        for(auto & [op, opCode] : aggOps) {
+            const int64_t pos = positions[opCode];
+            Value lo = builder.create<daphne::ConstantOp>(loc, pos);
+            Value hi = builder.create<daphne::ConstantOp>(loc, pos + 1);
+            auto resTy = op->getResult(0).getType().cast<daphne::MatrixType>();
+            auto sliceTy = resTy.withElementType(fusedVt);
+            Value slice;
+            if(isCol)
+                slice = builder.create<daphne::SliceRowOp>(loc, sliceTy, fused, lo, hi);
+            else
+                slice = builder.create<daphne::SliceColOp>(loc, sliceTy, fused, lo, hi);
+            if(sliceTy != resTy)
+                slice = builder.create<daphne::CastOp>(loc, resTy, slice);
+            op->getResult(0).replaceAllUsesWith(slice);
+            op->erase();
+        }
+    }
+
+    struct FuseAggregationsPass : public PassWrapper<FuseAggregationsPass, OperationPass<func::FuncOp>> {
+        void runOnOperation() final;
+    };
+}
+
+void FuseAggregationsPass::runOnOperation()
+{
+    auto func = getOperation();
+
+    // The fusable row (0) and column (1) aggregations, grouped by their
+    // argument and block, in the order of their occurrence.
+    using Key = std::pair<Value, Block *>;
+    llvm::MapVector<Key, std::vector<std::pair<Operation *, AggOpCode>>> groups[2];
+    func->walk([&](Operation * op) {
+        auto info = getAggInfo(op);
+        if(!info)
+            return;
+        Value arg = op->getOperand(0);
+        if(isFusable(arg, info->opCode))
+            groups[info->isCol][{arg, op->getBlock()}].push_back({op, info->opCode});
+    });
+
+    for(bool isCol : {false, true})
+        for(auto & [key, aggOps] : groups[isCol])
+            fuse(key.first, isCol, aggOps);
+}
+
+std::unique_ptr<Pass> daphne::createFuseAggregationsPass() {
+    return std::make_unique<FuseAggregationsPass>();
+}
@@ -489,6 +489,12 @@ public:
         Type itemType = item.getType();
         if (itemType != elementType) {
             if (llvm::isa<LLVM::LLVMPointerType>(elementType)) {
+                if(llvm::isa<LLVM::LLVMPointerType>(itemType)) {
+                    // e.g., a string passed among the data objects
+                    item = rewriter.create<LLVM::BitcastOp>(loc, elementType, item);
+                    rewriter.replaceOpWithNewOp<LLVM::StoreOp>(op.getOperation(), item, addr);
+                    return success();
+                }
                 if(itemType.isSignedInteger())
                     item = rewriter.create<LLVM::SExtOp>(loc, rewriter.getI64Type(), item);
                 else if(itemType.isUnsignedInteger() || itemType.isSignlessInteger())
@@ -582,6 +588,14 @@ public:
         auto numDataOperands = op.getInputs().size();
         std::vector<mlir::Value> func_ptrs;
 
+        // A row-split string input is the name of a file the pipeline streams
+        // its input from (see StreamPipelinesPass).
+        int64_t streamInput = -1;
+        for(size_t i = 0; i < numDataOperands; i++)
+            if(op.getSplits()[i].cast<daphne::VectorSplitAttr>().getValue() == daphne::VectorSplit::ROWS &&
+                    op.getInputs().getType()[i].isa<daphne::StringType>())
+                streamInput = i;
+
         auto i1Ty = IntegerType::get(getContext(), 1);
         auto ptrI1Ty = LLVM::LLVMPointerType::get(i1Ty);
         auto ptrPtrI1Ty = LLVM::LLVMPointerType::get(ptrI1Ty);
@@ -624,7 +638,8 @@ public:
                     ArrayRef<Value>({
                         rewriter.create<arith::ConstantOp>(loc, rewriter.getI64IntegerAttr(i))}));
                 Value val = rewriter.create<LLVM::LoadOp>(loc, addr);
-                auto expTy = typeConverter->convertType(op.getInputs().getType()[i]);
+                // The body expects a matrix chunk for a streamed input.
+                auto expTy = typeConverter->convertType(funcBlock.getArgument(0).getType());
                 if (expTy != val.getType()) {
                     // casting for scalars
                     val = rewriter.create<LLVM::PtrToIntOp>(loc, rewriter.getI64Type(), val);
@@ -664,7 +679,7 @@ public:
 
         func_ptrs.push_back(fnPtr);
 
-        if(cfg.use_cuda && !op.getCuda().getBlocks().empty()) {
+        if(cfg.use_cuda && !op.getCuda().getBlocks().empty() && streamInput == -1) {
             LLVM::LLVMFuncOp fOp2;
             {
                 OpBuilder::InsertionGuard ig(rewriter);
@@ -730,7 +745,7 @@ public:
             func_ptrs.push_back(fnPtr2);
         }
         std::stringstream callee;
-        callee << '_' << op->getName().stripDialect().str();
+        callee << '_' << (streamInput == -1 ? op->getName().stripDialect().str() : "streamingPipeline");
 
         // Get some information on the results.
         Operation::result_type_range resultTypes = op->getResultTypes();
@@ -847,6 +862,12 @@ public:
         }
         newOperands.push_back(convertToArray(loc, rewriter, rewriter.getI64Type(), combineConsts));
 
+        if(streamInput != -1) {
+            callee << "__int64_t";
+            newOperands.push_back(rewriter.create<daphne::ConstantOp>(loc, rewriter.getI64Type(),
+                    rewriter.getI64IntegerAttr(streamInput)));
+        }
+
         // TODO: pass function pointer with special placeholder instead of `void`
 
         callee << "__size_t";
@@ -202,7 +202,7 @@ void processBlock(OpBuilder builder, Block * b) {
                 incRefArgs(op, builder);
         }
         // Loops and function calls.
-        else if(llvm::isa<scf::WhileOp, scf::ForOp, func::CallOp, daphne::GenericCallOp>(op))
+        else if(llvm::isa<scf::WhileOp, scf::ForOp, func::CallOp, daphne::GenericCallOp, daphne::RecompileCallOp>(op))
             incRefArgs(op, builder);
         // YieldOp of IfOp.
         else if(llvm::isa<scf::YieldOp>(op) && llvm::isa<scf::IfOp>(op.getParentOp())) {
@@ -48,6 +48,12 @@ struct MarkCUDAOpsPass : public PassWrapper<MarkCUDAOpsPass, OperationPass<func:
         auto& pipeline = pipelineOp.getBody().front().getOperations();
         bool build_cuda_pipeline;
         
+        // column blocks are not contiguous in memory, which the CUDA kernels do not support
+        if(llvm::any_of(pipelineOp.getSplits(), [](Attribute split) {
+            return split.cast<daphne::VectorSplitAttr>().getValue() == daphne::VectorSplit::COLS;
+        }))
+            return;
+        
         // add CUDA ops if at least one (cuda_fuse_any) or all (!cuda_fuse_any) ops would be supported
         if(cfg.cuda_fuse_any) {
             bool pipeline_has_supported_cuda_ops = llvm::any_of(pipeline, [&](Operation& o) {
@@ -0,0 +1,294 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <compiler/utils/CompilerUtils.h>
+#include "ir/daphneir/Daphne.h"
+#include "ir/daphneir/Passes.h"
+#include <runtime/local/datastructures/MncSketch.h>
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace mlir;
+
+/**
+ * @brief Reorders chains of matrix multiplications such that the number of
+ * floating-point operations is minimized.
+ *
+ * Matrix multiplication is associative, but the cost of a chain such as
+ * `A @ B @ v` depends heavily on its parenthesization: for `n x n` matrices
+ * `A` and `B` and an `n x 1` vector `v`, `(A @ B) @ v` requires `O(n^3)`
+ * operations, whereas `A @ (B @ v)` requires only `O(n^2)`. This pass collects
+ * maximal trees of MatMulOps, whose intermediate results are not used
+ * elsewhere, and replaces them by the optimal parenthesization found by the
+ * classic dynamic program for the matrix chain ordering problem.
+ *
+ * Transposed inputs (the `transa`/`transb` arguments of MatMulOp, into which
+ * the canonicalization folds TransposeOps) are retained on the respective
+ * factor of the chain. The cost of each multiplication is the number of
+ * scalar multiplications of a sparsity-exploiting kernel. If the MNC sketches
+ * of the factors are known (see daphne::tryGetMncSketch()), this number is
+ * exact for the factors and the sketches are propagated to the intermediate
+ * results. Otherwise, it is the dense cost `m * k * n` scaled by the sparsity
+ * of both inputs, where the sparsity of intermediate results is estimated
+ * like in MatMulOp::inferSparsity().
+ *
+ * The pass requires the shapes of all factors to be known and does not touch
+ * chains of mixed value types.
+ */
+namespace
+{
+    /**
+     * @brief A matrix or (intermediate) result in a chain of matrix
+     * multiplications.
+     */
+    struct ChainPlan {
+        ssize_t numRows;
+        ssize_t numCols;
+        // -1.0 if unknown
+        double sparsity;
+        // The number of scalar multiplications required to compute it.
+        double cost;
+        // null if unknown
+        std::shared_ptr<const MncSketch> sketch;
+
+        double sparsityOrDense() const {
+            return sparsity == -1.0 ? 1.0 : sparsity;
+        }
+    };
+
+    ChainPlan multiply(const ChainPlan & lhs, const ChainPlan & rhs) {
+        if(lhs.sketch && rhs.sketch) {
+            // The exact number of scalar multiplications.
+            double cost = 0;
+            for(size_t i = 0; i < lhs.sketch->numCols; i++)
+                cost += static_cast<double>(lhs.sketch->colNnz[i]) * rhs.sketch->rowNnz[i];
+            auto sketch = std::make_shared<const MncSketch>(propagateMncMatMul(*lhs.sketch, *rhs.sketch));
+            return {lhs.numRows, rhs.numCols, sketch->getSparsity(), lhs.cost + rhs.cost + cost, sketch};
+        }
+        const double cost = static_cast<double>(lhs.numRows) * lhs.numCols * rhs.numCols
+                * lhs.sparsityOrDense() * rhs.sparsityOrDense();
+        const double sparsity = estimateSparsityMatMul(lhs.sparsity, rhs.sparsity, lhs.numCols);
+        return {lhs.numRows, rhs.numCols, sparsity, lhs.cost + rhs.cost + cost, nullptr};
+    }
+
+    struct Factor {
+        Value mat;
+        bool transposed;
+        ChainPlan plan;
+    };
+
+    struct MatMulChain {
+        Type elementType;
+        std::vector<Factor> factors;
+        // The MatMulOps of the chain in post-order, i.e., the root is last.
+        std::vector<daphne::MatMulOp> ops;
+    };
+
+    bool getTransFlags(daphne::MatMulOp op, bool & ta, bool & tb) {
+        auto pa = CompilerUtils::isConstant<bool>(op.getTransa());
+        auto pb = CompilerUtils::isConstant<bool>(op.getTransb());
+        ta = pa.second;
+        tb = pb.second;
+        return pa.first && pb.first;
+    }
+
+    Type getElementType(Value v) {
+        if(auto mt = v.getType().dyn_cast<daphne::MatrixType>())
+            return mt.getElementType();
+        return nullptr;
+    }
+
+    /**
+     * @brief Returns if the result of the given MatMulOp is an intermediate
+     * result of the chain of its (only) user.
+     */
+    bool isInnerLink(daphne::MatMulOp op) {
+        if(!op->hasOneUse())
+            return false;
+        OpOperand & use = *op->getUses().begin();
+        auto user = llvm::dyn_cast<daphne::MatMulOp>(use.getOwner());
+        if(!user || user->getBlock() != op->getBlock())
+            return false;
+        bool ta, tb;
+        if(!getTransFlags(op, ta, tb) || !getTransFlags(user, ta, tb))
+            return false;
+        // Transposed intermediate results stay separate chains.
+        const unsigned operandNumber = use.getOperandNumber();
+        if(operandNumber > 1 || (operandNumber == 0 ? ta : tb))
+            return false;
+        return getElementType(op.getResult()) == getElementType(user.getResult());
+    }
+
+    /**
+     * @brief Collects the factors of the chain rooted at the given value and
+     * returns the plan of how it is currently computed.
+     *
+     * @return `false` if the chain cannot be optimized.
+     */
+    bool collect(Value v, bool transposed, bool isRoot, MatMulChain & chain, ChainPlan & plan) {
+        auto mmOp = v.getDefiningOp<daphne::MatMulOp>();
+        if(mmOp && (isRoot || (!transposed && isInnerLink(mmOp)))) {
+            bool ta, tb;
+            if(!getTransFlags(mmOp, ta, tb))
+                return false;
+            ChainPlan lhsPlan, rhsPlan;
+            if(!collect(mmOp.getLhs(), ta, false, chain, lhsPlan) ||
+                    !collect(mmOp.getRhs(), tb, false, chain, rhsPlan))
+                return false;
+            if(lhsPlan.numCols != rhsPlan.numRows)
+                return false;
+            plan = multiply(lhsPlan, rhsPlan);
+            chain.ops.push_back(mmOp);
+            return true;
+        }
+
+        auto mt = v.getType().dyn_cast<daphne::MatrixType>();
+        if(!mt || mt.getElementType() != chain.elementType)
+            return false;
+        const ssize_t numRows = transposed ? mt.getNumCols() : mt.getNumRows();
+        const ssize_t numCols = transposed ? mt.getNumRows() : mt.getNumCols();
+        if(numRows == -1 || numCols == -1)
+            return false;
+        plan = {numRows, numCols, mt.getSparsity(), 0.0, nullptr};
+        if(auto sketch = daphne::tryGetMncSketch(v))
+            if(sketch->numRows == static_cast<size_t>(mt.getNumRows()) &&
+                    sketch->numCols == static_cast<size_t>(mt.getNumCols())) {
+                plan.sketch = transposed ? std::make_shared<const MncSketch>(sketch->transposed()) : sketch;
+                plan.sparsity = sketch->getSparsity();
+            }
+        chain.factors.push_back({v, transposed, plan});
+        return true;
+    }
+
+    /**
+     * @brief Finds the optimal parenthesization of a chain by dynamic
+     * programming.
+     */
+    class ChainOrderOptimizer {
+        const std::vector<Factor> & factors;
+        // plans[i][j] and splits[i][j] describe the optimal plan for the
+        // factors i..j, which multiplies (i..splits[i][j]) by
+        // (splits[i][j]+1..j).
+        std::vector<std::vector<ChainPlan>> plans;
+        std::vector<std::vector<size_t>> splits;
+
+    public:
+        explicit ChainOrderOptimizer(const std::vector<Factor> & factors) : factors(factors) {
+            const size_t n = factors.size();
+            plans.resize(n, std::vector<ChainPlan>(n));
+            splits.resize(n, std::vector<size_t>(n, 0));
+            for(size_t i = 0; i < n; i++)
+                plans[i][i] = factors[i].plan;
+            for(size_t len = 2; len <= n; len++)
+                for(size_t i = 0; i + len <= n; i++) {
+                    const size_t j = i + len - 1;
+                    plans[i][j].cost = std::numeric_limits<double>::infinity();
+                    for(size_t k = i; k < j; k++) {
+                        ChainPlan p = multiply(plans[i][k], plans[k + 1][j]);
+                        if(p.cost < plans[i][j].cost) {
+                            plans[i][j] = p;
+                            splits[i][j] = k;
+                        }
+                    }
+                }
+        }
+
+        double getCost() const {
+            return plans.front().back().cost;
+        }
+
+        /**
+         * @brief Creates the MatMulOps for the factors i..j.
+         *
+         * @param resTy The result type to use, or null for an intermediate
+         * result, whose type is derived from the plan.
+         */
+        std::pair<Value, bool> build(OpBuilder & builder, Location loc, daphne::MatrixType rootTy,
+                                     size_t i, size_t j, Type resTy = nullptr) const {
+            if(i == j)
+                return {factors[i].mat, factors[i].transposed};
+            const size_t k = splits[i][j];
+            auto [lhs, ta] = build(builder, loc, rootTy, i, k);
+            auto [rhs, tb] = build(builder, loc, rootTy, k + 1, j);
+            if(!resTy) {
+                const ChainPlan & p = plans[i][j];
+                resTy = rootTy.withShape(p.numRows, p.numCols).withSparsity(p.sparsity);
+            }
+            Value res = builder.create<daphne::MatMulOp>(
+                    loc, resTy, lhs, rhs,
+                    static_cast<Value>(builder.create<daphne::ConstantOp>(loc, ta)),
+                    static_cast<Value>(builder.create<daphne::ConstantOp>(loc, tb))
+            );
+            return {res, false};
+        }
+    };
+
+    void optimizeChain(daphne::MatMulOp root) {
+        auto rootTy = root.getType().dyn_cast<daphne::MatrixType>();
+        if(!rootTy)
+            return;
+        MatMulChain chain;
+        chain.elementType = rootTy.getElementType();
+        ChainPlan origPlan;
+        if(!collect(root.getResult(), false, true, chain, origPlan))
+            return;
+        // For two factors, there is nothing to reorder.
+        if(chain.factors.size() < 3)
+            return;
+
+        ChainOrderOptimizer opt(chain.factors);
+        // Only rewrite if the new order is substantially cheaper, such that
+        // equivalent orders (up to rounding of the cost) are not exchanged.
+        if(!(opt.getCost() < 0.99 * origPlan.cost))
+            return;
+
+        OpBuilder builder(root);
+        Value res = opt.build(builder, root.getLoc(), rootTy, 0, chain.factors.size() - 1, root.getType()).first;
+        root.getResult().replaceAllUsesWith(res);
+        // Erase the old chain from the root down, such that each op is unused
+        // when it is erased.
+        for(auto it = chain.ops.rbegin(); it != chain.ops.rend(); ++it)
+            it->erase();
+    }
+
+    struct MatMulChainOptimizationPass : public PassWrapper<MatMulChainOptimizationPass, OperationPass<func::FuncOp>> {
+        void runOnOperation() final;
+    };
+}
+
+void MatMulChainOptimizationPass::runOnOperation()
+{
+    auto func = getOperation();
+
+    // Collect the roots of all chains first, since rewriting a chain erases
+    // its MatMulOps.
+    std::vector<daphne::MatMulOp> roots;
+    func->walk([&](daphne::MatMulOp op) {
+        if(!isInnerLink(op))
+            roots.push_back(op);
+    });
+    for(daphne::MatMulOp root : roots)
+        optimizeChain(root);
+}
+
+std::unique_ptr<Pass> daphne::createMatMulChainOptimizationPass() {
+    return std::make_unique<MatMulChainOptimizationPass>();
+}
@@ -22,6 +22,7 @@
 #include <utility>
 #include <vector>
 
+#include "compiler/utils/CompilerUtils.h"
 #include "compiler/utils/LoweringUtils.h"
 #include <util/ErrorHandler.h>
 #include "hwloc.h"
@@ -723,7 +724,15 @@ void MatMulLoweringPass::runOnOperation() {
   options.enableLoopInversion(matmul_invert_loops);
   options.setNumberOfVectorRegisters(matmul_num_vec_registers);
   target.addDynamicallyLegalOp<mlir::daphne::MatMulOp>(
-      [options](Operation *op) { return !is_valid_options(options); });
+      [options](Operation *op) {
+        // The generated loops do not support transposed inputs, those
+        // multiplications are left to the kernels.
+        auto mmOp = llvm::cast<mlir::daphne::MatMulOp>(op);
+        if (CompilerUtils::constantOrDefault<bool>(mmOp.getTransa(), true) ||
+            CompilerUtils::constantOrDefault<bool>(mmOp.getTransb(), true))
+          return true;
+        return !is_valid_options(options);
+      });
 
   patterns.insert<MatMulLowering>(typeConverter, &getContext(), options);
 
@@ -15,6 +15,7 @@
  */
 
 #include <compiler/utils/CompilerUtils.h>
+#include <api/cli/DaphneUserConfig.h>
 #include "ir/daphneir/Daphne.h"
 #include "ir/daphneir/Passes.h"
 
@@ -31,12 +32,322 @@
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/Transforms/DialectConversion.h"
 
+#include <initializer_list>
 #include <memory>
 #include <utility>
 #include <vector>
 
 using namespace mlir;
 
+/**
+ * @brief Returns the matrix whose transpose is the left-hand-side input of the
+ * given MatMulOp, or a null value if the lhs input is not transposed.
+ *
+ * The canonicalization of MatMulOp factors in transposed inputs:
+ * - `t(X) @_ta_tb Y` to `X @_!ta_tb Y`
+ * - `X @_ta_tb t(Y)` to `X @_ta_!tb Y`
+ * I.e., the arguments transa and transb of MatMulOp represent if the inputs
+ * shall be transposed. For robustness, we also recognize a TransposeOp that has
+ * not been folded (yet).
+ */
+static Value getTransposedLhs(daphne::MatMulOp op) {
+    bool lhsTransposed = CompilerUtils::constantOrThrow<bool>(
+            op.getTransa(), "MatMulOp.getTransa() is expected to be a constant"
+    );
+    if(auto to = op.getLhs().getDefiningOp<daphne::TransposeOp>())
+        return lhsTransposed ? nullptr : to.getArg();
+    return lhsTransposed ? op.getLhs() : nullptr;
+}
+
+// ****************************************************************************
+// Fused operators
+// ****************************************************************************
+// The fused operators replace compositions of operations, whose intermediate
+// results are not used elsewhere. They are only introduced for dense matrices
+// of floating-point values (the weights of `wsLoss` may also be sparse), since
+// only those are supported by the fused kernels.
+
+/**
+ * @brief Returns if the given value is a matrix of the given floating-point
+ * value type (dense or, if allowed, CSR).
+ */
+static bool isFloatMatrix(Value v, Type vt, bool allowSparse = false) {
+    auto mt = v.getType().dyn_cast<daphne::MatrixType>();
+    if(!mt || mt.getElementType() != vt || !(vt.isF64() || vt.isF32()))
+        return false;
+    return mt.getRepresentation() == daphne::MatrixRepresentation::Dense ||
+            (allowSparse && mt.getRepresentation() == daphne::MatrixRepresentation::Sparse);
+}
+
+/**
+ * @brief Returns if the given matrices have the same shape, which is known at
+ * compile-time.
+ *
+ * Element-wise operations broadcast row/column vectors and scalars, which the
+ * fused kernels do not.
+ */
+static bool haveSameKnownShape(Value a, Value b) {
+    auto at = a.getType().cast<daphne::MatrixType>();
+    auto bt = b.getType().cast<daphne::MatrixType>();
+    return at.getNumRows() != -1 && at.getNumCols() != -1 &&
+            at.getNumRows() == bt.getNumRows() && at.getNumCols() == bt.getNumCols();
+}
+
+/**
+ * @brief Returns if the given value is a constant of the given value, no matter
+ * if it is represented as an integer or a floating-point value.
+ */
+static bool isConstantValue(Value v, double c) {
+    if(auto co = v.getDefiningOp<daphne::CastOp>())
+        v = co.getArg();
+    auto pf = CompilerUtils::isConstant<double>(v);
+    if(pf.first)
+        return pf.second == c;
+    auto pi = CompilerUtils::isConstant<int64_t>(v);
+    return pi.first && static_cast<double>(pi.second) == c;
+}
+
+/**
+ * @brief Returns the operation of type `OpT` defining the given value, if it
+ * can be fused into the given root operation, i.e., if the value is used only
+ * once and in the same block as the root.
+ */
+template<class OpT>
+static OpT getFusable(Value v, Operation * root) {
+    auto op = v.getDefiningOp<OpT>();
+    if(op && op->hasOneUse() && op->getBlock() == root->getBlock())
+        return op;
+    return nullptr;
+}
+
+/**
+ * @brief Replaces the given root operation by the given fused value and erases
+ * the intermediate operations, which must be given from the root down.
+ */
+static void replaceFused(Operation * root, Value fused, std::initializer_list<Operation *> intermediates) {
+    root->getResult(0).replaceAllUsesWith(fused);
+    root->erase();
+    for(Operation * op : intermediates)
+        if(op && op->use_empty())
+            op->erase();
+}
+
+/**
+ * @brief Returns `X` if the given value is `-X` (expressed as `-1 * X`,
+ * `X * -1`, `0 - X`, or `-X`), or a null value otherwise.
+ */
+static Value getNegatedArg(Value v, Operation * root, Operation *& negOp) {
+    if(auto op = getFusable<daphne::EwMinusOp>(v, root)) {
+        negOp = op;
+        return op.getArg();
+    }
+    if(auto op = getFusable<daphne::EwMulOp>(v, root)) {
+        negOp = op;
+        if(isConstantValue(op.getLhs(), -1))
+            return op.getRhs();
+        if(isConstantValue(op.getRhs(), -1))
+            return op.getLhs();
+    }
+    if(auto op = getFusable<daphne::EwSubOp>(v, root)) {
+        negOp = op;
+        if(isConstantValue(op.getLhs(), 0))
+            return op.getRhs();
+    }
+    negOp = nullptr;
+    return nullptr;
+}
+
+/**
+ * @brief Fuses the compositions rooted at an AllAggSumOp:
+ * - `sum(W * (X - U @ t(V))^2)` -> `wsLoss(W, X, U, V)`
+ * - `sum((X - Y)^2)` -> `sumSqDiff(X, Y)`
+ * - `sum(X * Y)` -> `dot(X, Y)`
+ */
+static bool fuseAllAggSum(daphne::AllAggSumOp root) {
+    Type resTy = root.getType();
+    Type vt = resTy;
+    Location loc = root.getLoc();
+
+    if(auto mul = getFusable<daphne::EwMulOp>(root.getArg(), root)) {
+        for(auto [w, sq] : {std::make_pair(mul.getLhs(), mul.getRhs()), std::make_pair(mul.getRhs(), mul.getLhs())}) {
+            auto pow = getFusable<daphne::EwPowOp>(sq, root);
+            if(!pow || !isConstantValue(pow.getRhs(), 2))
+                continue;
+            auto sub = getFusable<daphne::EwSubOp>(pow.getLhs(), root);
+            if(!sub)
+                continue;
+            auto mm = getFusable<daphne::MatMulOp>(sub.getRhs(), root);
+            if(!mm)
+                continue;
+            auto ta = CompilerUtils::isConstant<bool>(mm.getTransa());
+            auto tb = CompilerUtils::isConstant<bool>(mm.getTransb());
+            if(!ta.first || ta.second || !tb.first || !tb.second)
+                continue;
+            Value x = sub.getLhs();
+            Value u = mm.getLhs();
+            Value v = mm.getRhs();
+            if(isFloatMatrix(w, vt, true) && isFloatMatrix(x, vt) && isFloatMatrix(u, vt) && isFloatMatrix(v, vt) &&
+                    haveSameKnownShape(w, x) && haveSameKnownShape(x, mm.getResult())) {
+                OpBuilder builder(root);
+                Value fused = builder.create<daphne::WsLossOp>(loc, resTy, w, x, u, v);
+                replaceFused(root, fused, {mul, pow, sub, mm});
+                return true;
+            }
+        }
+        Value lhs = mul.getLhs();
+        Value rhs = mul.getRhs();
+        if(isFloatMatrix(lhs, vt) && isFloatMatrix(rhs, vt) && haveSameKnownShape(lhs, rhs)) {
+            OpBuilder builder(root);
+            Value fused = builder.create<daphne::DotOp>(loc, resTy, lhs, rhs);
+            replaceFused(root, fused, {mul});
+            return true;
+        }
+    }
+
+    if(auto pow = getFusable<daphne::EwPowOp>(root.getArg(), root)) {
+        if(auto sub = getFusable<daphne::EwSubOp>(pow.getLhs(), root)) {
+            Value lhs = sub.getLhs();
+            Value rhs = sub.getRhs();
+            if(isConstantValue(pow.getRhs(), 2) &&
+                    isFloatMatrix(lhs, vt) && isFloatMatrix(rhs, vt) && haveSameKnownShape(lhs, rhs)) {
+                OpBuilder builder(root);
+                Value fused = builder.create<daphne::SumSqDiffOp>(loc, resTy, lhs, rhs);
+                replaceFused(root, fused, {pow, sub});
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Fuses `sum(X * Y, 0)` -> `rowDot(X, Y)`.
+ */
+static bool fuseRowAggSum(daphne::RowAggSumOp root) {
+    auto resTy = root.getType().dyn_cast<daphne::MatrixType>();
+    auto mul = getFusable<daphne::EwMulOp>(root.getArg(), root);
+    if(!resTy || !mul)
+        return false;
+    Value lhs = mul.getLhs();
+    Value rhs = mul.getRhs();
+    Type vt = resTy.getElementType();
+    if(!isFloatMatrix(lhs, vt) || !isFloatMatrix(rhs, vt) || !haveSameKnownShape(lhs, rhs))
+        return false;
+    OpBuilder builder(root);
+    Value fused = builder.create<daphne::RowDotOp>(root.getLoc(), resTy, lhs, rhs);
+    replaceFused(root, fused, {mul});
+    return true;
+}
+
+/**
+ * @brief Fuses `X * (M > 0)` -> `ewMulPosMask(X, M)`.
+ */
+static bool fuseEwMul(daphne::EwMulOp root) {
+    auto resTy = root.getType().dyn_cast<daphne::MatrixType>();
+    if(!resTy)
+        return false;
+    Type vt = resTy.getElementType();
+    for(auto [arg, maskArg] : {std::make_pair(root.getLhs(), root.getRhs()), std::make_pair(root.getRhs(), root.getLhs())}) {
+        auto gt = getFusable<daphne::EwGtOp>(maskArg, root);
+        if(!gt || !isConstantValue(gt.getRhs(), 0))
+            continue;
+        Value mask = gt.getLhs();
+        if(isFloatMatrix(arg, vt) && isFloatMatrix(mask, vt) && isFloatMatrix(gt.getResult(), vt) &&
+                haveSameKnownShape(arg, mask)) {
+            OpBuilder builder(root);
+            Value fused = builder.create<daphne::EwMulPosMaskOp>(root.getLoc(), resTy, arg, mask);
+            replaceFused(root, fused, {gt});
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Fuses the compositions rooted at an EwDivOp:
+ * - `1 / (1 + exp(-X))` -> `sigmoid(X)`
+ * - `E / sum(E, 0)` with `E = exp(X - aggMax(X, 0))` or `E = exp(X)` ->
+ *   `rowSoftmax(X)`
+ */
+static bool fuseEwDiv(daphne::EwDivOp root) {
+    auto resTy = root.getType().dyn_cast<daphne::MatrixType>();
+    if(!resTy)
+        return false;
+    Type vt = resTy.getElementType();
+    Location loc = root.getLoc();
+
+    if(isConstantValue(root.getLhs(), 1)) {
+        if(auto add = getFusable<daphne::EwAddOp>(root.getRhs(), root)) {
+            Value expVal = isConstantValue(add.getLhs(), 1) ? add.getRhs()
+                    : (isConstantValue(add.getRhs(), 1) ? add.getLhs() : nullptr);
+            auto exp = expVal ? getFusable<daphne::EwExpOp>(expVal, root) : nullptr;
+            Operation * negOp = nullptr;
+            Value x = exp ? getNegatedArg(exp.getArg(), root, negOp) : nullptr;
+            if(x && isFloatMatrix(x, vt)) {
+                OpBuilder builder(root);
+                Value fused = builder.create<daphne::SigmoidOp>(loc, resTy, x);
+                replaceFused(root, fused, {add, exp, negOp});
+                return true;
+            }
+        }
+    }
+
+    // E is used by both the division and the row-wise sum.
+    auto exp = root.getLhs().getDefiningOp<daphne::EwExpOp>();
+    auto sum = getFusable<daphne::RowAggSumOp>(root.getRhs(), root);
+    if(!exp || !sum || sum.getArg() != exp.getResult() || exp->getBlock() != root->getBlock())
+        return false;
+    for(Operation * user : exp->getUsers())
+        if(user != root && user != sum)
+            return false;
+    Value x = exp.getArg();
+    daphne::EwSubOp sub = getFusable<daphne::EwSubOp>(x, root);
+    daphne::RowAggMaxOp max = sub ? getFusable<daphne::RowAggMaxOp>(sub.getRhs(), root) : nullptr;
+    if(max && max.getArg() == sub.getLhs())
+        // The kernel subtracts the row-wise maximum anyway.
+        x = sub.getLhs();
+    else
+        sub = nullptr;
+    if(!isFloatMatrix(x, vt))
+        return false;
+    OpBuilder builder(root);
+    Value fused = builder.create<daphne::RowSoftmaxOp>(loc, resTy, x);
+    replaceFused(root, fused, {sum, exp, sub, sub ? max : nullptr});
+    return true;
+}
+
+/**
+ * @brief Fuses `t(X) @ (X @ v)` -> `mmChain(X, v)`.
+ *
+ * This takes precedence over `gemv`, which would materialize `X @ v`.
+ */
+static bool fuseMatMul(daphne::MatMulOp root) {
+    auto resTy = root.getType().dyn_cast<daphne::MatrixType>();
+    if(!resTy)
+        return false;
+    Value x = getTransposedLhs(root);
+    auto tb = CompilerUtils::isConstant<bool>(root.getTransb());
+    if(!x || !tb.first || tb.second)
+        return false;
+    auto inner = getFusable<daphne::MatMulOp>(root.getRhs(), root);
+    if(!inner || inner.getLhs() != x)
+        return false;
+    auto ta = CompilerUtils::isConstant<bool>(inner.getTransa());
+    auto tbInner = CompilerUtils::isConstant<bool>(inner.getTransb());
+    if(!ta.first || ta.second || !tbInner.first || tbInner.second)
+        return false;
+    Value v = inner.getRhs();
+    Type vt = resTy.getElementType();
+    if(!isFloatMatrix(x, vt) || !isFloatMatrix(v, vt) || v.getType().cast<daphne::MatrixType>().getNumCols() != 1)
+        return false;
+    Operation * transposeOp = root.getLhs().getDefiningOp<daphne::TransposeOp>();
+    OpBuilder builder(root);
+    Value fused = builder.create<daphne::MMChainOp>(root.getLoc(), resTy, x, v);
+    replaceFused(root, fused, {inner, transposeOp});
+    return true;
+}
+
 class MatMulOpLowering : public OpConversionPattern<daphne::MatMulOp> {
 public:
     using OpConversionPattern::OpConversionPattern;
@@ -44,13 +355,12 @@ public:
     LogicalResult
     matchAndRewrite(daphne::MatMulOp op, OpAdaptor adaptor,
                     ConversionPatternRewriter &rewriter) const override {
-        Value lhs = op.getLhs();
         Value rhs = op.getRhs();
-        if(auto to = lhs.getDefiningOp<daphne::TransposeOp>()) {
+        if(Value lhsArg = getTransposedLhs(op)) {
             bool rhsTransposed = CompilerUtils::constantOrThrow<bool>(
                     op.getTransb(), "MatMulOp.getTransb() is expected to be a constant"
             );
-            if(to.getArg() == rhs && !rhsTransposed) {
+            if(lhsArg == rhs && !rhsTransposed) {
                 // `t(M) @ M` -> `syrk(M)`
                 rewriter.replaceOpWithNewOp<daphne::SyrkOp>(op, op.getResult().getType(), rhs);
                 return success();
@@ -58,7 +368,7 @@ public:
             auto rhsMatTy = rhs.getType().dyn_cast<daphne::MatrixType>();
             if((!rhsTransposed && rhsMatTy.getNumCols() == 1) || (rhsTransposed && rhsMatTy.getNumRows() == 1)) {
                 // `t(M) @ v` -> `gemv(M, v)`
-                rewriter.replaceOpWithNewOp<daphne::GemvOp>(op, op.getResult().getType(), to.getArg(), rhs);
+                rewriter.replaceOpWithNewOp<daphne::GemvOp>(op, op.getResult().getType(), lhsArg, rhs);
                 return success();
             }
         }
@@ -69,14 +379,44 @@ public:
 namespace {
     struct PhyOperatorSelectionPass
     : public PassWrapper<PhyOperatorSelectionPass, OperationPass<ModuleOp>> {
-		explicit PhyOperatorSelectionPass() { }
+        const DaphneUserConfig& cfg;
+		explicit PhyOperatorSelectionPass(const DaphneUserConfig& cfg) : cfg(cfg) { }
         void runOnOperation() final;
+        void fuseOperators(ModuleOp module);
     };
 } // end anonymous namespace
 
+void PhyOperatorSelectionPass::fuseOperators(ModuleOp module) {
+    // Collect the candidate roots first, since fusing erases operations. The
+    // intermediates of a fused composition precede its root in the same
+    // block, such that they have already been visited when they are erased.
+    std::vector<Operation *> roots;
+    module->walk([&](Operation * op) {
+        if(llvm::isa<daphne::AllAggSumOp, daphne::RowAggSumOp, daphne::EwMulOp, daphne::EwDivOp, daphne::MatMulOp>(op))
+            roots.push_back(op);
+    });
+    for(Operation * op : roots) {
+        if(auto root = llvm::dyn_cast<daphne::AllAggSumOp>(op))
+            fuseAllAggSum(root);
+        else if(auto root = llvm::dyn_cast<daphne::RowAggSumOp>(op))
+            fuseRowAggSum(root);
+        else if(auto root = llvm::dyn_cast<daphne::EwMulOp>(op))
+            fuseEwMul(root);
+        else if(auto root = llvm::dyn_cast<daphne::EwDivOp>(op))
+            fuseEwDiv(root);
+        else if(auto root = llvm::dyn_cast<daphne::MatMulOp>(op))
+            fuseMatMul(root);
+    }
+}
+
 void PhyOperatorSelectionPass::runOnOperation() {
     auto module = getOperation();
 
+    // The fused operators are only available as CPU kernels, and the
+    // distributed workers do not know them either.
+    if(!cfg.use_cuda && !cfg.use_fpgaopencl && !cfg.use_distributed)
+        fuseOperators(module);
+
     ConversionTarget target(getContext());
     target.addLegalOp<ModuleOp>();
     target.addLegalDialect<arith::ArithDialect>();
@@ -84,22 +424,14 @@ void PhyOperatorSelectionPass::runOnOperation() {
     target.addLegalDialect<func::FuncDialect>();
     target.addLegalDialect<scf::SCFDialect>();
     target.addDynamicallyLegalOp<daphne::MatMulOp>([](daphne::MatMulOp op) {
-        // Note: The canonicalization of MatMulOp factors in transposed inputs:
-        // - `t(X) @_ta_tb Y` to `X @_!ta_tb Y`
-        // - `X @_ta_tb t(Y)` to `X @_ta_!tb Y`
-        // I.e., the arguments transa and transb of MatMulOp represent if
-        // the inputs shall be transposed.
-        // However, we currently don't do this for the left-hand-side argument
-        // (see MatMulOp::canonicalize()), once we do it there again, we need
-        // to account for it here (and above in MatMulOpLowering).
-        auto to = op.getLhs().getDefiningOp<daphne::TransposeOp>();
+        Value lhsArg = getTransposedLhs(op);
         bool rhsTransposed = CompilerUtils::constantOrThrow<bool>(
                 op.getTransb(), "MatMulOp.getTransb() is expected to be a constant"
         );
         auto rhsMatTy = op.getRhs().getType().dyn_cast<daphne::MatrixType>();
-        return !(to && (
+        return !(lhsArg && (
             // `t(M) @ M` -> `syrk(M)`
-            (to.getArg() == op.getRhs() && !rhsTransposed) ||
+            (lhsArg == op.getRhs() && !rhsTransposed) ||
             // `t(M) @ v` -> `gemv(M, v)`
             (!rhsTransposed && rhsMatTy.getNumCols() == 1) ||
             (rhsTransposed && rhsMatTy.getNumRows() == 1)
@@ -113,6 +445,6 @@ void PhyOperatorSelectionPass::runOnOperation() {
         signalPassFailure();
 }
 
-std::unique_ptr<Pass> daphne::createPhyOperatorSelectionPass() {
-    return std::make_unique<PhyOperatorSelectionPass>();
+std::unique_ptr<Pass> daphne::createPhyOperatorSelectionPass(const DaphneUserConfig& cfg) {
+    return std::make_unique<PhyOperatorSelectionPass>(cfg);
 }
\ No newline at end of file
@@ -679,6 +679,77 @@ namespace
         }
     };
 
+    class RecompileCallKernelReplacement : public OpConversionPattern<daphne::RecompileCallOp> {
+        Value dctx;
+        const DaphneUserConfig & userConfig;
+        std::unordered_map<std::string, bool> & usedLibPaths;
+
+    public:
+        using OpConversionPattern::OpConversionPattern;
+        RecompileCallKernelReplacement(
+            MLIRContext * mctx,
+            Value dctx,
+            const DaphneUserConfig & userConfig,
+            std::unordered_map<std::string, bool> & usedLibPaths,
+            PatternBenefit benefit = 2
+        )
+        : OpConversionPattern(mctx, benefit),
+        dctx(dctx), userConfig(userConfig), usedLibPaths(usedLibPaths)
+        {
+        }
+
+        LogicalResult matchAndRewrite(daphne::RecompileCallOp op, OpAdaptor adaptor,
+                                      ConversionPatternRewriter &rewriter) const override
+        {
+            const std::string opMnemonic = op->getName().stripDialect().data();
+            std::vector<KernelInfo> kernelInfos = userConfig.kernelCatalog.getKernelInfos(opMnemonic);
+            if(kernelInfos.empty())
+                throw ErrorHandler::compilerError(
+                    op.getLoc(),
+                    "RewriteToCallKernelOpPass",
+                    "no kernels registered for operation `" + opMnemonic + "`"
+                );
+            // There is a single kernel for all argument and result types, since
+            // they are passed as generic structures.
+            const KernelInfo & ki = kernelInfos.front();
+            usedLibPaths.at(ki.libPath) = true;
+
+            size_t numInputs = op.getInputs().size();
+
+            MLIRContext* mctx = rewriter.getContext();
+            Location loc = op.getLoc();
+            Type vptObj = daphne::VariadicPackType::get(mctx, daphne::StructureType::get(mctx));
+
+            // Variadic pack for inputs.
+            auto cvpInputs = rewriter.create<daphne::CreateVariadicPackOp>(loc, vptObj, rewriter.getI64IntegerAttr(numInputs));
+            for(size_t i = 0; i < numInputs; i++)
+                rewriter.create<daphne::StoreVariadicPackOp>(
+                        loc, cvpInputs, op.getInputs()[i], rewriter.getI64IntegerAttr(i)
+                );
+            auto coNumInputs = rewriter.create<daphne::ConstantOp>(loc, numInputs);
+
+            auto kId = rewriter.create<mlir::arith::ConstantOp>(
+                loc, rewriter.getI32IntegerAttr(
+                         KernelDispatchMapping::instance().registerKernel(
+                             ki.kernelFuncName, op)));
+
+            // Create CallKernelOp.
+            std::vector<Value> newOperands = {
+                cvpInputs, coNumInputs, op.getIr(), kId, dctx
+            };
+            auto cko = rewriter.replaceOpWithNewOp<daphne::CallKernelOp>(
+                    op.getOperation(),
+                    ki.kernelFuncName,
+                    newOperands,
+                    op.getOutputs().getTypes()
+            );
+            // TODO Use ATTR_HASVARIADICRESULTS from LowerToLLVMPass.cpp.
+            cko->setAttr("hasVariadicResults", rewriter.getBoolAttr(true));
+
+            return success();
+        }
+    };
+
     struct RewriteToCallKernelOpPass
     : public PassWrapper<RewriteToCallKernelOpPass, OperationPass<func::FuncOp>>
     {
@@ -735,7 +806,8 @@ void RewriteToCallKernelOpPass::runOnOperation()
     // Apply conversion to CallKernelOps.
     patterns.insert<
             KernelReplacement,
-            DistributedPipelineKernelReplacement
+            DistributedPipelineKernelReplacement,
+            RecompileCallKernelReplacement
     >(&getContext(), dctx, userConfig, usedLibPaths);
     if (failed(applyPartialConversion(func, target, std::move(patterns))))
         signalPassFailure();
@@ -0,0 +1,99 @@
+/*
+ *  Copyright 2021 The DAPHNE Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "ir/daphneir/Daphne.h"
+#include "ir/daphneir/Passes.h"
+
+#include <memory>
+#include <vector>
+
+using namespace mlir;
+
+/**
+ * @brief Makes vectorized pipelines stream their input directly from a file.
+ *
+ * A pipeline qualifies if all of its outputs are combined by `ADD` (i.e.,
+ * they have a fixed size independent of the number of input rows, like the
+ * result of `colSums` or `t(X) @ X`) and one of its `ROWS`-split inputs is the
+ * dense matrix result of a `ReadOp`, which is not used anywhere else. In that
+ * case, the `ReadOp` is removed and the file name becomes the pipeline's
+ * input instead. The lowering then calls the `streamingPipeline` kernel,
+ * which reads the file in chunks of rows and runs the pipeline on each chunk,
+ * such that the whole matrix is never materialized.
+ *
+ * Must run after the `VectorizeComputationsPass` and canonicalization, such
+ * that unused intermediate outputs have already been removed.
+ */
+namespace
+{
+    bool isStreamable(daphne::VectorizedPipelineOp pipelineOp) {
+        for(auto combine : pipelineOp.getCombines())
+            if(combine.cast<daphne::VectorCombineAttr>().getValue() != daphne::VectorCombine::ADD)
+                return false;
+        // The streaming kernel is only available for dense results.
+        for(auto resTy : pipelineOp->getResultTypes()) {
+            auto mt = resTy.dyn_cast<daphne::MatrixType>();
+            if(!mt || mt.getRepresentation() != daphne::MatrixRepresentation::Dense)
+                return false;
+        }
+        return pipelineOp->getNumResults() > 0 && pipelineOp.getCuda().getBlocks().empty();
+    }
+
+    struct StreamPipelinesPass : public PassWrapper<StreamPipelinesPass, OperationPass<func::FuncOp>> {
+        void runOnOperation() final;
+    };
+}
+
+void StreamPipelinesPass::runOnOperation()
+{
+    auto func = getOperation();
+
+    std::vector<daphne::VectorizedPipelineOp> pipelines;
+    func->walk([&](daphne::VectorizedPipelineOp op) {
+        pipelines.push_back(op);
+    });
+
+    for(auto pipelineOp : pipelines) {
+        if(!isStreamable(pipelineOp))
+            continue;
+        // The kernel treats all inputs as having the value type of the results.
+        auto resElemTy = pipelineOp->getResultTypes()[0].cast<daphne::MatrixType>().getElementType();
+        auto splits = pipelineOp.getSplits();
+        for(size_t i = 0; i < pipelineOp.getInputs().size(); i++) {
+            if(splits[i].cast<daphne::VectorSplitAttr>().getValue() != daphne::VectorSplit::ROWS)
+                continue;
+            Value input = pipelineOp.getInputs()[i];
+            auto readOp = input.getDefiningOp<daphne::ReadOp>();
+            if(!readOp || readOp->getBlock() != pipelineOp->getBlock() || !input.hasOneUse())
+                continue;
+            auto mt = input.getType().dyn_cast<daphne::MatrixType>();
+            if(!mt || mt.getRepresentation() != daphne::MatrixRepresentation::Dense ||
+                    mt.getElementType() != resElemTy)
+                continue;
+
+            // The pipeline body still sees a matrix; only the operand changes.
+            pipelineOp->setOperand(i, readOp.getFileName());
+            readOp->erase();
+            // At most one input per pipeline is streamed; other row-split
+            // inputs are sliced along with it.
+            break;
+        }
+    }
+}
+
+std::unique_ptr<Pass> daphne::createStreamPipelinesPass() {
+    return std::make_unique<StreamPipelinesPass>();
+}
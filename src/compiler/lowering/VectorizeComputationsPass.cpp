@@ -21,9 +21,14 @@
 #include "ir/daphneir/Passes.h"
 
 #include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Transforms/DialectConversion.h"
 
+#include "llvm/ADT/SmallPtrSet.h"
+
+#include <algorithm>
 #include <memory>
+#include <numeric>
 #include <set>
 #include <iostream>
 
@@ -173,7 +178,204 @@ namespace
         }
     }
 
+    /**
+     * @brief Checks if the estimated size of the operands and results of the
+     * given operation exceeds the given memory budget.
+     *
+     * Operations with operands or results of unknown size are assumed not to
+     * exceed the budget.
+     */
+    bool exceedsMemoryBudget(Operation *op, size_t memoryBudget) {
+        ssize_t bytes = 0;
+        auto add = [&bytes](Type t) {
+            const ssize_t b = CompilerUtils::estimateSizeInBytes(t);
+            if(b < 0)
+                return false;
+            bytes += b;
+            return true;
+        };
+        return llvm::all_of(op->getOperandTypes(), add) && llvm::all_of(op->getResultTypes(), add) &&
+               static_cast<size_t>(bytes) > memoryBudget;
+    }
+
+    /**
+     * @brief The maximum number of operations in a pipeline created by fusing sibling pipelines.
+     *
+     * Every operation in a pipeline keeps its intermediate result for the current row block alive during a task,
+     * such that fusing too many operations increases the pressure on registers and caches.
+     */
+    constexpr size_t MAX_SIBLING_FUSION_OPS = 32;
+
+    /**
+     * @brief Returns the distinct inputs of the pipeline, i.e., the operands not produced inside the pipeline,
+     * together with their splits.
+     */
+    std::vector<std::pair<Value, daphne::VectorSplit>> getPipelineInputs(const std::vector<daphne::Vectorizable> &pipeline) {
+        std::vector<std::pair<Value, daphne::VectorSplit>> inputs;
+        for(auto v : pipeline) {
+            auto vSplits = v.getVectorSplits();
+            for(auto i = 0u; i < v->getNumOperands(); ++i) {
+                Value operand = v->getOperand(i);
+                if(llvm::any_of(pipeline, [&](daphne::Vectorizable lv) { return lv == operand.getDefiningOp(); }))
+                    continue;
+                std::pair<Value, daphne::VectorSplit> input{operand, vSplits[i]};
+                if(!llvm::is_contained(inputs, input))
+                    inputs.push_back(input);
+            }
+        }
+        return inputs;
+    }
+
+    /**
+     * @brief Estimates the number of bytes, which need not be read again if the two pipelines are fused, i.e., the
+     * size of the inputs both pipelines split in the same way.
+     *
+     * Shared inputs of unknown size count as one byte, such that sharing them is still preferred over sharing nothing.
+     */
+    size_t sharedInputBytes(const std::vector<daphne::Vectorizable> &pipeline1,
+                            const std::vector<daphne::Vectorizable> &pipeline2) {
+        size_t bytes = 0;
+        auto inputs2 = getPipelineInputs(pipeline2);
+        for(auto input : getPipelineInputs(pipeline1)) {
+            if(input.second == daphne::VectorSplit::NONE || !llvm::is_contained(inputs2, input))
+                continue;
+            const ssize_t b = CompilerUtils::estimateSizeInBytes(input.first.getType());
+            bytes += b > 0 ? b : 1;
+        }
+        return bytes;
+    }
+
+    /**
+     * @brief Estimates the number of bytes the pipeline needs at once, i.e., the size of its results, which are
+     * allocated as a whole, and of its inputs, which are not split. Values of unknown size are ignored.
+     */
+    size_t estimatePipelineBytes(const std::vector<daphne::Vectorizable> &pipeline) {
+        size_t bytes = 0;
+        auto add = [&bytes](Type t) {
+            const ssize_t b = CompilerUtils::estimateSizeInBytes(t);
+            if(b > 0)
+                bytes += b;
+        };
+        for(auto input : getPipelineInputs(pipeline))
+            if(input.second == daphne::VectorSplit::NONE)
+                add(input.first.getType());
+        for(auto v : pipeline)
+            for(auto t : v->getResultTypes())
+                add(t);
+        return bytes;
+    }
+
+    /**
+     * @brief Checks if any operation of the consumer pipeline transitively depends on a result of the producer
+     * pipeline.
+     */
+    bool pipelineDependsOn(const std::vector<daphne::Vectorizable> &consumer,
+                           const std::vector<daphne::Vectorizable> &producer) {
+        for(auto c : consumer)
+            for(auto operand : c->getOperands())
+                for(auto p : producer)
+                    if(valueDependsOnResultOf(operand, p))
+                        return true;
+        return false;
+    }
+
+    /**
+     * @brief Checks if all operations between the first and the last operation of the pipeline (ordered from the last
+     * to the first in the IR), which are not part of it, can safely be moved before or after it.
+     *
+     * That is the case if they have no side effects, no nested regions (whose uses of pipeline results we would not
+     * see), and are not part of another pipeline (whose order we would break).
+     */
+    bool canMoveInterleavedOperations(const std::vector<daphne::Vectorizable> &pipeline,
+                                      const llvm::SmallPtrSetImpl<Operation *> &pipelineOps) {
+        auto endPos = pipeline.front()->getIterator();
+        for(auto it = pipeline.back()->getIterator(); it != endPos; ++it) {
+            Operation *op = &(*it);
+            if(llvm::any_of(pipeline, [&](daphne::Vectorizable lv) { return lv == op; }))
+                continue;
+            if(pipelineOps.count(op) || op->getNumRegions())
+                return false;
+            auto memInterface = dyn_cast<MemoryEffectOpInterface>(op);
+            if(!memInterface || !memInterface.hasNoEffect())
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Fuses pipelines without a producer-consumer relationship, which split the same inputs, such that each of
+     * these inputs is read only once.
+     *
+     * Candidate pairs of pipelines are fused in the order of the estimated number of bytes that need not be read
+     * again, as long as the fused pipeline does not exceed `MAX_SIBLING_FUSION_OPS` operations and, if given, the
+     * memory budget. Pipelines fused into another one are left empty.
+     *
+     * @param pipelines The pipelines created by the greedy producer-consumer fusion
+     * @param memoryBudget If non-zero, the maximum estimated number of bytes a fused pipeline may need at once
+     */
+    void fuseSiblingPipelines(std::vector<std::vector<daphne::Vectorizable>> &pipelines, size_t memoryBudget) {
+        struct Candidate {
+            size_t bytes;
+            size_t ix1;
+            size_t ix2;
+        };
+        llvm::SmallPtrSet<Operation *, 32> pipelineOps;
+        std::vector<Candidate> candidates;
+        for(size_t ix1 = 0; ix1 < pipelines.size(); ++ix1) {
+            for(auto v : pipelines[ix1])
+                pipelineOps.insert(v.getOperation());
+            for(size_t ix2 = ix1 + 1; ix2 < pipelines.size(); ++ix2) {
+                if(pipelines[ix1].empty() || pipelines[ix2].empty() ||
+                   pipelines[ix1].front()->getBlock() != pipelines[ix2].front()->getBlock())
+                    continue;
+                if(size_t bytes = sharedInputBytes(pipelines[ix1], pipelines[ix2]))
+                    candidates.push_back({bytes, ix1, ix2});
+            }
+        }
+        std::stable_sort(candidates.begin(), candidates.end(),
+                         [](const Candidate &a, const Candidate &b) { return a.bytes > b.bytes; });
+
+        // A pipeline fused into another one is forwarded to it.
+        std::vector<size_t> fusedInto(pipelines.size());
+        std::iota(fusedInto.begin(), fusedInto.end(), 0);
+        auto find = [&fusedInto](size_t ix) {
+            while(fusedInto[ix] != ix)
+                ix = fusedInto[ix];
+            return ix;
+        };
+        for(auto c : candidates) {
+            const size_t ix1 = find(c.ix1);
+            const size_t ix2 = find(c.ix2);
+            if(ix1 == ix2)
+                continue;
+            auto &pipeline1 = pipelines[ix1];
+            auto &pipeline2 = pipelines[ix2];
+            if(pipeline1.size() + pipeline2.size() > MAX_SIBLING_FUSION_OPS ||
+               pipelineDependsOn(pipeline1, pipeline2) || pipelineDependsOn(pipeline2, pipeline1))
+                continue;
+            std::vector<daphne::Vectorizable> fused(pipeline1);
+            fused.insert(fused.end(), pipeline2.begin(), pipeline2.end());
+            // first op in pipeline is last in IR
+            std::sort(fused.begin(), fused.end(),
+                      [](daphne::Vectorizable a, daphne::Vectorizable b) { return b->isBeforeInBlock(a); });
+            if(!canMoveInterleavedOperations(fused, pipelineOps) ||
+               (memoryBudget && estimatePipelineBytes(fused) > memoryBudget))
+                continue;
+            pipeline1 = std::move(fused);
+            pipeline2.clear();
+            fusedInto[ix2] = ix1;
+        }
+    }
+
     struct VectorizeComputationsPass : public PassWrapper<VectorizeComputationsPass, OperationPass<func::FuncOp>> {
+        /**
+         * @brief If non-zero, only operations estimated to exceed this number
+         * of bytes are vectorized, such that they are processed block-wise.
+         */
+        size_t memoryBudget;
+
+        explicit VectorizeComputationsPass(size_t memoryBudget) : memoryBudget(memoryBudget) {}
+
         void runOnOperation() final;
     };
 }
@@ -181,13 +383,26 @@ namespace
 void VectorizeComputationsPass::runOnOperation()
 {
     auto func = getOperation();
-    // TODO: fuse pipelines that have the matching inputs, even if no output of the one pipeline is used by the other.
-    //  This requires multi-returns in way more cases, which is not implemented yet.
 
     // Find vectorizable operations and their inputs of vectorizable operations
     std::vector<daphne::Vectorizable> vectOps;
     func->walk([&](daphne::Vectorizable op)
     {
+      // A MatMulOp with a transposed lhs input is split into column blocks of
+      // its lhs input, which requires knowing that it is transposed and
+      // slicing the columns of a dense matrix.
+      if(auto mmOp = llvm::dyn_cast<daphne::MatMulOp>(op.getOperation())) {
+          auto transa = CompilerUtils::isConstant<bool>(mmOp.getTransa());
+          if(!transa.first)
+              return;
+          auto lhsTy = mmOp.getLhs().getType().dyn_cast<daphne::MatrixType>();
+          if(transa.second && (!lhsTy || lhsTy.getRepresentation() != daphne::MatrixRepresentation::Dense))
+              return;
+      }
+      // With a memory budget, only the operations that would not fit into it
+      // as a whole are executed in pipelines.
+      if(memoryBudget && !exceedsMemoryBudget(op.getOperation(), memoryBudget))
+          return;
       if(CompilerUtils::isMatrixComputation(op))
           vectOps.emplace_back(op);
     });
@@ -232,6 +447,10 @@ void VectorizeComputationsPass::runOnOperation()
                         if(combine == daphne::VectorCombine::ROWS)
                             possibleMerges.insert({v, defOp});
                     }
+                    else if(split == daphne::VectorSplit::COLS) {
+                        if(combine == daphne::VectorCombine::COLS)
+                            possibleMerges.insert({v, defOp});
+                    }
                     else if (split == daphne::VectorSplit::NONE) {
                         // can't be merged
                     }
@@ -271,6 +490,9 @@ void VectorizeComputationsPass::runOnOperation()
             greedyPipelineFusion(operationToPipelineIx, pipelines, pipelineIx, operandVectorizable);
         }
     }
+    // Additionally fuse the pipelines that read the same inputs, even if no output of the one pipeline is used by
+    // the other.
+    fuseSiblingPipelines(pipelines, memoryBudget);
 
     OpBuilder builder(func);
     // Create the `VectorizedPipelineOp`s
@@ -344,6 +566,12 @@ void VectorizeComputationsPass::runOnOperation()
                     argTy = matTy.withShape(-1, matTy.getNumCols());
                     break;
                 }
+                case daphne::VectorSplit::COLS: {
+                    auto matTy = argTy.cast<daphne::MatrixType>();
+                    // only remove column information
+                    argTy = matTy.withShape(matTy.getNumRows(), -1);
+                    break;
+                }
                 case daphne::VectorSplit::NONE:
                     // keep any size information
                     break;
@@ -404,6 +632,6 @@ void VectorizeComputationsPass::runOnOperation()
     }
 }
 
-std::unique_ptr<Pass> daphne::createVectorizeComputationsPass() {
-    return std::make_unique<VectorizeComputationsPass>();
+std::unique_ptr<Pass> daphne::createVectorizeComputationsPass(size_t memoryBudget) {
+    return std::make_unique<VectorizeComputationsPass>(memoryBudget);
 }
@@ -23,9 +23,13 @@
 #include <mlir/Dialect/Arith/IR/Arith.h>
 #include <mlir/IR/Value.h>
 
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 #include <string>
 
+#include <sys/types.h>
+
 struct CompilerUtils {
 
 private:
@@ -280,6 +284,34 @@ public:
             return vt;
     }
 
+    /**
+     * @brief Estimates the number of bytes a data object of the given type
+     * occupies in memory, based on its inferred shape, sparsity, and
+     * representation.
+     *
+     * @param t The type
+     * @result The estimated number of bytes; `0` for types other than
+     * matrices, `-1` if the shape or value type of a matrix is unknown
+     */
+    static ssize_t estimateSizeInBytes(mlir::Type t) {
+        auto mt = t.dyn_cast<mlir::daphne::MatrixType>();
+        if(!mt)
+            return 0;
+        const ssize_t numRows = mt.getNumRows();
+        const ssize_t numCols = mt.getNumCols();
+        mlir::Type vt = mt.getElementType();
+        if(numRows < 0 || numCols < 0 || !vt.isIntOrFloat())
+            return -1;
+        const ssize_t vtBytes = std::max(1u, vt.getIntOrFloatBitWidth() / 8);
+        if(mt.getRepresentation() == mlir::daphne::MatrixRepresentation::Sparse) {
+            // Without a known sparsity, we assume the worst case.
+            const double sparsity = mt.getSparsity() < 0 ? 1.0 : mt.getSparsity();
+            const auto numNonZeros = static_cast<ssize_t>(std::ceil(sparsity * numRows * numCols));
+            return numNonZeros * (vtBytes + sizeof(size_t)) + (numRows + 1) * sizeof(size_t);
+        }
+        return numRows * numCols * vtBytes;
+    }
+
     /**
      * @brief Checks if the two given types are the same, whereby
      * DaphneIR's unknown type acts as a wildcard.
@@ -1070,22 +1070,19 @@ mlir::LogicalResult mlir::daphne::MatMulOp::canonicalize(
     bool ta = CompilerUtils::constantOrDefault<bool>(transa, false);
     bool tb = CompilerUtils::constantOrDefault<bool>(transb, false);
 
-    // TODO Turn on the transposition-awareness for the left-hand-side argument again (see #447).
-    // mlir::daphne::TransposeOp lhsTransposeOp = lhs.getDefiningOp<mlir::daphne::TransposeOp>();
+    mlir::daphne::TransposeOp lhsTransposeOp = lhs.getDefiningOp<mlir::daphne::TransposeOp>();
     mlir::daphne::TransposeOp rhsTransposeOp = rhs.getDefiningOp<mlir::daphne::TransposeOp>();
 
-    //if (!lhsTransposeOp && !rhsTransposeOp){
-    if (!rhsTransposeOp){
+    if (!lhsTransposeOp && !rhsTransposeOp){
         return mlir::failure();
     }
 
-#if 0
-    // TODO Adapt PhyOperatorSelectionPass once this code is turned on again.
+    // Note: The PhyOperatorSelectionPass and the VectorizeComputationsPass
+    // take a transposed left-hand-side argument (transa) into account.
     if(lhsTransposeOp) {
         lhs = lhsTransposeOp.getArg();
         ta = !ta;
     }
-#endif
     if(rhsTransposeOp) {
         rhs = rhsTransposeOp.getArg();
         tb = !tb;
@@ -21,6 +21,7 @@
 
 #include <mlir/IR/Value.h>
 
+#include <bitset>
 #include <vector>
 #include <stdexcept>
 #include <utility>
@@ -405,6 +406,21 @@ std::vector<std::pair<ssize_t, ssize_t>> daphne::MatrixConstantOp::inferShape()
     return {{mat->getNumRows(), mat->getNumCols()}};
 }
 
+namespace {
+    ssize_t inferNumAggs(Value aggs) {
+        auto p = CompilerUtils::isConstant<int64_t>(aggs);
+        return p.first ? static_cast<ssize_t>(std::bitset<64>(p.second).count()) : -1;
+    }
+}
+
+std::vector<std::pair<ssize_t, ssize_t>> daphne::MultiAggRowOp::inferShape() {
+    return {{getShape(getArg()).first, inferNumAggs(getAggs())}};
+}
+
+std::vector<std::pair<ssize_t, ssize_t>> daphne::MultiAggColOp::inferShape() {
+    return {{inferNumAggs(getAggs()), getShape(getArg()).second}};
+}
+
 std::vector<std::pair<ssize_t, ssize_t>> daphne::SliceRowOp::inferShape() {
     Type srcTy = getSource().getType();
     ssize_t srcNumRows;
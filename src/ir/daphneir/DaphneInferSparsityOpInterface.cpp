@@ -20,7 +20,14 @@
 #include <mlir/IR/Value.h>
 
 #include <parser/metadata/MetaDataParser.h>
+#include <runtime/local/datastructures/MncSketch.h>
+#include <runtime/local/io/MncSketchFile.h>
 
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 #include <stdexcept>
 #include <utility>
@@ -45,6 +52,143 @@ double getSparsityOrUnknownFromType(Value v) {
         return -1.0;
 }
 
+static ssize_t getNumRowsOrUnknownFromType(Value v) {
+    if(auto mt = v.getType().dyn_cast<daphne::MatrixType>())
+        return mt.getNumRows();
+    return -1;
+}
+
+static ssize_t getNumColsOrUnknownFromType(Value v) {
+    if(auto mt = v.getType().dyn_cast<daphne::MatrixType>())
+        return mt.getNumCols();
+    return -1;
+}
+
+/**
+ * @brief Returns the MNC sketch stored next to the given file (see
+ * `writeMncSketch`), or null if there is none or it does not match the shape
+ * in the file's meta data.
+ *
+ * The sketches are cached, since the sparsity inference of each operation on
+ * the file's data asks for it again.
+ */
+static std::shared_ptr<const MncSketch> getMncSketchFromMetaData(const std::string & filename) {
+    static std::mutex mtx;
+    static std::map<std::string, std::pair<std::filesystem::file_time_type, std::shared_ptr<const MncSketch>>> cache;
+
+    std::error_code ec;
+    const auto mtime = std::filesystem::last_write_time(getMncSketchFilename(filename), ec);
+    if(ec)
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = cache.find(filename);
+    if(it != cache.end() && it->second.first == mtime)
+        return it->second.second;
+    std::shared_ptr<const MncSketch> sketch;
+    try {
+        FileMetaData fmd = MetaDataParser::readMetaData(filename);
+        std::shared_ptr<const MncSketch> fileSketch = readMncSketch(filename);
+        // A sketch of another shape is left over from a previous version of
+        // the file.
+        if(fmd.isSingleValueType && fileSketch && fileSketch->numRows == fmd.numRows && fileSketch->numCols == fmd.numCols)
+            sketch = fileSketch;
+    }
+    catch(std::exception &) {
+        // Treat invalid meta data or sketches like missing sketches, the read
+        // itself reports errors in the meta data.
+    }
+    cache[filename] = {mtime, sketch};
+    return sketch;
+}
+
+static std::shared_ptr<const MncSketch> deriveMncSketch(Value v, size_t depth, daphne::MncSketchCache & cache);
+
+/**
+ * @brief Returns the sketch of the given value from the cache, or derives and
+ * caches it.
+ *
+ * Without memoization, values used several times in the DAG of operations
+ * (e.g., `X` in `t(X) @ X`) would make the derivation exponential in the
+ * depth.
+ */
+static std::shared_ptr<const MncSketch> tryGetMncSketchRec(Value v, size_t depth, daphne::MncSketchCache & cache) {
+    if(!v.getType().isa<daphne::MatrixType>())
+        return nullptr;
+    auto it = cache.find(v);
+    if(it != cache.end())
+        return it->second;
+    // Bound the effort for long chains of operations.
+    if(depth == 0)
+        return nullptr;
+    auto sketch = deriveMncSketch(v, depth - 1, cache);
+    cache[v] = sketch;
+    return sketch;
+}
+
+static std::shared_ptr<const MncSketch> deriveMncSketch(Value v, size_t depth, daphne::MncSketchCache & cache) {
+    Operation * op = v.getDefiningOp();
+    if(!op)
+        return nullptr;
+
+    auto pair = [&](Value lhs, Value rhs) {
+        return std::make_pair(tryGetMncSketchRec(lhs, depth, cache), tryGetMncSketchRec(rhs, depth, cache));
+    };
+    auto sameShape = [](const MncSketch & a, const MncSketch & b) {
+        return a.numRows == b.numRows && a.numCols == b.numCols;
+    };
+
+    if(auto readOp = llvm::dyn_cast<daphne::ReadOp>(op)) {
+        auto p = CompilerUtils::isConstant<std::string>(readOp.getFileName());
+        return p.first ? getMncSketchFromMetaData(p.second) : nullptr;
+    }
+    if(auto castOp = llvm::dyn_cast<daphne::CastOp>(op))
+        return tryGetMncSketchRec(castOp.getArg(), depth + 1, cache);
+    if(auto transposeOp = llvm::dyn_cast<daphne::TransposeOp>(op)) {
+        if(auto sketch = tryGetMncSketchRec(transposeOp.getArg(), depth, cache))
+            return std::make_shared<const MncSketch>(sketch->transposed());
+        return nullptr;
+    }
+    if(auto matMulOp = llvm::dyn_cast<daphne::MatMulOp>(op)) {
+        auto ta = CompilerUtils::isConstant<bool>(matMulOp.getTransa());
+        auto tb = CompilerUtils::isConstant<bool>(matMulOp.getTransb());
+        auto [lhs, rhs] = pair(matMulOp.getLhs(), matMulOp.getRhs());
+        if(!ta.first || !tb.first || !lhs || !rhs)
+            return nullptr;
+        MncSketch l = ta.second ? lhs->transposed() : *lhs;
+        MncSketch r = tb.second ? rhs->transposed() : *rhs;
+        if(l.numCols != r.numRows)
+            return nullptr;
+        return std::make_shared<const MncSketch>(propagateMncMatMul(l, r));
+    }
+    if(llvm::isa<daphne::EwMulOp, daphne::EwAddOp, daphne::EwSubOp>(op)) {
+        auto [lhs, rhs] = pair(op->getOperand(0), op->getOperand(1));
+        if(!lhs || !rhs || !sameShape(*lhs, *rhs))
+            return nullptr;
+        return std::make_shared<const MncSketch>(propagateMncEw(*lhs, *rhs, llvm::isa<daphne::EwMulOp>(op)));
+    }
+    if(llvm::isa<daphne::RowBindOp, daphne::ColBindOp>(op)) {
+        const bool isRowBind = llvm::isa<daphne::RowBindOp>(op);
+        auto [lhs, rhs] = pair(op->getOperand(0), op->getOperand(1));
+        if(!lhs || !rhs || (isRowBind ? lhs->numCols != rhs->numCols : lhs->numRows != rhs->numRows))
+            return nullptr;
+        return std::make_shared<const MncSketch>(propagateMncBind(*lhs, *rhs, isRowBind));
+    }
+    if(llvm::isa<daphne::RowAggSumOp, daphne::ColAggSumOp>(op)) {
+        if(auto sketch = tryGetMncSketchRec(op->getOperand(0), depth, cache))
+            return std::make_shared<const MncSketch>(propagateMncAgg(*sketch, llvm::isa<daphne::RowAggSumOp>(op)));
+        return nullptr;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<const MncSketch> daphne::tryGetMncSketch(Value v, MncSketchCache * cache) {
+    if(cache)
+        return tryGetMncSketchRec(v, 16, *cache);
+    MncSketchCache localCache;
+    return tryGetMncSketchRec(v, 16, localCache);
+}
+
 // ****************************************************************************
 // Sparsity inference interface implementations
 // ****************************************************************************
@@ -64,18 +208,72 @@ std::vector<double> daphne::DiagMatrixOp::inferSparsity() {
 std::vector<double> daphne::MatMulOp::inferSparsity() {
     auto lhsTy = getLhs().getType().dyn_cast<daphne::MatrixType>();
     auto rhsTy = getRhs().getType().dyn_cast<daphne::MatrixType>();
-    if(lhsTy.getSparsity() == -1.0 || rhsTy.getSparsity() == -1.0) {
+    if(!lhsTy || !rhsTy)
         return {-1.0};
-    }
-    auto k = lhsTy.getNumCols();
+    // The common dimension depends on whether the inputs are transposed.
+    bool ta = CompilerUtils::constantOrDefault<bool>(getTransa(), false);
+    bool tb = CompilerUtils::constantOrDefault<bool>(getTransb(), false);
+    auto k = ta ? lhsTy.getNumRows() : lhsTy.getNumCols();
     if(k == -1) {
-        k = rhsTy.getNumRows();
+        k = tb ? rhsTy.getNumCols() : rhsTy.getNumRows();
     }
-    if(k == -1)
+    return {estimateSparsityMatMul(lhsTy.getSparsity(), rhsTy.getSparsity(), k)};
+}
+
+std::vector<double> daphne::FillOp::inferSparsity() {
+    auto pf = CompilerUtils::isConstant<double>(getArg());
+    if(pf.first)
+        return {pf.second == 0.0 ? 0.0 : 1.0};
+    auto pi = CompilerUtils::isConstant<int64_t>(getArg());
+    if(pi.first)
+        return {pi.second == 0 ? 0.0 : 1.0};
+    return {-1.0};
+}
+
+std::vector<double> daphne::EwDivOp::inferSparsity() {
+    // Only a non-zero scalar divisor retains the zeros and non-zeros of the
+    // dividend, while zeros in the divisor yield infinity or NaN.
+    if(getRhs().getType().isa<daphne::MatrixType>())
         return {-1.0};
-    else
-        // unbiased estimate
-        return {1.0 - std::pow(1.0 - lhsTy.getSparsity() * rhsTy.getSparsity(), k)};
+    auto pf = CompilerUtils::isConstant<double>(getRhs());
+    if(pf.first)
+        return {pf.second != 0.0 ? getSparsityOrUnknownFromType(getLhs()) : -1.0};
+    auto pi = CompilerUtils::isConstant<int64_t>(getRhs());
+    if(pi.first)
+        return {pi.second != 0 ? getSparsityOrUnknownFromType(getLhs()) : -1.0};
+    return {-1.0};
+}
+
+std::vector<double> daphne::RowAggSumOp::inferSparsity() {
+    return {estimateSparsityAgg(getSparsityOrUnknownFromType(getArg()), getNumColsOrUnknownFromType(getArg()))};
+}
+
+std::vector<double> daphne::ColAggSumOp::inferSparsity() {
+    return {estimateSparsityAgg(getSparsityOrUnknownFromType(getArg()), getNumRowsOrUnknownFromType(getArg()))};
+}
+
+/**
+ * @brief The sparsity of the concatenation of two matrices, whose sizes along
+ * the concatenation dimension are `nLhs` and `nRhs`.
+ */
+static double getSparsityOfBind(double spLhs, double spRhs, ssize_t nLhs, ssize_t nRhs) {
+    if(spLhs == -1.0 || spRhs == -1.0 || nLhs == -1 || nRhs == -1 || nLhs + nRhs == 0)
+        return -1.0;
+    return (spLhs * nLhs + spRhs * nRhs) / (nLhs + nRhs);
+}
+
+std::vector<double> daphne::ColBindOp::inferSparsity() {
+    return {getSparsityOfBind(
+            getSparsityOrUnknownFromType(getLhs()), getSparsityOrUnknownFromType(getRhs()),
+            getNumColsOrUnknownFromType(getLhs()), getNumColsOrUnknownFromType(getRhs())
+    )};
+}
+
+std::vector<double> daphne::RowBindOp::inferSparsity() {
+    return {getSparsityOfBind(
+            getSparsityOrUnknownFromType(getLhs()), getSparsityOrUnknownFromType(getRhs()),
+            getNumRowsOrUnknownFromType(getLhs()), getNumRowsOrUnknownFromType(getRhs())
+    )};
 }
 
 std::vector<double> daphne::TriOp::inferSparsity() {
@@ -144,7 +342,13 @@ struct trySparsityFromIthArg {
 // Sparsity inference function
 // ****************************************************************************
 
-std::vector<double> daphne::tryInferSparsity(Operation *op) {
+std::vector<double> daphne::tryInferSparsity(Operation *op, MncSketchCache * sketchCache) {
+    // If the MNC sketches of the inputs are known, they yield a more accurate
+    // estimate than the sparsities alone.
+    if(op->getNumResults() == 1)
+        if(auto sketch = tryGetMncSketch(op->getResult(0), sketchCache))
+            return {sketch->getSparsity()};
+
     if(auto inferSparsityOp = llvm::dyn_cast<daphne::InferSparsity>(op))
         // If the operation implements the sparsity inference interface,
         // we apply that.
@@ -161,17 +365,14 @@ std::vector<double> daphne::tryInferSparsity(Operation *op) {
         if(op->hasTrait<EwSparseIfBoth>()) {
             auto spLhs = getSparsityOrUnknownFromType(op->getOperand(0));
             auto spRhs = getSparsityOrUnknownFromType(op->getOperand(1));
-            if(spLhs != -1.0 && spRhs != -1.0)
-                // unbiased estimate
-                sparsity = spLhs + spRhs - spLhs * spRhs;
+            sparsity = estimateSparsityEwOr(spLhs, spRhs);
         }
 
         if(op->hasTrait<EwSparseIfEither>()) {
             auto spLhs = getSparsityOrUnknownFromType(op->getOperand(0));
             auto spRhs = getSparsityOrUnknownFromType(op->getOperand(1));
             if(spLhs != -1.0 && spRhs != -1.0)
-                // unbiased estimate
-                sparsity = spLhs * spRhs;
+                sparsity = estimateSparsityEwAnd(spLhs, spRhs);
             else if (spLhs != -1.0)
                 sparsity = spLhs;
             else if (spRhs != -1.0)
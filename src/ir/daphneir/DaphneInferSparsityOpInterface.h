@@ -17,6 +17,12 @@
 #ifndef SRC_IR_DAPHNEIR_DAPHNEINFERSPARSITYOPINTERFACE_H
 #define SRC_IR_DAPHNEIR_DAPHNEINFERSPARSITYOPINTERFACE_H
 
+#include <runtime/local/datastructures/MncSketch.h>
+
+#include <llvm/ADT/DenseMap.h>
+#include <mlir/IR/Value.h>
+
+#include <memory>
 #include <vector>
 #include <utility>
 
@@ -71,6 +77,11 @@ namespace mlir::daphne {
 // ****************************************************************************
 
 namespace mlir::daphne {
+/**
+ * @brief The MNC sketches derived for values (null if none can be derived).
+ */
+using MncSketchCache = llvm::DenseMap<mlir::Value, std::shared_ptr<const MncSketch>>;
+
     // NOTE: we could replace this by instead using a default implementation of the interface method, which would check
     //  the traits
 /**
@@ -83,12 +94,31 @@ namespace mlir::daphne {
  * have any relevant traits or interfaces, -1.0 (unknown) will be returned for sparsity.
  *
  * @param op The operation whose results' sparsities shall be inferred.
+ * @param sketchCache An optional cache of the MNC sketches derived so far (see
+ * `tryGetMncSketch()`).
  * @return A vector of sparsity. The i-th element in this vector represents the
  * sparsity of the i-th result of the given
  * operation. A value of -1.0 for any sparsity indicates
  * that this number is not known (yet).
  */
-std::vector<double> tryInferSparsity(mlir::Operation* op);
+std::vector<double> tryInferSparsity(mlir::Operation* op, MncSketchCache * sketchCache = nullptr);
+
+/**
+ * @brief Tries to derive the MNC sketch of the given matrix value.
+ *
+ * Sketches originate from the meta data of files read by `ReadOp` (written
+ * along with matrices by the `write` kernel) and are propagated through
+ * matrix multiplications, element-wise additions/subtractions/multiplications,
+ * transpositions, concatenations, and row/column sums.
+ *
+ * @param v The value.
+ * @param cache An optional cache of the sketches derived so far, which allows
+ * reusing them across calls, e.g., during one run of a pass. The cache must be
+ * discarded when operations are erased. Without a cache, the sketches are
+ * only reused within this call.
+ * @return The sketch, or null if it cannot be derived.
+ */
+std::shared_ptr<const MncSketch> tryGetMncSketch(mlir::Value v, MncSketchCache * cache = nullptr);
 }
 
 #endif // SRC_IR_DAPHNEIR_DAPHNEINFERSPARSITYOPINTERFACE_H
@@ -308,6 +308,29 @@ std::vector<Type> daphne::ExtractOp::inferTypes() {
         "type inference not implemented for ExtractOp"); // TODO
 }
 
+namespace {
+    std::vector<Type> inferTypesMultiAgg(Value arg) {
+        // The aggregations are computed in the floating-point type of the
+        // argument (float for float, double otherwise).
+        MLIRContext * ctx = arg.getContext();
+        auto argMatTy = arg.getType().dyn_cast<daphne::MatrixType>();
+        if(!argMatTy)
+            return {daphne::MatrixType::get(ctx, daphne::UnknownType::get(ctx))};
+        Type vt = argMatTy.getElementType();
+        if(!vt.isF32() && !llvm::isa<daphne::UnknownType>(vt))
+            vt = FloatType::getF64(ctx);
+        return {daphne::MatrixType::get(ctx, vt)};
+    }
+}
+
+std::vector<Type> daphne::MultiAggRowOp::inferTypes() {
+    return inferTypesMultiAgg(getArg());
+}
+
+std::vector<Type> daphne::MultiAggColOp::inferTypes() {
+    return inferTypesMultiAgg(getArg());
+}
+
 std::vector<Type> daphne::OneHotOp::inferTypes() {
     Type srcType = getArg().getType();
     return {srcType.dyn_cast<daphne::MatrixType>().withSameElementType()};
@@ -358,14 +381,16 @@ std::vector<Type> daphne::ReadOp::inferTypes() {
     Builder builder(getContext());
     if (getRes().getType().dyn_cast<daphne::MatrixType>()) {
         // If an individual value type was specified per column
-        // (fmd.isSingleValueType == false), then this silently uses the
-        // type of the first column.
+        // (fmd.isSingleValueType == false), then this uses the most general
+        // value type of all columns.
         // TODO: add sparsity information here already (if present), currently not possible as many other ops
         //  just take input types as output types, which is incorrect for sparsity
         if (p.first) {
             FileMetaData fmd = CompilerUtils::getFileMetaData(getFileName());
-            mlir::Type valType = mlirTypeForCode(fmd.schema[0], builder);
-            return {mlir::daphne::MatrixType::get(getContext(), valType)};
+            std::vector<mlir::Type> valTypes;
+            for (ValueTypeCode vtc : fmd.schema)
+                valTypes.push_back(mlirTypeForCode(vtc, builder));
+            return {mlir::daphne::MatrixType::get(getContext(), mostGeneralVt(valTypes))};
         } else {
             return {mlir::daphne::MatrixType::get(getContext(), daphne::UnknownType::get(getContext()))};
         }
@@ -95,10 +95,22 @@ std::vector<std::pair<Value, Value>> createOpsOutputSizes_RowAggOp(RowAggOp *op,
     auto cst1 = builder.create<daphne::ConstantOp>(loc, sizeTy, builder.getIndexAttr(1l));
     return {{rows, cst1}};
 }
+/**
+ * @brief Column aggregations over dense matrices with more columns than rows
+ * are split by columns, such that each task computes its own part of the
+ * result, instead of a full-width partial result that must be added up.
+ */
+template<class ColAggOp>
+bool isSplitByCols_ColAggOp(ColAggOp *op)
+{
+    auto mt = op->getArg().getType().template dyn_cast<daphne::MatrixType>();
+    return mt && mt.getRepresentation() == daphne::MatrixRepresentation::Dense &&
+            mt.getNumRows() != -1 && mt.getNumCols() > mt.getNumRows();
+}
 template<class ColAggOp>
 std::vector<daphne::VectorSplit> getVectorSplits_ColAggOp(ColAggOp *op)
 {
-    return {daphne::VectorSplit::ROWS};
+    return {isSplitByCols_ColAggOp(op) ? daphne::VectorSplit::COLS : daphne::VectorSplit::ROWS};
 }
 template<class ColAggOp>
 std::vector<std::pair<Value, Value>> createOpsOutputSizes_ColAggOp(ColAggOp *op, OpBuilder &builder)
@@ -118,8 +130,11 @@ std::vector<std::pair<Value, Value>> createOpsOutputSizes_ColAggOp(ColAggOp *op,
 // Matrix multiplication
 std::vector<daphne::VectorSplit> daphne::MatMulOp::getVectorSplits()
 {
+    // If the lhs is transposed, the columns of the lhs yield the rows of the
+    // result.
+    bool ta = CompilerUtils::constantOrDefault<bool>(getTransa(), false);
     return {
-        daphne::VectorSplit::ROWS, // lhs
+        ta ? daphne::VectorSplit::COLS : daphne::VectorSplit::ROWS, // lhs
         daphne::VectorSplit::NONE, // rhs
         daphne::VectorSplit::NONE, // transa
         daphne::VectorSplit::NONE  // transb
@@ -225,7 +240,6 @@ IMPL_SPLIT_COMBINE_EWUNARYOP(EwSqrtOp)
 
 // ----------------------------------------------------------------------------
 // Aggregations
-// TODO: splitting and combining by column probably makes more sense
 #define IMPL_SPLIT_COMBINE_ROWAGG(OP) \
     std::vector<daphne::VectorSplit> daphne::OP::getVectorSplits() { \
         return getVectorSplits_RowAggOp(this); \
@@ -252,7 +266,7 @@ IMPL_SPLIT_COMBINE_ROWAGG(RowAggSumOp)
 IMPL_SPLIT_COMBINE_COLAGG(ColAggSumOp)
 std::vector<daphne::VectorCombine> daphne::ColAggSumOp::getVectorCombines()
 {
-    return {daphne::VectorCombine::ADD};
+    return {isSplitByCols_ColAggOp(this) ? daphne::VectorCombine::COLS : daphne::VectorCombine::ADD};
 }
 
 #undef IMPL_SPLIT_COMBINE_ROWAGG
@@ -359,4 +373,83 @@ std::vector<std::pair<Value, Value>> daphne::GemvOp::createOpsOutputSizes(OpBuil
     auto one = builder.create<daphne::ConstantOp>(loc, builder.getIndexType(), builder.getIndexAttr(1));
     return {{cols, one}};
 }
+
+std::vector<daphne::VectorSplit> daphne::MMChainOp::getVectorSplits()
+{
+    // t(X) @ (X @ v) is the sum of t(X_i) @ (X_i @ v) over the row blocks X_i.
+    return {daphne::VectorSplit::ROWS, daphne::VectorSplit::NONE};
+}
+std::vector<daphne::VectorCombine> daphne::MMChainOp::getVectorCombines()
+{
+    return {daphne::VectorCombine::ADD};
+}
+std::vector<std::pair<Value, Value>> daphne::MMChainOp::createOpsOutputSizes(OpBuilder &builder)
+{
+    auto loc = getLoc();
+    auto sizeTy = builder.getIndexType();
+    auto cols = builder.create<daphne::NumColsOp>(loc, sizeTy, getMat());
+    auto one = builder.create<daphne::ConstantOp>(loc, builder.getIndexType(), builder.getIndexAttr(1));
+    return {{cols, one}};
+}
+
+std::vector<daphne::VectorSplit> daphne::RowDotOp::getVectorSplits()
+{
+    return {daphne::VectorSplit::ROWS, daphne::VectorSplit::ROWS};
+}
+std::vector<daphne::VectorCombine> daphne::RowDotOp::getVectorCombines()
+{
+    return {daphne::VectorCombine::ROWS};
+}
+std::vector<std::pair<Value, Value>> daphne::RowDotOp::createOpsOutputSizes(OpBuilder &builder)
+{
+    auto loc = getLoc();
+    auto sizeTy = builder.getIndexType();
+    auto rows = builder.create<daphne::NumRowsOp>(loc, sizeTy, getLhs());
+    auto one = builder.create<daphne::ConstantOp>(loc, builder.getIndexType(), builder.getIndexAttr(1));
+    return {{rows, one}};
+}
+
+std::vector<daphne::VectorSplit> daphne::EwMulPosMaskOp::getVectorSplits()
+{
+    return {daphne::VectorSplit::ROWS, daphne::VectorSplit::ROWS};
+}
+std::vector<daphne::VectorCombine> daphne::EwMulPosMaskOp::getVectorCombines()
+{
+    return {daphne::VectorCombine::ROWS};
+}
+std::vector<std::pair<Value, Value>> daphne::EwMulPosMaskOp::createOpsOutputSizes(OpBuilder &builder)
+{
+    auto loc = getLoc();
+    auto sizeTy = builder.getIndexType();
+    auto rows = builder.create<daphne::NumRowsOp>(loc, sizeTy, getArg());
+    auto cols = builder.create<daphne::NumColsOp>(loc, sizeTy, getArg());
+    return {{rows, cols}};
+}
+
+std::vector<daphne::VectorSplit> daphne::SigmoidOp::getVectorSplits()
+{
+    return getVectorSplits_EwUnaryOp(this);
+}
+std::vector<daphne::VectorCombine> daphne::SigmoidOp::getVectorCombines()
+{
+    return getVectorCombines_EwUnaryOp(this);
+}
+std::vector<std::pair<Value, Value>> daphne::SigmoidOp::createOpsOutputSizes(OpBuilder &builder)
+{
+    return createOpsOutputSizes_EwUnaryOp(this, builder);
+}
+
+// The softmax of a row only depends on that row.
+std::vector<daphne::VectorSplit> daphne::RowSoftmaxOp::getVectorSplits()
+{
+    return getVectorSplits_EwUnaryOp(this);
+}
+std::vector<daphne::VectorCombine> daphne::RowSoftmaxOp::getVectorCombines()
+{
+    return getVectorCombines_EwUnaryOp(this);
+}
+std::vector<std::pair<Value, Value>> daphne::RowSoftmaxOp::createOpsOutputSizes(OpBuilder &builder)
+{
+    return createOpsOutputSizes_EwUnaryOp(this, builder);
+}
 // ----------------------------------------------------------------------------
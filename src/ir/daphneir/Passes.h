@@ -44,14 +44,17 @@ namespace mlir::daphne {
 
     // alphabetically sorted list of passes
     std::unique_ptr<Pass> createAdaptTypesToKernelsPass();
+    std::unique_ptr<Pass> createAdaptiveRecompilationPass();
     std::unique_ptr<Pass> createDistributeComputationsPass();
     std::unique_ptr<Pass> createDistributePipelinesPass();
     std::unique_ptr<Pass> createMapOpLoweringPass();
     std::unique_ptr<Pass> createEwOpLoweringPass();
+    std::unique_ptr<Pass> createFuseAggregationsPass();
     std::unique_ptr<Pass> createModOpLoweringPass();
     std::unique_ptr<Pass> createInferencePass(InferenceConfig cfg = {false, true, true, true, true});
     std::unique_ptr<Pass> createInsertDaphneContextPass(const DaphneUserConfig& cfg);
     std::unique_ptr<Pass> createDaphneOptPass();
+    std::unique_ptr<Pass> createMatMulChainOptimizationPass();
     std::unique_ptr<OperationPass<ModuleOp>> createMatMulOpLoweringPass(bool matmul_tile,
         int matmul_vec_size_bits = 0,
         std::vector<unsigned> matmul_fixed_tile_sizes = {},
@@ -66,13 +69,14 @@ namespace mlir::daphne {
     std::unique_ptr<Pass> createProfilingPass();
     std::unique_ptr<Pass> createLowerToLLVMPass(const DaphneUserConfig& cfg);
     std::unique_ptr<Pass> createManageObjRefsPass();
-    std::unique_ptr<Pass> createPhyOperatorSelectionPass();
+    std::unique_ptr<Pass> createPhyOperatorSelectionPass(const DaphneUserConfig& cfg);
     std::unique_ptr<Pass> createPrintIRPass(std::string message = "");
     std::unique_ptr<Pass> createRewriteSqlOpPass();
     std::unique_ptr<Pass> createRewriteToCallKernelOpPass(const DaphneUserConfig& cfg, std::unordered_map<std::string, bool> & usedLibPaths);
     std::unique_ptr<Pass> createSelectMatrixRepresentationsPass(const DaphneUserConfig& cfg);
     std::unique_ptr<Pass> createSpecializeGenericFunctionsPass(const DaphneUserConfig& cfg);
-    std::unique_ptr<Pass> createVectorizeComputationsPass();
+    std::unique_ptr<Pass> createStreamPipelinesPass();
+    std::unique_ptr<Pass> createVectorizeComputationsPass(size_t memoryBudget = 0);
     std::unique_ptr<Pass> createWhileLoopInvariantCodeMotionPass();
 #ifdef USE_CUDA
     std::unique_ptr<Pass> createMarkCUDAOpsPass(const DaphneUserConfig& cfg);
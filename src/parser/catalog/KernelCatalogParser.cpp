@@ -18,11 +18,14 @@
 #include <compiler/utils/CompilerUtils.h>
 #include <ir/daphneir/Daphne.h>
 #include <parser/catalog/KernelCatalogParser.h>
+#include <util/CpuIsa.h>
 
 #include <nlohmannjson/json.hpp>
+#include <spdlog/spdlog.h>
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
@@ -30,7 +33,9 @@
 #include <unordered_map>
 #include <vector>
 
-KernelCatalogParser::KernelCatalogParser(mlir::MLIRContext * mctx) {
+KernelCatalogParser::KernelCatalogParser(mlir::MLIRContext * mctx, const std::string & kernelIsa)
+        : isaCandidates(getKernelIsaCandidates(kernelIsa)),
+          explicitIsa(kernelIsa != "auto" && kernelIsa != "generic" && !kernelIsa.empty()) {
     // Initialize the mapping from C++ type name strings to MLIR types for parsing.
 
     mlir::OpBuilder builder(mctx);
@@ -102,6 +107,28 @@ void KernelCatalogParser::mapTypes(
     }
 }
 
+std::string KernelCatalogParser::resolveLibPath(const std::string & libPath) const {
+    auto it = resolvedLibPaths.find(libPath);
+    if(it != resolvedLibPaths.end())
+        return it->second;
+
+    std::string resolved = libPath;
+    const std::filesystem::path path(libPath);
+    for(const std::string & isa : isaCandidates) {
+        std::filesystem::path isaPath = path;
+        isaPath.replace_filename(path.stem().string() + "-" + isa + path.extension().string());
+        if(std::filesystem::exists(isaPath)) {
+            resolved = isaPath.string();
+            break;
+        }
+        if(explicitIsa)
+            spdlog::warn("kernel library `{}` for ISA level `{}` does not exist, using `{}` instead",
+                         isaPath.string(), isa, libPath);
+    }
+    resolvedLibPaths.emplace(libPath, resolved);
+    return resolved;
+}
+
 void KernelCatalogParser::parseKernelCatalog(const std::string & filePath, KernelCatalog & kc) const {
     std::filesystem::path dirPath = std::filesystem::path(filePath).parent_path();
     try {
@@ -117,12 +144,23 @@ void KernelCatalogParser::parseKernelCatalog(const std::string & filePath, Kerne
                 continue;
             const std::string kernelFuncName = kernelData["kernelFuncName"].get<std::string>();
             const std::string backend = kernelData["backend"].get<std::string>();
-            const std::string libPath = dirPath / kernelData["libPath"].get<std::string>();
+            const std::string libPath = resolveLibPath(dirPath / kernelData["libPath"].get<std::string>());
             std::vector<mlir::Type> resTypes;
             mapTypes(kernelData["resTypes"], resTypes, "result", kernelFuncName, opMnemonic, backend);
             std::vector<mlir::Type> argTypes;
             mapTypes(kernelData["argTypes"], argTypes, "argument", kernelFuncName, opMnemonic, backend);
-            kc.registerKernel(opMnemonic, KernelInfo(kernelFuncName, resTypes, argTypes, backend, libPath));
+            std::vector<KernelVariantInfo> variants;
+            if(kernelData.contains("variants"))
+                for(auto variantData : kernelData["variants"]) {
+                    const nlohmann::json costHint = variantData.value("costHint", nlohmann::json::object());
+                    variants.emplace_back(
+                        variantData["name"].get<std::string>(),
+                        costHint.value("minCells", size_t(0)),
+                        costHint.value("maxCells", std::numeric_limits<size_t>::max()),
+                        costHint.value("maxSparsity", 1.0)
+                    );
+                }
+            kc.registerKernel(opMnemonic, KernelInfo(kernelFuncName, resTypes, argTypes, backend, libPath, variants));
         }
     }
     catch(std::exception& e) {
@@ -35,6 +35,23 @@ class KernelCatalogParser {
      */
     std::unordered_map<std::string, mlir::Type> typeMap;
 
+    /**
+     * @brief The ISA levels for which specialized kernel libraries are looked
+     * for, best level first.
+     */
+    std::vector<std::string> isaCandidates;
+
+    /**
+     * @brief Whether the ISA level was set explicitly (rather than detected
+     * from the host CPU).
+     */
+    bool explicitIsa;
+
+    /**
+     * @brief Cache of the already resolved kernel library paths.
+     */
+    mutable std::unordered_map<std::string, std::string> resolvedLibPaths;
+
     /**
      * @brief Maps the given C++ type names to MLIR types.
      * 
@@ -54,12 +71,27 @@ class KernelCatalogParser {
         const std::string & backend
     ) const;
 
+    /**
+     * @brief Returns the path of the variant of the given kernel library
+     * compiled for the best ISA level among the candidates, if such a variant
+     * exists next to it (e.g., `libAllKernels-x86-64-v3.so` for
+     * `libAllKernels.so`), or the given path otherwise.
+     *
+     * @param libPath The path of the generic kernel library.
+     */
+    std::string resolveLibPath(const std::string & libPath) const;
+
 public:
 
     /**
      * @brief Creates a new kernel catalog parser.
+     *
+     * @param mctx The MLIR context.
+     * @param kernelIsa The ISA level of the kernel libraries to use: `"auto"`
+     * (the best level supported by the host CPU), `"generic"` (the baseline
+     * libraries), or a particular level like `"x86-64-v3"`.
      */
-    KernelCatalogParser(mlir::MLIRContext * mctx);
+    KernelCatalogParser(mlir::MLIRContext * mctx, const std::string & kernelIsa = "auto");
 
     /**
      * @brief Parses kernel information from the given file and registers them with the given kernel catalog.
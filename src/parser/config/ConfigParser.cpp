@@ -52,6 +52,18 @@ void ConfigParser::readUserConfig(const std::string& filename, DaphneUserConfig&
         config.use_ipa_const_propa = jf.at(DaphneConfigJsonParams::USE_IPA_CONST_PROPA).get<bool>();
     if (keyExists(jf, DaphneConfigJsonParams::USE_PHY_OP_SELECTION))
         config.use_phy_op_selection = jf.at(DaphneConfigJsonParams::USE_PHY_OP_SELECTION).get<bool>();
+    if (keyExists(jf, DaphneConfigJsonParams::USE_MATMUL_CHAIN_OPT))
+        config.use_matmul_chain_opt = jf.at(DaphneConfigJsonParams::USE_MATMUL_CHAIN_OPT).get<bool>();
+    if (keyExists(jf, DaphneConfigJsonParams::USE_ADAPTIVE_RECOMPILATION))
+        config.use_adaptive_recompilation = jf.at(DaphneConfigJsonParams::USE_ADAPTIVE_RECOMPILATION).get<bool>();
+    if (keyExists(jf, DaphneConfigJsonParams::USE_LINEAGE_REUSE))
+        config.use_lineage_reuse = jf.at(DaphneConfigJsonParams::USE_LINEAGE_REUSE).get<bool>();
+    if (keyExists(jf, DaphneConfigJsonParams::LINEAGE_CACHE_SIZE))
+        config.lineage_cache_size = jf.at(DaphneConfigJsonParams::LINEAGE_CACHE_SIZE).get<size_t>();
+    if (keyExists(jf, DaphneConfigJsonParams::MEMORY_BUDGET))
+        config.memory_budget = jf.at(DaphneConfigJsonParams::MEMORY_BUDGET).get<size_t>();
+    if (keyExists(jf, DaphneConfigJsonParams::SPILL_DIR))
+        config.spill_dir = jf.at(DaphneConfigJsonParams::SPILL_DIR).get<std::string>();
     if (keyExists(jf, DaphneConfigJsonParams::USE_MLIR_CODEGEN))
         config.use_mlir_codegen = jf.at(DaphneConfigJsonParams::USE_MLIR_CODEGEN).get<bool>();
     if (keyExists(jf, DaphneConfigJsonParams::MATMUL_VEC_SIZE_BITS))
@@ -74,6 +86,26 @@ void ConfigParser::readUserConfig(const std::string& filename, DaphneUserConfig&
         config.cuda_fuse_any = jf.at(DaphneConfigJsonParams::CUDA_FUSE_ANY).get<bool>();
     if (keyExists(jf, DaphneConfigJsonParams::VECTORIZED_SINGLE_QUEUE))
         config.vectorized_single_queue = jf.at(DaphneConfigJsonParams::VECTORIZED_SINGLE_QUEUE).get<bool>();
+    if (keyExists(jf, DaphneConfigJsonParams::USE_MMAP_IO))
+        config.use_mmap_io = jf.at(DaphneConfigJsonParams::USE_MMAP_IO).get<bool>();
+    if (keyExists(jf, DaphneConfigJsonParams::DBDF_BLOCK_ROWS))
+        config.dbdf_block_rows = jf.at(DaphneConfigJsonParams::DBDF_BLOCK_ROWS).get<size_t>();
+    if (keyExists(jf, DaphneConfigJsonParams::CSV_FULL_PRECISION))
+        config.csv_full_precision = jf.at(DaphneConfigJsonParams::CSV_FULL_PRECISION).get<bool>();
+    if (keyExists(jf, DaphneConfigJsonParams::WRITE_MNC_SKETCH))
+        config.write_mnc_sketch = jf.at(DaphneConfigJsonParams::WRITE_MNC_SKETCH).get<bool>();
+    if (keyExists(jf, DaphneConfigJsonParams::WRITE_INFERRED_META))
+        config.write_inferred_meta = jf.at(DaphneConfigJsonParams::WRITE_INFERRED_META).get<bool>();
+    if (keyExists(jf, DaphneConfigJsonParams::USE_STREAMING))
+        config.use_streaming = jf.at(DaphneConfigJsonParams::USE_STREAMING).get<bool>();
+    if (keyExists(jf, DaphneConfigJsonParams::STREAMING_CHUNK_ROWS))
+        config.streaming_chunk_rows = jf.at(DaphneConfigJsonParams::STREAMING_CHUNK_ROWS).get<size_t>();
+    if (keyExists(jf, DaphneConfigJsonParams::SCHEDULING_TELEMETRY))
+        config.scheduling_telemetry = jf.at(DaphneConfigJsonParams::SCHEDULING_TELEMETRY).get<bool>();
+    if (keyExists(jf, DaphneConfigJsonParams::AUTOTUNE_SCHEDULING))
+        config.autotune_scheduling = jf.at(DaphneConfigJsonParams::AUTOTUNE_SCHEDULING).get<bool>();
+    if (keyExists(jf, DaphneConfigJsonParams::AUTOTUNE_FILE))
+        config.autotune_file = jf.at(DaphneConfigJsonParams::AUTOTUNE_FILE).get<std::string>();
     if (keyExists(jf, DaphneConfigJsonParams::DEBUG_LLVM))
         config.debug_llvm = jf.at(DaphneConfigJsonParams::DEBUG_LLVM).get<bool>();
     if (keyExists(jf, DaphneConfigJsonParams::EXPLAIN_KERNELS))
@@ -117,6 +149,10 @@ void ConfigParser::readUserConfig(const std::string& filename, DaphneUserConfig&
 #endif
     if (keyExists(jf, DaphneConfigJsonParams::LIB_DIR))
         config.libdir = jf.at(DaphneConfigJsonParams::LIB_DIR).get<std::string>();
+    if (keyExists(jf, DaphneConfigJsonParams::KERNEL_ISA))
+        config.kernel_isa = jf.at(DaphneConfigJsonParams::KERNEL_ISA).get<std::string>();
+    if (keyExists(jf, DaphneConfigJsonParams::JIT_OPT_LEVEL))
+        config.jit_opt_level = jf.at(DaphneConfigJsonParams::JIT_OPT_LEVEL).get<unsigned>();
     if (keyExists(jf, DaphneConfigJsonParams::DAPHNEDSL_IMPORT_PATHS)) {
         config.daphnedsl_import_paths = jf.at(DaphneConfigJsonParams::DAPHNEDSL_IMPORT_PATHS).get<std::map<std::string,
                 std::vector<std::string>>>();
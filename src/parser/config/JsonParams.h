@@ -29,6 +29,12 @@ struct DaphneConfigJsonParams {
     inline static const std::string USE_OBJ_REF_MGNT = "use_obj_ref_mgnt";
     inline static const std::string USE_IPA_CONST_PROPA = "use_ipa_const_propa";
     inline static const std::string USE_PHY_OP_SELECTION = "use_phy_op_selection";
+    inline static const std::string USE_MATMUL_CHAIN_OPT = "use_matmul_chain_opt";
+    inline static const std::string USE_ADAPTIVE_RECOMPILATION = "use_adaptive_recompilation";
+    inline static const std::string USE_LINEAGE_REUSE = "use_lineage_reuse";
+    inline static const std::string LINEAGE_CACHE_SIZE = "lineage_cache_size";
+    inline static const std::string MEMORY_BUDGET = "memory_budget";
+    inline static const std::string SPILL_DIR = "spill_dir";
     inline static const std::string USE_MLIR_CODEGEN = "use_mlir_codegen";
     inline static const std::string MATMUL_VEC_SIZE_BITS = "matmul_vec_size_bits";
     inline static const std::string MATMUL_TILE = "matmul_tile";
@@ -40,6 +46,16 @@ struct DaphneConfigJsonParams {
     inline static const std::string MATMUL_INVERT_LOOPS = "matmul_invert_loops";
     inline static const std::string CUDA_FUSE_ANY = "cuda_fuse_any";
     inline static const std::string VECTORIZED_SINGLE_QUEUE = "vectorized_single_queue";
+    inline static const std::string USE_MMAP_IO = "use_mmap_io";
+    inline static const std::string DBDF_BLOCK_ROWS = "dbdf_block_rows";
+    inline static const std::string CSV_FULL_PRECISION = "csv_full_precision";
+    inline static const std::string WRITE_MNC_SKETCH = "write_mnc_sketch";
+    inline static const std::string WRITE_INFERRED_META = "write_inferred_meta";
+    inline static const std::string USE_STREAMING = "use_streaming";
+    inline static const std::string STREAMING_CHUNK_ROWS = "streaming_chunk_rows";
+    inline static const std::string SCHEDULING_TELEMETRY = "scheduling_telemetry";
+    inline static const std::string AUTOTUNE_SCHEDULING = "autotune_scheduling";
+    inline static const std::string AUTOTUNE_FILE = "autotune_file";
 
     inline static const std::string DEBUG_LLVM = "debug_llvm";
     inline static const std::string EXPLAIN_KERNELS = "explain_kernels";
@@ -59,6 +75,8 @@ struct DaphneConfigJsonParams {
     inline static const std::string MINIMUM_TASK_SIZE = "minimumTaskSize";
     inline static const std::string CUDA_DEVICES = "cuda_devices";
     inline static const std::string LIB_DIR = "libdir";
+    inline static const std::string KERNEL_ISA = "kernel_isa";
+    inline static const std::string JIT_OPT_LEVEL = "jit_opt_level";
     inline static const std::string DAPHNEDSL_IMPORT_PATHS = "daphnedsl_import_paths";
     inline static const std::string LOGGING = "logging";
     inline static const std::string FORCE_CUDA = "force_cuda";
@@ -78,9 +96,25 @@ struct DaphneConfigJsonParams {
             USE_OBJ_REF_MGNT,
             USE_IPA_CONST_PROPA,
             USE_PHY_OP_SELECTION,
+            USE_MATMUL_CHAIN_OPT,
+            USE_ADAPTIVE_RECOMPILATION,
+            USE_LINEAGE_REUSE,
+            LINEAGE_CACHE_SIZE,
+            MEMORY_BUDGET,
+            SPILL_DIR,
             USE_MLIR_CODEGEN,
             CUDA_FUSE_ANY,
             VECTORIZED_SINGLE_QUEUE,
+            USE_MMAP_IO,
+            DBDF_BLOCK_ROWS,
+            CSV_FULL_PRECISION,
+            WRITE_MNC_SKETCH,
+            WRITE_INFERRED_META,
+            USE_STREAMING,
+            STREAMING_CHUNK_ROWS,
+            SCHEDULING_TELEMETRY,
+            AUTOTUNE_SCHEDULING,
+            AUTOTUNE_FILE,
             DEBUG_LLVM,
             EXPLAIN_KERNELS,
             EXPLAIN_LLVM,
@@ -99,6 +133,8 @@ struct DaphneConfigJsonParams {
             MINIMUM_TASK_SIZE,
             CUDA_DEVICES,
             LIB_DIR,
+            KERNEL_ISA,
+            JIT_OPT_LEVEL,
             DAPHNEDSL_IMPORT_PATHS,
             LOGGING,
             FORCE_CUDA,
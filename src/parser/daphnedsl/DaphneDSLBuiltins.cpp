@@ -17,6 +17,7 @@
 #include <compiler/utils/CompilerUtils.h>
 #include <ir/daphneir/Daphne.h>
 #include <parser/daphnedsl/DaphneDSLBuiltins.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
 #include <runtime/local/datastructures/Frame.h>
 #include <runtime/local/io/FileMetaData.h>
 
@@ -88,6 +89,73 @@ void DaphneDSLBuiltins::checkNumArgsEven(mlir::Location loc, const std::string &
         );
 }
 
+mlir::Type DaphneDSLBuiltins::getValueTypeFromCode(mlir::Location loc, const std::string & func, mlir::Value valueTypeCode) {
+    int64_t code = CompilerUtils::constantOrThrow<int64_t>(
+            valueTypeCode, "the value type code in " + func + " must be a constant"
+    );
+    if(code < 0 || code >= (int64_t)ValueTypeCode::INVALID)
+        throw ErrorHandler::compilerError(loc, "DSLBuiltins", "invalid value type code");
+    return getValueTypeFromCode(loc, static_cast<ValueTypeCode>(code));
+}
+
+mlir::Type DaphneDSLBuiltins::getValueTypeFromCode(mlir::Location loc, ValueTypeCode code) {
+    switch(code) {
+        case ValueTypeCode::F32:  return builder.getF32Type();
+        case ValueTypeCode::F64:  return builder.getF64Type();
+        case ValueTypeCode::SI8:  return builder.getIntegerType(8, true);
+        case ValueTypeCode::SI32: return builder.getIntegerType(32, true);
+        case ValueTypeCode::SI64: return builder.getIntegerType(64, true);
+        case ValueTypeCode::UI8:  return builder.getIntegerType(8, false);
+        case ValueTypeCode::UI32: return builder.getIntegerType(32, false);
+        case ValueTypeCode::UI64: return builder.getIntegerType(64, false);
+        default:
+            throw ErrorHandler::compilerError(loc, "DSLBuiltins", "invalid value type code");
+    }
+}
+
+template<typename VT>
+static bool isDenseMatrixOf(const Structure * obj) {
+    return dynamic_cast<const DenseMatrix<VT> *>(obj) != nullptr;
+}
+
+mlir::Type DaphneDSLBuiltins::getSessionInputType(mlir::Location loc, mlir::Value name) {
+    const std::string n = CompilerUtils::constantOrThrow<std::string>(
+            name, "the name in loadSessionInput must be a constant if no value type code is given"
+    );
+    if(!sessionInputs)
+        throw ErrorHandler::compilerError(
+                loc, "DSLBuiltins", "loadSessionInput without a value type code can only be used in a session"
+        );
+    auto it = sessionInputs->find(n);
+    if(it == sessionInputs->end())
+        throw ErrorHandler::compilerError(loc, "DSLBuiltins", "there is no session input named `" + n + "`");
+    const Structure * obj = it->second;
+
+    if(auto frm = dynamic_cast<const Frame *>(obj)) {
+        const size_t numCols = frm->getNumCols();
+        std::vector<mlir::Type> colTypes;
+        for(size_t c = 0; c < numCols; c++)
+            colTypes.push_back(getValueTypeFromCode(loc, frm->getColumnType(c)));
+        auto * labels = new std::vector<std::string>(frm->getLabels(), frm->getLabels() + numCols);
+        return mlir::daphne::FrameType::get(builder.getContext(), colTypes).withLabels(labels);
+    }
+
+    mlir::Type vt;
+    if(isDenseMatrixOf<double>(obj))        vt = builder.getF64Type();
+    else if(isDenseMatrixOf<float>(obj))    vt = builder.getF32Type();
+    else if(isDenseMatrixOf<int64_t>(obj))  vt = builder.getIntegerType(64, true);
+    else if(isDenseMatrixOf<int32_t>(obj))  vt = builder.getIntegerType(32, true);
+    else if(isDenseMatrixOf<int8_t>(obj))   vt = builder.getIntegerType(8, true);
+    else if(isDenseMatrixOf<uint64_t>(obj)) vt = builder.getIntegerType(64, false);
+    else if(isDenseMatrixOf<uint32_t>(obj)) vt = builder.getIntegerType(32, false);
+    else if(isDenseMatrixOf<uint8_t>(obj))  vt = builder.getIntegerType(8, false);
+    else
+        throw ErrorHandler::compilerError(
+                loc, "DSLBuiltins", "the session input `" + n + "` has an unsupported data or value type"
+        );
+    return utils.matrixOf(vt);
+}
+
 // ************************************************************************
 // Creating similar DaphneIR operations
 // ************************************************************************
@@ -1071,37 +1139,34 @@ antlrcpp::Any DaphneDSLBuiltins::build(mlir::Location loc, const std::string & f
         mlir::Value lower = utils.castUI32If(args[1]);
         mlir::Value rows = args[2];
         mlir::Value cols = args[3];
-        mlir::Value valueType = args[4];
-
-        int64_t valueTypeCode = CompilerUtils::constantOrThrow<int64_t>(
-                valueType, "the value type code in ReceiveFromNumpyOp must be a constant"
-        );
-
-        // TODO Is there a utility for this mapping from value type code to MLIR type?
-        mlir::Type vt;
-        if(valueTypeCode == (int64_t)ValueTypeCode::F32)
-            vt = builder.getF32Type();
-        else if(valueTypeCode == (int64_t)ValueTypeCode::F64)
-            vt = builder.getF64Type();
-        else if(valueTypeCode == (int64_t)ValueTypeCode::SI8)
-            vt = builder.getIntegerType(8, true);
-        else if(valueTypeCode == (int64_t)ValueTypeCode::SI32)
-            vt = builder.getIntegerType(32, true);
-        else if(valueTypeCode == (int64_t)ValueTypeCode::SI64)
-            vt = builder.getIntegerType(64, true);
-        else if(valueTypeCode == (int64_t)ValueTypeCode::UI8)
-            vt = builder.getIntegerType(8, false);
-        else if(valueTypeCode == (int64_t)ValueTypeCode::UI32)
-            vt = builder.getIntegerType(32, false);
-        else if(valueTypeCode == (int64_t)ValueTypeCode::UI64)
-            vt = builder.getIntegerType(64, false);
-        else
-            throw ErrorHandler::compilerError(loc, "DSLBuiltins", "invalid value type code");
+        mlir::Type vt = getValueTypeFromCode(loc, "ReceiveFromNumpyOp", args[4]);
 
         return static_cast<mlir::Value>(builder.create<ReceiveFromNumpyOp>(
                 loc, utils.matrixOf(vt), upper, lower, rows, cols
         ));
     }
+    if(func == "loadSessionInput") {
+        checkNumArgsBetween(loc, func, numArgs, 1, 2);
+
+        // The shape of the input is only known at run-time, such that scripts
+        // compiled once can be executed repeatedly on different inputs.
+        // Without a value type code, the data and value types are taken from
+        // the data object bound at compile-time.
+        mlir::Value name = args[0];
+        mlir::Type resType = (numArgs == 2)
+                ? utils.matrixOf(getValueTypeFromCode(loc, "LoadSessionInputOp", args[1]))
+                : getSessionInputType(loc, name);
+
+        return static_cast<mlir::Value>(builder.create<LoadSessionInputOp>(
+                loc, resType, name
+        ));
+    }
+    if(func == "storeSessionInput") {
+        checkNumArgsExact(loc, func, numArgs, 2);
+        mlir::Value arg = args[0];
+        mlir::Value name = args[1];
+        return builder.create<StoreSessionInputOp>(loc, arg, name).getOperation();
+    }
     if(func == "saveDaphneLibResult") {
         checkNumArgsExact(loc, func, numArgs, 1);
         mlir::Value arg = args[0];
@@ -18,6 +18,7 @@
 #define SRC_PARSER_DAPHNEDSL_DAPHNEDSLBUILTINS_H
 
 #include <parser/ParserUtils.h>
+#include <runtime/local/datastructures/Structure.h>
 #include <runtime/local/io/FileMetaData.h>
 
 #include "antlr4-runtime.h"
@@ -27,6 +28,7 @@
 
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <cstdlib>
@@ -46,6 +48,12 @@ class DaphneDSLBuiltins {
      * @brief General utilities for parsing to DaphneIR.
      */
     ParserUtils utils;
+
+    /**
+     * @brief The data objects bound in the session the script is compiled for
+     * (see `DaphneSession`), or `nullptr` outside a session.
+     */
+    const std::unordered_map<std::string, Structure *> * sessionInputs;
     
     // ************************************************************************
     // Checking number of arguments
@@ -61,6 +69,21 @@ class DaphneDSLBuiltins {
     
     static void checkNumArgsEven(mlir::Location loc, const std::string & func, size_t numArgs);
     
+    /**
+     * @brief Returns the MLIR value type for the given value type code, which
+     * must be a constant.
+     */
+    mlir::Type getValueTypeFromCode(mlir::Location loc, const std::string & func, mlir::Value valueTypeCode);
+
+    mlir::Type getValueTypeFromCode(mlir::Location loc, ValueTypeCode code);
+
+    /**
+     * @brief Returns the MLIR data type of the data object bound under the
+     * given name in the session the script is compiled for. The name must be
+     * a constant.
+     */
+    mlir::Type getSessionInputType(mlir::Location loc, mlir::Value name);
+    
     // ************************************************************************
     // Creating similar DaphneIR operations
     // ************************************************************************
@@ -121,7 +144,10 @@ class DaphneDSLBuiltins {
     
 public:
     
-    explicit DaphneDSLBuiltins(mlir::OpBuilder & builder) : builder(builder), utils(builder) {
+    explicit DaphneDSLBuiltins(
+            mlir::OpBuilder & builder,
+            const std::unordered_map<std::string, Structure *> * sessionInputs = nullptr
+    ) : builder(builder), utils(builder), sessionInputs(sessionInputs) {
         //
     };
 
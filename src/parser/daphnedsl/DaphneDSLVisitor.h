@@ -177,7 +177,8 @@ public:
             std::unordered_map<std::string, std::string> args,
             const std::string & rootScriptPath,
             DaphneUserConfig userConf_
-    ) : module(module), builder(builder), utils(builder), builtins(builder), args(std::move(args)) {
+    ) : module(module), builder(builder), utils(builder), builtins(builder, userConf_.session_inputs),
+            args(std::move(args)) {
         scriptPaths.push(rootScriptPath);
         userConf = std::move(userConf_);
         logger = spdlog::get("parser");
@@ -0,0 +1,274 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <parser/metadata/CsvMetaDataInference.h>
+
+#include <algorithm>
+#include <charconv>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    /**
+     * @brief The kinds of values found in a CSV column, ordered by generality.
+     */
+    enum class CsvValueKind : uint8_t {
+        EMPTY,
+        INTEGER,
+        FLOAT,
+    };
+
+    // Blocks smaller than this are not worth an own thread.
+    constexpr size_t MIN_BLOCK_SIZE = 1 << 20;
+
+    /**
+     * @brief A read-only memory mapping of a whole file.
+     */
+    struct MappedFile {
+        const char * data = nullptr;
+        size_t size = 0;
+
+        explicit MappedFile(const std::string & filename) {
+            int fd = open(filename.c_str(), O_RDONLY);
+            if(fd == -1)
+                throw std::runtime_error("could not open file '" + filename + "' for inferring its meta data");
+            struct stat st;
+            if(fstat(fd, &st) == -1) {
+                close(fd);
+                throw std::runtime_error("could not stat file '" + filename + "' for inferring its meta data");
+            }
+            size = st.st_size;
+            if(size) {
+                void * addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if(addr == MAP_FAILED) {
+                    close(fd);
+                    throw std::runtime_error("could not map file '" + filename + "' for inferring its meta data");
+                }
+                madvise(addr, size, MADV_SEQUENTIAL);
+                data = static_cast<const char *>(addr);
+            }
+            close(fd);
+        }
+
+        ~MappedFile() {
+            if(data)
+                munmap(const_cast<char *>(data), size);
+        }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile & operator=(const MappedFile &) = delete;
+    };
+
+    size_t countLineBreaks(const char * begin, const char * end) {
+        // memchr is vectorized by the C library.
+        size_t count = 0;
+        while(begin < end) {
+            const void * pos = memchr(begin, '\n', end - begin);
+            if(!pos)
+                break;
+            count++;
+            begin = static_cast<const char *>(pos) + 1;
+        }
+        return count;
+    }
+
+    CsvValueKind classifyValue(const char * begin, const char * end, const std::string & filename) {
+        while(begin < end && (*begin == ' ' || *begin == '\t'))
+            begin++;
+        while(end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r'))
+            end--;
+        if(begin == end)
+            return CsvValueKind::EMPTY;
+
+        const char * digits = (*begin == '+') ? begin + 1 : begin;
+        int64_t intVal;
+        auto [ptr, ec] = std::from_chars(digits, end, intVal);
+        if(ptr == end && ec == std::errc())
+            return CsvValueKind::INTEGER;
+
+        // Also covers integers out of the range of int64_t, nan, and inf.
+        const std::string str(begin, end);
+        char * strEnd;
+        strtod(str.c_str(), &strEnd);
+        if(strEnd == str.c_str() + str.size())
+            return CsvValueKind::FLOAT;
+
+        throw std::runtime_error("could not infer the meta data of file '" + filename +
+                                 "', since it contains the non-numeric value '" + str +
+                                 "'; please provide a meta data file");
+    }
+
+    /**
+     * @brief Classifies the values of the given line and merges their kinds
+     * into `kinds`.
+     */
+    void classifyLine(const char * begin, const char * end, std::vector<CsvValueKind> & kinds,
+                      const std::string & filename) {
+        size_t col = 0;
+        const char * valBegin = begin;
+        for(const char * p = begin; ; p++) {
+            if(p == end || *p == ',') {
+                if(col == kinds.size())
+                    throw std::runtime_error("could not infer the meta data of file '" + filename +
+                                             "', since its lines have different numbers of columns");
+                kinds[col] = std::max(kinds[col], classifyValue(valBegin, p, filename));
+                col++;
+                valBegin = p + 1;
+                if(p == end)
+                    break;
+            }
+        }
+        if(col != kinds.size())
+            throw std::runtime_error("could not infer the meta data of file '" + filename +
+                                     "', since its lines have different numbers of columns");
+    }
+
+    /**
+     * @brief Classifies the values of up to `numRows` lines starting at
+     * `begin`, which must be the beginning of a line.
+     *
+     * @return The beginning of the first line not classified, or a position
+     * after `end` if all lines were classified.
+     */
+    const char * classifyLines(const char * begin, const char * end, size_t numRows,
+                               std::vector<CsvValueKind> & kinds, const std::string & filename) {
+        for(size_t r = 0; r < numRows && begin < end; r++) {
+            const char * lineEnd = static_cast<const char *>(memchr(begin, '\n', end - begin));
+            if(!lineEnd)
+                lineEnd = end;
+            classifyLine(begin, lineEnd, kinds, filename);
+            begin = lineEnd + 1;
+        }
+        return begin;
+    }
+}
+
+FileMetaData CsvMetaDataInference::inferMetaData(const std::string & filename, size_t numThreads,
+                                                 size_t numSampleRows) {
+    MappedFile file(filename);
+
+    // Trailing line breaks do not start further rows.
+    const char * data = file.data;
+    const char * end = data + file.size;
+    while(end > data && (end[-1] == '\n' || end[-1] == '\r'))
+        end--;
+    if(end == data)
+        throw std::runtime_error("could not infer the meta data of file '" + filename + "', since it is empty");
+    const size_t size = end - data;
+
+    const char * firstLineEnd = static_cast<const char *>(memchr(data, '\n', size));
+    if(!firstLineEnd)
+        firstLineEnd = end;
+    const size_t numCols = std::count(data, firstLineEnd, ',') + 1;
+
+    if(numThreads == 0)
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    numThreads = std::max<size_t>(1, std::min(numThreads, size / MIN_BLOCK_SIZE));
+    const size_t blockSize = (size + numThreads - 1) / numThreads;
+
+    // Each thread counts the line breaks in its block and samples the rows
+    // starting at the first line beginning in its block. It also records
+    // whether the sample covers all lines beginning in its block.
+    std::vector<size_t> numLineBreaks(numThreads, 0);
+    std::vector<uint8_t> blockFullySampled(numThreads, false);
+    std::vector<std::vector<CsvValueKind>> kinds(numThreads, std::vector<CsvValueKind>(numCols, CsvValueKind::EMPTY));
+    std::vector<std::exception_ptr> errors(numThreads);
+    auto scanBlock = [&](size_t t) {
+        try {
+            const char * blockBegin = data + std::min(size, t * blockSize);
+            const char * blockEnd = data + std::min(size, (t + 1) * blockSize);
+            numLineBreaks[t] = countLineBreaks(blockBegin, blockEnd);
+
+            const char * sampleBegin = blockBegin;
+            if(t > 0) {
+                // The line containing the block boundary belongs to the previous block.
+                if(blockBegin[-1] != '\n') {
+                    sampleBegin = static_cast<const char *>(memchr(blockBegin, '\n', blockEnd - blockBegin));
+                    if(!sampleBegin) {
+                        blockFullySampled[t] = true;
+                        return;
+                    }
+                    sampleBegin++;
+                }
+                if(sampleBegin >= blockEnd) {
+                    blockFullySampled[t] = true;
+                    return;
+                }
+            }
+            blockFullySampled[t] = classifyLines(sampleBegin, end, numSampleRows, kinds[t], filename) >= blockEnd;
+        }
+        catch(...) {
+            errors[t] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    for(size_t t = 1; t < numThreads; t++)
+        threads.emplace_back(scanBlock, t);
+    scanBlock(0);
+    for(auto & thread : threads)
+        thread.join();
+    for(auto & error : errors)
+        if(error)
+            std::rethrow_exception(error);
+
+    // Additionally sample the last rows of the file.
+    const char * tailBegin = end;
+    for(size_t r = 0; r < numSampleRows && tailBegin > data; r++) {
+        // Skip the line break ending the previous line.
+        const char * searchEnd = (tailBegin == end) ? end : tailBegin - 1;
+        const char * pos = static_cast<const char *>(memrchr(data, '\n', searchEnd - data));
+        tailBegin = pos ? pos + 1 : data;
+    }
+    classifyLines(tailBegin, end, numSampleRows, kinds[0], filename);
+
+    size_t numRows = 1;
+    for(size_t n : numLineBreaks)
+        numRows += n;
+
+    // A column that looks like integers in a sample may still contain
+    // floating-point values elsewhere, which would be truncated when read as
+    // si64, whereas f64 represents (reasonably small) integers exactly.
+    const bool fullySampled = std::all_of(blockFullySampled.begin(), blockFullySampled.end(), [](uint8_t b) { return b; });
+    std::vector<ValueTypeCode> schema(numCols);
+    for(size_t c = 0; c < numCols; c++) {
+        CsvValueKind kind = CsvValueKind::EMPTY;
+        for(size_t t = 0; t < numThreads; t++)
+            kind = std::max(kind, kinds[t][c]);
+        // Columns without any sampled value can still hold nan.
+        schema[c] = (kind == CsvValueKind::INTEGER && fullySampled) ? ValueTypeCode::SI64 : ValueTypeCode::F64;
+    }
+
+    if(std::all_of(schema.begin(), schema.end(), [&](ValueTypeCode vtc) { return vtc == schema[0]; }))
+        return FileMetaData(numRows, numCols, true, schema[0]);
+
+    // The default labels of a frame (see Frame::getDefaultLabel()).
+    std::vector<std::string> labels;
+    for(size_t c = 0; c < numCols; c++)
+        labels.push_back("col_" + std::to_string(c));
+    return FileMetaData(numRows, numCols, false, schema, labels);
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <runtime/local/io/FileMetaData.h>
+
+#include <string>
+
+#include <cstddef>
+
+/**
+ * @brief Infers the meta data of a CSV file by scanning the file itself.
+ *
+ * This is used when a CSV file comes without a `.meta` file. The number of
+ * rows is obtained by counting the line breaks of the memory-mapped file in
+ * parallel (one block per thread), the number of columns from the first line.
+ * The value types are inferred from a sample of rows taken at the beginning of
+ * each block and at the end of the file: a column becomes `si64` if the sample
+ * covers the whole file and all values of the column are integers, and `f64`
+ * otherwise, since a column could contain floating-point values beyond the
+ * sample. If all columns have the
+ * same value type, the meta data describe a single value type (and can be used
+ * for matrices and frames), otherwise they describe a frame with the default
+ * column labels.
+ */
+class CsvMetaDataInference {
+
+public:
+    /**
+     * @brief Infers the meta data of the specified CSV file.
+     *
+     * @param filename The name of the CSV file.
+     * @param numThreads The number of threads for scanning the file, or 0 to
+     * use the available hardware concurrency.
+     * @param numSampleRows The number of rows sampled per block for inferring
+     * the value types.
+     * @return The inferred meta data.
+     * @throws std::runtime_error Thrown if the file could not be read or if a
+     * value is not numeric.
+     */
+    static FileMetaData inferMetaData(const std::string & filename, size_t numThreads = 0,
+                                      size_t numSampleRows = 256);
+};
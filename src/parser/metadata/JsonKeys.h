@@ -36,6 +36,11 @@ struct JsonKeys {
 
     // optional key
     inline static const std::string NUM_NON_ZEROS = "numNonZeros";  // int (default: -1)
+
+    // only in meta data inferred from the data file itself, identify the
+    // version of the data file they were inferred from
+    inline static const std::string INFERRED_FILE_SIZE = "inferredFileSize";  // int
+    inline static const std::string INFERRED_FILE_TIME = "inferredFileTime";  // int
 };
 
 #endif
\ No newline at end of file
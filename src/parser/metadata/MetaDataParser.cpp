@@ -16,17 +16,41 @@
 
 #include <parser/metadata/MetaDataParser.h>
 #include <parser/metadata/JsonKeys.h>
+#include <parser/metadata/CsvMetaDataInference.h>
 
+#include <atomic>
+#include <filesystem>
 #include <fstream>
+#include <mutex>
+#include <system_error>
+#include <tuple>
+#include <unordered_map>
+
+#include <unistd.h>
+
+namespace {
+    std::atomic<bool> writeInferredMetaData(false);
+}
 
 FileMetaData MetaDataParser::readMetaData(const std::string& filename_) {
     std::string metaFilename = filename_ + ".meta";
     std::ifstream ifs(metaFilename, std::ios::in);
-    if (!ifs.good())
+    if (!ifs.good()) {
+        if (isCsvFile(filename_))
+            return inferMetaData(filename_);
         throw std::runtime_error("Could not open file '" + metaFilename + "' for reading meta data.");
+    }
 
     nlohmann::json jf = nlohmann::json::parse(ifs);
 
+    // Meta data inferred by an earlier run are outdated if the file changed.
+    if (keyExists(jf, JsonKeys::INFERRED_FILE_SIZE) && keyExists(jf, JsonKeys::INFERRED_FILE_TIME)) {
+        auto [fileSize, fileTime] = getFileStamp(filename_);
+        if (jf.at(JsonKeys::INFERRED_FILE_SIZE).get<uint64_t>() != fileSize ||
+            jf.at(JsonKeys::INFERRED_FILE_TIME).get<int64_t>() != fileTime)
+            return inferMetaData(filename_);
+    }
+
     if (!keyExists(jf, JsonKeys::NUM_ROWS) || !keyExists(jf, JsonKeys::NUM_COLS)) {
         throw std::invalid_argument("A meta data JSON file should always contain \"" + JsonKeys::NUM_ROWS + "\" and \""
                                     + JsonKeys::NUM_COLS + "\" keys.");
@@ -84,35 +108,113 @@ void MetaDataParser::writeMetaData(const std::string& filename_, const FileMetaD
         throw std::runtime_error("could not open file '" + metaFilename + "' for writing meta data");
 
     if(ofs.is_open()) {
-        nlohmann::json json;
+        ofs << toJson(metaData).dump();
+    }
+    else
+        throw std::runtime_error("could not open file '" + metaFilename + "' for writing meta data");
+}
 
-        json[JsonKeys::NUM_ROWS] = metaData.numRows;
-        json[JsonKeys::NUM_COLS] = metaData.numCols;
+nlohmann::json MetaDataParser::toJson(const FileMetaData& metaData) {
+    nlohmann::json json;
 
-        if (metaData.isSingleValueType) {
-            if (metaData.schema.size() != 1)
-                throw std::runtime_error("inappropriate meta data tried to be written to file");
-            json[JsonKeys::VALUE_TYPE] = metaData.schema[0];
-        }
-        else {
-            std::vector<SchemaColumn> schemaColumns;
-            // assume that the schema and labels are the same lengths
-            for (unsigned int i = 0; i < metaData.schema.size(); i++) {
-                SchemaColumn schemaColumn;
-                schemaColumn.setLabel(metaData.labels[i]);
-                schemaColumn.setValueType(metaData.schema[i]);
-                schemaColumns.emplace_back(schemaColumn);
-            }
-            json[JsonKeys::SCHEMA] = schemaColumns;
+    json[JsonKeys::NUM_ROWS] = metaData.numRows;
+    json[JsonKeys::NUM_COLS] = metaData.numCols;
+
+    if (metaData.isSingleValueType) {
+        if (metaData.schema.size() != 1)
+            throw std::runtime_error("inappropriate meta data tried to be written to file");
+        json[JsonKeys::VALUE_TYPE] = metaData.schema[0];
+    }
+    else {
+        std::vector<SchemaColumn> schemaColumns;
+        // assume that the schema and labels are the same lengths
+        for (unsigned int i = 0; i < metaData.schema.size(); i++) {
+            SchemaColumn schemaColumn;
+            schemaColumn.setLabel(metaData.labels[i]);
+            schemaColumn.setValueType(metaData.schema[i]);
+            schemaColumns.emplace_back(schemaColumn);
         }
+        json[JsonKeys::SCHEMA] = schemaColumns;
+    }
 
-        if (metaData.numNonZeros != -1)
-            json[JsonKeys::NUM_NON_ZEROS] = metaData.numNonZeros;
+    if (metaData.numNonZeros != -1)
+        json[JsonKeys::NUM_NON_ZEROS] = metaData.numNonZeros;
 
+    return json;
+}
+
+FileMetaData MetaDataParser::inferMetaData(const std::string& filename) {
+    // The inferred meta data are also cached in-process, such that files
+    // whose meta data file cannot be written (e.g., in a read-only directory)
+    // are not scanned again on every read. The entries are only valid for the
+    // size and modification time of the file they were inferred from.
+    static std::mutex mtx;
+    static std::unordered_map<std::string, std::tuple<uint64_t, int64_t, FileMetaData>> cache;
+
+    uint64_t fileSize;
+    int64_t fileTime;
+    try {
+        std::tie(fileSize, fileTime) = getFileStamp(filename);
+    }
+    catch (std::filesystem::filesystem_error&) {
+        // Let the inference report the missing or unreadable file.
+        return CsvMetaDataInference::inferMetaData(filename);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = cache.find(filename);
+        if (it != cache.end() && std::get<0>(it->second) == fileSize && std::get<1>(it->second) == fileTime)
+            return std::get<2>(it->second);
+    }
+
+    FileMetaData metaData = CsvMetaDataInference::inferMetaData(filename);
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        // FileMetaData is not assignable.
+        cache.erase(filename);
+        cache.emplace(filename, std::make_tuple(fileSize, fileTime, metaData));
+    }
+    if (!writeInferredMetaData)
+        return metaData;
+
+    // Cache the inferred meta data in a meta data file, together with the size
+    // and modification time of the file they were inferred from. The file is
+    // written under a temporary name and renamed, such that concurrent readers
+    // never see a partial file. Failing to cache (e.g., in a read-only
+    // directory) is not an error.
+    nlohmann::json json = toJson(metaData);
+    json[JsonKeys::INFERRED_FILE_SIZE] = fileSize;
+    json[JsonKeys::INFERRED_FILE_TIME] = fileTime;
+    const std::string metaFilename = filename + ".meta";
+    const std::string tmpFilename = metaFilename + ".tmp" + std::to_string(getpid());
+    {
+        std::ofstream ofs(tmpFilename, std::ios::out);
+        if (!ofs.good())
+            return metaData;
         ofs << json.dump();
     }
-    else
-        throw std::runtime_error("could not open file '" + metaFilename + "' for writing meta data");
+    std::error_code ec;
+    std::filesystem::rename(tmpFilename, metaFilename, ec);
+    if (ec)
+        std::filesystem::remove(tmpFilename, ec);
+
+    return metaData;
+}
+
+void MetaDataParser::setWriteInferredMetaData(bool write) {
+    writeInferredMetaData = write;
+}
+
+std::pair<uint64_t, int64_t> MetaDataParser::getFileStamp(const std::string& filename) {
+    return {
+        std::filesystem::file_size(filename),
+        std::filesystem::last_write_time(filename).time_since_epoch().count()
+    };
+}
+
+bool MetaDataParser::isCsvFile(const std::string& filename) {
+    const std::string ext = ".csv";
+    return filename.size() > ext.size() && filename.compare(filename.size() - ext.size(), ext.size(), ext) == 0;
 }
 
 bool MetaDataParser::keyExists(const nlohmann::json& j, const std::string& key) { return j.find(key) != j.end(); }
@@ -22,6 +22,9 @@
 #include <runtime/local/datastructures/ValueTypeCode.h>
 
 #include <string>
+#include <utility>
+
+#include <cstdint>
 
 // must be in the same namespace as the enum class ValueTypeCode
 NLOHMANN_JSON_SERIALIZE_ENUM(ValueTypeCode, {
@@ -60,7 +63,11 @@ public:
      * @brief Retrieves the file meta data for the specified file.
      *
      * @param filename The name of the file for which to retrieve the meta data.
-     * Meta data should be passed using a simple JSON-based format.
+     * Meta data should be passed using a simple JSON-based format. If there is
+     * no meta data file for a CSV file, the meta data are inferred from the CSV
+     * file itself (see `CsvMetaDataInference`) and cached in-process and, if
+     * enabled (see `setWriteInferredMetaData()`), in a meta data file, which is
+     * ignored once the CSV file changes.
      * @return The meta data of the specified file.
      * @throws std::runtime_error Thrown if the specified file could not be open.
      * @throws std::invalid_argument Thrown if the JSON file contains any unexpected
@@ -77,7 +84,32 @@ public:
      */
     static void writeMetaData(const std::string& filename, const FileMetaData& metaData);
 
+    /**
+     * @brief Sets whether meta data inferred from a CSV file are cached in a
+     * meta data file next to it for later runs (`--write-inferred-meta`).
+     *
+     * Disabled by default, since DAPHNE should not create files in the
+     * directories of its inputs unless asked to.
+     */
+    static void setWriteInferredMetaData(bool write);
+
 private:
+    static nlohmann::json toJson(const FileMetaData& metaData);
+
+    /**
+     * @brief Infers the meta data of the specified CSV file, or returns them
+     * from an in-process cache if the file did not change since, and, if
+     * enabled, tries to cache them in its meta data file.
+     */
+    static FileMetaData inferMetaData(const std::string& filename);
+
+    /**
+     * @brief Returns the size and the modification time of the specified file.
+     */
+    static std::pair<uint64_t, int64_t> getFileStamp(const std::string& filename);
+
+    static bool isCsvFile(const std::string& filename);
+
     /**
      * @brief Checks whether a specified key exists in JSON or not.
      *
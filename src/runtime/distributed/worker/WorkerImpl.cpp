@@ -79,7 +79,7 @@ WorkerImpl::Status WorkerImpl::Compute(std::vector<WorkerImpl::StoredInfo> *outp
     DaphneIrExecutor executor(false, cfg);
 
     KernelCatalog & kc = executor.getUserConfig().kernelCatalog;
-    KernelCatalogParser kcp(executor.getContext());
+    KernelCatalogParser kcp(executor.getContext(), cfg.kernel_isa);
     kcp.parseKernelCatalog(cfg.libdir + "/catalog.json", kc);
     if(executor.getUserConfig().use_cuda)
         kcp.parseKernelCatalog(cfg.libdir + "/CUDAcatalog.json", kc);
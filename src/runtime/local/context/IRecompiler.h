@@ -0,0 +1,56 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+class Structure;
+
+/**
+ * @brief Re-compiles and runs DaphneIR functions at run-time.
+ *
+ * The compiler replaces calls of functions whose arguments have properties
+ * that are unknown at compile-time (e.g., the number of rows of a matrix that
+ * results from a data-dependent filter) by a `RecompileCallOp`, which carries
+ * the IR of the function. At run-time, the kernel of that operation hands
+ * the IR and the actual arguments over to the recompiler, which specializes
+ * the function for the actual properties of the arguments, compiles it, and
+ * invokes it.
+ *
+ * This interface separates the kernels from the compiler: the kernels
+ * library must not depend on MLIR, while the implementation (see
+ * `AdaptiveRecompiler`) is part of the compiler and is passed to the kernels
+ * through the `DaphneUserConfig`.
+ */
+class IRecompiler {
+public:
+    virtual ~IRecompiler() = default;
+
+    /**
+     * @brief Calls the entry function of the given IR module with the given
+     * arguments after specializing it for their actual properties.
+     *
+     * @param res An array of `numRes` pointers to store the results in.
+     * @param numRes The number of results.
+     * @param args An array of `numArgs` arguments.
+     * @param numArgs The number of arguments.
+     * @param irCode The textual representation of an MLIR module containing
+     * the entry function and all functions it calls.
+     */
+    virtual void call(Structure ** res, size_t numRes, const Structure ** args, size_t numArgs,
+                      const char * irCode) = 0;
+};
@@ -28,6 +28,7 @@
 #include <runtime/local/datastructures/ContiguousTensor.h>
 #include <runtime/local/datastructures/DataObjectFactory.h>
 #include <runtime/local/datastructures/Tensor.h>
+#include <runtime/local/io/io_uring/AsyncIOService.h>
 #include <runtime/local/io/io_uring/AsyncUtil.h>
 #include <runtime/local/datastructures/ValueTypeUtils.h>
 
@@ -1180,6 +1181,32 @@ class ChunkedTensor : public Tensor<ValueType> {
         return &(chunk_io_futures[getLinearChunkIdFromChunkIds(chunk_ids)]);
     }
 
+    // Submits reads of the given chunks (chunk ids and file offset of each chunk's data) from the open file `fd`
+    // through the AsyncIOService. The chunks' AsyncIOInfo is updated on completion, such that
+    // PollChunkMaterializationAndIOStatus() materializes them once they have arrived. Chunks that are already
+    // materialized or in flight are skipped.
+    void AsyncLoadChunks(int fd, const std::vector<std::pair<std::vector<size_t>, uint64_t>> &chunks,
+                         bool needs_byte_reversal = false, AsyncIOService &service = AsyncIOService::get()) {
+        const size_t chunk_size_in_bytes = chunk_element_count * sizeof(ValueType);
+        for (const auto &[chunk_ids, offset] : chunks) {
+            size_t linear_chunk_id = getLinearChunkIdFromChunkIds(chunk_ids);
+            AsyncIOInfo *info      = &chunk_io_futures[linear_chunk_id];
+            if (chunk_materialization_flags[linear_chunk_id] || info->status == IO_STATUS::IN_FLIGHT) {
+                continue;
+            }
+            info->needs_byte_reversal = needs_byte_reversal;
+            info->status              = IO_STATUS::IN_FLIGHT;
+            service.submitRead(fd, getPtrToChunk(linear_chunk_id), chunk_size_in_bytes, offset,
+                               [info, chunk_size_in_bytes](IO_STATUS status, size_t bytes_read) {
+                                   if (status == IO_STATUS::SUCCESS && bytes_read != chunk_size_in_bytes) {
+                                       status = IO_STATUS::IO_ERROR;
+                                   }
+                                   info->status = status;
+                               });
+        }
+        service.flush();
+    }
+
     // Prints elements in logical layout
     void print(std::ostream &os) const override {
         os << "ChunkedTensor(";
@@ -230,6 +230,18 @@ public:
     std::shared_ptr<ValueType[]> getValuesSharedPtr() const {
         return values;
     }
+
+    /**
+     * @brief Replaces the values array of this matrix, e.g., to release it after it was spilled to disk and to
+     * restore it afterwards (see `BufferManager`).
+     *
+     * Must only be used if this matrix is not a view and does not share its values array with other data objects.
+     *
+     * @param newValues The new values array of `numRows * numCols` elements, or `nullptr`.
+     */
+    void replaceValues(std::shared_ptr<ValueType[]> newValues) {
+        values = std::move(newValues);
+    }
     
     ValueType get(size_t rowIdx, size_t colIdx) const override {
         return getValues()[pos(rowIdx, colIdx, isPartialBuffer())];
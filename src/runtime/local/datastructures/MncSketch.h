@@ -0,0 +1,373 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <cmath>
+#include <cstddef>
+#include <sys/types.h>
+
+// ****************************************************************************
+// Metadata-only sparsity estimation
+// ****************************************************************************
+
+// These estimators only use the sparsities (i.e., the fraction of non-zero
+// cells) of the inputs and assume that the non-zeros are distributed uniformly
+// at random (average case). A sparsity of -1.0 means unknown.
+
+/**
+ * @brief Estimates the sparsity of the product of a matrix with sparsity
+ * `spLhs` and one with sparsity `spRhs`, whose common dimension is `k`.
+ */
+inline double estimateSparsityMatMul(double spLhs, double spRhs, ssize_t k) {
+    if(spLhs == -1.0 || spRhs == -1.0 || k == -1)
+        return -1.0;
+    return 1.0 - std::pow(1.0 - spLhs * spRhs, static_cast<double>(k));
+}
+
+/**
+ * @brief Estimates the sparsity of an element-wise operation whose result is
+ * zero if either input is zero (e.g., multiplication).
+ */
+inline double estimateSparsityEwAnd(double spLhs, double spRhs) {
+    if(spLhs == -1.0 || spRhs == -1.0)
+        return -1.0;
+    return spLhs * spRhs;
+}
+
+/**
+ * @brief Estimates the sparsity of an element-wise operation whose result is
+ * zero only if both inputs are zero (e.g., addition).
+ */
+inline double estimateSparsityEwOr(double spLhs, double spRhs) {
+    if(spLhs == -1.0 || spRhs == -1.0)
+        return -1.0;
+    return spLhs + spRhs - spLhs * spRhs;
+}
+
+/**
+ * @brief Estimates the sparsity of a row-wise (or column-wise) sum of `n`
+ * values per row (column) of a matrix with the given sparsity, i.e., the
+ * probability that a row (column) contains at least one non-zero.
+ */
+inline double estimateSparsityAgg(double sp, ssize_t n) {
+    if(sp == -1.0 || n == -1)
+        return -1.0;
+    return 1.0 - std::pow(1.0 - sp, static_cast<double>(n));
+}
+
+// ****************************************************************************
+// Matrix non-zero count (MNC) sketch
+// ****************************************************************************
+
+/**
+ * @brief A matrix non-zero count (MNC) sketch, i.e., the number of non-zeros
+ * per row and per column of a matrix.
+ *
+ * Unlike the sparsity alone, the sketch captures skew and structure (e.g.,
+ * empty rows, permutation or selection matrices), which allows much more
+ * accurate estimates of the sparsity of matrix products, and even exact ones
+ * in many practically relevant cases. Sketches can be propagated through
+ * operations to estimate the sparsity of chains of operations.
+ *
+ * See J. Sommer et al.: "MNC: Structure-Exploiting Sparsity Estimation for
+ * Matrix Expressions", SIGMOD 2019.
+ */
+struct MncSketch {
+    size_t numRows;
+    size_t numCols;
+    // The number of non-zeros in each row.
+    std::vector<size_t> rowNnz;
+    // The number of non-zeros in each column.
+    std::vector<size_t> colNnz;
+
+    // Summary statistics derived from the histograms.
+    size_t nnz;
+    size_t maxRowNnz;
+    size_t maxColNnz;
+    size_t numNonEmptyRows;
+    size_t numNonEmptyCols;
+
+    MncSketch(size_t numRows, size_t numCols, std::vector<size_t> rowNnz, std::vector<size_t> colNnz) :
+            numRows(numRows), numCols(numCols), rowNnz(std::move(rowNnz)), colNnz(std::move(colNnz)),
+            nnz(0), maxRowNnz(0), maxColNnz(0), numNonEmptyRows(0), numNonEmptyCols(0)
+    {
+        if(this->rowNnz.size() != numRows || this->colNnz.size() != numCols)
+            throw std::runtime_error("MncSketch: the histograms must match the shape");
+        for(size_t n : this->rowNnz) {
+            nnz += n;
+            maxRowNnz = std::max(maxRowNnz, n);
+            numNonEmptyRows += n > 0;
+        }
+        for(size_t n : this->colNnz) {
+            maxColNnz = std::max(maxColNnz, n);
+            numNonEmptyCols += n > 0;
+        }
+    }
+
+    double getSparsity() const {
+        if(numRows == 0 || numCols == 0)
+            return 0.0;
+        return static_cast<double>(nnz) / numRows / numCols;
+    }
+
+    MncSketch transposed() const {
+        return MncSketch(numCols, numRows, colNnz, rowNnz);
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Construction
+// ----------------------------------------------------------------------------
+
+// Only forward-declared, such that the compiler can use sketches without
+// depending on the runtime's data structures.
+template<typename ValueType> class DenseMatrix;
+template<typename ValueType> class CSRMatrix;
+
+template<typename VT>
+MncSketch createMncSketch(const DenseMatrix<VT> * arg) {
+    const size_t numRows = arg->getNumRows();
+    const size_t numCols = arg->getNumCols();
+    std::vector<size_t> rowNnz(numRows, 0);
+    std::vector<size_t> colNnz(numCols, 0);
+    const VT * valuesArg = arg->getValues();
+    for(size_t r = 0; r < numRows; r++) {
+        size_t n = 0;
+        for(size_t c = 0; c < numCols; c++) {
+            const bool isNonZero = valuesArg[c] != VT(0);
+            n += isNonZero;
+            colNnz[c] += isNonZero;
+        }
+        rowNnz[r] = n;
+        valuesArg += arg->getRowSkip();
+    }
+    return MncSketch(numRows, numCols, std::move(rowNnz), std::move(colNnz));
+}
+
+template<typename VT>
+MncSketch createMncSketch(const CSRMatrix<VT> * arg) {
+    const size_t numRows = arg->getNumRows();
+    const size_t numCols = arg->getNumCols();
+    std::vector<size_t> rowNnz(numRows, 0);
+    std::vector<size_t> colNnz(numCols, 0);
+    for(size_t r = 0; r < numRows; r++) {
+        const size_t n = arg->getNumNonZeros(r);
+        const VT * valuesRow = arg->getValues(r);
+        const size_t * colIdxsRow = arg->getColIdxs(r);
+        // Explicitly stored zeros do not count.
+        for(size_t i = 0; i < n; i++)
+            if(valuesRow[i] != VT(0)) {
+                rowNnz[r]++;
+                colNnz[colIdxsRow[i]]++;
+            }
+    }
+    return MncSketch(numRows, numCols, std::move(rowNnz), std::move(colNnz));
+}
+
+/**
+ * @brief Collects the MNC sketch of a dense matrix from row ranges, which may
+ * be added concurrently, e.g., by the threads writing the matrix to a file.
+ */
+class MncSketchBuilder {
+    size_t numRows;
+    size_t numCols;
+    std::vector<size_t> rowNnz;
+    std::vector<size_t> colNnz;
+    std::mutex mtx;
+
+public:
+    MncSketchBuilder(size_t numRows, size_t numCols) :
+            numRows(numRows), numCols(numCols), rowNnz(numRows, 0), colNnz(numCols, 0) {}
+
+    /**
+     * @brief Counts the non-zeros of the rows `[rowBegin, rowEnd)`.
+     *
+     * Thread-safe as long as the row ranges of concurrent calls are disjoint.
+     *
+     * @param values The values of the matrix (not of row `rowBegin`).
+     * @param rowSkip The distance between two rows in `values`.
+     */
+    template<typename VT>
+    void addRows(const VT * values, size_t rowSkip, size_t rowBegin, size_t rowEnd) {
+        std::vector<size_t> blockColNnz(numCols, 0);
+        for(size_t r = rowBegin; r < rowEnd; r++) {
+            const VT * valuesRow = values + r * rowSkip;
+            size_t n = 0;
+            for(size_t c = 0; c < numCols; c++) {
+                const bool isNonZero = valuesRow[c] != VT(0);
+                n += isNonZero;
+                blockColNnz[c] += isNonZero;
+            }
+            rowNnz[r] = n;
+        }
+        std::lock_guard<std::mutex> lock(mtx);
+        for(size_t c = 0; c < numCols; c++)
+            colNnz[c] += blockColNnz[c];
+    }
+
+    /**
+     * @brief Returns the sketch once all rows have been added; the builder
+     * must not be used afterwards.
+     */
+    MncSketch build() {
+        return MncSketch(numRows, numCols, std::move(rowNnz), std::move(colNnz));
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Estimation and propagation
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Estimates the number of non-zeros of the product `lhs @ rhs`.
+ *
+ * The estimate is exact if each row of `lhs` or each column of `rhs` has at
+ * most one non-zero. Otherwise, the products of the column counts of `lhs`
+ * and the row counts of `rhs` are treated as independent outer products,
+ * which are distributed uniformly over the non-empty rows of `lhs` and the
+ * non-empty columns of `rhs`.
+ */
+inline double estimateNnzMatMul(const MncSketch & lhs, const MncSketch & rhs) {
+    if(lhs.numCols != rhs.numRows)
+        throw std::runtime_error("estimateNnzMatMul: the common dimensions must match");
+    const size_t k = lhs.numCols;
+
+    if(lhs.maxRowNnz <= 1 || rhs.maxColNnz <= 1) {
+        // Each output cell is produced by at most one scalar product.
+        double nnz = 0;
+        for(size_t i = 0; i < k; i++)
+            nnz += static_cast<double>(lhs.colNnz[i]) * rhs.rowNnz[i];
+        return nnz;
+    }
+
+    const double p = static_cast<double>(lhs.numNonEmptyRows) * rhs.numNonEmptyCols;
+    if(p == 0)
+        return 0;
+    // s = 1 - prod_i (1 - lhs.colNnz[i] * rhs.rowNnz[i] / p), in log-space to
+    // avoid underflow.
+    double logZero = 0;
+    for(size_t i = 0; i < k; i++) {
+        const double frac = static_cast<double>(lhs.colNnz[i]) * rhs.rowNnz[i] / p;
+        if(frac >= 1.0)
+            return p;
+        logZero += std::log1p(-frac);
+    }
+    return p * -std::expm1(logZero);
+}
+
+/**
+ * @brief Scales the given histogram such that it sums up to (approximately)
+ * `nnz`, and caps the counts at `maxCount`.
+ */
+inline std::vector<size_t> scaleMncHistogram(const std::vector<size_t> & hist, size_t histNnz, double nnz, size_t maxCount) {
+    std::vector<size_t> res(hist.size(), 0);
+    if(histNnz == 0)
+        return res;
+    const double factor = nnz / histNnz;
+    for(size_t i = 0; i < hist.size(); i++)
+        res[i] = std::min(maxCount, static_cast<size_t>(std::llround(hist[i] * factor)));
+    return res;
+}
+
+/**
+ * @brief Propagates the sketches of `lhs` and `rhs` to a sketch of the
+ * product `lhs @ rhs`, by scaling the row counts of `lhs` and the column
+ * counts of `rhs` to the estimated number of non-zeros.
+ */
+inline MncSketch propagateMncMatMul(const MncSketch & lhs, const MncSketch & rhs) {
+    const double nnz = estimateNnzMatMul(lhs, rhs);
+    return MncSketch(
+            lhs.numRows, rhs.numCols,
+            scaleMncHistogram(lhs.rowNnz, lhs.nnz, nnz, rhs.numCols),
+            scaleMncHistogram(rhs.colNnz, rhs.nnz, nnz, lhs.numRows)
+    );
+}
+
+/**
+ * @brief Propagates the sketches of `lhs` and `rhs` to a sketch of an
+ * element-wise operation of the same shape.
+ *
+ * @param isAnd `true` if the result is zero if either input is zero (e.g.,
+ * multiplication), `false` if it is zero only if both inputs are zero (e.g.,
+ * addition).
+ */
+inline MncSketch propagateMncEw(const MncSketch & lhs, const MncSketch & rhs, bool isAnd) {
+    if(lhs.numRows != rhs.numRows || lhs.numCols != rhs.numCols)
+        throw std::runtime_error("propagateMncEw: the shapes must match");
+    // Within a row (column), the non-zeros of both inputs are assumed to be
+    // distributed uniformly and independently.
+    auto combine = [isAnd](const std::vector<size_t> & a, const std::vector<size_t> & b, size_t n) {
+        std::vector<size_t> res(a.size());
+        for(size_t i = 0; i < a.size(); i++) {
+            const double both = n ? static_cast<double>(a[i]) * b[i] / n : 0.0;
+            const double v = isAnd ? both : a[i] + b[i] - both;
+            res[i] = std::min(n, static_cast<size_t>(std::llround(v)));
+        }
+        return res;
+    };
+    return MncSketch(
+            lhs.numRows, lhs.numCols,
+            combine(lhs.rowNnz, rhs.rowNnz, lhs.numCols),
+            combine(lhs.colNnz, rhs.colNnz, lhs.numRows)
+    );
+}
+
+/**
+ * @brief Propagates the sketches of `lhs` and `rhs` to a sketch of their
+ * row-wise (`rbind`) or column-wise (`cbind`) concatenation, which is exact.
+ */
+inline MncSketch propagateMncBind(const MncSketch & lhs, const MncSketch & rhs, bool isRowBind) {
+    auto concat = [](const std::vector<size_t> & a, const std::vector<size_t> & b) {
+        std::vector<size_t> res(a);
+        res.insert(res.end(), b.begin(), b.end());
+        return res;
+    };
+    auto add = [](const std::vector<size_t> & a, const std::vector<size_t> & b) {
+        if(a.size() != b.size())
+            throw std::runtime_error("propagateMncBind: the shapes must match");
+        std::vector<size_t> res(a.size());
+        for(size_t i = 0; i < a.size(); i++)
+            res[i] = a[i] + b[i];
+        return res;
+    };
+    if(isRowBind)
+        return MncSketch(lhs.numRows + rhs.numRows, lhs.numCols, concat(lhs.rowNnz, rhs.rowNnz), add(lhs.colNnz, rhs.colNnz));
+    return MncSketch(lhs.numRows, lhs.numCols + rhs.numCols, add(lhs.rowNnz, rhs.rowNnz), concat(lhs.colNnz, rhs.colNnz));
+}
+
+/**
+ * @brief Propagates the sketch of `arg` to a sketch of its row-wise
+ * (`isRowAgg`, `numRows x 1`) or column-wise (`1 x numCols`) sum, assuming
+ * that non-zeros do not cancel out.
+ */
+inline MncSketch propagateMncAgg(const MncSketch & arg, bool isRowAgg) {
+    auto nonEmpty = [](const std::vector<size_t> & hist) {
+        std::vector<size_t> res(hist.size());
+        for(size_t i = 0; i < hist.size(); i++)
+            res[i] = hist[i] > 0;
+        return res;
+    };
+    if(isRowAgg)
+        return MncSketch(arg.numRows, 1, nonEmpty(arg.rowNnz), {arg.numNonEmptyRows});
+    return MncSketch(1, arg.numCols, {arg.numNonEmptyCols}, nonEmpty(arg.colNnz));
+}
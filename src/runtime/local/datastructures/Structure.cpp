@@ -21,6 +21,19 @@ Structure::Structure(size_t numRows, size_t numCols) : refCounter(1), numRows(nu
     mdo = std::make_shared<MetaDataObject>();
 };
 
+uint64_t Structure::getLineage() const {
+    static std::atomic<uint64_t> nextId{1};
+    uint64_t l = lineage.load();
+    if(l == 0) {
+        // Unique ids have the most significant bit set, such that they are
+        // unlikely to collide with the hashes of traced lineages.
+        const uint64_t id = nextId.fetch_add(1) | (uint64_t(1) << 63);
+        if(lineage.compare_exchange_strong(l, id))
+            l = id;
+    }
+    return l;
+}
+
 void Structure::clone_mdo(const Structure* src) {
     // FIXME: This clones the meta data to avoid locking (thread synchronization for data copy)
     for(int i = 0; i < static_cast<int>(ALLOCATION_TYPE::NUM_ALLOC_TYPES); i++) {
@@ -19,7 +19,9 @@
 #include <runtime/local/datastructures/DataObjectFactory.h>
 #include <runtime/local/datastructures/MetaDataObject.h>
 
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <mutex>
 
 /**
@@ -30,6 +32,14 @@ class Structure
 private:
     mutable size_t refCounter;
     mutable std::mutex refCounterMutex;
+
+    /**
+     * @brief The lineage of this data object, i.e., a hash of the operation
+     * that produced it and the lineages of its inputs, or a unique id if this
+     * data object was not produced by a kernel that traces lineage (e.g., it
+     * was read from a file). Zero means not yet assigned.
+     */
+    mutable std::atomic<uint64_t> lineage{0};
     
     template<class DataType>
     friend void DataObjectFactory::destroy(const DataType * obj);
@@ -77,6 +87,22 @@ public:
         refCounterMutex.unlock();
     }
     
+    /**
+     * @brief Returns the lineage of this data object (see `LineageCache`).
+     *
+     * If no lineage has been set, a fresh unique id is assigned, such that
+     * data objects of unknown origin never share a lineage.
+     */
+    uint64_t getLineage() const;
+
+    /**
+     * @brief Sets the lineage of this data object; must only be called by the
+     * kernel that produced this data object.
+     */
+    void setLineage(uint64_t lineage) const {
+        this->lineage = lineage;
+    }
+    
     // Note that there is no method for decreasing the reference counter here.
     // Instead, use DataObjectFactory::destroy(). It is important that the
     // reference counter becoming zero triggers the deletion of the data
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <runtime/local/context/DaphneContext.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/datastructures/Matrix.h>
+#include <runtime/local/datastructures/Structure.h>
+#include <runtime/local/io/ReadDaphne.h>
+#include <runtime/local/io/WriteDaphne.h>
+#include <util/BufferManager.h>
+#include <util/KernelThreads.h>
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <cstddef>
+
+// ****************************************************************************
+// Spilling dense matrices
+// ****************************************************************************
+
+template <typename VT> bool spillDenseMatrix(const Structure *obj, const std::string &path) {
+    auto mat = const_cast<DenseMatrix<VT> *>(static_cast<const DenseMatrix<VT> *>(obj));
+    // If the values are shared with other data objects (e.g., views or
+    // frames), spilling would not free any memory, and restoring would break
+    // the sharing (besides the matrix, `values` holds a reference here).
+    {
+        std::shared_ptr<VT[]> values = mat->getValuesSharedPtr();
+        if (!values || values.use_count() > 2)
+            return false;
+    }
+    writeDaphne(mat, path.c_str());
+    mat->replaceValues(nullptr);
+    return true;
+}
+
+template <typename VT> void restoreDenseMatrix(const Structure *obj, const std::string &path) {
+    auto mat = const_cast<DenseMatrix<VT> *>(static_cast<const DenseMatrix<VT> *>(obj));
+    DenseMatrix<VT> *tmp = nullptr;
+    readDaphne(tmp, path.c_str());
+    mat->replaceValues(tmp->getValuesSharedPtr());
+    DataObjectFactory::destroy(tmp);
+}
+
+// ****************************************************************************
+// Arrays of data objects
+// ****************************************************************************
+
+/**
+ * @brief An array of data objects passed to a kernel together with its length
+ * (e.g., the inputs of a vectorized pipeline).
+ */
+template <class DT> struct BufferArray {
+    DT *const *objs;
+    size_t numObjs;
+};
+
+template <class DT> BufferArray<DT> bufferArray(DT **objs, size_t numObjs) { return {objs, numObjs}; }
+
+// ****************************************************************************
+// Buffer access by a kernel
+// ****************************************************************************
+
+/**
+ * @brief Announces the data objects a kernel call accesses to the
+ * `BufferManager`, when --memory-budget is specified by the user.
+ *
+ * Used by the generated kernel wrappers as follows:
+ *
+ * ```
+ * BufferAccess ba(ctx, arg1, arg2, ..., *res);
+ * kernel(*res, arg1, arg2, ..., ctx);
+ * ba.finish(arg1, arg2, ..., *res);
+ * ```
+ *
+ * The constructor restores spilled data objects and protects them from being
+ * spilled during the kernel call. `finish()` tracks the (new) large dense
+ * matrices and releases the tracked data objects that are not referenced
+ * anymore.
+ *
+ * Kernel calls in the bodies of vectorized pipelines are not announced: the
+ * workers access their per-task results outside of any kernel call when
+ * combining them, and the inputs of the pipeline are already protected by the
+ * kernel call of the pipeline itself.
+ */
+class BufferAccess {
+    BufferManager *bm;
+    std::vector<const Structure *> pinned;
+
+    void pinObj(const Structure *obj) {
+        if (obj && bm->pin(obj))
+            pinned.push_back(obj);
+    }
+
+    template <class DT> void pinObj(const BufferArray<DT> &arr) {
+        for (size_t i = 0; i < arr.numObjs; i++)
+            pinObj(arr.objs[i]);
+    }
+
+    // Other data types are not spilled.
+    void trackObj(const Structure *obj) {}
+
+    template <typename VT> void trackObj(const DenseMatrix<VT> *mat) {
+        if constexpr (std::is_arithmetic_v<VT> && !std::is_same_v<VT, bool>) {
+            if (mat == nullptr || mat->isView() || mat->getRowSkip() != mat->getNumCols())
+                return;
+            const size_t bytes = mat->getNumRows() * mat->getNumCols() * sizeof(VT);
+            if (bytes >= BufferManager::MIN_TRACKED_BYTES)
+                bm->track(mat, bytes, &spillDenseMatrix<VT>, &restoreDenseMatrix<VT>);
+        }
+    }
+
+    template <typename VT> void trackObj(const Matrix<VT> *mat) {
+        trackObj(dynamic_cast<const DenseMatrix<VT> *>(mat));
+    }
+
+    template <class DT> void trackObj(const BufferArray<DT> &arr) {
+        for (size_t i = 0; i < arr.numObjs; i++)
+            trackObj(arr.objs[i]);
+    }
+
+    void unpinAll() {
+        for (const Structure *obj : pinned)
+            bm->unpin(obj);
+        pinned.clear();
+    }
+
+  public:
+    template <typename... Args>
+    BufferAccess(DaphneContext *ctx, const Args &...objs)
+        : bm(isVectorizedWorkerThread() ? nullptr : ctx->getUserConfig().buffer_manager) {
+        if (bm)
+            (pinObj(objs), ...);
+    }
+
+    template <typename... Args> void finish(const Args &...objs) {
+        if (!bm)
+            return;
+        (trackObj(objs), ...);
+        unpinAll();
+        bm->releaseUnused();
+    }
+
+    ~BufferAccess() {
+        // The kernel threw an exception.
+        if (bm)
+            unpinAll();
+    }
+
+    BufferAccess(const BufferAccess &) = delete;
+    BufferAccess &operator=(const BufferAccess &) = delete;
+};
@@ -1,13 +1,23 @@
 #include <runtime/local/instrumentation/KernelInstrumentation.h>
+#include <util/PerfCounters.h>
 
 void preKernelInstrumentation(int kId, DaphneContext *ctx)
 {
     if (ctx->getUserConfig().statistics)
         ctx->startKernelTimer(kId);
+    if (ctx->getUserConfig().perf_counters)
+        PerfCounters::instance().startKernel(kId);
+    if (ctx->getUserConfig().enable_tracing)
+        Tracer::instance().beginKernel(kId);
 }
 
-void postKernelInstrumentation(int kId, DaphneContext *ctx)
+void postKernelInstrumentation(int kId, DaphneContext *ctx, std::initializer_list<TracedOperand> operands,
+                               const char *name)
 {
+    if (ctx->getUserConfig().enable_tracing)
+        Tracer::instance().endKernel(kId, operands, name);
+    if (ctx->getUserConfig().perf_counters)
+        PerfCounters::instance().stopKernel(kId);
     if (ctx->getUserConfig().statistics)
         ctx->stopKernelTimer(kId);
 }
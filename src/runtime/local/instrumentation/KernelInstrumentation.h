@@ -1,17 +1,79 @@
+#pragma once
+
 #include <runtime/local/context/DaphneContext.h>
+#include <runtime/local/datastructures/CSRMatrix.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/datastructures/Frame.h>
+#include <runtime/local/datastructures/Structure.h>
+#include <runtime/local/datastructures/ValueTypeUtils.h>
+#include <util/Tracer.h>
 
+#include <initializer_list>
 #include <string>
 
 /**
  * @brief Executes instrumentation code before a kernel is called.
- * Currently only starts the statistics runtime tracking when --statistics is
- * specified by the user.
+ * Starts the statistics runtime tracking when --statistics is specified, the
+ * hardware counters when --perf-counters is specified and the trace event of
+ * the kernel call when --trace is specified by the user.
  */
 void preKernelInstrumentation(int kId, DaphneContext *ctx);
 
 /**
  * @brief Executes instrumentation code after a kernel call returned.
- * Currently only stops the statistics runtime tracking when --statistics is
- * specified by the user.
+ * Stops the statistics runtime tracking when --statistics is specified, the
+ * hardware counters when --perf-counters is specified and records the trace
+ * event of the kernel call when --trace is specified by the user.
+ *
+ * @param operands The data objects the kernel read or wrote (see
+ * `traceOperand`), recorded in the trace event.
+ * @param name A static name for the trace event, for kernels that are not
+ * identified by their kernel ID (e.g., vectorized pipelines).
+ */
+void postKernelInstrumentation(int kId, DaphneContext *ctx,
+                               std::initializer_list<TracedOperand> operands = {},
+                               const char *name = nullptr);
+
+// ****************************************************************************
+// Shapes and sizes of traced operands
+// ****************************************************************************
+
+inline size_t tracedBytes([[maybe_unused]] const Structure *arg) {
+    return 0;
+}
+
+template<typename VT>
+size_t tracedBytes(const DenseMatrix<VT> *arg) {
+    return arg->getNumRows() * arg->getNumCols() * sizeof(VT);
+}
+
+template<typename VT>
+size_t tracedBytes(const CSRMatrix<VT> *arg) {
+    return arg->getNumNonZeros() * (sizeof(VT) + sizeof(size_t)) + (arg->getNumRows() + 1) * sizeof(size_t);
+}
+
+template<typename VT>
+size_t tracedBytes(const Matrix<VT> *arg) {
+    if (auto dense = dynamic_cast<const DenseMatrix<VT> *>(arg))
+        return tracedBytes(dense);
+    if (auto csr = dynamic_cast<const CSRMatrix<VT> *>(arg))
+        return tracedBytes(csr);
+    return 0;
+}
+
+inline size_t tracedBytes(const Frame *arg) {
+    size_t bytes = 0;
+    for (size_t i = 0; i < arg->getNumCols(); i++)
+        bytes += arg->getNumRows() * ValueTypeUtils::sizeOf(arg->getColumnType(i));
+    return bytes;
+}
+
+/**
+ * @brief Extracts the information recorded for a data object in a trace event.
  */
-void postKernelInstrumentation(int kId, DaphneContext *ctx);
+template<class DT>
+TracedOperand traceOperand(const DT *arg) {
+    if (arg == nullptr)
+        return {};
+    return {arg->getNumRows(), arg->getNumCols(), tracedBytes(arg)};
+}
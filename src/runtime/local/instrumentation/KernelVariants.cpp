@@ -0,0 +1,87 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <runtime/local/instrumentation/KernelVariants.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+size_t bucketOf(size_t cells, size_t numBuckets) {
+    size_t bucket = 0;
+    while (cells >>= 1)
+        bucket++;
+    return std::min(bucket, numBuckets - 1);
+}
+} // namespace
+
+KernelVariantSelector::KernelVariantSelector(std::initializer_list<KernelVariantHint> variants)
+    : variants(variants), arms(NUM_BUCKETS, std::vector<Arm>(variants.size())), numCalls(NUM_BUCKETS, 0) {
+    if (this->variants.empty())
+        throw std::runtime_error("KernelVariantSelector: at least one variant is required");
+}
+
+size_t KernelVariantSelector::select(size_t cells, double sparsity) {
+    std::vector<size_t> candidates;
+    for (size_t i = 0; i < variants.size(); i++)
+        if (variants[i].minCells <= cells && cells <= variants[i].maxCells && sparsity <= variants[i].maxSparsity)
+            candidates.push_back(i);
+    // If the hints exclude all variants, fall back to the first one.
+    if (candidates.empty())
+        return 0;
+    if (candidates.size() == 1)
+        return candidates[0];
+
+    const size_t bucket = bucketOf(cells, NUM_BUCKETS);
+    std::lock_guard<std::mutex> lg(mtx);
+    const std::vector<Arm> &bucketArms = arms[bucket];
+    const size_t call = numCalls[bucket]++;
+
+    // Explore each candidate a few times.
+    for (size_t i : candidates)
+        if (bucketArms[i].trials < MIN_TRIALS)
+            return i;
+
+    // Exploit the fastest candidate, but periodically try the least tried
+    // other candidate.
+    size_t best = candidates[0];
+    for (size_t i : candidates)
+        if (bucketArms[i].secondsPerCell < bucketArms[best].secondsPerCell)
+            best = i;
+    if (call % EXPLORATION_PERIOD == EXPLORATION_PERIOD - 1) {
+        size_t other = best;
+        for (size_t i : candidates)
+            if (i != best && (other == best || bucketArms[i].trials < bucketArms[other].trials))
+                other = i;
+        return other;
+    }
+    return best;
+}
+
+void KernelVariantSelector::update(size_t variant, size_t cells, double seconds) {
+    const double secondsPerCell = seconds / std::max<size_t>(cells, 1);
+    std::lock_guard<std::mutex> lg(mtx);
+    Arm &arm = arms[bucketOf(cells, NUM_BUCKETS)][variant];
+    arm.trials++;
+    // Moving average over the recent calls, such that the estimate adapts to
+    // changing conditions.
+    arm.secondsPerCell += (secondsPerCell - arm.secondsPerCell) / std::min(arm.trials, MAX_HISTORY);
+}
+
+size_t KernelVariantSelector::getNumTrials(size_t variant, size_t cells) {
+    std::lock_guard<std::mutex> lg(mtx);
+    return arms[bucketOf(cells, NUM_BUCKETS)][variant].trials;
+}
@@ -0,0 +1,209 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <runtime/local/context/DaphneContext.h>
+#include <runtime/local/datastructures/CSRMatrix.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/datastructures/Frame.h>
+#include <runtime/local/datastructures/Structure.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief A named variant of a kernel together with hints on the regime in
+ * which it may be competitive.
+ *
+ * Outside this regime, the variant is not considered, which avoids measuring
+ * variants that are known to be slow.
+ */
+struct KernelVariantHint {
+    const char *name;
+    /**
+     * @brief The minimum total number of cells of the data objects passed to
+     * the kernel.
+     */
+    size_t minCells;
+    /**
+     * @brief The maximum total number of cells of the data objects passed to
+     * the kernel.
+     */
+    size_t maxCells;
+    /**
+     * @brief The maximum fraction of non-zeros of the data objects passed to
+     * the kernel (dense inputs have a sparsity of one).
+     */
+    double maxSparsity;
+};
+
+/**
+ * @brief Selects one of several variants of a kernel per call, based on the
+ * sizes of its inputs and the measured execution times of past calls.
+ *
+ * The calls are grouped into buckets by the (base-2 logarithm of the) total
+ * number of input cells. Within a bucket, the selection works like a simple
+ * multi-armed bandit: Each variant admissible by its hints is first tried a
+ * few times, then the variant with the lowest average time per cell is
+ * exploited, while the others are still tried periodically to adapt to
+ * changing conditions.
+ *
+ * The generated wrapper of a kernel with variants holds one selector per type
+ * instantiation. All methods may be called concurrently.
+ */
+class KernelVariantSelector {
+    static constexpr size_t NUM_BUCKETS = 64;
+    static constexpr size_t MIN_TRIALS = 2;
+    static constexpr size_t EXPLORATION_PERIOD = 32;
+    static constexpr size_t MAX_HISTORY = 8;
+
+    struct Arm {
+        size_t trials = 0;
+        double secondsPerCell = 0;
+    };
+
+    std::vector<KernelVariantHint> variants;
+    std::vector<std::vector<Arm>> arms;
+    std::vector<size_t> numCalls;
+    std::mutex mtx;
+
+  public:
+    explicit KernelVariantSelector(std::initializer_list<KernelVariantHint> variants);
+
+    size_t getNumVariants() const { return variants.size(); }
+
+    const char *getName(size_t variant) const { return variants[variant].name; }
+
+    /**
+     * @brief Returns the index of the variant to use for a call on inputs
+     * with the given total number of cells and sparsity.
+     */
+    size_t select(size_t cells, double sparsity);
+
+    /**
+     * @brief Records the execution time of a call of the given variant on
+     * inputs with the given total number of cells.
+     */
+    void update(size_t variant, size_t cells, double seconds);
+
+    /**
+     * @brief Returns the number of recorded calls of the given variant in the
+     * bucket of the given number of cells.
+     */
+    size_t getNumTrials(size_t variant, size_t cells);
+};
+
+// ****************************************************************************
+// Input features of a kernel call
+// ****************************************************************************
+
+struct KernelVariantFeatures {
+    size_t cells = 0;
+    size_t nonZeros = 0;
+};
+
+inline void addVariantFeatures(KernelVariantFeatures &f, const Structure *arg) {
+    if (arg == nullptr)
+        return;
+    const size_t cells = arg->getNumRows() * arg->getNumCols();
+    f.cells += cells;
+    f.nonZeros += cells;
+}
+
+template <typename VT> void addVariantFeatures(KernelVariantFeatures &f, const CSRMatrix<VT> *arg) {
+    if (arg == nullptr)
+        return;
+    f.cells += arg->getNumRows() * arg->getNumCols();
+    f.nonZeros += arg->getNumNonZeros();
+}
+
+template <typename VT> void addVariantFeatures(KernelVariantFeatures &f, const Matrix<VT> *arg) {
+    if (auto csr = dynamic_cast<const CSRMatrix<VT> *>(arg))
+        addVariantFeatures(f, csr);
+    else
+        addVariantFeatures(f, static_cast<const Structure *>(arg));
+}
+
+template <typename VT> void addVariantFeatures(KernelVariantFeatures &f, const DenseMatrix<VT> *arg) {
+    addVariantFeatures(f, static_cast<const Structure *>(arg));
+}
+
+inline void addVariantFeatures(KernelVariantFeatures &f, const Frame *arg) {
+    addVariantFeatures(f, static_cast<const Structure *>(arg));
+}
+
+// Scalar arguments do not contribute to the features.
+template <typename VT>
+std::enable_if_t<std::is_arithmetic_v<VT> || std::is_enum_v<VT>>
+addVariantFeatures([[maybe_unused]] KernelVariantFeatures &f, [[maybe_unused]] VT arg) {}
+
+/**
+ * @brief Selects the variant of a single kernel call and records its execution
+ * time afterwards.
+ *
+ * Used by the generated kernel wrappers of kernels with `"variants"` in
+ * `kernels.json` as follows:
+ *
+ * ```
+ * static KernelVariantSelector variants({{"a", ...}, {"b", ...}});
+ * KernelVariantDispatch vd(variants, kId, ctx, arg1, arg2, ...);
+ * switch (vd.select()) {
+ *     case 0: kernelA(...); break;
+ *     case 1: kernelB(...); break;
+ * }
+ * vd.finish();
+ * ```
+ *
+ * The decisions are recorded in the statistics when --statistics is
+ * specified by the user.
+ */
+class KernelVariantDispatch {
+    using Clock = std::chrono::steady_clock;
+
+    KernelVariantSelector &selector;
+    int kId;
+    DaphneContext *ctx;
+    KernelVariantFeatures features;
+    size_t variant = 0;
+    Clock::time_point start;
+
+  public:
+    template <typename... Args>
+    KernelVariantDispatch(KernelVariantSelector &selector, int kId, DaphneContext *ctx, const Args &...args)
+        : selector(selector), kId(kId), ctx(ctx) {
+        (addVariantFeatures(features, args), ...);
+    }
+
+    size_t select() {
+        const double sparsity = features.cells ? static_cast<double>(features.nonZeros) / features.cells : 1.0;
+        variant = selector.select(features.cells, sparsity);
+        if (ctx->getUserConfig().statistics)
+            ctx->stats.recordKernelVariant(kId, selector.getName(variant));
+        start = Clock::now();
+        return variant;
+    }
+
+    void finish() {
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        selector.update(variant, features.cells, seconds);
+    }
+};
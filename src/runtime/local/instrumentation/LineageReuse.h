@@ -0,0 +1,93 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <runtime/local/context/DaphneContext.h>
+#include <runtime/local/instrumentation/KernelInstrumentation.h>
+#include <util/LineageCache.h>
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Reuses the result of a kernel call from the `LineageCache`, or offers
+ * the newly computed result to it, when --lineage-reuse is specified by the
+ * user.
+ *
+ * Used by the generated kernel wrappers of kernels marked with
+ * `"lineageReuse": true` in `kernels.json` as follows:
+ *
+ * ```
+ * LineageReuse lr(ctx, "_kernel__types", arg1, arg2, ...);
+ * if (!lr.tryReuse(res)) {
+ *     kernel(*res, arg1, arg2, ..., ctx);
+ *     lr.store(*res);
+ * }
+ * ```
+ *
+ * Only kernels without side effects, whose results depend solely on their
+ * arguments, may be marked in this way.
+ */
+class LineageReuse {
+    using Clock = std::chrono::steady_clock;
+
+    DaphneContext *ctx;
+    uint64_t lineage = 0;
+    Clock::time_point start;
+
+  public:
+    template <typename... Args>
+    LineageReuse(DaphneContext *ctx, const char *kernelFuncName, const Args &...args) : ctx(ctx) {
+        if (ctx->getUserConfig().use_lineage_reuse && ctx->getUserConfig().lineage_cache) {
+            lineage = lineageOf(kernelFuncName);
+            ((lineage = combineLineage(lineage, lineageOf(args))), ...);
+        }
+    }
+
+    /**
+     * @brief Sets `*res` to the cached result of this kernel call, if any.
+     *
+     * @return `true` if the result was reused, `false` if the kernel must be
+     * executed.
+     */
+    template <class DT> bool tryReuse(DT **res) {
+        if (lineage == 0 || *res != nullptr)
+            return false;
+        if (const Structure *hit = ctx->getUserConfig().lineage_cache->lookup(lineage)) {
+            if (auto cached = dynamic_cast<const DT *>(hit)) {
+                *res = const_cast<DT *>(cached);
+                return true;
+            }
+            DataObjectFactory::destroy(hit);
+        }
+        start = Clock::now();
+        return false;
+    }
+
+    /**
+     * @brief Records the lineage of the computed result and offers it to the
+     * cache.
+     */
+    template <class DT> void store(const DT *res) {
+        if (lineage == 0 || res == nullptr)
+            return;
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        res->setLineage(lineage);
+        ctx->getUserConfig().lineage_cache->put(lineage, res, tracedBytes(res), seconds,
+                                                ctx->getUserConfig().lineage_cache_size);
+    }
+};
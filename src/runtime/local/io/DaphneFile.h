@@ -41,3 +41,25 @@ struct DF_body_block {
 
 enum DF_body_t {empty = 0, dense = 1, sparse = 2, ultra_sparse = 3};
 
+// In files of this version, the values of the single dense block are padded to
+// DF_PAYLOAD_ALIGNMENT bytes, such that they can be memory-mapped and used in
+// place.
+const uint8_t DF_VERSION_ALIGNED = 2;
+const uint64_t DF_PAYLOAD_ALIGNMENT = 64;
+
+inline uint64_t DF_alignedOffset(uint64_t offset) {
+	return (offset + DF_PAYLOAD_ALIGNMENT - 1) / DF_PAYLOAD_ALIGNMENT * DF_PAYLOAD_ALIGNMENT;
+}
+
+// Files of this version consist of the header, a sequence of row blocks (each
+// a DF_body followed by the block), and a block index: one DF_block_index_entry
+// per block followed by the number of blocks (uint64).
+const uint8_t DF_VERSION_BLOCKED = 3;
+
+struct DF_block_index_entry {
+	uint64_t rx; // row index
+	uint64_t cx; // column index
+	uint32_t nbrows;
+	uint32_t nbcols;
+	uint64_t offset; // byte offset of the DF_body_block in the file
+} __attribute__((__packed__));
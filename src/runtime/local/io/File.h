@@ -17,11 +17,16 @@
 #ifndef SRC_RUNTIME_LOCAL_IO_FILE_H
 #define SRC_RUNTIME_LOCAL_IO_FILE_H
 
+#include <runtime/local/io/io_uring/ReadaheadFile.h>
+
 #include <stdio.h>
 #include <stdlib.h>
 
 struct File {
   FILE *identifier;
+  // Files opened for reading are read ahead asynchronously instead of
+  // through `identifier`.
+  ReadaheadFile *readahead;
   unsigned long pos;
   long read;
   char *line;
@@ -32,6 +37,7 @@ inline struct File *openMemFile(FILE *ident){
   struct File *f = (struct File *)malloc(sizeof(struct File));
 
   f->identifier = ident;
+  f->readahead = NULL;
   f->pos = 0;
 
   f->line = NULL;
@@ -43,11 +49,14 @@ inline struct File *openMemFile(FILE *ident){
 inline struct File *openFile(const char *filename) {
   struct File *f = (struct File *)malloc(sizeof(struct File));
 
-  f->identifier = fopen(filename, "r");
+  f->identifier = NULL;
+  f->readahead = ReadaheadFile::open(filename);
   f->pos = 0;
 
-  if (f->identifier == NULL)
+  if (f->readahead == NULL) {
+    free(f);
     return NULL;
+  }
 
   f->line = NULL;
   f->line_len = 0;
@@ -59,6 +68,7 @@ inline struct File *openFileForWrite(const char *filename) {
   struct File *f = (struct File *)malloc(sizeof(struct File));
 
   f->identifier = fopen(filename, "w+");
+  f->readahead = NULL;
   f->pos = 0;
   
   if (f->identifier == NULL)
@@ -71,14 +81,17 @@ inline struct File *openFileForWrite(const char *filename) {
 }
 
 inline void closeFile(File *f) {
-  fclose(f->identifier);
+  if (f->identifier)
+    fclose(f->identifier);
+  delete f->readahead;
   if (f->line) {
     free(f->line);
   }
 }
 
 inline ssize_t getFileLine(File *f) {
-  ssize_t ret = getline(&f->line, &f->line_len, f->identifier);
+  ssize_t ret = f->readahead ? f->readahead->getLine(&f->line, &f->line_len)
+                            : getline(&f->line, &f->line_len, f->identifier);
   f->read = ret;
   f->pos += ret;
 
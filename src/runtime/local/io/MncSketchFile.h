@@ -0,0 +1,130 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <runtime/local/datastructures/MncSketch.h>
+
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+#include <cstring>
+
+// ****************************************************************************
+// MNC sketch files
+// ****************************************************************************
+
+// The histograms of the MNC sketch of a matrix written to `<file>` are stored
+// in the binary file `<file>.mnc` next to the meta data file, since they have
+// one entry per row and column. The file consists of an `MncSketchFileHeader`
+// followed by the row counts and the column counts, each stored with
+// `countBytes` bytes in native byte order.
+
+struct MncSketchFileHeader {
+    char magic[4];
+    uint32_t countBytes;
+    uint64_t numRows;
+    uint64_t numCols;
+};
+
+constexpr char MNC_SKETCH_FILE_MAGIC[4] = {'M', 'N', 'C', '1'};
+
+inline std::string getMncSketchFilename(const std::string & filename) {
+    return filename + ".mnc";
+}
+
+/**
+ * @brief Writes the histograms of the given MNC sketch to the sketch file of
+ * the given file.
+ *
+ * The counts are stored as 32-bit integers if the matrix has less than 2^32
+ * rows and columns.
+ */
+inline void writeMncSketch(const std::string & filename, const MncSketch & sketch) {
+    MncSketchFileHeader h;
+    std::memcpy(h.magic, MNC_SKETCH_FILE_MAGIC, sizeof(h.magic));
+    h.countBytes = (sketch.numRows <= UINT32_MAX && sketch.numCols <= UINT32_MAX) ? sizeof(uint32_t) : sizeof(uint64_t);
+    h.numRows = sketch.numRows;
+    h.numCols = sketch.numCols;
+
+    const std::string sketchFilename = getMncSketchFilename(filename);
+    std::ofstream ofs(sketchFilename, std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!ofs.good())
+        throw std::runtime_error("could not open file '" + sketchFilename + "' for writing MNC sketch");
+    ofs.write(reinterpret_cast<const char *>(&h), sizeof(h));
+    auto writeCounts = [&](const std::vector<size_t> & counts) {
+        if(h.countBytes == sizeof(uint64_t)) {
+            const std::vector<uint64_t> out(counts.begin(), counts.end());
+            ofs.write(reinterpret_cast<const char *>(out.data()), out.size() * sizeof(uint64_t));
+        }
+        else {
+            const std::vector<uint32_t> out(counts.begin(), counts.end());
+            ofs.write(reinterpret_cast<const char *>(out.data()), out.size() * sizeof(uint32_t));
+        }
+    };
+    writeCounts(sketch.rowNnz);
+    writeCounts(sketch.colNnz);
+    if(!ofs.good())
+        throw std::runtime_error("could not write MNC sketch to file '" + sketchFilename + "'");
+}
+
+/**
+ * @brief Reads the MNC sketch from the sketch file of the given file.
+ *
+ * @return The sketch, or null if there is no sketch file.
+ * @throws std::runtime_error Thrown if the sketch file is invalid.
+ */
+inline std::unique_ptr<MncSketch> readMncSketch(const std::string & filename) {
+    const std::string sketchFilename = getMncSketchFilename(filename);
+    std::ifstream ifs(sketchFilename, std::ios::in | std::ios::binary);
+    if(!ifs.good())
+        return nullptr;
+
+    MncSketchFileHeader h;
+    if(!ifs.read(reinterpret_cast<char *>(&h), sizeof(h)) ||
+            std::memcmp(h.magic, MNC_SKETCH_FILE_MAGIC, sizeof(h.magic)) != 0 ||
+            (h.countBytes != sizeof(uint32_t) && h.countBytes != sizeof(uint64_t)))
+        throw std::runtime_error("invalid MNC sketch file '" + sketchFilename + "'");
+    auto readCounts = [&](uint64_t n) {
+        std::vector<size_t> counts(n);
+        if(h.countBytes == sizeof(uint64_t)) {
+            std::vector<uint64_t> in(n);
+            ifs.read(reinterpret_cast<char *>(in.data()), n * sizeof(uint64_t));
+            std::copy(in.begin(), in.end(), counts.begin());
+        }
+        else {
+            std::vector<uint32_t> in(n);
+            ifs.read(reinterpret_cast<char *>(in.data()), n * sizeof(uint32_t));
+            std::copy(in.begin(), in.end(), counts.begin());
+        }
+        if(!ifs)
+            throw std::runtime_error("truncated MNC sketch file '" + sketchFilename + "'");
+        return counts;
+    };
+    std::vector<size_t> rowNnz = readCounts(h.numRows);
+    std::vector<size_t> colNnz = readCounts(h.numCols);
+    auto sketch = std::make_unique<MncSketch>(h.numRows, h.numCols, std::move(rowNnz), std::move(colNnz));
+    size_t colSum = 0;
+    for(size_t n : sketch->colNnz)
+        colSum += n;
+    if(colSum != sketch->nnz)
+        throw std::runtime_error("inconsistent MNC sketch file '" + sketchFilename + "'");
+    return sketch;
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2021 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <util/KernelThreads.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+
+#include <sys/types.h>
+#include <unistd.h>
+
+// ****************************************************************************
+// Helpers for reading and writing files from multiple threads
+// ****************************************************************************
+
+/**
+ * @brief Returns the number of threads to use for I/O if the caller does not
+ * specify it (`0`).
+ */
+inline size_t getNumIOThreads(size_t numThreads = 0) {
+    if(numThreads)
+        return numThreads;
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * @brief Writes exactly `size` bytes at the given offset, retrying on
+ * partial writes.
+ */
+inline void pwriteFully(int fd, const void * buf, size_t size, off_t offset) {
+    const char * ptr = static_cast<const char *>(buf);
+    while(size) {
+        ssize_t n = pwrite(fd, ptr, size, offset);
+        if(n < 0) {
+            if(errno == EINTR)
+                continue;
+            throw std::runtime_error(std::string("pwriteFully: ") + strerror(errno));
+        }
+        ptr += n;
+        size -= n;
+        offset += n;
+    }
+}
+
+/**
+ * @brief Reads exactly `size` bytes at the given offset, retrying on partial
+ * reads; reaching the end of the file before is an error.
+ */
+inline void preadFully(int fd, void * buf, size_t size, off_t offset) {
+    char * ptr = static_cast<char *>(buf);
+    while(size) {
+        ssize_t n = pread(fd, ptr, size, offset);
+        if(n < 0) {
+            if(errno == EINTR)
+                continue;
+            throw std::runtime_error(std::string("preadFully: ") + strerror(errno));
+        }
+        if(n == 0)
+            throw std::runtime_error("preadFully: unexpected end of file");
+        ptr += n;
+        size -= n;
+        offset += n;
+    }
+}
@@ -24,35 +24,70 @@
 
 #include <runtime/local/io/DaphneFile.h>
 #include <runtime/local/io/DaphneSerializer.h>
+#include <runtime/local/io/ParallelIO.h>
 #include <runtime/local/io/utils.h>
+#include <runtime/local/io/io_uring/AsyncIOService.h>
 
 #include <util/preprocessor_defs.h>
 
+#include <algorithm>
 #include <type_traits>
 #include <cstddef>
 #include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <vector>
 #include <stdlib.h>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 // ****************************************************************************
 // Struct for partial template specialization
 // ****************************************************************************
 
 template <class DTRes>
 struct ReadDaphne {
-    static void apply(DTRes *&res, const char *filename) = delete;
+    static void apply(DTRes *&res, const char *filename, bool useMmap = false) = delete;
 };
 
 // ****************************************************************************
 // Convenience function
 // ****************************************************************************
 
+/**
+ * @brief Reads a data object from a file in DAPHNE's binary format.
+ *
+ * @param res The result data object, created if `nullptr`.
+ * @param filename The path of the file.
+ * @param useMmap If `true`, dense matrices are memory-mapped instead of
+ * copied, if the file layout permits (ignored for other data types).
+ */
+template <class DTRes>
+void readDaphne(DTRes *&res, const char *filename, bool useMmap = false) {
+    ReadDaphne<DTRes>::apply(res, filename, useMmap);
+}
+
+/**
+ * @brief Reads only the rows `[rowLowerIncl, rowUpperExcl)` of a dense matrix
+ * from a file in DAPHNE's binary format.
+ *
+ * For files consisting of multiple blocks (see `DF_VERSION_BLOCKED`), only the
+ * blocks overlapping the row range are read, using multiple threads.
+ *
+ * @param res The result matrix, created if `nullptr`.
+ * @param filename The path of the file.
+ * @param rowLowerIncl Inclusive lower bound of the row range.
+ * @param rowUpperExcl Exclusive upper bound of the row range.
+ * @param numThreads The number of threads, `0` for one per hardware thread.
+ */
 template <class DTRes>
-void readDaphne(DTRes *&res, const char *filename) {
-    ReadDaphne<DTRes>::apply(res, filename);
+void readDaphneRows(DTRes *&res, const char *filename, size_t rowLowerIncl, size_t rowUpperExcl, size_t numThreads = 0) {
+    ReadDaphne<DTRes>::applyRows(res, filename, rowLowerIncl, rowUpperExcl, numThreads);
 }
 
 // ****************************************************************************
@@ -61,11 +96,216 @@ void readDaphne(DTRes *&res, const char *filename) {
 
 template <typename VT>
 struct ReadDaphne<DenseMatrix<VT>> {
-    static void apply(DenseMatrix<VT> *&res, const char *filename) {
+    static void apply(DenseMatrix<VT> *&res, const char *filename, bool useMmap = false) {
         std::ifstream f;
         f.open(filename, std::ios::in | std::ios::binary);
-        // TODO: check f.good()
+        if (!f.good())
+            throw std::runtime_error(std::string("ReadDaphne::apply: could not open file ") + filename);
+
+        const size_t headerSize = DaphneSerializer<DenseMatrix<VT>>::HEADER_BUFFER_SIZE;
+        char header[DaphneSerializer<DenseMatrix<VT>>::HEADER_BUFFER_SIZE];
+        f.read(header, headerSize);
+        const size_t bytesRead = f.gcount();
+        if (bytesRead >= sizeof(DF_header) && reinterpret_cast<DF_header *>(header)->version == DF_VERSION_BLOCKED) {
+            f.close();
+            applyRows(res, filename, 0, std::numeric_limits<size_t>::max());
+            return;
+        }
+        if (bytesRead < headerSize || reinterpret_cast<DF_header *>(header)->version < DF_VERSION_ALIGNED) {
+            // The values are not aligned, deserialize the file chunk by chunk.
+            f.clear();
+            f.seekg(0);
+            readChunks(res, f);
+            f.close();
+            return;
+        }
+
+        DF_body_block bb;
+        std::copy(header + sizeof(DF_header) + sizeof(ValueTypeCode) + sizeof(DF_body),
+                  header + sizeof(DF_header) + sizeof(ValueTypeCode) + sizeof(DF_body) + sizeof(DF_body_block),
+                  reinterpret_cast<char *>(&bb));
+        const size_t payloadOffset = DF_alignedOffset(headerSize);
+        const size_t valuesSize = static_cast<size_t>(bb.nbrows) * bb.nbcols * sizeof(VT);
+
+        if (useMmap && res == nullptr && bb.bt == (uint8_t)DF_body_t::dense && valuesSize) {
+            if (DF_Dtype(header) != DF_data_t::DenseMatrix_t || DF_Vtype(header) != ValueTypeUtils::codeFor<VT>)
+                throw std::runtime_error("ReadDaphne::apply: data type or value type mismatch");
+            f.close();
+            res = mapValues(filename, bb.nbrows, bb.nbcols, payloadOffset, valuesSize);
+            return;
+        }
+
+        res = DaphneSerializer<DenseMatrix<VT>>::deserializeHeader(header, res);
+        if (bb.bt == (uint8_t)DF_body_t::dense) {
+            f.seekg(payloadOffset);
+            VT *valuesRes = res->getValues();
+            const size_t rowSkip = res->getRowSkip();
+            if (rowSkip == bb.nbcols) {
+                f.close();
+                readAsync(filename, valuesRes, valuesSize, payloadOffset);
+                return;
+            }
+            else
+                for (size_t r = 0; r < bb.nbrows; r++)
+                    f.read(reinterpret_cast<char *>(valuesRes + r * rowSkip), bb.nbcols * sizeof(VT));
+            if (!f)
+                throw std::runtime_error(std::string("ReadDaphne::apply: unexpected end of file ") + filename);
+        }
+
+        f.close();
+        return;
+    }
+
+    static void applyRows(DenseMatrix<VT> *&res, const char *filename, size_t rowLowerIncl, size_t rowUpperExcl, size_t numThreads = 0) {
+        int fd = open(filename, O_RDONLY);
+        if (fd == -1)
+            throw std::runtime_error(std::string("ReadDaphne::applyRows: could not open file ") + filename);
+        try {
+            DF_header h;
+            ValueTypeCode vt;
+            preadFully(fd, &h, sizeof(h), 0);
+            preadFully(fd, &vt, sizeof(vt), sizeof(h));
+            if (h.dt != (uint8_t)DF_data_t::DenseMatrix_t || vt != ValueTypeUtils::codeFor<VT>)
+                throw std::runtime_error("ReadDaphne::applyRows: data type or value type mismatch");
+            rowUpperExcl = std::min<size_t>(rowUpperExcl, h.nbrows);
+            if (rowLowerIncl > rowUpperExcl)
+                throw std::runtime_error("ReadDaphne::applyRows: invalid row range");
+
+            if (res == nullptr)
+                res = DataObjectFactory::create<DenseMatrix<VT>>(rowUpperExcl - rowLowerIncl, h.nbcols, false);
+            else if (res->getNumRows() != rowUpperExcl - rowLowerIncl || res->getNumCols() != h.nbcols)
+                throw std::runtime_error("ReadDaphne::applyRows: result has wrong dimensions");
+
+            std::vector<DF_block_index_entry> index;
+            if (h.version == DF_VERSION_BLOCKED)
+                index = readBlockIndex(fd);
+            else {
+                // A single block right after the header.
+                DF_block_index_entry e;
+                e.rx = 0;
+                e.cx = 0;
+                e.nbrows = h.nbrows;
+                e.nbcols = h.nbcols;
+                e.offset = sizeof(DF_header) + sizeof(ValueTypeCode) + sizeof(DF_body);
+                index.push_back(e);
+            }
 
+            std::vector<DF_block_index_entry> selected;
+            for (auto &e : index)
+                if (e.rx < rowUpperExcl && e.rx + e.nbrows > rowLowerIncl)
+                    selected.push_back(e);
+
+            VT *valuesRes = res->getValues();
+            const size_t rowSkip = res->getRowSkip();
+            parallelForEach(selected.size(), numThreads, [&](size_t i) {
+                readBlock(fd, h.version, selected[i], rowLowerIncl, rowUpperExcl, valuesRes, rowSkip);
+            });
+        }
+        catch (...) {
+            close(fd);
+            throw;
+        }
+        close(fd);
+    }
+
+private:
+    static std::vector<DF_block_index_entry> readBlockIndex(int fd) {
+        struct stat st;
+        if (fstat(fd, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(uint64_t))
+            throw std::runtime_error("ReadDaphne: could not read block index");
+        uint64_t numBlocks;
+        preadFully(fd, &numBlocks, sizeof(numBlocks), st.st_size - sizeof(numBlocks));
+        if (numBlocks > (st.st_size - sizeof(numBlocks)) / sizeof(DF_block_index_entry))
+            throw std::runtime_error("ReadDaphne: corrupt block index");
+        std::vector<DF_block_index_entry> index(numBlocks);
+        preadFully(fd, index.data(), numBlocks * sizeof(DF_block_index_entry),
+                   st.st_size - sizeof(numBlocks) - numBlocks * sizeof(DF_block_index_entry));
+        return index;
+    }
+
+    /**
+     * @brief Reads the rows of one row block that lie within
+     * `[rowLowerIncl, rowUpperExcl)` into the result values.
+     */
+    static void readBlock(int fd, uint8_t version, const DF_block_index_entry &e, size_t rowLowerIncl, size_t rowUpperExcl, VT *valuesRes, size_t rowSkip) {
+        DF_body_block bb;
+        ValueTypeCode vt;
+        preadFully(fd, &bb, sizeof(bb), e.offset);
+        if (bb.bt != (uint8_t)DF_body_t::empty)
+            preadFully(fd, &vt, sizeof(vt), e.offset + sizeof(bb));
+        if (bb.bt != (uint8_t)DF_body_t::empty && vt != ValueTypeUtils::codeFor<VT>)
+            throw std::runtime_error("ReadDaphne: value type mismatch in block");
+
+        const size_t numCols = bb.nbcols;
+        const size_t rowBegin = std::max<size_t>(e.rx, rowLowerIncl);
+        const size_t rowEnd = std::min<size_t>(e.rx + bb.nbrows, rowUpperExcl);
+        VT *valuesOut = valuesRes + (rowBegin - rowLowerIncl) * rowSkip;
+
+        if (bb.bt == (uint8_t)DF_body_t::empty) {
+            for (size_t r = rowBegin; r < rowEnd; r++, valuesOut += rowSkip)
+                std::fill(valuesOut, valuesOut + numCols, VT(0));
+        }
+        else if (bb.bt == (uint8_t)DF_body_t::dense) {
+            size_t payloadOffset = e.offset + sizeof(bb) + sizeof(vt);
+            if (version == DF_VERSION_ALIGNED)
+                payloadOffset = DF_alignedOffset(payloadOffset);
+            payloadOffset += (rowBegin - e.rx) * numCols * sizeof(VT);
+            if (rowSkip == numCols)
+                AsyncIOService::get().readFully(fd, valuesOut, (rowEnd - rowBegin) * numCols * sizeof(VT), payloadOffset);
+            else
+                for (size_t r = rowBegin; r < rowEnd; r++, valuesOut += rowSkip, payloadOffset += numCols * sizeof(VT))
+                    preadFully(fd, valuesOut, numCols * sizeof(VT), payloadOffset);
+        }
+        else if (bb.bt == (uint8_t)DF_body_t::sparse) {
+            uint64_t nzb;
+            preadFully(fd, &nzb, sizeof(nzb), e.offset + sizeof(bb) + sizeof(vt));
+            std::vector<char> buffer(bb.nbrows * sizeof(uint32_t) + nzb * (sizeof(uint32_t) + sizeof(VT)));
+            preadFully(fd, buffer.data(), buffer.size(), e.offset + sizeof(bb) + sizeof(vt) + sizeof(nzb));
+            const char *in = buffer.data();
+            for (size_t r = e.rx; r < rowEnd; r++) {
+                uint32_t nzr;
+                std::copy(in, in + sizeof(nzr), reinterpret_cast<char *>(&nzr));
+                in += sizeof(nzr);
+                if (r < rowBegin) {
+                    in += nzr * (sizeof(uint32_t) + sizeof(VT));
+                    continue;
+                }
+                std::fill(valuesOut, valuesOut + numCols, VT(0));
+                for (uint32_t i = 0; i < nzr; i++) {
+                    uint32_t cx;
+                    VT v;
+                    std::copy(in, in + sizeof(cx), reinterpret_cast<char *>(&cx));
+                    in += sizeof(cx);
+                    std::copy(in, in + sizeof(v), reinterpret_cast<char *>(&v));
+                    in += sizeof(v);
+                    valuesOut[cx] = v;
+                }
+                valuesOut += rowSkip;
+            }
+        }
+        else
+            throw std::runtime_error("ReadDaphne: unsupported block type");
+    }
+
+    /**
+     * @brief Reads a contiguous range of the file through the
+     * `AsyncIOService`, which issues many requests at once.
+     */
+    static void readAsync(const char *filename, VT *valuesRes, size_t size, size_t offset) {
+        int fd = open(filename, O_RDONLY);
+        if (fd == -1)
+            throw std::runtime_error(std::string("ReadDaphne::apply: could not open file ") + filename);
+        try {
+            AsyncIOService::get().readFully(fd, valuesRes, size, offset);
+        }
+        catch (...) {
+            close(fd);
+            throw;
+        }
+        close(fd);
+    }
+
+    static void readChunks(DenseMatrix<VT> *&res, std::ifstream &f) {
         auto deser = DaphneDeserializerChunks<DenseMatrix<VT>>(&res, DaphneSerializer<DenseMatrix<VT>>::DEFAULT_SERIALIZATION_BUFFER_SIZE);
         for (auto it = deser.begin(); it != deser.end(); ++it) {
             it->first = DaphneSerializer<DenseMatrix<VT>>::DEFAULT_SERIALIZATION_BUFFER_SIZE;
@@ -73,15 +313,41 @@ struct ReadDaphne<DenseMatrix<VT>> {
             // in case we read less than that
             it->first = f.gcount();
         }
+    }
 
-        f.close();
-        return;
+    /**
+     * @brief Creates a `DenseMatrix` directly over a private (copy-on-write)
+     * mapping of the file, which is unmapped when the last reference to the
+     * values is gone.
+     */
+    static DenseMatrix<VT> *mapValues(const char *filename, size_t numRows, size_t numCols, size_t payloadOffset, size_t valuesSize) {
+        int fd = open(filename, O_RDONLY);
+        if (fd == -1)
+            throw std::runtime_error(std::string("ReadDaphne::apply: could not open file ") + filename);
+        struct stat st;
+        if (fstat(fd, &st) == -1 || static_cast<size_t>(st.st_size) < payloadOffset + valuesSize) {
+            close(fd);
+            throw std::runtime_error(std::string("ReadDaphne::apply: unexpected end of file ") + filename);
+        }
+
+        const size_t mappedSize = payloadOffset + valuesSize;
+        // MAP_PRIVATE: writes to the matrix go to private copies of the pages and never reach the file.
+        void *mapped = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED)
+            throw std::runtime_error(std::string("ReadDaphne::apply: could not map file ") + filename);
+
+        std::shared_ptr<VT[]> values(
+            reinterpret_cast<VT *>(static_cast<char *>(mapped) + payloadOffset),
+            [mapped, mappedSize](VT *) { munmap(mapped, mappedSize); }
+        );
+        return DataObjectFactory::create<DenseMatrix<VT>>(numRows, numCols, values);
     }
 };
 
 template <typename VT>
 struct ReadDaphne<CSRMatrix<VT>> {
-    static void apply(CSRMatrix<VT> *&res, const char *filename) {
+    static void apply(CSRMatrix<VT> *&res, const char *filename, bool useMmap = false) {
         std::ifstream f;
         f.open(filename, std::ios::in | std::ios::binary);
         // TODO: check f.good()
@@ -101,7 +367,7 @@ struct ReadDaphne<CSRMatrix<VT>> {
 
 template <>
 struct ReadDaphne<Frame> {
-    static void apply(Frame *&res, const char *filename) {
+    static void apply(Frame *&res, const char *filename, bool useMmap = false) {
         std::ifstream f;
         f.open(filename, std::ios::in | std::ios::binary);
         // TODO: check f.good()
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2021 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/io/File.h>
+#include <runtime/local/io/ReadCsvFile.h>
+#include <runtime/local/io/ReadDaphne.h>
+
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+#include <string>
+
+#include <cstddef>
+
+// ****************************************************************************
+// Reading a file as a sequence of row chunks
+// ****************************************************************************
+
+/**
+ * @brief Reads a dense matrix stored in a CSV file or a DAPHNE binary file
+ * (`.dbdf`) as a sequence of chunks of consecutive rows.
+ *
+ * While the caller works on one chunk, the next chunk is already read in the
+ * background, such that at most two chunks are held by the reader at any time.
+ * The chunks are handed over to the caller, who must destroy them.
+ */
+template<typename VT>
+class RowChunkReader {
+    const std::string filename;
+    const size_t numRows;
+    const size_t numCols;
+    const size_t chunkRows;
+    const char delim;
+    const bool isDaphneFile;
+
+    File * file = nullptr;
+
+    /**
+     * @brief The first row of the chunk that will be read next.
+     */
+    size_t nextRow = 0;
+
+    /**
+     * @brief The first row of the chunk that is being read in the background.
+     */
+    size_t prefetchedRow = 0;
+    std::future<DenseMatrix<VT> *> prefetched;
+
+    DenseMatrix<VT> * readChunk(size_t rowLowerIncl, size_t rowUpperExcl) {
+        DenseMatrix<VT> * chunk = nullptr;
+        if(isDaphneFile)
+            readDaphneRows(chunk, filename.c_str(), rowLowerIncl, rowUpperExcl, 1);
+        else {
+            // CSV rows are read sequentially, so the chunks must be requested
+            // in order, which is guaranteed by prefetch().
+            chunk = DataObjectFactory::create<DenseMatrix<VT>>(rowUpperExcl - rowLowerIncl, numCols, false);
+            readCsvFile(chunk, file, rowUpperExcl - rowLowerIncl, numCols, delim);
+        }
+        return chunk;
+    }
+
+    void prefetch() {
+        if(nextRow >= numRows)
+            return;
+        const size_t rowLowerIncl = nextRow;
+        const size_t rowUpperExcl = std::min(numRows, nextRow + chunkRows);
+        nextRow = rowUpperExcl;
+        prefetchedRow = rowLowerIncl;
+        prefetched = std::async(std::launch::async, [this, rowLowerIncl, rowUpperExcl]() {
+            return readChunk(rowLowerIncl, rowUpperExcl);
+        });
+    }
+
+public:
+    RowChunkReader(const char * filename, size_t numRows, size_t numCols, size_t chunkRows, char delim = ',')
+            : filename(filename), numRows(numRows), numCols(numCols), chunkRows(chunkRows), delim(delim),
+              isDaphneFile(this->filename.size() >= 5 &&
+                           this->filename.compare(this->filename.size() - 5, 5, ".dbdf") == 0) {
+        if(chunkRows == 0)
+            throw std::runtime_error("RowChunkReader: chunkRows must be > 0");
+        if(numCols == 0)
+            throw std::runtime_error("RowChunkReader: numCols must be > 0");
+        if(!isDaphneFile) {
+            file = openFile(filename);
+            if(file == nullptr)
+                throw std::runtime_error(std::string("RowChunkReader: could not open file ") + filename);
+        }
+        prefetch();
+    }
+
+    RowChunkReader(const RowChunkReader &) = delete;
+    RowChunkReader & operator=(const RowChunkReader &) = delete;
+
+    ~RowChunkReader() {
+        if(prefetched.valid()) {
+            try {
+                DataObjectFactory::destroy(prefetched.get());
+            }
+            catch(...) {
+                // The error is irrelevant if the caller stopped early.
+            }
+        }
+        if(file)
+            closeFile(file);
+    }
+
+    /**
+     * @brief Returns the next chunk of rows, or `nullptr` if all rows have
+     * been returned.
+     *
+     * @param rowOffset Set to the index of the first row of the returned chunk
+     * within the whole matrix.
+     */
+    DenseMatrix<VT> * next(size_t & rowOffset) {
+        if(!prefetched.valid())
+            return nullptr;
+        DenseMatrix<VT> * chunk = prefetched.get();
+        rowOffset = prefetchedRow;
+        prefetch();
+        return chunk;
+    }
+};
@@ -20,12 +20,18 @@
 #include <runtime/local/datastructures/DataObjectFactory.h>
 #include <runtime/local/datastructures/DenseMatrix.h>
 #include <runtime/local/datastructures/Frame.h>
+#include <runtime/local/datastructures/MncSketch.h>
 
 #include <runtime/local/io/File.h>
+#include <runtime/local/io/ParallelIO.h>
 #include <runtime/local/io/utils.h>
 
+#include <spdlog/fmt/fmt.h>
+
+#include <algorithm>
 #include <stdexcept>
 #include <type_traits>
+#include <vector>
 
 #include <cstddef>
 #include <cstdint>
@@ -34,22 +40,102 @@
 #include <sstream>
 #include <stdexcept>
 
+// ****************************************************************************
+// Helper functions
+// ****************************************************************************
+
+/**
+ * @brief The number of cells formatted as one unit of work by `writeCsvRows`.
+ */
+const size_t CSV_WRITE_BLOCK_CELLS = 1 << 18;
+
+/**
+ * @brief Appends the CSV representation of a single value to `buf`.
+ *
+ * Floating-point values are formatted like `%f` by default, or with the
+ * shortest representation that parses back to the same value if
+ * `fullPrecision` is set.
+ */
+template <typename VT>
+inline void formatCsvValue(fmt::memory_buffer &buf, VT val, bool fullPrecision) {
+    if constexpr (std::is_floating_point<VT>::value) {
+        if (fullPrecision)
+            fmt::format_to(fmt::appender(buf), "{}", val);
+        else
+            fmt::format_to(fmt::appender(buf), "{:.6f}", val);
+    }
+    else if constexpr (std::is_same<VT, int8_t>::value || std::is_same<VT, uint8_t>::value)
+        // Conversion to int32 for formating as number as opposed to character.
+        fmt::format_to(fmt::appender(buf), "{}", static_cast<int32_t>(val));
+    else
+        fmt::format_to(fmt::appender(buf), "{}", val);
+}
+
+/**
+ * @brief Writes `numRows` rows to `file`.
+ *
+ * Blocks of rows are formatted concurrently into thread-local buffers, which
+ * are then written to the file in order, one large write per block.
+ *
+ * @param file The file to write to.
+ * @param numRows The number of rows.
+ * @param numCols The number of columns, used to size the blocks.
+ * @param numThreads The number of threads, `0` for one per hardware thread.
+ * @param formatRow Appends row `r` including the line break to a buffer, must
+ * be callable as `formatRow(fmt::memory_buffer &, size_t r)`.
+ * @param blockDone Called as `blockDone(rowBegin, rowEnd)` by the thread that
+ * formatted the rows `[rowBegin, rowEnd)`, e.g., to collect statistics on
+ * them while they are in the cache.
+ */
+template <typename FormatRow, typename BlockDone = void (*)(size_t, size_t)>
+void writeCsvRows(File *file, size_t numRows, size_t numCols, size_t numThreads, FormatRow formatRow,
+                  BlockDone blockDone = [](size_t, size_t) {}) {
+    numThreads = getNumIOThreads(numThreads);
+    const size_t rowsPerBlock = std::max<size_t>(1, CSV_WRITE_BLOCK_CELLS / std::max<size_t>(1, numCols));
+    std::vector<fmt::memory_buffer> buffers(numThreads);
+
+    for (size_t firstRow = 0; firstRow < numRows; firstRow += numThreads * rowsPerBlock) {
+        const size_t numBlocks = std::min(numThreads, (numRows - firstRow + rowsPerBlock - 1) / rowsPerBlock);
+        parallelForEach(numBlocks, numThreads, [&](size_t b) {
+            fmt::memory_buffer &buf = buffers[b];
+            buf.clear();
+            const size_t rowBegin = firstRow + b * rowsPerBlock;
+            const size_t rowEnd = std::min(rowBegin + rowsPerBlock, numRows);
+            for (size_t r = rowBegin; r < rowEnd; r++)
+                formatRow(buf, r);
+            blockDone(rowBegin, rowEnd);
+        });
+        for (size_t b = 0; b < numBlocks; b++)
+            if (fwrite(buffers[b].data(), 1, buffers[b].size(), file->identifier) != buffers[b].size())
+                throw std::runtime_error("WriteCsv: could not write to file");
+    }
+}
+
 // ****************************************************************************
 // Struct for partial template specialization
 // ****************************************************************************
 
 template <class DTArg>
 struct WriteCsv {
-    static void apply(const DTArg *arg, File *file) = delete;
+    static void apply(const DTArg *arg, File *file, bool fullPrecision = false, size_t numThreads = 0) = delete;
 };
 
 // ****************************************************************************
 // Convenience function
 // ****************************************************************************
 
+/**
+ * @brief Writes a data object to a CSV file.
+ *
+ * @param arg The data object.
+ * @param file The file to write to.
+ * @param fullPrecision Whether floating-point values shall be written with
+ * all significant digits instead of six decimal places.
+ * @param numThreads The number of threads, `0` for one per hardware thread.
+ */
 template <class DTArg>
-void writeCsv(const DTArg *arg, File *file) {
-    WriteCsv<DTArg>::apply(arg, file);
+void writeCsv(const DTArg *arg, File *file, bool fullPrecision = false, size_t numThreads = 0) {
+    WriteCsv<DTArg>::apply(arg, file, fullPrecision, numThreads);
 }
 
 // ****************************************************************************
@@ -62,28 +148,30 @@ void writeCsv(const DTArg *arg, File *file) {
 
 template <typename VT>
 struct WriteCsv<DenseMatrix<VT>> {
-    static void apply(const DenseMatrix<VT> *arg, File* file) {
+    /**
+     * @param sketch If not null, collects the MNC sketch of `arg` while
+     * writing it.
+     */
+    static void apply(const DenseMatrix<VT> *arg, File* file, bool fullPrecision = false, size_t numThreads = 0,
+                      MncSketchBuilder *sketch = nullptr) {
         if (file == nullptr)
             throw std::runtime_error("WriteCsv: requires a file to be specified (must not be nullptr)");
         const VT * valuesArg = arg->getValues();
         const size_t rowSkip = arg->getRowSkip();
         const size_t argNumCols = arg->getNumCols();
 
-        for (size_t i = 0; i < arg->getNumRows(); ++i)
-        {
-            for(size_t j = 0; j < argNumCols; ++j)
-            {
-                fprintf(
-                        file->identifier,
-                        std::is_floating_point<VT>::value ? "%f" : (std::is_same<VT, long int>::value ? "%ld" : "%d"),
-                        valuesArg[i*rowSkip + j]
-                );
-                if(j < (arg->getNumCols() - 1))
-                    fprintf(file->identifier, ",");
-                else
-                    fprintf(file->identifier, "\n");
+        auto formatRow = [&](fmt::memory_buffer &buf, size_t i) {
+            const VT * row = valuesArg + i * rowSkip;
+            for(size_t j = 0; j < argNumCols; ++j) {
+                formatCsvValue(buf, row[j], fullPrecision);
+                buf.push_back(j < argNumCols - 1 ? ',' : '\n');
             }
-        }
+        };
+        if (sketch)
+            writeCsvRows(file, arg->getNumRows(), argNumCols, numThreads, formatRow,
+                         [&](size_t rowBegin, size_t rowEnd) { sketch->addRows(valuesArg, rowSkip, rowBegin, rowEnd); });
+        else
+            writeCsvRows(file, arg->getNumRows(), argNumCols, numThreads, formatRow);
    }
 };
 
@@ -92,35 +180,34 @@ struct WriteCsv<DenseMatrix<VT>> {
 // ----------------------------------------------------------------------------
 
 template <> struct WriteCsv<Frame> {
-    static void apply(const Frame * arg, File * file) {
+    static void apply(const Frame * arg, File * file, bool fullPrecision = false, size_t numThreads = 0) {
 
     if (file == nullptr)
         throw std::runtime_error("WriteCsv: requires a file to be specified (must not be nullptr)");
 
-    for(size_t i = 0; i < arg->getNumRows(); ++i) {
-        for(size_t j = 0; j < arg->getNumCols(); ++j) {
-            const void* array = arg->getColumnRaw(j);
-            ValueTypeCode vtc = arg->getColumnType(j);
-            switch(vtc) {
-                // Conversion int8->int32 for formating as number as opposed to character.
-                case ValueTypeCode::SI8:  fprintf(file->identifier, "%" PRId8, static_cast<int32_t>(reinterpret_cast<const int8_t *>(array)[i])); break;
-                case ValueTypeCode::SI32: fprintf(file->identifier, "%" PRId32, reinterpret_cast<const int32_t *>(array)[i]); break;
-                case ValueTypeCode::SI64: fprintf(file->identifier, "%" PRId64, reinterpret_cast<const int64_t *>(array)[i]); break;
-                // Conversion uint8->uint32 for formating as number as opposed to character.
-                case ValueTypeCode::UI8:  fprintf(file->identifier, "%" PRIu8, static_cast<uint32_t>(reinterpret_cast<const uint8_t *>(array)[i])); break;
-                case ValueTypeCode::UI32: fprintf(file->identifier, "%" PRIu32, reinterpret_cast<const uint32_t *>(array)[i]); break;
-                case ValueTypeCode::UI64: fprintf(file->identifier, "%" PRIu64, reinterpret_cast<const uint64_t *>(array)[i]); break;
-                case ValueTypeCode::F32: fprintf(file->identifier, "%f", reinterpret_cast<const float  *>(array)[i]); break;
-                case ValueTypeCode::F64: fprintf(file->identifier, "%f", reinterpret_cast<const double *>(array)[i]); break;
+    const size_t numCols = arg->getNumCols();
+    std::vector<const void *> arrays(numCols);
+    for(size_t j = 0; j < numCols; ++j)
+        arrays[j] = arg->getColumnRaw(j);
+    const ValueTypeCode * schema = arg->getSchema();
+
+    writeCsvRows(file, arg->getNumRows(), numCols, numThreads, [&](fmt::memory_buffer &buf, size_t i) {
+        for(size_t j = 0; j < numCols; ++j) {
+            const void* array = arrays[j];
+            switch(schema[j]) {
+                case ValueTypeCode::SI8:  formatCsvValue(buf, reinterpret_cast<const int8_t *>(array)[i], fullPrecision); break;
+                case ValueTypeCode::SI32: formatCsvValue(buf, reinterpret_cast<const int32_t *>(array)[i], fullPrecision); break;
+                case ValueTypeCode::SI64: formatCsvValue(buf, reinterpret_cast<const int64_t *>(array)[i], fullPrecision); break;
+                case ValueTypeCode::UI8:  formatCsvValue(buf, reinterpret_cast<const uint8_t *>(array)[i], fullPrecision); break;
+                case ValueTypeCode::UI32: formatCsvValue(buf, reinterpret_cast<const uint32_t *>(array)[i], fullPrecision); break;
+                case ValueTypeCode::UI64: formatCsvValue(buf, reinterpret_cast<const uint64_t *>(array)[i], fullPrecision); break;
+                case ValueTypeCode::F32: formatCsvValue(buf, reinterpret_cast<const float  *>(array)[i], fullPrecision); break;
+                case ValueTypeCode::F64: formatCsvValue(buf, reinterpret_cast<const double *>(array)[i], fullPrecision); break;
                 default: throw std::runtime_error("unknown value type code");
             }
-
-            if(j < (arg->getNumCols() - 1))
-                fprintf(file->identifier, ",");
-            else
-                fprintf(file->identifier, "\n");
+            buf.push_back(j < numCols - 1 ? ',' : '\n');
         }
-    }
+    });
 }
 
 };
@@ -131,26 +218,19 @@ template <> struct WriteCsv<Frame> {
 
 template <typename VT>
 struct WriteCsv<Matrix<VT>> {
-    static void apply(const Matrix<VT> *arg, File* file) {
+    static void apply(const Matrix<VT> *arg, File* file, bool fullPrecision = false, size_t numThreads = 0) {
         if (file == nullptr)
             throw std::runtime_error("WriteCsv: File required");
 
-        const size_t numRows = arg->getNumRows();
         const size_t numCols = arg->getNumCols();
 
-        for (size_t r = 0; r < numRows; ++r) {
+        // Single-threaded, since get() is not guaranteed to be safe for concurrent use.
+        writeCsvRows(file, arg->getNumRows(), numCols, 1, [&](fmt::memory_buffer &buf, size_t r) {
             for (size_t c = 0; c < numCols; ++c) {
-                fprintf(
-                        file->identifier,
-                        std::is_floating_point<VT>::value ? "%f" : (std::is_same<VT, long int>::value ? "%ld" : "%d"),
-                        arg->get(r, c)
-                );
-                if (c < (numCols - 1))
-                    fprintf(file->identifier, ",");
-                else
-                    fprintf(file->identifier, "\n");
+                formatCsvValue(buf, arg->get(r, c), fullPrecision);
+                buf.push_back(c < numCols - 1 ? ',' : '\n');
             }
-        }
+        });
    }
 };
   
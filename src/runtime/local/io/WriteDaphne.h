@@ -21,13 +21,17 @@
 #include <runtime/local/datastructures/DenseMatrix.h>
 #include <runtime/local/datastructures/CSRMatrix.h>
 #include <runtime/local/datastructures/Frame.h>
+#include <runtime/local/datastructures/MncSketch.h>
 #include <runtime/local/datastructures/ValueTypeUtils.h>
 
 #include <runtime/local/io/utils.h>
 #include <runtime/local/io/DaphneFile.h>
 #include <runtime/local/io/DaphneSerializer.h>
+#include <runtime/local/io/ParallelIO.h>
 
+#include <algorithm>
 #include <type_traits>
+#include <vector>
 
 #include <cstddef>
 #include <cstdint>
@@ -36,6 +40,9 @@
 #include <limits>
 #include <stdlib.h>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 // ****************************************************************************
 // Struct for partial template specialization
 // ****************************************************************************
@@ -54,6 +61,24 @@ void writeDaphne(const DTArg *arg, const char *filename) {
     WriteDaphne<DTArg>::apply(arg, filename);
 }
 
+/**
+ * @brief Writes a dense matrix as a sequence of row blocks followed by a block
+ * index (see `DF_VERSION_BLOCKED`), using multiple threads.
+ *
+ * @param arg The matrix to write.
+ * @param filename The path of the file.
+ * @param rowsPerBlock The number of rows per block (the last block may have
+ * fewer).
+ * @param numThreads The number of threads, `0` for one per hardware thread.
+ * @param sketch If not null, collects the MNC sketch of `arg` while writing
+ * it.
+ */
+template <class DTArg>
+void writeDaphneBlocked(const DTArg *arg, const char *filename, size_t rowsPerBlock, size_t numThreads = 0,
+                        MncSketchBuilder *sketch = nullptr) {
+    WriteDaphne<DTArg>::applyBlocked(arg, filename, rowsPerBlock, numThreads, sketch);
+}
+
 // ****************************************************************************
 // (Partial) template specializations for different data/value types
 // ****************************************************************************
@@ -67,16 +92,165 @@ struct WriteDaphne<DenseMatrix<VT>> {
     static void apply(const DenseMatrix<VT> *arg, const char *filename) {
         std::ofstream f;
         f.open(filename, std::ios::out | std::ios::binary);
-        // TODO: check f.good()
+        if (!f.good())
+            throw std::runtime_error(std::string("WriteDaphne::apply: could not open file ") + filename);
 
-        auto ser = DaphneSerializerChunks<const DenseMatrix<VT>>(arg, DaphneSerializer<DenseMatrix<VT>>::DEFAULT_SERIALIZATION_BUFFER_SIZE);
-        for (auto it = ser.begin(); it != ser.end(); ++it) {
-            f.write(it->second->data(), it->first);
-        }
+        // Same header as for the serialization, but the values are padded to
+        // an aligned offset, such that ReadDaphne can map them in place.
+        const size_t headerSize = DaphneSerializer<DenseMatrix<VT>>::HEADER_BUFFER_SIZE;
+        char header[DaphneSerializer<DenseMatrix<VT>>::HEADER_BUFFER_SIZE];
+        DaphneSerializer<DenseMatrix<VT>>::serializeHeader(arg, header);
+        reinterpret_cast<DF_header *>(header)->version = DF_VERSION_ALIGNED;
+        f.write(header, headerSize);
+
+        const char padding[DF_PAYLOAD_ALIGNMENT] = {};
+        f.write(padding, DF_alignedOffset(headerSize) - headerSize);
+
+        const size_t numRows = arg->getNumRows();
+        const size_t numCols = arg->getNumCols();
+        const size_t rowSkip = arg->getRowSkip();
+        const VT *valuesArg = arg->getValues();
+        if (rowSkip == numCols)
+            f.write(reinterpret_cast<const char *>(valuesArg), numRows * numCols * sizeof(VT));
+        else
+            for (size_t r = 0; r < numRows; r++)
+                f.write(reinterpret_cast<const char *>(valuesArg + r * rowSkip), numCols * sizeof(VT));
 
         f.close();
         return;
     }
+
+    static void applyBlocked(const DenseMatrix<VT> *arg, const char *filename, size_t rowsPerBlock, size_t numThreads = 0,
+                             MncSketchBuilder *sketch = nullptr) {
+        if (rowsPerBlock == 0)
+            throw std::runtime_error("WriteDaphne::applyBlocked: the number of rows per block must be positive");
+        const size_t numRows = arg->getNumRows();
+        const size_t numCols = arg->getNumCols();
+        if (numCols > std::numeric_limits<uint32_t>::max() || rowsPerBlock > std::numeric_limits<uint32_t>::max())
+            throw std::runtime_error("WriteDaphne::applyBlocked: blocks must not exceed 2^32-1 rows/columns");
+        const size_t numBlocks = (numRows + rowsPerBlock - 1) / rowsPerBlock;
+        const VT *valuesArg = arg->getValues();
+        const size_t rowSkip = arg->getRowSkip();
+
+        // Each block is represented as dense or sparse, whichever is smaller,
+        // which requires the number of non-zeros per block.
+        std::vector<size_t> numNonZeros(numBlocks);
+        parallelForEach(numBlocks, numThreads, [&](size_t b) {
+            const size_t rowBegin = b * rowsPerBlock;
+            const size_t rowEnd = std::min(rowBegin + rowsPerBlock, numRows);
+            size_t nnz = 0;
+            for (size_t r = rowBegin; r < rowEnd; r++)
+                for (size_t c = 0; c < numCols; c++)
+                    nnz += valuesArg[r * rowSkip + c] != VT(0);
+            numNonZeros[b] = nnz;
+            if (sketch)
+                sketch->addRows(valuesArg, rowSkip, rowBegin, rowEnd);
+        });
+
+        std::vector<DF_block_index_entry> index(numBlocks);
+        size_t offset = sizeof(DF_header) + sizeof(ValueTypeCode);
+        for (size_t b = 0; b < numBlocks; b++) {
+            const size_t blockRows = std::min(rowsPerBlock, numRows - b * rowsPerBlock);
+            index[b].rx = b * rowsPerBlock;
+            index[b].cx = 0;
+            index[b].nbrows = static_cast<uint32_t>(blockRows);
+            index[b].nbcols = static_cast<uint32_t>(numCols);
+            index[b].offset = offset + sizeof(DF_body);
+            offset += sizeof(DF_body) + blockLength(blockRows, numCols, numNonZeros[b]);
+        }
+
+        int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd == -1)
+            throw std::runtime_error(std::string("WriteDaphne::applyBlocked: could not open file ") + filename);
+        try {
+            DF_header h;
+            h.version = DF_VERSION_BLOCKED;
+            h.dt = (uint8_t)DF_data_t::DenseMatrix_t;
+            h.nbrows = (uint64_t)numRows;
+            h.nbcols = (uint64_t)numCols;
+            const ValueTypeCode vt = ValueTypeUtils::codeFor<VT>;
+            pwriteFully(fd, &h, sizeof(h), 0);
+            pwriteFully(fd, &vt, sizeof(vt), sizeof(h));
+
+            parallelForEach(numBlocks, numThreads, [&](size_t b) {
+                std::vector<char> buffer(sizeof(DF_body) + blockLength(index[b].nbrows, numCols, numNonZeros[b]));
+                serializeBlock(valuesArg + index[b].rx * rowSkip, rowSkip, index[b], numNonZeros[b], buffer.data());
+                pwriteFully(fd, buffer.data(), buffer.size(), index[b].offset - sizeof(DF_body));
+            });
+
+            const uint64_t numBlocksOut = numBlocks;
+            pwriteFully(fd, index.data(), numBlocks * sizeof(DF_block_index_entry), offset);
+            pwriteFully(fd, &numBlocksOut, sizeof(numBlocksOut), offset + numBlocks * sizeof(DF_block_index_entry));
+        }
+        catch (...) {
+            close(fd);
+            throw;
+        }
+        close(fd);
+    }
+
+private:
+    static bool isSparse(size_t numRows, size_t numCols, size_t numNonZeros) {
+        return sizeof(uint64_t) + numRows * sizeof(uint32_t) + numNonZeros * (sizeof(uint32_t) + sizeof(VT))
+            < numRows * numCols * sizeof(VT);
+    }
+
+    /**
+     * @brief The byte length of a block including its block header.
+     */
+    static size_t blockLength(size_t numRows, size_t numCols, size_t numNonZeros) {
+        size_t len = sizeof(DF_body_block) + sizeof(ValueTypeCode);
+        if (isSparse(numRows, numCols, numNonZeros))
+            len += sizeof(uint64_t) + numRows * sizeof(uint32_t) + numNonZeros * (sizeof(uint32_t) + sizeof(VT));
+        else
+            len += numRows * numCols * sizeof(VT);
+        return len;
+    }
+
+    /**
+     * @brief Serializes the block position, block header and values of one
+     * row block (starting at `valuesArg`) into `buffer`.
+     */
+    static void serializeBlock(const VT *valuesArg, size_t rowSkip, const DF_block_index_entry &e, size_t numNonZeros, char *buffer) {
+        const size_t numCols = e.nbcols;
+        const bool sparse = isSparse(e.nbrows, numCols, numNonZeros);
+
+        DF_body b;
+        b.rx = e.rx;
+        b.cx = e.cx;
+        DF_body_block bb;
+        bb.nbrows = e.nbrows;
+        bb.nbcols = e.nbcols;
+        bb.bt = (uint8_t)(sparse ? DF_body_t::sparse : DF_body_t::dense);
+        const ValueTypeCode vt = ValueTypeUtils::codeFor<VT>;
+        buffer = std::copy(reinterpret_cast<const char *>(&b), reinterpret_cast<const char *>(&b) + sizeof(b), buffer);
+        buffer = std::copy(reinterpret_cast<const char *>(&bb), reinterpret_cast<const char *>(&bb) + sizeof(bb), buffer);
+        buffer = std::copy(reinterpret_cast<const char *>(&vt), reinterpret_cast<const char *>(&vt) + sizeof(vt), buffer);
+
+        if (!sparse) {
+            for (size_t r = 0; r < e.nbrows; r++, valuesArg += rowSkip)
+                buffer = std::copy(reinterpret_cast<const char *>(valuesArg),
+                                   reinterpret_cast<const char *>(valuesArg + numCols), buffer);
+            return;
+        }
+
+        const uint64_t nzb = numNonZeros;
+        buffer = std::copy(reinterpret_cast<const char *>(&nzb), reinterpret_cast<const char *>(&nzb) + sizeof(nzb), buffer);
+        for (size_t r = 0; r < e.nbrows; r++, valuesArg += rowSkip) {
+            char *nzrPos = buffer;
+            buffer += sizeof(uint32_t);
+            uint32_t nzr = 0;
+            for (size_t c = 0; c < numCols; c++) {
+                if (valuesArg[c] == VT(0))
+                    continue;
+                const uint32_t cx = static_cast<uint32_t>(c);
+                buffer = std::copy(reinterpret_cast<const char *>(&cx), reinterpret_cast<const char *>(&cx) + sizeof(cx), buffer);
+                buffer = std::copy(reinterpret_cast<const char *>(&valuesArg[c]), reinterpret_cast<const char *>(&valuesArg[c]) + sizeof(VT), buffer);
+                nzr++;
+            }
+            std::copy(reinterpret_cast<const char *>(&nzr), reinterpret_cast<const char *>(&nzr) + sizeof(nzr), nzrPos);
+        }
+    }
 };
 
 // ----------------------------------------------------------------------------
@@ -0,0 +1,492 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <runtime/local/io/io_uring/AsyncUtil.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#define DAPHNE_HAVE_IO_URING 1
+#endif
+
+/**
+ * @brief Called once an asynchronous read has finished, with its status and
+ * the number of bytes read (less than requested only at the end of the file).
+ *
+ * Callbacks run on an internal thread of the `AsyncIOService` and should be
+ * short; they must not wait for other reads to finish.
+ */
+using IOCallback = std::function<void(IO_STATUS status, size_t bytesRead)>;
+
+/**
+ * @brief A buffer from the pool of the `AsyncIOService`.
+ *
+ * If `index` is non-negative, the buffer is registered with the kernel, which
+ * saves mapping its pages for every read.
+ */
+struct IOBuffer {
+    char *data = nullptr;
+    size_t size = 0;
+    int index = -1;
+};
+
+/**
+ * @brief A process-wide service for asynchronous file reads.
+ *
+ * Reads are backed by an io_uring instance if the kernel supports it, and by a
+ * small pool of threads issuing `pread`s otherwise. Reads are collected and
+ * only handed to the kernel on `flush()` (or when the submission queue is
+ * full), such that many reads cost a single system call. The number of reads
+ * in flight is bounded by the size of the completion queue.
+ */
+class AsyncIOService {
+  public:
+    /**
+     * @brief The size of each pooled buffer, which is also the granularity of
+     * readahead.
+     */
+    static constexpr size_t BUFFER_SIZE = 1 << 20;
+    static constexpr size_t NUM_BUFFERS = 16;
+    /**
+     * @brief Large reads are split into requests of at most this size, such
+     * that the device sees multiple requests at once.
+     */
+    static constexpr size_t MAX_REQUEST_SIZE = 4 << 20;
+
+    /**
+     * @brief Returns the shared instance, which is created on first use.
+     */
+    static AsyncIOService &get() {
+        static AsyncIOService service;
+        return service;
+    }
+
+    explicit AsyncIOService(unsigned queueDepth = 128, size_t numFallbackThreads = 4, bool tryIOUring = true) {
+        bufferMemory = static_cast<char *>(std::aligned_alloc(4096, NUM_BUFFERS * BUFFER_SIZE));
+        if (bufferMemory == nullptr)
+            throw std::bad_alloc();
+        for (size_t i = 0; i < NUM_BUFFERS; i++)
+            freeBuffers.push_back(i);
+
+#ifdef DAPHNE_HAVE_IO_URING
+        if (tryIOUring && initRing(queueDepth)) {
+            completionThread = std::thread([this]() { reapCompletions(); });
+            return;
+        }
+#endif
+        for (size_t i = 0; i < std::max<size_t>(1, numFallbackThreads); i++)
+            fallbackThreads.emplace_back([this]() { runFallbackWorker(); });
+    }
+
+    AsyncIOService(const AsyncIOService &) = delete;
+    AsyncIOService &operator=(const AsyncIOService &) = delete;
+
+    ~AsyncIOService() {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            flushLocked();
+            cvInFlight.wait(lock, [this]() { return numInFlight == 0; });
+            stopping = true;
+        }
+#ifdef DAPHNE_HAVE_IO_URING
+        if (ringFd != -1) {
+            {
+                // A NOP without request wakes the completion thread for exit.
+                std::lock_guard<std::mutex> lock(mtx);
+                io_uring_sqe *sqe = nextSqeLocked();
+                sqe->opcode = IORING_OP_NOP;
+                sqe->user_data = 0;
+                flushLocked();
+            }
+            completionThread.join();
+            unmapRing();
+        }
+#endif
+        cvFallback.notify_all();
+        for (auto &t : fallbackThreads)
+            t.join();
+        std::free(bufferMemory);
+    }
+
+    bool usesIOUring() const { return ringFd != -1; }
+
+    bool hasRegisteredBuffers() const { return buffersRegistered; }
+
+    /**
+     * @brief Takes a buffer from the pool if one is free.
+     */
+    bool tryAcquireBuffer(IOBuffer &buf) {
+        std::lock_guard<std::mutex> lock(bufferMtx);
+        if (freeBuffers.empty())
+            return false;
+        const size_t i = freeBuffers.back();
+        freeBuffers.pop_back();
+        buf.data = bufferMemory + i * BUFFER_SIZE;
+        buf.size = BUFFER_SIZE;
+        buf.index = buffersRegistered ? static_cast<int>(i) : -1;
+        return true;
+    }
+
+    void releaseBuffer(const IOBuffer &buf) {
+        std::lock_guard<std::mutex> lock(bufferMtx);
+        freeBuffers.push_back((buf.data - bufferMemory) / BUFFER_SIZE);
+    }
+
+    /**
+     * @brief Queues a read of `size` bytes at `offset` of `fd` into `buf`.
+     *
+     * The read is not guaranteed to start before the next `flush()`. Both `fd`
+     * and `buf` must remain valid until `callback` has been called.
+     */
+    void submitRead(int fd, void *buf, size_t size, uint64_t offset, IOCallback callback) {
+        submit(new Request{fd, static_cast<char *>(buf), size, offset, -1, 0, std::move(callback)});
+    }
+
+    /**
+     * @brief Like `submitRead()`, but reads into the first `size` bytes of a
+     * pooled buffer, using the registered buffer if possible.
+     */
+    void submitRead(int fd, const IOBuffer &buf, size_t size, uint64_t offset, IOCallback callback) {
+        if (size > buf.size)
+            throw std::runtime_error("AsyncIOService: read exceeds the buffer size");
+        submit(new Request{fd, buf.data, size, offset, buf.index, 0, std::move(callback)});
+    }
+
+    /**
+     * @brief Hands all queued reads to the kernel.
+     */
+    void flush() {
+        std::lock_guard<std::mutex> lock(mtx);
+        flushLocked();
+    }
+
+    /**
+     * @brief Reads exactly `size` bytes at `offset` of `fd` into `buf` as
+     * multiple concurrent requests and waits for all of them.
+     */
+    void readFully(int fd, void *buf, size_t size, uint64_t offset) {
+        std::mutex doneMtx;
+        std::condition_variable doneCv;
+        size_t numPending = 0;
+        IO_STATUS firstError = IO_STATUS::SUCCESS;
+        bool endOfFile = false;
+
+        char *ptr = static_cast<char *>(buf);
+        for (size_t pos = 0; pos < size; pos += MAX_REQUEST_SIZE) {
+            const size_t len = std::min(MAX_REQUEST_SIZE, size - pos);
+            {
+                std::lock_guard<std::mutex> lock(doneMtx);
+                numPending++;
+            }
+            submitRead(fd, ptr + pos, len, offset + pos, [&, len](IO_STATUS status, size_t bytesRead) {
+                std::lock_guard<std::mutex> lock(doneMtx);
+                if (status != IO_STATUS::SUCCESS && firstError == IO_STATUS::SUCCESS)
+                    firstError = status;
+                if (bytesRead < len)
+                    endOfFile = true;
+                if (--numPending == 0)
+                    doneCv.notify_all();
+            });
+        }
+        flush();
+
+        std::unique_lock<std::mutex> lock(doneMtx);
+        doneCv.wait(lock, [&]() { return numPending == 0; });
+        if (firstError != IO_STATUS::SUCCESS)
+            throw std::runtime_error("AsyncIOService::readFully: read failed (status " +
+                                     std::to_string(static_cast<int>(firstError)) + ")");
+        if (endOfFile)
+            throw std::runtime_error("AsyncIOService::readFully: unexpected end of file");
+    }
+
+  private:
+    struct Request {
+        int fd;
+        char *buf;
+        size_t size;
+        uint64_t offset;
+        int bufIndex;
+        size_t done;
+        IOCallback callback;
+    };
+
+    std::mutex mtx;
+    std::condition_variable cvInFlight;
+    size_t numInFlight = 0;
+    size_t maxInFlight = 0;
+    bool stopping = false;
+
+    std::mutex bufferMtx;
+    char *bufferMemory = nullptr;
+    std::vector<size_t> freeBuffers;
+    bool buffersRegistered = false;
+
+    // io_uring state.
+    int ringFd = -1;
+    void *sqRing = nullptr;
+    void *cqRing = nullptr;
+    size_t sqRingSize = 0;
+    size_t cqRingSize = 0;
+    void *sqesMem = nullptr;
+    size_t sqesSize = 0;
+    unsigned sqEntries = 0;
+    unsigned *sqHead = nullptr;
+    unsigned *sqTail = nullptr;
+    unsigned *sqMask = nullptr;
+    unsigned *sqArray = nullptr;
+    unsigned *cqHead = nullptr;
+    unsigned *cqTail = nullptr;
+    unsigned *cqMask = nullptr;
+#ifdef DAPHNE_HAVE_IO_URING
+    io_uring_cqe *cqes = nullptr;
+#endif
+    unsigned numQueued = 0;
+    std::thread completionThread;
+
+    // Fallback state.
+    std::vector<std::thread> fallbackThreads;
+    std::condition_variable cvFallback;
+    std::deque<Request *> fallbackQueue;
+
+    void submit(Request *req) {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (ringFd == -1) {
+            fallbackQueue.push_back(req);
+            numInFlight++;
+            cvFallback.notify_one();
+            return;
+        }
+        while (numInFlight >= maxInFlight) {
+            // Queued reads must reach the kernel before waiting for any.
+            flushLocked();
+            cvInFlight.wait(lock);
+        }
+        numInFlight++;
+        queueLocked(req);
+    }
+
+    void finish(Request *req, IO_STATUS status) {
+        try {
+            req->callback(status, req->done);
+        } catch (...) {
+            // Callbacks must not throw; there is nobody to report to here.
+        }
+        delete req;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            numInFlight--;
+        }
+        cvInFlight.notify_all();
+    }
+
+    void runFallbackWorker() {
+        while (true) {
+            Request *req;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cvFallback.wait(lock, [this]() { return stopping || !fallbackQueue.empty(); });
+                if (fallbackQueue.empty())
+                    return;
+                req = fallbackQueue.front();
+                fallbackQueue.pop_front();
+            }
+            IO_STATUS status = IO_STATUS::SUCCESS;
+            while (req->done < req->size) {
+                ssize_t n = pread(req->fd, req->buf + req->done, req->size - req->done, req->offset + req->done);
+                if (n < 0) {
+                    if (errno == EINTR)
+                        continue;
+                    status = ioStatusFromErrno(errno);
+                    break;
+                }
+                if (n == 0)
+                    break;
+                req->done += n;
+            }
+            finish(req, status);
+        }
+    }
+
+#ifdef DAPHNE_HAVE_IO_URING
+    bool initRing(unsigned queueDepth) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ringFd = static_cast<int>(syscall(__NR_io_uring_setup, queueDepth, &params));
+        if (ringFd < 0) {
+            ringFd = -1;
+            return false;
+        }
+        // IORING_OP_READ requires the same kernel version (5.6) as this feature.
+        if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+            close(ringFd);
+            ringFd = -1;
+            return false;
+        }
+
+        sqEntries = params.sq_entries;
+        maxInFlight = params.cq_entries;
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMmap)
+            sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd,
+                      IORING_OFF_SQ_RING);
+        cqRing = singleMmap ? sqRing
+                            : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd,
+                                   IORING_OFF_CQ_RING);
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqesMem = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+        if (sqRing == MAP_FAILED || cqRing == MAP_FAILED || sqesMem == MAP_FAILED) {
+            unmapRing();
+            return false;
+        }
+
+        char *sq = static_cast<char *>(sqRing);
+        sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        char *cq = static_cast<char *>(cqRing);
+        cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+        // Registering may fail due to RLIMIT_MEMLOCK; then the pooled buffers
+        // are used like any other memory.
+        std::vector<iovec> iovecs(NUM_BUFFERS);
+        for (size_t i = 0; i < NUM_BUFFERS; i++) {
+            iovecs[i].iov_base = bufferMemory + i * BUFFER_SIZE;
+            iovecs[i].iov_len = BUFFER_SIZE;
+        }
+        buffersRegistered =
+            syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_BUFFERS, iovecs.data(), NUM_BUFFERS) == 0;
+        return true;
+    }
+
+    void unmapRing() {
+        if (sqesMem && sqesMem != MAP_FAILED)
+            munmap(sqesMem, sqesSize);
+        if (cqRing && cqRing != MAP_FAILED && cqRing != sqRing)
+            munmap(cqRing, cqRingSize);
+        if (sqRing && sqRing != MAP_FAILED)
+            munmap(sqRing, sqRingSize);
+        close(ringFd);
+        ringFd = -1;
+    }
+
+    io_uring_sqe *nextSqeLocked() {
+        const unsigned tail = *sqTail + numQueued;
+        if (tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries)
+            flushLocked();
+        const unsigned index = (*sqTail + numQueued) & *sqMask;
+        io_uring_sqe *sqe = static_cast<io_uring_sqe *>(sqesMem) + index;
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqArray[index] = index;
+        numQueued++;
+        return sqe;
+    }
+
+    void queueLocked(Request *req) {
+        io_uring_sqe *sqe = nextSqeLocked();
+        sqe->opcode = req->bufIndex >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ;
+        sqe->fd = req->fd;
+        sqe->addr = reinterpret_cast<uint64_t>(req->buf + req->done);
+        // The length is 32 bits wide; the rest is read after completion.
+        sqe->len = static_cast<uint32_t>(std::min<size_t>(req->size - req->done, 1 << 30));
+        sqe->off = req->offset + req->done;
+        if (req->bufIndex >= 0)
+            sqe->buf_index = static_cast<uint16_t>(req->bufIndex);
+        sqe->user_data = reinterpret_cast<uint64_t>(req);
+    }
+#endif
+
+    void flushLocked() {
+#ifdef DAPHNE_HAVE_IO_URING
+        if (ringFd == -1 || numQueued == 0)
+            return;
+        __atomic_store_n(sqTail, *sqTail + numQueued, __ATOMIC_RELEASE);
+        unsigned toSubmit = numQueued;
+        numQueued = 0;
+        while (toSubmit) {
+            long n = syscall(__NR_io_uring_enter, ringFd, toSubmit, 0, 0, nullptr, 0);
+            if (n < 0) {
+                if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+                    continue;
+                throw std::runtime_error(std::string("AsyncIOService: io_uring_enter failed: ") + strerror(errno));
+            }
+            toSubmit -= static_cast<unsigned>(n);
+        }
+#endif
+    }
+
+#ifdef DAPHNE_HAVE_IO_URING
+    void reapCompletions() {
+        while (true) {
+            unsigned head = *cqHead;
+            if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+                syscall(__NR_io_uring_enter, ringFd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+                continue;
+            }
+            const io_uring_cqe cqe = cqes[head & *cqMask];
+            __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+
+            auto *req = reinterpret_cast<Request *>(cqe.user_data);
+            if (req == nullptr)
+                return;
+            if (cqe.res == -EINTR || cqe.res == -EAGAIN)
+                resubmit(req);
+            else if (cqe.res < 0)
+                finish(req, ioStatusFromErrno(-cqe.res));
+            else {
+                req->done += cqe.res;
+                if (cqe.res > 0 && req->done < req->size)
+                    resubmit(req); // short read, not yet at the end of the file
+                else
+                    finish(req, IO_STATUS::SUCCESS);
+            }
+        }
+    }
+
+    void resubmit(Request *req) {
+        std::lock_guard<std::mutex> lock(mtx);
+        queueLocked(req);
+        flushLocked();
+    }
+#endif
+};
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <cerrno>
 #include <cstdint>
 
 enum struct IO_STATUS : uint8_t {
@@ -28,3 +29,25 @@ enum struct IO_STATUS : uint8_t {
     OTHER_ERROR,
     OUT_OF_SPACE,
 };
+
+/**
+ * @brief Maps an `errno` value of a failed I/O operation to an `IO_STATUS`.
+ */
+inline IO_STATUS ioStatusFromErrno(int err) {
+    switch (err) {
+        case 0:
+            return IO_STATUS::SUCCESS;
+        case EIO:
+            return IO_STATUS::IO_ERROR;
+        case EACCES:
+        case EPERM:
+            return IO_STATUS::ACCESS_DENIED;
+        case EBADF:
+            return IO_STATUS::BAD_FD;
+        case ENOSPC:
+        case EDQUOT:
+            return IO_STATUS::OUT_OF_SPACE;
+        default:
+            return IO_STATUS::OTHER_ERROR;
+    }
+}
@@ -0,0 +1,249 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <runtime/local/io/io_uring/AsyncIOService.h>
+#include <runtime/local/io/io_uring/AsyncUtil.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/**
+ * @brief Reads a file sequentially, while the blocks after the current one are
+ * already being read through the `AsyncIOService`.
+ *
+ * Up to `depth` blocks of `AsyncIOService::BUFFER_SIZE` bytes are in flight or
+ * ready at any time. The blocks use pooled (registered) buffers if available,
+ * and private buffers otherwise.
+ */
+class ReadaheadFile {
+    struct Block {
+        IOBuffer buf;
+        bool pooled = false;
+        size_t len = 0;
+        bool ready = false;
+        IO_STATUS status = IO_STATUS::IN_FLIGHT;
+    };
+
+    AsyncIOService &service;
+    int fd;
+    uint64_t fileSize;
+    uint64_t nextOffset = 0;
+    const size_t depth;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<std::unique_ptr<Block>> blocks;
+    /**
+     * @brief The position of the next unconsumed byte in the front block.
+     */
+    size_t pos = 0;
+    /**
+     * @brief Private buffers of consumed blocks, for reuse.
+     */
+    std::vector<char *> spareBuffers;
+
+    ReadaheadFile(int fd, uint64_t fileSize, size_t depth, AsyncIOService &service)
+        : service(service), fd(fd), fileSize(fileSize), depth(depth) {
+        issue();
+    }
+
+    /**
+     * @brief Requests blocks until `depth` blocks are outstanding.
+     */
+    void issue() {
+        bool submitted = false;
+        while (nextOffset < fileSize && blocks.size() < depth) {
+            auto block = std::make_unique<Block>();
+            if (service.tryAcquireBuffer(block->buf))
+                block->pooled = true;
+            else {
+                if (spareBuffers.empty())
+                    block->buf.data = static_cast<char *>(std::malloc(AsyncIOService::BUFFER_SIZE));
+                else {
+                    block->buf.data = spareBuffers.back();
+                    spareBuffers.pop_back();
+                }
+                if (block->buf.data == nullptr)
+                    throw std::bad_alloc();
+                block->buf.size = AsyncIOService::BUFFER_SIZE;
+            }
+            const size_t len = std::min<uint64_t>(AsyncIOService::BUFFER_SIZE, fileSize - nextOffset);
+            Block *b = block.get();
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                blocks.push_back(std::move(block));
+            }
+            service.submitRead(fd, b->buf, len, nextOffset, [this, b](IO_STATUS status, size_t bytesRead) {
+                std::lock_guard<std::mutex> lock(mtx);
+                b->status = status;
+                b->len = bytesRead;
+                b->ready = true;
+                cv.notify_all();
+            });
+            nextOffset += len;
+            submitted = true;
+        }
+        if (submitted)
+            service.flush();
+    }
+
+    void releaseBlock(Block &b) {
+        if (b.pooled)
+            service.releaseBuffer(b.buf);
+        else
+            spareBuffers.push_back(b.buf.data);
+    }
+
+    /**
+     * @brief Waits until the front block has arrived; returns `nullptr` at the
+     * end of the file.
+     */
+    Block *front() {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (blocks.empty())
+            return nullptr;
+        Block *b = blocks.front().get();
+        cv.wait(lock, [b]() { return b->ready; });
+        if (b->status != IO_STATUS::SUCCESS)
+            throw std::runtime_error("ReadaheadFile: read failed (status " +
+                                     std::to_string(static_cast<int>(b->status)) + ")");
+        if (b->len == 0) {
+            // The file was truncated while reading it.
+            nextOffset = fileSize;
+            return nullptr;
+        }
+        return b;
+    }
+
+    void popFront() {
+        std::unique_ptr<Block> b;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            b = std::move(blocks.front());
+            blocks.pop_front();
+        }
+        releaseBlock(*b);
+        pos = 0;
+        issue();
+    }
+
+  public:
+    /**
+     * @brief Opens the given file for reading; returns `nullptr` if that is not
+     * possible.
+     */
+    static ReadaheadFile *open(const char *filename, size_t depth = 4,
+                               AsyncIOService &service = AsyncIOService::get()) {
+        int fd = ::open(filename, O_RDONLY);
+        if (fd == -1)
+            return nullptr;
+        struct stat st;
+        if (fstat(fd, &st) == -1) {
+            ::close(fd);
+            return nullptr;
+        }
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        return new ReadaheadFile(fd, st.st_size, depth, service);
+    }
+
+    ReadaheadFile(const ReadaheadFile &) = delete;
+    ReadaheadFile &operator=(const ReadaheadFile &) = delete;
+
+    ~ReadaheadFile() {
+        // The outstanding reads write into our blocks and notify us.
+        std::unique_lock<std::mutex> lock(mtx);
+        for (auto &b : blocks) {
+            Block *p = b.get();
+            cv.wait(lock, [p]() { return p->ready; });
+            releaseBlock(*p);
+        }
+        for (char *buf : spareBuffers)
+            std::free(buf);
+        ::close(fd);
+    }
+
+    /**
+     * @brief Reads the next line including its newline character (if any)
+     * into `*line`, which is (re)allocated as needed, like POSIX `getline`.
+     *
+     * @return The number of characters read, or `-1` at the end of the file.
+     */
+    ssize_t getLine(char **line, size_t *cap) {
+        size_t len = 0;
+        while (Block *b = front()) {
+            const char *start = b->buf.data + pos;
+            const size_t avail = b->len - pos;
+            const char *nl = static_cast<const char *>(std::memchr(start, '\n', avail));
+            const size_t n = nl ? nl - start + 1 : avail;
+            if (*line == nullptr || *cap < len + n + 1) {
+                size_t newCap = std::max<size_t>(len + n + 1, 2 * *cap);
+                char *newLine = static_cast<char *>(std::realloc(*line, newCap));
+                if (newLine == nullptr)
+                    throw std::bad_alloc();
+                *line = newLine;
+                *cap = newCap;
+            }
+            std::memcpy(*line + len, start, n);
+            len += n;
+            pos += n;
+            if (pos == b->len)
+                popFront();
+            if (nl)
+                break;
+        }
+        if (len == 0)
+            return -1;
+        (*line)[len] = '\0';
+        return static_cast<ssize_t>(len);
+    }
+
+    /**
+     * @brief Reads up to `size` bytes; returns the number of bytes read, which
+     * is less than `size` only at the end of the file.
+     */
+    size_t read(void *dst, size_t size) {
+        size_t done = 0;
+        while (done < size) {
+            Block *b = front();
+            if (b == nullptr)
+                break;
+            const size_t n = std::min(size - done, b->len - pos);
+            std::memcpy(static_cast<char *>(dst) + done, b->buf.data + pos, n);
+            done += n;
+            pos += n;
+            if (pos == b->len)
+                popFront();
+        }
+        return done;
+    }
+};
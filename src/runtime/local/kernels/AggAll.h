@@ -22,6 +22,7 @@
 #include <runtime/local/datastructures/DenseMatrix.h>
 #include <runtime/local/datastructures/Matrix.h>
 #include <runtime/local/kernels/AggOpCode.h>
+#include <runtime/local/kernels/AggReduction.h>
 #include <runtime/local/kernels/EwBinarySca.h>
 
 #include <cmath>
@@ -61,27 +62,22 @@ struct AggAll<VTRes, DenseMatrix<VTArg>> {
         
         const VTArg * valuesArg = arg->getValues();
 
-        EwBinaryScaFuncPtr<VTRes, VTRes, VTRes> func;
-        VTRes agg, stddev;
-        if (AggOpCodeUtils::isPureBinaryReduction(opCode)) {
-            func = getEwBinaryScaFuncPtr<VTRes, VTRes, VTRes>(AggOpCodeUtils::getBinaryOpCode(opCode));
-            agg = AggOpCodeUtils::template getNeutral<VTRes>(opCode);
-        }
-        else {
-            // TODO Setting the function pointer yields the correct result.
-            // However, since MEAN, VAR, and STDDEV are not sparse-safe, the program
-            // does not take the same path for doing the summation, and is less
-            // efficient.
-            // for MEAN, VAR, and STDDEV, we need to sum
-            func = getEwBinaryScaFuncPtr<VTRes, VTRes, VTRes>(AggOpCodeUtils::getBinaryOpCode(AggOpCode::SUM));
-            agg = VTRes(0);
-        }
-
-        for(size_t r = 0; r < numRows; r++) {
-            for(size_t c = 0; c < numCols; c++)
-                agg = func(agg, static_cast<VTRes>(valuesArg[c]), ctx);
-            valuesArg += arg->getRowSkip();
-        }
+        // For MEAN, VAR, and STDDEV, we need to sum.
+        const AggOpCode reduction = AggOpCodeUtils::isPureBinaryReduction(opCode) ? opCode : AggOpCode::SUM;
+        const VTRes neutral = AggOpCodeUtils::template getNeutral<VTRes>(reduction);
+        VTRes agg = neutral;
+        VTRes stddev;
+        dispatchAggReduction(reduction, [&](auto op) {
+            constexpr BinaryOpCode bop = decltype(op)::value;
+            // Reduce each row separately, such that the partial results of a
+            // row are combined pairwise.
+            for(size_t r = 0; r < numRows; r++) {
+                agg = EwBinarySca<bop, VTRes, VTRes, VTRes>::apply(
+                        agg, reduceContiguous<bop>(valuesArg, numCols, neutral), ctx
+                );
+                valuesArg += arg->getRowSkip();
+            }
+        });
         if (AggOpCodeUtils::isPureBinaryReduction(opCode))
             return agg;
 
@@ -23,6 +23,7 @@
 #include <runtime/local/datastructures/DenseMatrix.h>
 #include <runtime/local/datastructures/Matrix.h>
 #include <runtime/local/kernels/AggOpCode.h>
+#include <runtime/local/kernels/AggReduction.h>
 #include <runtime/local/kernels/EwBinarySca.h>
 
 #include <vector>
@@ -121,26 +122,19 @@ struct AggCol<DenseMatrix<VTRes>, DenseMatrix<VTArg>> {
             DataObjectFactory::destroy(tmp);
         }
         else {
-            EwBinaryScaFuncPtr<VTRes, VTRes, VTRes> func;
-            if(AggOpCodeUtils::isPureBinaryReduction(opCode))
-                func = getEwBinaryScaFuncPtr<VTRes, VTRes, VTRes>(AggOpCodeUtils::getBinaryOpCode(opCode));
-            else
-                // TODO Setting the function pointer yields the correct result.
-                // However, since MEAN and STDDEV are not sparse-safe, the program
-                // does not take the same path for doing the summation, and is less
-                // efficient.
-                // for MEAN and STDDDEV, we need to sum
-                func = getEwBinaryScaFuncPtr<VTRes, VTRes, VTRes>(AggOpCodeUtils::getBinaryOpCode(AggOpCode::SUM));
+            // For MEAN and STDDEV and VAR, we need to sum.
+            const AggOpCode reduction = AggOpCodeUtils::isPureBinaryReduction(opCode) ? opCode : AggOpCode::SUM;
 
             // memcpy(valuesRes, valuesArg, numCols * sizeof(VTRes));
             // Can't memcpy because we might have different result type
             for (size_t c = 0; c < numCols; c++)
                 valuesRes[c] = static_cast<VTRes>(valuesArg[c]);
-            for(size_t r = 1; r < numRows; r++) {
-                valuesArg += arg->getRowSkip();
-                for(size_t c = 0; c < numCols; c++)
-                    valuesRes[c] = func(valuesRes[c], static_cast<VTRes>(valuesArg[c]), ctx);
-            }
+            dispatchAggReduction(reduction, [&](auto op) {
+                for(size_t r = 1; r < numRows; r++) {
+                    valuesArg += arg->getRowSkip();
+                    reduceInto<decltype(op)::value>(valuesRes, valuesArg, numCols);
+                }
+            });
             
             if(AggOpCodeUtils::isPureBinaryReduction(opCode))
                 return;
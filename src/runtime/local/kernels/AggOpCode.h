@@ -22,6 +22,8 @@
 #include <limits>
 #include <stdexcept>
 
+#include <cstdint>
+
 enum class AggOpCode {
     SUM,
     PROD,
@@ -32,6 +34,7 @@ enum class AggOpCode {
     MEAN,
     STDDEV,
     VAR,
+    NNZ, // number of non-zeros, only supported by the multi-aggregation kernels
 };
 
 struct AggOpCodeUtils {
@@ -82,6 +85,15 @@ struct AggOpCodeUtils {
         }
     }
     
+    /**
+     * @brief Returns the bit representing the given op-code in the bit mask
+     * of aggregations computed by the multi-aggregation kernels (see
+     * `MultiAgg.h`).
+     */
+    static int64_t getMultiAggBit(AggOpCode opCode) {
+        return int64_t(1) << static_cast<int>(opCode);
+    }
+    
     static bool isSparseSafe(AggOpCode opCode) {
         switch(opCode) {
             case AggOpCode::SUM:
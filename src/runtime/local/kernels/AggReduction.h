@@ -0,0 +1,111 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_RUNTIME_LOCAL_KERNELS_AGGREDUCTION_H
+#define SRC_RUNTIME_LOCAL_KERNELS_AGGREDUCTION_H
+
+#include <runtime/local/kernels/AggOpCode.h>
+#include <runtime/local/kernels/BinaryOpCode.h>
+#include <runtime/local/kernels/EwBinarySca.h>
+
+#include <stdexcept>
+#include <type_traits>
+
+#include <cstddef>
+
+// ****************************************************************************
+// Building blocks of the dense aggregation kernels
+// ****************************************************************************
+
+// The dense aggregation kernels (aggAll, aggRow, aggCol) used to apply the
+// reduction through an EwBinaryScaFuncPtr for each element. The indirect call
+// prevents the C++ compiler from vectorizing the loops, and the single
+// accumulator of a sequential reduction serializes the additions. The helpers
+// below make the reduction a compile-time constant and use multiple
+// independent accumulators instead.
+
+/**
+ * @brief The number of independent accumulators used by `reduceContiguous`.
+ *
+ * Eight accumulators cover the latency of a floating-point addition and allow
+ * the compiler to map them to (at least) two SIMD registers.
+ */
+constexpr size_t AGG_NUM_ACCUMULATORS = 8;
+
+/**
+ * @brief Calls `f` with the binary op-code of the given pure binary reduction
+ * (see `AggOpCodeUtils::isPureBinaryReduction`) as an
+ * `std::integral_constant`, such that `f` can instantiate the reduction at
+ * compile-time.
+ */
+template<class F>
+void dispatchAggReduction(AggOpCode opCode, F && f) {
+    switch(opCode) {
+        case AggOpCode::SUM:  f(std::integral_constant<BinaryOpCode, BinaryOpCode::ADD>()); break;
+        case AggOpCode::PROD: f(std::integral_constant<BinaryOpCode, BinaryOpCode::MUL>()); break;
+        case AggOpCode::MIN:  f(std::integral_constant<BinaryOpCode, BinaryOpCode::MIN>()); break;
+        case AggOpCode::MAX:  f(std::integral_constant<BinaryOpCode, BinaryOpCode::MAX>()); break;
+        default:
+            throw std::runtime_error("Aggregation kernel expects pure binary reduction.");
+    }
+}
+
+/**
+ * @brief Reduces `n` contiguous values to a single value, starting from the
+ * given neutral element.
+ *
+ * The values are distributed round-robin over `AGG_NUM_ACCUMULATORS`
+ * accumulators, which are combined at the end. For sums, this is also more
+ * accurate than a single accumulator, since each accumulator only sees every
+ * eighth value.
+ */
+template<BinaryOpCode op, typename VTRes, typename VTArg>
+VTRes reduceContiguous(const VTArg * values, size_t n, VTRes neutral) {
+    using Op = EwBinarySca<op, VTRes, VTRes, VTRes>;
+
+    VTRes acc[AGG_NUM_ACCUMULATORS];
+    for(size_t k = 0; k < AGG_NUM_ACCUMULATORS; k++)
+        acc[k] = neutral;
+
+    size_t i = 0;
+    for(; i + AGG_NUM_ACCUMULATORS <= n; i += AGG_NUM_ACCUMULATORS)
+        for(size_t k = 0; k < AGG_NUM_ACCUMULATORS; k++)
+            acc[k] = Op::apply(acc[k], static_cast<VTRes>(values[i + k]), nullptr);
+    for(size_t k = 0; i < n; i++, k++)
+        acc[k] = Op::apply(acc[k], static_cast<VTRes>(values[i]), nullptr);
+
+    // Pairwise combination of the accumulators.
+    for(size_t width = AGG_NUM_ACCUMULATORS / 2; width > 0; width /= 2)
+        for(size_t k = 0; k < width; k++)
+            acc[k] = Op::apply(acc[k], acc[k + width], nullptr);
+    return acc[0];
+}
+
+/**
+ * @brief Element-wise reduces `n` contiguous values into `n` accumulators,
+ * i.e., `acc[i] = acc[i] op values[i]`.
+ *
+ * This is the inner loop of column-wise aggregation over a row-major matrix;
+ * since all iterations are independent, the compiler vectorizes it.
+ */
+template<BinaryOpCode op, typename VTRes, typename VTArg>
+void reduceInto(VTRes * acc, const VTArg * values, size_t n) {
+    using Op = EwBinarySca<op, VTRes, VTRes, VTRes>;
+    for(size_t i = 0; i < n; i++)
+        acc[i] = Op::apply(acc[i], static_cast<VTRes>(values[i]), nullptr);
+}
+
+#endif //SRC_RUNTIME_LOCAL_KERNELS_AGGREDUCTION_H
@@ -24,6 +24,7 @@
 #include <runtime/local/datastructures/Matrix.h>
 #include <runtime/local/kernels/AggAll.h>
 #include <runtime/local/kernels/AggOpCode.h>
+#include <runtime/local/kernels/AggReduction.h>
 #include <runtime/local/kernels/EwBinarySca.h>
 
 #include <vector>
@@ -100,26 +101,16 @@ struct AggRow<DenseMatrix<VTRes>, DenseMatrix<VTArg>> {
             }
         }
         else {
-            EwBinaryScaFuncPtr<VTRes, VTRes, VTRes> func;    
-            if(AggOpCodeUtils::isPureBinaryReduction(opCode))
-                func = getEwBinaryScaFuncPtr<VTRes, VTRes, VTRes>(AggOpCodeUtils::getBinaryOpCode(opCode));
-            else
-                // TODO Setting the function pointer yields the correct result.
-                // However, since MEAN and STDDEV are not sparse-safe, the program
-                // does not take the same path for doing the summation, and is less
-                // efficient.
-                // for MEAN and STDDDEV, we need to sum
-                func = getEwBinaryScaFuncPtr<VTRes, VTRes, VTRes>(AggOpCodeUtils::getBinaryOpCode(AggOpCode::SUM));
-
-            for(size_t r = 0; r < numRows; r++) {
-                VTRes agg = static_cast<VTRes>(*valuesArg);
-                for(size_t c = 1; c < numCols; c++){
-                    agg = func(agg, static_cast<VTRes>(valuesArg[c]), ctx);
+            // For MEAN and STDDEV and VAR, we need to sum.
+            const AggOpCode reduction = AggOpCodeUtils::isPureBinaryReduction(opCode) ? opCode : AggOpCode::SUM;
+            const VTRes neutral = AggOpCodeUtils::template getNeutral<VTRes>(reduction);
+            dispatchAggReduction(reduction, [&](auto op) {
+                for(size_t r = 0; r < numRows; r++) {
+                    *valuesRes = reduceContiguous<decltype(op)::value>(valuesArg, numCols, neutral);
+                    valuesArg += arg->getRowSkip();
+                    valuesRes += res->getRowSkip();
                 }
-                *valuesRes = static_cast<VTRes>(agg);
-                valuesArg += arg->getRowSkip();
-                valuesRes += res->getRowSkip();
-            }
+            });
 
             if(AggOpCodeUtils::isPureBinaryReduction(opCode))
                 return;
@@ -22,6 +22,13 @@
 #include <runtime/local/datastructures/Frame.h>
 #include <runtime/local/datastructures/ValueTypeCode.h>
 #include <runtime/local/datastructures/ValueTypeUtils.h>
+#include <util/KernelThreads.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <cstddef>
 
 // ****************************************************************************
 // Struct for partial template specialization
@@ -47,6 +54,44 @@ void castObj(DTRes *& res, const DTArg * arg, DCTX(ctx)) {
     CastObj<DTRes, DTArg>::apply(res, arg, ctx);
 }
 
+// ****************************************************************************
+// Helpers for converting between column-major and row-major layouts
+// ****************************************************************************
+
+/**
+ * @brief The approximate number of bytes of the row-major side of a
+ * layout conversion that is processed as one block.
+ *
+ * Converting between the columns of a frame and the rows of a matrix column
+ * by column accesses the matrix with a stride of a whole row, missing the
+ * cache for every element of wide matrices. Instead, the conversion runs over
+ * blocks of rows, such that the part of the matrix touched by a block stays
+ * in the cache while all columns are processed.
+ */
+constexpr size_t CAST_OBJ_BLOCK_BYTES = size_t(1) << 16;
+
+/**
+ * @brief The minimum number of cells for which a layout conversion uses
+ * multiple threads.
+ */
+constexpr size_t CAST_OBJ_MIN_PARALLEL_CELLS = size_t(1) << 20;
+
+/**
+ * @brief Calls `func(rowBeg, rowEnd)` for all blocks of rows of a layout
+ * conversion, in parallel for large inputs outside of vectorized pipelines.
+ */
+template<typename Func>
+void forEachCastObjRowBlock(size_t numRows, size_t numCols, size_t valueSize, DCTX(ctx), Func func) {
+    const size_t blockRows = std::max<size_t>(16, CAST_OBJ_BLOCK_BYTES / std::max<size_t>(1, numCols * valueSize));
+    const size_t numBlocks = (numRows + blockRows - 1) / blockRows;
+    size_t numThreads = 1;
+    if(numRows * numCols >= CAST_OBJ_MIN_PARALLEL_CELLS)
+        numThreads = getNumKernelThreads(ctx != nullptr ? ctx->getUserConfig().numberOfThreads : 0);
+    parallelForEach(numBlocks, numThreads, [&](size_t b) {
+        func(b * blockRows, std::min(numRows, (b + 1) * blockRows));
+    });
+}
+
 // ****************************************************************************
 // (Partial) template specializations for different data/value types
 // ****************************************************************************
@@ -59,18 +104,37 @@ template<typename VTRes>
 class CastObj<DenseMatrix<VTRes>, Frame> {
     
     /**
-     * @brief Casts the values of the input column at index `c` and stores the
-     * casted values to column `c` in the output matrix.
-     * @param res The output matrix.
-     * @param argFrm The input frame.
-     * @param c The position of the column to cast.
+     * @brief Casts the values in rows `[rowBeg, rowEnd)` of an input column
+     * and stores the casted values to the corresponding column of the output
+     * matrix.
+     * @param resCol The first value of the column in the output matrix.
+     * @param rowSkip The row skip of the output matrix.
+     * @param argCol The raw values of the input column.
+     * @param rowBeg The first row to cast.
+     * @param rowEnd The row after the last row to cast.
      */
     template<typename VTArg>
-    static void castCol(DenseMatrix<VTRes> * res, const Frame * argFrm, size_t c) {
-        const size_t numRows = argFrm->getNumRows();
-        const DenseMatrix<VTArg> * argCol = argFrm->getColumn<VTArg>(c);
-        for(size_t r = 0; r < numRows; r++)
-            res->set(r, c, static_cast<VTRes>(argCol->get(r, 0)));
+    static void castColBlock(VTRes * resCol, size_t rowSkip, const void * argCol, size_t rowBeg, size_t rowEnd) {
+        const VTArg * argVals = static_cast<const VTArg *>(argCol);
+        for(size_t r = rowBeg; r < rowEnd; r++)
+            resCol[r * rowSkip] = static_cast<VTRes>(argVals[r]);
+    }
+
+    using CastColBlockFunc = void (*)(VTRes *, size_t, const void *, size_t, size_t);
+
+    static CastColBlockFunc getCastColBlock(ValueTypeCode vtc) {
+        switch(vtc) {
+            // For all value types:
+            case ValueTypeCode::F64: return &castColBlock<double>;
+            case ValueTypeCode::F32: return &castColBlock<float >;
+            case ValueTypeCode::SI64: return &castColBlock<int64_t>;
+            case ValueTypeCode::SI32: return &castColBlock<int32_t>;
+            case ValueTypeCode::SI8 : return &castColBlock<int8_t >;
+            case ValueTypeCode::UI64: return &castColBlock<uint64_t>;
+            case ValueTypeCode::UI32: return &castColBlock<uint32_t>;
+            case ValueTypeCode::UI8 : return &castColBlock<uint8_t >;
+            default: throw std::runtime_error("CastObj::apply: unknown value type code");
+        }
     }
     
 public:
@@ -92,29 +156,21 @@ public:
             // individual values.
             if(res == nullptr)
                 res = DataObjectFactory::create<DenseMatrix<VTRes>>(numRows, numCols, false);
-            // TODO We could run over the rows in blocks for cache efficiency.
+
+            // The value type of each column is dispatched only once.
+            std::vector<CastColBlockFunc> castFuncs(numCols);
+            std::vector<const void *> argCols(numCols);
             for(size_t c = 0; c < numCols; c++) {
-                // TODO We do not really need all cases.
-                // - All pairs of the same type can be handled by a single
-                //   copy-the-column helper function.
-                // - All pairs of (un)signed integer types of the same width
-                //   as well.
-                // - Truncating integers to a narrower type does not need to
-                //   consider (un)signedness either.
-                // - ...
-                switch(arg->getColumnType(c)) {
-                    // For all value types:
-                    case ValueTypeCode::F64: castCol<double>(res, arg, c); break;
-                    case ValueTypeCode::F32: castCol<float >(res, arg, c); break;
-                    case ValueTypeCode::SI64: castCol<int64_t>(res, arg, c); break;
-                    case ValueTypeCode::SI32: castCol<int32_t>(res, arg, c); break;
-                    case ValueTypeCode::SI8 : castCol<int8_t >(res, arg, c); break;
-                    case ValueTypeCode::UI64: castCol<uint64_t>(res, arg, c); break;
-                    case ValueTypeCode::UI32: castCol<uint32_t>(res, arg, c); break;
-                    case ValueTypeCode::UI8 : castCol<uint8_t >(res, arg, c); break;
-                    default: throw std::runtime_error("CastObj::apply: unknown value type code");
-                }
+                castFuncs[c] = getCastColBlock(arg->getColumnType(c));
+                argCols[c] = arg->getColumnRaw(c);
             }
+
+            VTRes * resVals = res->getValues();
+            const size_t rowSkip = res->getRowSkip();
+            forEachCastObjRowBlock(numRows, numCols, sizeof(VTRes), ctx, [&](size_t rowBeg, size_t rowEnd) {
+                for(size_t c = 0; c < numCols; c++)
+                    castFuncs[c](resVals + c, rowSkip, argCols[c], rowBeg, rowEnd);
+            });
         }
     }
 };
@@ -142,12 +198,22 @@ public:
             // The input matrix has multiple columns.
             // Need to change row-major to column-major layout and 
             // split matrix into single column matrices.
+            std::vector<VTArg *> colVals(numCols);
             for(size_t c = 0; c < numCols; c++) {
                 auto * colMatrix = DataObjectFactory::create<DenseMatrix<VTArg>>(numRows, 1, false);
-                for(size_t r = 0; r < numRows; r++)
-                    colMatrix->set(r, 0, arg->get(r, c));
+                colVals[c] = colMatrix->getValues();
                 cols.push_back(colMatrix);
-            }   
+            }
+            const VTArg * argVals = arg->getValues();
+            const size_t rowSkip = arg->getRowSkip();
+            forEachCastObjRowBlock(numRows, numCols, sizeof(VTArg), ctx, [&](size_t rowBeg, size_t rowEnd) {
+                for(size_t c = 0; c < numCols; c++) {
+                    VTArg * colValsC = colVals[c];
+                    const VTArg * argValsC = argVals + c;
+                    for(size_t r = rowBeg; r < rowEnd; r++)
+                        colValsC[r] = argValsC[r * rowSkip];
+                }
+            });
         }
         res = DataObjectFactory::create<Frame>(cols, nullptr);
     }
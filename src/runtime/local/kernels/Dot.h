@@ -0,0 +1,149 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_RUNTIME_LOCAL_KERNELS_DOT_H
+#define SRC_RUNTIME_LOCAL_KERNELS_DOT_H
+
+#include <runtime/local/context/DaphneContext.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <util/KernelThreads.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <cstddef>
+
+// ****************************************************************************
+// Struct for partial template specialization
+// ****************************************************************************
+
+template<typename VTRes, class DTLhs, class DTRhs>
+struct Dot {
+    static VTRes apply(const DTLhs * lhs, const DTRhs * rhs, DCTX(ctx)) = delete;
+};
+
+// ****************************************************************************
+// Convenience function
+// ****************************************************************************
+
+/**
+ * @brief Computes `sum(lhs * rhs)`, i.e., the sum of the element-wise
+ * products of two matrices of the same shape, without materializing the
+ * element-wise product.
+ */
+template<typename VTRes, class DTLhs, class DTRhs>
+VTRes dot(const DTLhs * lhs, const DTRhs * rhs, DCTX(ctx)) {
+    return Dot<VTRes, DTLhs, DTRhs>::apply(lhs, rhs, ctx);
+}
+
+// ****************************************************************************
+// Building block of the fused kernels
+// ****************************************************************************
+
+/**
+ * @brief The dot product of `n` contiguous values.
+ *
+ * Four independent accumulators allow the compiler to vectorize the loop
+ * without reassociating a single sum.
+ */
+template<typename VT>
+VT dotContiguous(const VT * a, const VT * b, size_t n) {
+    VT acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+    size_t i = 0;
+    for(; i + 4 <= n; i += 4) {
+        acc0 += a[i    ] * b[i    ];
+        acc1 += a[i + 1] * b[i + 1];
+        acc2 += a[i + 2] * b[i + 2];
+        acc3 += a[i + 3] * b[i + 3];
+    }
+    for(; i < n; i++)
+        acc0 += a[i] * b[i];
+    return (acc0 + acc1) + (acc2 + acc3);
+}
+
+/**
+ * @brief The approximate cost (number of multiply-adds) of a block of rows of
+ * the fused aggregation kernels.
+ */
+constexpr size_t FUSED_AGG_BLOCK_COST = size_t(1) << 16;
+
+/**
+ * @brief The minimum cost for which the fused aggregation kernels use
+ * multiple threads.
+ */
+constexpr size_t FUSED_AGG_MIN_PARALLEL_COST = size_t(1) << 20;
+
+/**
+ * @brief Sums up `func(rowBeg, rowEnd)` over blocks of rows, in parallel for
+ * large inputs.
+ *
+ * The scalar results of the fused aggregation kernels cannot be split up by
+ * the vectorized engine. Instead, each block of rows yields a partial sum,
+ * and the partial sums are added in the order of the blocks, such that the
+ * result does not depend on the scheduling of the threads. Inside vectorized
+ * pipelines, the blocks are processed by the calling worker.
+ *
+ * @param cost The total cost of all rows, which determines the block size.
+ */
+template<typename VT, typename Func>
+VT sumRowBlocks(size_t numRows, size_t cost, DCTX(ctx), Func func) {
+    if(cost < FUSED_AGG_MIN_PARALLEL_COST || numRows < 2)
+        return func(0, numRows);
+    const size_t blockRows = std::max<size_t>(1, numRows * FUSED_AGG_BLOCK_COST / cost);
+    const size_t numBlocks = (numRows + blockRows - 1) / blockRows;
+    const size_t numThreads = getNumKernelThreads(ctx != nullptr ? ctx->getUserConfig().numberOfThreads : 0);
+    std::vector<VT> partialSums(numBlocks);
+    parallelForEach(numBlocks, numThreads, [&](size_t b) {
+        partialSums[b] = func(b * blockRows, std::min(numRows, (b + 1) * blockRows));
+    });
+    VT res = 0;
+    for(VT partialSum : partialSums)
+        res += partialSum;
+    return res;
+}
+
+// ****************************************************************************
+// (Partial) template specializations for different data/value types
+// ****************************************************************************
+
+// ----------------------------------------------------------------------------
+// scalar <- DenseMatrix, DenseMatrix
+// ----------------------------------------------------------------------------
+
+template<typename VT>
+struct Dot<VT, DenseMatrix<VT>, DenseMatrix<VT>> {
+    static VT apply(const DenseMatrix<VT> * lhs, const DenseMatrix<VT> * rhs, DCTX(ctx)) {
+        const size_t numRows = lhs->getNumRows();
+        const size_t numCols = lhs->getNumCols();
+        if(numRows != rhs->getNumRows() || numCols != rhs->getNumCols())
+            throw std::runtime_error("Dot: lhs and rhs must have the same shape");
+
+        return sumRowBlocks<VT>(numRows, numRows * numCols, ctx, [&](size_t rowBeg, size_t rowEnd) {
+            const VT * valuesLhs = lhs->getValues() + rowBeg * lhs->getRowSkip();
+            const VT * valuesRhs = rhs->getValues() + rowBeg * rhs->getRowSkip();
+            VT res = 0;
+            for(size_t r = rowBeg; r < rowEnd; r++) {
+                res += dotContiguous(valuesLhs, valuesRhs, numCols);
+                valuesLhs += lhs->getRowSkip();
+                valuesRhs += rhs->getRowSkip();
+            }
+            return res;
+        });
+    }
+};
+
+#endif //SRC_RUNTIME_LOCAL_KERNELS_DOT_H
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_RUNTIME_LOCAL_KERNELS_EWMULPOSMASK_H
+#define SRC_RUNTIME_LOCAL_KERNELS_EWMULPOSMASK_H
+
+#include <runtime/local/context/DaphneContext.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+
+#include <stdexcept>
+
+#include <cstddef>
+
+// ****************************************************************************
+// Struct for partial template specialization
+// ****************************************************************************
+
+template<class DTRes, class DTArg, class DTMask>
+struct EwMulPosMask {
+    static void apply(DTRes *& res, const DTArg * arg, const DTMask * mask, DCTX(ctx)) = delete;
+};
+
+// ****************************************************************************
+// Convenience function
+// ****************************************************************************
+
+/**
+ * @brief Computes `arg * (mask > 0)`, i.e., keeps the values of `arg` where
+ * `mask` is positive and sets all others to zero, without materializing the
+ * comparison.
+ *
+ * This is, e.g., the backward pass of a ReLU activation.
+ */
+template<class DTRes, class DTArg, class DTMask>
+void ewMulPosMask(DTRes *& res, const DTArg * arg, const DTMask * mask, DCTX(ctx)) {
+    EwMulPosMask<DTRes, DTArg, DTMask>::apply(res, arg, mask, ctx);
+}
+
+// ****************************************************************************
+// (Partial) template specializations for different data/value types
+// ****************************************************************************
+
+// ----------------------------------------------------------------------------
+// DenseMatrix <- DenseMatrix, DenseMatrix
+// ----------------------------------------------------------------------------
+
+template<typename VT>
+struct EwMulPosMask<DenseMatrix<VT>, DenseMatrix<VT>, DenseMatrix<VT>> {
+    static void apply(DenseMatrix<VT> *& res, const DenseMatrix<VT> * arg, const DenseMatrix<VT> * mask, DCTX(ctx)) {
+        const size_t numRows = arg->getNumRows();
+        const size_t numCols = arg->getNumCols();
+        if(numRows != mask->getNumRows() || numCols != mask->getNumCols())
+            throw std::runtime_error("EwMulPosMask: arg and mask must have the same shape");
+
+        if(res == nullptr)
+            res = DataObjectFactory::create<DenseMatrix<VT>>(numRows, numCols, false);
+
+        const VT * valuesArg = arg->getValues();
+        const VT * valuesMask = mask->getValues();
+        VT * valuesRes = res->getValues();
+        for(size_t r = 0; r < numRows; r++) {
+            for(size_t c = 0; c < numCols; c++)
+                valuesRes[c] = valuesMask[c] > 0 ? valuesArg[c] : VT(0);
+            valuesArg += arg->getRowSkip();
+            valuesMask += mask->getRowSkip();
+            valuesRes += res->getRowSkip();
+        }
+    }
+};
+
+#endif //SRC_RUNTIME_LOCAL_KERNELS_EWMULPOSMASK_H
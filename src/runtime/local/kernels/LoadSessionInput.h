@@ -0,0 +1,60 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <runtime/local/context/DaphneContext.h>
+#include <runtime/local/datastructures/Structure.h>
+
+#include <stdexcept>
+#include <string>
+
+// ****************************************************************************
+// Struct for partial template specialization
+// ****************************************************************************
+
+template<class DTRes>
+struct LoadSessionInput {
+    static void apply(DTRes *& res, const char * name, DCTX(ctx)) {
+        auto inputs = ctx->getUserConfig().session_inputs;
+        if(!inputs)
+            throw std::runtime_error("loadSessionInput(): inputs can only be loaded when running in a session");
+        auto it = inputs->find(name);
+        if(it == inputs->end())
+            throw std::runtime_error("loadSessionInput(): there is no input named `" + std::string(name) + "`");
+        res = dynamic_cast<DTRes *>(it->second);
+        if(!res)
+            throw std::runtime_error(
+                    "loadSessionInput(): the input `" + std::string(name) +
+                    "` does not have the data and value type expected by the script"
+            );
+        // The session keeps its own reference to the input.
+        res->increaseRefCounter();
+    }
+};
+
+// ****************************************************************************
+// Convenience function
+// ****************************************************************************
+
+/**
+ * @brief Returns the data object bound under the given name in the current
+ * session (see `DaphneSession`), without copying it.
+ */
+template<class DTRes>
+void loadSessionInput(DTRes *& res, const char * name, DCTX(ctx)) {
+    LoadSessionInput<DTRes>::apply(res, name, ctx);
+}
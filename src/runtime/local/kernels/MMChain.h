@@ -0,0 +1,93 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_RUNTIME_LOCAL_KERNELS_MMCHAIN_H
+#define SRC_RUNTIME_LOCAL_KERNELS_MMCHAIN_H
+
+#include <runtime/local/context/DaphneContext.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/kernels/Dot.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include <cstddef>
+
+// ****************************************************************************
+// Struct for partial template specialization
+// ****************************************************************************
+
+template<class DTRes, class DTMat, class DTVec>
+struct MMChain {
+    static void apply(DTRes *& res, const DTMat * mat, const DTVec * vec, DCTX(ctx)) = delete;
+};
+
+// ****************************************************************************
+// Convenience function
+// ****************************************************************************
+
+/**
+ * @brief Computes `t(mat) @ (mat @ vec)` in a single pass over `mat`.
+ *
+ * Each row of `mat` is multiplied by `vec`, and the resulting scalar scales
+ * the same row, which is still in the cache, into the result. Neither
+ * `mat @ vec` nor `t(mat)` is materialized.
+ */
+template<class DTRes, class DTMat, class DTVec>
+void mmChain(DTRes *& res, const DTMat * mat, const DTVec * vec, DCTX(ctx)) {
+    MMChain<DTRes, DTMat, DTVec>::apply(res, mat, vec, ctx);
+}
+
+// ****************************************************************************
+// (Partial) template specializations for different data/value types
+// ****************************************************************************
+
+// ----------------------------------------------------------------------------
+// DenseMatrix <- DenseMatrix, DenseMatrix
+// ----------------------------------------------------------------------------
+
+template<typename VT>
+struct MMChain<DenseMatrix<VT>, DenseMatrix<VT>, DenseMatrix<VT>> {
+    static void apply(DenseMatrix<VT> *& res, const DenseMatrix<VT> * mat, const DenseMatrix<VT> * vec, DCTX(ctx)) {
+        const size_t numRows = mat->getNumRows();
+        const size_t numCols = mat->getNumCols();
+        if(vec->getNumRows() != numCols || vec->getNumCols() != 1)
+            throw std::runtime_error("MMChain: vec must be a column vector with as many rows as mat has columns");
+
+        // Contiguous copies of the vector and the accumulated result.
+        std::vector<VT> v(numCols);
+        for(size_t c = 0; c < numCols; c++)
+            v[c] = vec->get(c, 0);
+        std::vector<VT> acc(numCols, 0);
+
+        const VT * valuesMat = mat->getValues();
+        for(size_t r = 0; r < numRows; r++) {
+            const VT s = dotContiguous(valuesMat, v.data(), numCols);
+            if(s != 0)
+                for(size_t c = 0; c < numCols; c++)
+                    acc[c] += s * valuesMat[c];
+            valuesMat += mat->getRowSkip();
+        }
+
+        if(res == nullptr)
+            res = DataObjectFactory::create<DenseMatrix<VT>>(numCols, 1, false);
+        for(size_t c = 0; c < numCols; c++)
+            res->set(c, 0, acc[c]);
+    }
+};
+
+#endif //SRC_RUNTIME_LOCAL_KERNELS_MMCHAIN_H
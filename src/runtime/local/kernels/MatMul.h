@@ -23,7 +23,9 @@
 #include <runtime/local/datastructures/Matrix.h>
 #include <runtime/local/kernels/CastObj.h>
 
+#include <algorithm>
 #include <cstddef>
+#include <cstring>
 
 // ****************************************************************************
 // Struct for partial template specialization
@@ -57,19 +59,19 @@ template<typename VT>
 struct MatMul<DenseMatrix<VT>, CSRMatrix<VT>, DenseMatrix<VT>> {
     static void apply(DenseMatrix<VT> *& res, const CSRMatrix<VT> * lhs, const DenseMatrix<VT> * rhs, bool transa, bool transb, DCTX(ctx)) {
         const size_t nr1 = lhs->getNumRows();
-        [[maybe_unused]] const size_t nc1 = lhs->getNumCols();
+        const size_t nc1 = lhs->getNumCols();
 
-        [[maybe_unused]] const size_t nr2 = rhs->getNumRows();
-        const size_t nc2 = rhs->getNumCols();
+        const size_t nr2 = transb ? rhs->getNumCols() : rhs->getNumRows();
+        const size_t nc2 = transb ? rhs->getNumRows() : rhs->getNumCols();
 
-        if (nc1 != nr2) {
+        if ((transa ? nr1 : nc1) != nr2) {
             throw std::runtime_error(
                 "MatMul - #cols of lhs and #rows of rhs must be the same");
         }
-        // FIXME: transpose isn't supported atm
 
+        const size_t nrRes = transa ? nc1 : nr1;
         if(res == nullptr)
-            res = DataObjectFactory::create<DenseMatrix<VT>>(nr1, nc2, false);
+            res = DataObjectFactory::create<DenseMatrix<VT>>(nrRes, nc2, false);
 
         const VT * valuesRhs = rhs->getValues();
         VT * valuesRes = res->getValues();
@@ -77,19 +79,29 @@ struct MatMul<DenseMatrix<VT>, CSRMatrix<VT>, DenseMatrix<VT>> {
         const size_t rowSkipRhs = rhs->getRowSkip();
         const size_t rowSkipRes = res->getRowSkip();
 
-        memset(valuesRes, VT(0), sizeof(VT) * nr1 * nc2);
+        for(size_t r = 0; r < nrRes; r++)
+            memset(valuesRes + r * rowSkipRes, 0, sizeof(VT) * nc2);
         for(size_t r = 0; r < nr1; r++) {
             const size_t rowNumNonZeros = lhs->getNumNonZeros(r);
             const size_t * rowColIdxs = lhs->getColIdxs(r);
             const VT * rowValues = lhs->getValues(r);
 
-            const size_t rowIdxRes = r * rowSkipRes;
             for(size_t i = 0; i < rowNumNonZeros; i++) {
                 const size_t c = rowColIdxs[i];
-                const size_t rowIdxRhs = c * rowSkipRhs;
-
-                for(size_t j = 0; j < nc2; j++) {
-		            valuesRes[rowIdxRes + j] += rowValues[i] * valuesRhs[rowIdxRhs + j];
+                // For a transposed lhs, the non-zero (r, c) contributes row
+                // r of rhs to row c of the result instead of row c of rhs to
+                // row r of the result.
+                const size_t rowRes = transa ? c : r;
+                const size_t rowRhs = transa ? r : c;
+                VT * rowValuesRes = valuesRes + rowRes * rowSkipRes;
+
+                if(transb)
+                    for(size_t j = 0; j < nc2; j++)
+                        rowValuesRes[j] += rowValues[i] * valuesRhs[j * rowSkipRhs + rowRhs];
+                else {
+                    const VT * rowValuesRhs = valuesRhs + rowRhs * rowSkipRhs;
+                    for(size_t j = 0; j < nc2; j++)
+                        rowValuesRes[j] += rowValues[i] * rowValuesRhs[j];
                 }
             }
         }
@@ -129,3 +141,65 @@ struct MatMul<Matrix<VT>, Matrix<VT>, Matrix<VT>> {
         res->finishAppend();
     }
 };
+
+// ****************************************************************************
+// Naive variant
+// ****************************************************************************
+
+// A straightforward loop implementation without calling into BLAS, which can
+// be faster for small matrices, where the overhead of a BLAS call dominates.
+// Selected per call as a variant of matMul (see `"variants"` in kernels.json).
+
+template<class DTRes, class DTLhs, class DTRhs>
+struct MatMulNaive {
+    static void apply(DTRes *& res, const DTLhs * lhs, const DTRhs * rhs, bool transa, bool transb, DCTX(ctx)) = delete;
+};
+
+template<class DTRes, class DTLhs, class DTRhs>
+void matMulNaive(DTRes *& res, const DTLhs * lhs, const DTRhs * rhs, bool transa, bool transb, DCTX(ctx)) {
+    MatMulNaive<DTRes, DTLhs, DTRhs>::apply(res, lhs, rhs, transa, transb, ctx);
+}
+
+// ----------------------------------------------------------------------------
+// DenseMatrix <- DenseMatrix, DenseMatrix
+// ----------------------------------------------------------------------------
+
+template<typename VT>
+struct MatMulNaive<DenseMatrix<VT>, DenseMatrix<VT>, DenseMatrix<VT>> {
+    static void apply(DenseMatrix<VT> *& res, const DenseMatrix<VT> * lhs, const DenseMatrix<VT> * rhs, bool transa, bool transb, DCTX(ctx)) {
+        const size_t nrRes = transa ? lhs->getNumCols() : lhs->getNumRows();
+        const size_t nCommon = transa ? lhs->getNumRows() : lhs->getNumCols();
+        const size_t nr2 = transb ? rhs->getNumCols() : rhs->getNumRows();
+        const size_t ncRes = transb ? rhs->getNumRows() : rhs->getNumCols();
+
+        if(nCommon != nr2)
+            throw std::runtime_error("MatMul - #cols of lhs and #rows of rhs must be the same");
+
+        if(res == nullptr)
+            res = DataObjectFactory::create<DenseMatrix<VT>>(nrRes, ncRes, false);
+
+        const VT * valuesLhs = lhs->getValues();
+        const VT * valuesRhs = rhs->getValues();
+        VT * valuesRes = res->getValues();
+
+        const size_t rowSkipLhs = lhs->getRowSkip();
+        const size_t rowSkipRhs = rhs->getRowSkip();
+        const size_t rowSkipRes = res->getRowSkip();
+
+        for(size_t r = 0; r < nrRes; r++) {
+            VT * rowValuesRes = valuesRes + r * rowSkipRes;
+            std::fill(rowValuesRes, rowValuesRes + ncRes, VT(0));
+            for(size_t i = 0; i < nCommon; i++) {
+                const VT valLhs = transa ? valuesLhs[i * rowSkipLhs + r] : valuesLhs[r * rowSkipLhs + i];
+                if(transb)
+                    for(size_t c = 0; c < ncRes; c++)
+                        rowValuesRes[c] += valLhs * valuesRhs[c * rowSkipRhs + i];
+                else {
+                    const VT * rowValuesRhs = valuesRhs + i * rowSkipRhs;
+                    for(size_t c = 0; c < ncRes; c++)
+                        rowValuesRes[c] += valLhs * rowValuesRhs[c];
+                }
+            }
+        }
+    }
+};
@@ -0,0 +1,349 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_RUNTIME_LOCAL_KERNELS_MULTIAGG_H
+#define SRC_RUNTIME_LOCAL_KERNELS_MULTIAGG_H
+
+#include <runtime/local/context/DaphneContext.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/kernels/AggOpCode.h>
+#include <runtime/local/kernels/AggReduction.h>
+
+#include <algorithm>
+#include <bitset>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// ****************************************************************************
+// Struct for partial template specialization
+// ****************************************************************************
+
+// The multi-aggregation kernels compute several row/column-wise aggregations
+// of the same argument in a single scan of the argument. The requested
+// aggregations are passed as a bit mask `aggs` (see
+// `AggOpCodeUtils::getMultiAggBit`); supported are SUM, PROD, MIN, MAX,
+// IDXMIN, IDXMAX, MEAN, STDDEV, VAR, and NNZ. The result has one row
+// (multiAggCol) or one column (multiAggRow) per requested aggregation, in the
+// order of the AggOpCode enum.
+
+template<class DTRes, class DTArg>
+struct MultiAggCol {
+    static void apply(DTRes *& res, const DTArg * arg, int64_t aggs, DCTX(ctx)) = delete;
+};
+
+template<class DTRes, class DTArg>
+struct MultiAggRow {
+    static void apply(DTRes *& res, const DTArg * arg, int64_t aggs, DCTX(ctx)) = delete;
+};
+
+// ****************************************************************************
+// Convenience functions
+// ****************************************************************************
+
+template<class DTRes, class DTArg>
+void multiAggCol(DTRes *& res, const DTArg * arg, int64_t aggs, DCTX(ctx)) {
+    MultiAggCol<DTRes, DTArg>::apply(res, arg, aggs, ctx);
+}
+
+template<class DTRes, class DTArg>
+void multiAggRow(DTRes *& res, const DTArg * arg, int64_t aggs, DCTX(ctx)) {
+    MultiAggRow<DTRes, DTArg>::apply(res, arg, aggs, ctx);
+}
+
+// ****************************************************************************
+// Utilities
+// ****************************************************************************
+
+struct MultiAggUtils {
+    static constexpr AggOpCode ALL_OP_CODES[] = {
+        AggOpCode::SUM, AggOpCode::PROD, AggOpCode::MIN, AggOpCode::MAX, AggOpCode::IDXMIN,
+        AggOpCode::IDXMAX, AggOpCode::MEAN, AggOpCode::STDDEV, AggOpCode::VAR, AggOpCode::NNZ
+    };
+
+    static bool has(int64_t aggs, AggOpCode opCode) {
+        return aggs & AggOpCodeUtils::getMultiAggBit(opCode);
+    }
+
+    /**
+     * @brief Checks the bit mask of requested aggregations and returns the
+     * number of aggregations.
+     */
+    static size_t getNumAggs(int64_t aggs, const char * kernelName) {
+        int64_t supported = 0;
+        for(AggOpCode opCode : ALL_OP_CODES)
+            supported |= AggOpCodeUtils::getMultiAggBit(opCode);
+        if(aggs == 0 || (aggs & ~supported))
+            throw std::runtime_error(
+                    std::string(kernelName) + ": invalid bit mask of aggregations " + std::to_string(aggs)
+            );
+        return std::bitset<64>(aggs).count();
+    }
+};
+
+// ****************************************************************************
+// (Partial) template specializations for different data/value types
+// ****************************************************************************
+
+// ----------------------------------------------------------------------------
+// DenseMatrix <- DenseMatrix, column-wise
+// ----------------------------------------------------------------------------
+
+template<typename VTRes, typename VTArg>
+struct MultiAggCol<DenseMatrix<VTRes>, DenseMatrix<VTArg>> {
+    // The columns are processed in tiles, such that the accumulators of a
+    // tile stay in the L1 cache while scanning the rows.
+    static constexpr size_t COL_TILE = 512;
+
+    static void apply(DenseMatrix<VTRes> *& res, const DenseMatrix<VTArg> * arg, int64_t aggs, DCTX(ctx)) {
+        using MU = MultiAggUtils;
+
+        const size_t numRows = arg->getNumRows();
+        const size_t numCols = arg->getNumCols();
+        const size_t numAggs = MU::getNumAggs(aggs, "multiAggCol");
+        if(numRows == 0)
+            throw std::runtime_error("multiAggCol: the argument must have at least one row");
+
+        if(res == nullptr)
+            res = DataObjectFactory::create<DenseMatrix<VTRes>>(numAggs, numCols, false);
+
+        const bool needSum = MU::has(aggs, AggOpCode::SUM);
+        const bool needProd = MU::has(aggs, AggOpCode::PROD);
+        const bool needMin = MU::has(aggs, AggOpCode::MIN) || MU::has(aggs, AggOpCode::IDXMIN);
+        const bool needMax = MU::has(aggs, AggOpCode::MAX) || MU::has(aggs, AggOpCode::IDXMAX);
+        const bool needMoments = MU::has(aggs, AggOpCode::MEAN) || MU::has(aggs, AggOpCode::STDDEV) ||
+                                 MU::has(aggs, AggOpCode::VAR);
+        const bool needNnz = MU::has(aggs, AggOpCode::NNZ);
+
+        const VTArg * valuesArg = arg->getValues();
+        const size_t rowSkipArg = arg->getRowSkip();
+        VTRes * valuesRes = res->getValues();
+        const size_t rowSkipRes = res->getRowSkip();
+
+        // Accumulators for one tile of columns.
+        std::vector<VTRes> sum(needSum ? COL_TILE : 0);
+        std::vector<VTRes> prod(needProd ? COL_TILE : 0);
+        std::vector<VTArg> min(needMin ? COL_TILE : 0);
+        std::vector<VTArg> max(needMax ? COL_TILE : 0);
+        std::vector<size_t> idxMin(needMin ? COL_TILE : 0);
+        std::vector<size_t> idxMax(needMax ? COL_TILE : 0);
+        std::vector<VTRes> mean(needMoments ? COL_TILE : 0);
+        std::vector<VTRes> m2(needMoments ? COL_TILE : 0);
+        std::vector<size_t> nnz(needNnz ? COL_TILE : 0);
+
+        for(size_t c0 = 0; c0 < numCols; c0 += COL_TILE) {
+            const size_t w = std::min(COL_TILE, numCols - c0);
+
+            // Initialize the accumulators with the first row.
+            const VTArg * row = valuesArg + c0;
+            for(size_t c = 0; c < w; c++) {
+                if(needSum)
+                    sum[c] = static_cast<VTRes>(row[c]);
+                if(needProd)
+                    prod[c] = static_cast<VTRes>(row[c]);
+                if(needMin) {
+                    min[c] = row[c];
+                    idxMin[c] = 0;
+                }
+                if(needMax) {
+                    max[c] = row[c];
+                    idxMax[c] = 0;
+                }
+                if(needMoments) {
+                    mean[c] = static_cast<VTRes>(row[c]);
+                    m2[c] = 0;
+                }
+                if(needNnz)
+                    nnz[c] = row[c] != VTArg(0);
+            }
+
+            // Scan over the remaining rows. Each statistic has its own loop
+            // over the tile, such that the loops can be vectorized.
+            for(size_t r = 1; r < numRows; r++) {
+                row += rowSkipArg;
+                if(needSum)
+                    reduceInto<BinaryOpCode::ADD>(sum.data(), row, w);
+                if(needProd)
+                    reduceInto<BinaryOpCode::MUL>(prod.data(), row, w);
+                if(needMin)
+                    for(size_t c = 0; c < w; c++)
+                        if(row[c] < min[c]) {
+                            min[c] = row[c];
+                            idxMin[c] = r;
+                        }
+                if(needMax)
+                    for(size_t c = 0; c < w; c++)
+                        if(row[c] > max[c]) {
+                            max[c] = row[c];
+                            idxMax[c] = r;
+                        }
+                if(needMoments) {
+                    // Welford's online algorithm, which avoids the
+                    // cancellation of the textbook formula E[X^2] - E[X]^2.
+                    const VTRes invCount = VTRes(1) / static_cast<VTRes>(r + 1);
+                    for(size_t c = 0; c < w; c++) {
+                        const VTRes x = static_cast<VTRes>(row[c]);
+                        const VTRes delta = x - mean[c];
+                        mean[c] += delta * invCount;
+                        m2[c] += delta * (x - mean[c]);
+                    }
+                }
+                if(needNnz)
+                    for(size_t c = 0; c < w; c++)
+                        nnz[c] += row[c] != VTArg(0);
+            }
+
+            // Write the results of this tile.
+            VTRes * out = valuesRes + c0;
+            for(AggOpCode opCode : MU::ALL_OP_CODES) {
+                if(!MU::has(aggs, opCode))
+                    continue;
+                for(size_t c = 0; c < w; c++) {
+                    VTRes v;
+                    switch(opCode) {
+                        case AggOpCode::SUM:    v = sum[c]; break;
+                        case AggOpCode::PROD:   v = prod[c]; break;
+                        case AggOpCode::MIN:    v = static_cast<VTRes>(min[c]); break;
+                        case AggOpCode::MAX:    v = static_cast<VTRes>(max[c]); break;
+                        case AggOpCode::IDXMIN: v = static_cast<VTRes>(idxMin[c]); break;
+                        case AggOpCode::IDXMAX: v = static_cast<VTRes>(idxMax[c]); break;
+                        case AggOpCode::MEAN:   v = mean[c]; break;
+                        case AggOpCode::VAR:    v = m2[c] / numRows; break;
+                        case AggOpCode::STDDEV: v = std::sqrt(m2[c] / numRows); break;
+                        case AggOpCode::NNZ:    v = static_cast<VTRes>(nnz[c]); break;
+                    }
+                    out[c] = v;
+                }
+                out += rowSkipRes;
+            }
+        }
+    }
+};
+
+// ----------------------------------------------------------------------------
+// DenseMatrix <- DenseMatrix, row-wise
+// ----------------------------------------------------------------------------
+
+template<typename VTRes, typename VTArg>
+struct MultiAggRow<DenseMatrix<VTRes>, DenseMatrix<VTArg>> {
+    static void apply(DenseMatrix<VTRes> *& res, const DenseMatrix<VTArg> * arg, int64_t aggs, DCTX(ctx)) {
+        using MU = MultiAggUtils;
+
+        const size_t numRows = arg->getNumRows();
+        const size_t numCols = arg->getNumCols();
+        const size_t numAggs = MU::getNumAggs(aggs, "multiAggRow");
+        if(numCols == 0)
+            throw std::runtime_error("multiAggRow: the argument must have at least one column");
+
+        if(res == nullptr)
+            res = DataObjectFactory::create<DenseMatrix<VTRes>>(numRows, numAggs, false);
+
+        const bool needIdx = MU::has(aggs, AggOpCode::IDXMIN) || MU::has(aggs, AggOpCode::IDXMAX);
+
+        const VTArg * valuesArg = arg->getValues();
+        VTRes * valuesRes = res->getValues();
+
+        for(size_t r = 0; r < numRows; r++) {
+            // The row is read from memory once; all statistics but the first
+            // one find it in the cache.
+            VTRes sum = 0;
+            VTRes mean = 0;
+            if(MU::has(aggs, AggOpCode::SUM) || MU::has(aggs, AggOpCode::MEAN) ||
+                    MU::has(aggs, AggOpCode::STDDEV) || MU::has(aggs, AggOpCode::VAR)) {
+                sum = reduceContiguous<BinaryOpCode::ADD>(valuesArg, numCols, VTRes(0));
+                mean = sum / numCols;
+            }
+            VTRes var = 0;
+            if(MU::has(aggs, AggOpCode::STDDEV) || MU::has(aggs, AggOpCode::VAR)) {
+                // Two-pass algorithm over the cached row (sum of squared
+                // deviations from the mean), with multiple accumulators.
+                VTRes acc[AGG_NUM_ACCUMULATORS] = {};
+                size_t c = 0;
+                for(; c + AGG_NUM_ACCUMULATORS <= numCols; c += AGG_NUM_ACCUMULATORS)
+                    for(size_t k = 0; k < AGG_NUM_ACCUMULATORS; k++) {
+                        const VTRes d = static_cast<VTRes>(valuesArg[c + k]) - mean;
+                        acc[k] += d * d;
+                    }
+                for(size_t k = 0; c < numCols; c++, k++) {
+                    const VTRes d = static_cast<VTRes>(valuesArg[c]) - mean;
+                    acc[k] += d * d;
+                }
+                for(size_t k = 0; k < AGG_NUM_ACCUMULATORS; k++)
+                    var += acc[k];
+                var /= numCols;
+            }
+            VTArg min = valuesArg[0];
+            VTArg max = valuesArg[0];
+            size_t idxMin = 0;
+            size_t idxMax = 0;
+            if(needIdx) {
+                for(size_t c = 1; c < numCols; c++) {
+                    if(valuesArg[c] < min) {
+                        min = valuesArg[c];
+                        idxMin = c;
+                    }
+                    if(valuesArg[c] > max) {
+                        max = valuesArg[c];
+                        idxMax = c;
+                    }
+                }
+            }
+            else {
+                if(MU::has(aggs, AggOpCode::MIN))
+                    min = reduceContiguous<BinaryOpCode::MIN>(valuesArg, numCols, valuesArg[0]);
+                if(MU::has(aggs, AggOpCode::MAX))
+                    max = reduceContiguous<BinaryOpCode::MAX>(valuesArg, numCols, valuesArg[0]);
+            }
+
+            VTRes * out = valuesRes;
+            for(AggOpCode opCode : MU::ALL_OP_CODES) {
+                if(!MU::has(aggs, opCode))
+                    continue;
+                switch(opCode) {
+                    case AggOpCode::SUM:    *out = sum; break;
+                    case AggOpCode::PROD:
+                        *out = reduceContiguous<BinaryOpCode::MUL>(valuesArg, numCols, VTRes(1));
+                        break;
+                    case AggOpCode::MIN:    *out = static_cast<VTRes>(min); break;
+                    case AggOpCode::MAX:    *out = static_cast<VTRes>(max); break;
+                    case AggOpCode::IDXMIN: *out = static_cast<VTRes>(idxMin); break;
+                    case AggOpCode::IDXMAX: *out = static_cast<VTRes>(idxMax); break;
+                    case AggOpCode::MEAN:   *out = mean; break;
+                    case AggOpCode::VAR:    *out = var; break;
+                    case AggOpCode::STDDEV: *out = std::sqrt(var); break;
+                    case AggOpCode::NNZ: {
+                        size_t nnz = 0;
+                        for(size_t c = 0; c < numCols; c++)
+                            nnz += valuesArg[c] != VTArg(0);
+                        *out = static_cast<VTRes>(nnz);
+                        break;
+                    }
+                }
+                out++;
+            }
+
+            valuesArg += arg->getRowSkip();
+            valuesRes += res->getRowSkip();
+        }
+    }
+};
+
+#endif //SRC_RUNTIME_LOCAL_KERNELS_MULTIAGG_H
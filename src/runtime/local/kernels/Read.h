@@ -97,7 +97,7 @@ struct Read<DenseMatrix<VT>> {
 		readParquet(res, filename, fmd.numRows, fmd.numCols);
 		break;
 	case 3:
-		readDaphne(res, filename);
+		readDaphne(res, filename, ctx != nullptr && ctx->getUserConfig().use_mmap_io);
                 break;
         default:
             throw std::runtime_error("File extension not supported");
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <runtime/local/context/DaphneContext.h>
+#include <runtime/local/context/IRecompiler.h>
+#include <runtime/local/datastructures/Structure.h>
+
+#include <stdexcept>
+
+#include <cstddef>
+
+// ****************************************************************************
+// Convenience function
+// ****************************************************************************
+
+template<class DTRes>
+void recompileCall(
+        DTRes ** res, size_t numRes,
+        const Structure ** args, size_t numArgs,
+        const char * irCode,
+        DCTX(ctx)
+) {
+    IRecompiler * recompiler = ctx->config.recompiler;
+    if(recompiler == nullptr)
+        throw std::runtime_error(
+                "recompileCall: no recompiler is available, adaptive "
+                "recompilation must be enabled by the caller of the compiler"
+        );
+
+    recompiler->call(reinterpret_cast<Structure **>(res), numRes, args, numArgs, irCode);
+}
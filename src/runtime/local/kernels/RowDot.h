@@ -0,0 +1,82 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_RUNTIME_LOCAL_KERNELS_ROWDOT_H
+#define SRC_RUNTIME_LOCAL_KERNELS_ROWDOT_H
+
+#include <runtime/local/context/DaphneContext.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/kernels/Dot.h>
+
+#include <stdexcept>
+
+#include <cstddef>
+
+// ****************************************************************************
+// Struct for partial template specialization
+// ****************************************************************************
+
+template<class DTRes, class DTLhs, class DTRhs>
+struct RowDot {
+    static void apply(DTRes *& res, const DTLhs * lhs, const DTRhs * rhs, DCTX(ctx)) = delete;
+};
+
+// ****************************************************************************
+// Convenience function
+// ****************************************************************************
+
+/**
+ * @brief Computes `sum(lhs * rhs, 0)`, i.e., the row-wise dot products of two
+ * matrices of the same shape, without materializing the element-wise product.
+ */
+template<class DTRes, class DTLhs, class DTRhs>
+void rowDot(DTRes *& res, const DTLhs * lhs, const DTRhs * rhs, DCTX(ctx)) {
+    RowDot<DTRes, DTLhs, DTRhs>::apply(res, lhs, rhs, ctx);
+}
+
+// ****************************************************************************
+// (Partial) template specializations for different data/value types
+// ****************************************************************************
+
+// ----------------------------------------------------------------------------
+// DenseMatrix <- DenseMatrix, DenseMatrix
+// ----------------------------------------------------------------------------
+
+template<typename VT>
+struct RowDot<DenseMatrix<VT>, DenseMatrix<VT>, DenseMatrix<VT>> {
+    static void apply(DenseMatrix<VT> *& res, const DenseMatrix<VT> * lhs, const DenseMatrix<VT> * rhs, DCTX(ctx)) {
+        const size_t numRows = lhs->getNumRows();
+        const size_t numCols = lhs->getNumCols();
+        if(numRows != rhs->getNumRows() || numCols != rhs->getNumCols())
+            throw std::runtime_error("RowDot: lhs and rhs must have the same shape");
+
+        if(res == nullptr)
+            res = DataObjectFactory::create<DenseMatrix<VT>>(numRows, 1, false);
+
+        const VT * valuesLhs = lhs->getValues();
+        const VT * valuesRhs = rhs->getValues();
+        VT * valuesRes = res->getValues();
+        for(size_t r = 0; r < numRows; r++) {
+            *valuesRes = dotContiguous(valuesLhs, valuesRhs, numCols);
+            valuesLhs += lhs->getRowSkip();
+            valuesRhs += rhs->getRowSkip();
+            valuesRes += res->getRowSkip();
+        }
+    }
+};
+
+#endif //SRC_RUNTIME_LOCAL_KERNELS_ROWDOT_H
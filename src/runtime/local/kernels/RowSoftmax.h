@@ -0,0 +1,91 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_RUNTIME_LOCAL_KERNELS_ROWSOFTMAX_H
+#define SRC_RUNTIME_LOCAL_KERNELS_ROWSOFTMAX_H
+
+#include <runtime/local/context/DaphneContext.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+// ****************************************************************************
+// Struct for partial template specialization
+// ****************************************************************************
+
+template<class DTRes, class DTArg>
+struct RowSoftmax {
+    static void apply(DTRes *& res, const DTArg * arg, DCTX(ctx)) = delete;
+};
+
+// ****************************************************************************
+// Convenience function
+// ****************************************************************************
+
+/**
+ * @brief Computes the softmax of each row, i.e., `E / sum(E, 0)` with
+ * `E = exp(arg - aggMax(arg, 0))`.
+ *
+ * Each row is processed while it is in the cache; the intermediate results
+ * of the composition are not materialized. Subtracting the row maximum
+ * avoids overflows of `exp` and does not change the result.
+ */
+template<class DTRes, class DTArg>
+void rowSoftmax(DTRes *& res, const DTArg * arg, DCTX(ctx)) {
+    RowSoftmax<DTRes, DTArg>::apply(res, arg, ctx);
+}
+
+// ****************************************************************************
+// (Partial) template specializations for different data/value types
+// ****************************************************************************
+
+// ----------------------------------------------------------------------------
+// DenseMatrix <- DenseMatrix
+// ----------------------------------------------------------------------------
+
+template<typename VT>
+struct RowSoftmax<DenseMatrix<VT>, DenseMatrix<VT>> {
+    static void apply(DenseMatrix<VT> *& res, const DenseMatrix<VT> * arg, DCTX(ctx)) {
+        const size_t numRows = arg->getNumRows();
+        const size_t numCols = arg->getNumCols();
+
+        if(res == nullptr)
+            res = DataObjectFactory::create<DenseMatrix<VT>>(numRows, numCols, false);
+
+        const VT * valuesArg = arg->getValues();
+        VT * valuesRes = res->getValues();
+        for(size_t r = 0; r < numRows; r++) {
+            if(numCols) {
+                const VT max = *std::max_element(valuesArg, valuesArg + numCols);
+                VT sum = 0;
+                for(size_t c = 0; c < numCols; c++) {
+                    valuesRes[c] = std::exp(valuesArg[c] - max);
+                    sum += valuesRes[c];
+                }
+                const VT invSum = VT(1) / sum;
+                for(size_t c = 0; c < numCols; c++)
+                    valuesRes[c] *= invSum;
+            }
+            valuesArg += arg->getRowSkip();
+            valuesRes += res->getRowSkip();
+        }
+    }
+};
+
+#endif //SRC_RUNTIME_LOCAL_KERNELS_ROWSOFTMAX_H
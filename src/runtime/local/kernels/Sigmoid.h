@@ -0,0 +1,77 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_RUNTIME_LOCAL_KERNELS_SIGMOID_H
+#define SRC_RUNTIME_LOCAL_KERNELS_SIGMOID_H
+
+#include <runtime/local/context/DaphneContext.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+
+#include <cmath>
+#include <cstddef>
+
+// ****************************************************************************
+// Struct for partial template specialization
+// ****************************************************************************
+
+template<class DTRes, class DTArg>
+struct Sigmoid {
+    static void apply(DTRes *& res, const DTArg * arg, DCTX(ctx)) = delete;
+};
+
+// ****************************************************************************
+// Convenience function
+// ****************************************************************************
+
+/**
+ * @brief Computes the logistic function `1 / (1 + exp(-arg))` element-wise,
+ * without materializing the three intermediate results.
+ */
+template<class DTRes, class DTArg>
+void sigmoid(DTRes *& res, const DTArg * arg, DCTX(ctx)) {
+    Sigmoid<DTRes, DTArg>::apply(res, arg, ctx);
+}
+
+// ****************************************************************************
+// (Partial) template specializations for different data/value types
+// ****************************************************************************
+
+// ----------------------------------------------------------------------------
+// DenseMatrix <- DenseMatrix
+// ----------------------------------------------------------------------------
+
+template<typename VT>
+struct Sigmoid<DenseMatrix<VT>, DenseMatrix<VT>> {
+    static void apply(DenseMatrix<VT> *& res, const DenseMatrix<VT> * arg, DCTX(ctx)) {
+        const size_t numRows = arg->getNumRows();
+        const size_t numCols = arg->getNumCols();
+
+        if(res == nullptr)
+            res = DataObjectFactory::create<DenseMatrix<VT>>(numRows, numCols, false);
+
+        const VT * valuesArg = arg->getValues();
+        VT * valuesRes = res->getValues();
+        for(size_t r = 0; r < numRows; r++) {
+            for(size_t c = 0; c < numCols; c++)
+                valuesRes[c] = VT(1) / (VT(1) + std::exp(-valuesArg[c]));
+            valuesArg += arg->getRowSkip();
+            valuesRes += res->getRowSkip();
+        }
+    }
+};
+
+#endif //SRC_RUNTIME_LOCAL_KERNELS_SIGMOID_H
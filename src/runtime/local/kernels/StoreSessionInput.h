@@ -0,0 +1,62 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <runtime/local/context/DaphneContext.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/datastructures/Structure.h>
+
+#include <stdexcept>
+#include <string>
+
+// ****************************************************************************
+// Struct for partial template specialization
+// ****************************************************************************
+
+template<class DTArg>
+struct StoreSessionInput {
+    static void apply(const DTArg * arg, const char * name, DCTX(ctx)) {
+        auto outputs = ctx->getUserConfig().session_outputs;
+        if(!outputs)
+            throw std::runtime_error("storeSessionInput(): inputs can only be stored when running in a session");
+        // Keep the data object alive until the session takes it over after
+        // the script has finished.
+        arg->increaseRefCounter();
+        Structure * obj = const_cast<DTArg *>(arg);
+        auto it = outputs->find(name);
+        if(it != outputs->end()) {
+            DataObjectFactory::destroy(it->second);
+            it->second = obj;
+        }
+        else
+            outputs->emplace(name, obj);
+    }
+};
+
+// ****************************************************************************
+// Convenience function
+// ****************************************************************************
+
+/**
+ * @brief Binds the given data object under the given name in the current
+ * session (see `DaphneSession`) once the script has finished, such that
+ * subsequent scripts can load it via `loadSessionInput()`.
+ */
+template<class DTArg>
+void storeSessionInput(const DTArg * arg, const char * name, DCTX(ctx)) {
+    StoreSessionInput<DTArg>::apply(arg, name, ctx);
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2021 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <runtime/local/context/DaphneContext.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/io/RowChunkReader.h>
+#include <runtime/local/kernels/BinaryOpCode.h>
+#include <runtime/local/kernels/EwBinaryMat.h>
+#include <runtime/local/kernels/VectorizedPipeline.h>
+#include <parser/metadata/MetaDataParser.h>
+#include <ir/daphneir/Daphne.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+using mlir::daphne::VectorSplit;
+using mlir::daphne::VectorCombine;
+
+// ****************************************************************************
+// Struct for partial template specialization
+// ****************************************************************************
+
+/**
+ * @brief Executes a vectorized pipeline whose input `streamInput` is not a
+ * matrix, but the name of a file containing it.
+ *
+ * The file is read in chunks of `streaming_chunk_rows` rows (while the next
+ * chunk is read in the background), the pipeline is executed on each chunk,
+ * and the results of all chunks are added up. All other row-split inputs are
+ * sliced accordingly. Thus, only `ADD`-combined outputs are supported.
+ */
+template<class DTRes>
+struct StreamingPipeline {
+    static void apply(DTRes ** outputs, size_t numOutputs, bool* isScalar, Structure **inputs, size_t numInputs,
+            int64_t *outRows, int64_t *outCols, int64_t *splits, int64_t *combines, int64_t streamInput,
+            size_t numFuncs, void** fun, DCTX(ctx)) = delete;
+};
+
+// ****************************************************************************
+// Convenience function
+// ****************************************************************************
+
+template<class DTRes>
+[[maybe_unused]] void streamingPipeline(DTRes ** outputs, size_t numOutputs, bool* isScalar, Structure **inputs,
+        size_t numInputs, int64_t *outRows, int64_t *outCols, int64_t *splits, int64_t *combines,
+        int64_t streamInput, size_t numFuncs, void** fun, DCTX(ctx)) {
+    StreamingPipeline<DTRes>::apply(outputs, numOutputs, isScalar, inputs, numInputs, outRows, outCols, splits,
+            combines, streamInput, numFuncs, fun, ctx);
+}
+
+// ****************************************************************************
+// (Partial) template specializations for different data/value types
+// ****************************************************************************
+
+// ----------------------------------------------------------------------------
+// DenseMatrix
+// ----------------------------------------------------------------------------
+
+template<typename VT>
+struct StreamingPipeline<DenseMatrix<VT>> {
+    static void apply(DenseMatrix<VT> ** outputs, size_t numOutputs, bool* isScalar, Structure **inputs,
+            size_t numInputs, int64_t *outRows, int64_t *outCols, int64_t *splits, int64_t *combines,
+            int64_t streamInput, size_t numFuncs, void** fun, DCTX(ctx)) {
+        using DT = DenseMatrix<VT>;
+
+        for(size_t i = 0; i < numOutputs; i++)
+            if(static_cast<VectorCombine>(combines[i]) != VectorCombine::ADD)
+                throw std::runtime_error("StreamingPipeline: only ADD-combined outputs can be streamed");
+
+        const char * filename = reinterpret_cast<const char *>(inputs[streamInput]);
+        FileMetaData fmd = MetaDataParser::readMetaData(filename);
+        RowChunkReader<VT> reader(filename, fmd.numRows, fmd.numCols, ctx->getUserConfig().streaming_chunk_rows);
+        ctx->logger->debug("StreamingPipeline: streaming {} rows from {}", fmd.numRows, filename);
+
+        std::vector<Structure *> chunkInputs(inputs, inputs + numInputs);
+        std::vector<DT *> chunkOutputs(numOutputs);
+        size_t rowOffset;
+        while(DT * chunk = reader.next(rowOffset)) {
+            const size_t rowEnd = rowOffset + chunk->getNumRows();
+            chunkInputs[streamInput] = chunk;
+            for(size_t i = 0; i < numInputs; i++)
+                if(i != static_cast<size_t>(streamInput) && !isScalar[i] &&
+                        static_cast<VectorSplit>(splits[i]) == VectorSplit::ROWS)
+                    chunkInputs[i] = inputs[i]->sliceRow(rowOffset, rowEnd);
+
+            std::fill(chunkOutputs.begin(), chunkOutputs.end(), nullptr);
+            vectorizedPipeline(chunkOutputs.data(), numOutputs, isScalar, chunkInputs.data(), numInputs, outRows,
+                    outCols, splits, combines, numFuncs, fun, ctx);
+
+            for(size_t i = 0; i < numOutputs; i++) {
+                if(outputs[i] == nullptr)
+                    outputs[i] = chunkOutputs[i];
+                else {
+                    ewBinaryMat(BinaryOpCode::ADD, outputs[i], outputs[i], chunkOutputs[i], ctx);
+                    DataObjectFactory::destroy(chunkOutputs[i]);
+                }
+            }
+
+            for(size_t i = 0; i < numInputs; i++)
+                if(chunkInputs[i] != inputs[i])
+                    DataObjectFactory::destroy(chunkInputs[i]);
+        }
+
+        // An empty file yields all-zero results.
+        for(size_t i = 0; i < numOutputs; i++)
+            if(outputs[i] == nullptr) {
+                if(outRows[i] == -1 || outCols[i] == -1)
+                    throw std::runtime_error("StreamingPipeline: cannot determine the shape of an output "
+                                             "for an empty input file");
+                outputs[i] = DataObjectFactory::create<DT>(outRows[i], outCols[i], true);
+            }
+    }
+};
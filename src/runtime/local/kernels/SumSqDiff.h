@@ -0,0 +1,92 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_RUNTIME_LOCAL_KERNELS_SUMSQDIFF_H
+#define SRC_RUNTIME_LOCAL_KERNELS_SUMSQDIFF_H
+
+#include <runtime/local/context/DaphneContext.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/kernels/Dot.h>
+
+#include <stdexcept>
+
+#include <cstddef>
+
+// ****************************************************************************
+// Struct for partial template specialization
+// ****************************************************************************
+
+template<typename VTRes, class DTLhs, class DTRhs>
+struct SumSqDiff {
+    static VTRes apply(const DTLhs * lhs, const DTRhs * rhs, DCTX(ctx)) = delete;
+};
+
+// ****************************************************************************
+// Convenience function
+// ****************************************************************************
+
+/**
+ * @brief Computes `sum((lhs - rhs)^2)`, i.e., the squared Euclidean distance
+ * of two matrices of the same shape, without materializing the difference.
+ */
+template<typename VTRes, class DTLhs, class DTRhs>
+VTRes sumSqDiff(const DTLhs * lhs, const DTRhs * rhs, DCTX(ctx)) {
+    return SumSqDiff<VTRes, DTLhs, DTRhs>::apply(lhs, rhs, ctx);
+}
+
+// ****************************************************************************
+// (Partial) template specializations for different data/value types
+// ****************************************************************************
+
+// ----------------------------------------------------------------------------
+// scalar <- DenseMatrix, DenseMatrix
+// ----------------------------------------------------------------------------
+
+template<typename VT>
+struct SumSqDiff<VT, DenseMatrix<VT>, DenseMatrix<VT>> {
+    static VT apply(const DenseMatrix<VT> * lhs, const DenseMatrix<VT> * rhs, DCTX(ctx)) {
+        const size_t numRows = lhs->getNumRows();
+        const size_t numCols = lhs->getNumCols();
+        if(numRows != rhs->getNumRows() || numCols != rhs->getNumCols())
+            throw std::runtime_error("SumSqDiff: lhs and rhs must have the same shape");
+
+        return sumRowBlocks<VT>(numRows, numRows * numCols, ctx, [&](size_t rowBeg, size_t rowEnd) {
+            const VT * valuesLhs = lhs->getValues() + rowBeg * lhs->getRowSkip();
+            const VT * valuesRhs = rhs->getValues() + rowBeg * rhs->getRowSkip();
+            VT res = 0;
+            for(size_t r = rowBeg; r < rowEnd; r++) {
+                VT acc0 = 0, acc1 = 0;
+                size_t c = 0;
+                for(; c + 2 <= numCols; c += 2) {
+                    const VT d0 = valuesLhs[c] - valuesRhs[c];
+                    const VT d1 = valuesLhs[c + 1] - valuesRhs[c + 1];
+                    acc0 += d0 * d0;
+                    acc1 += d1 * d1;
+                }
+                if(c < numCols) {
+                    const VT d = valuesLhs[c] - valuesRhs[c];
+                    acc0 += d * d;
+                }
+                res += acc0 + acc1;
+                valuesLhs += lhs->getRowSkip();
+                valuesRhs += rhs->getRowSkip();
+            }
+            return res;
+        });
+    }
+};
+
+#endif //SRC_RUNTIME_LOCAL_KERNELS_SUMSQDIFF_H
@@ -21,12 +21,66 @@
 #include <runtime/local/datastructures/DataObjectFactory.h>
 #include <runtime/local/datastructures/DenseMatrix.h>
 #include <runtime/local/datastructures/Matrix.h>
+#include <runtime/local/datastructures/MncSketch.h>
 #include <runtime/local/io/File.h>
 #include <runtime/local/io/FileMetaData.h>
+#include <runtime/local/io/MncSketchFile.h>
+#include <runtime/local/io/ParallelIO.h>
 #include <runtime/local/io/WriteCsv.h>
 #include <runtime/local/io/WriteDaphne.h>
 #include <parser/metadata/MetaDataParser.h>
 
+#include <filesystem>
+#include <memory>
+#include <system_error>
+
+
+// ****************************************************************************
+// Helper functions
+// ****************************************************************************
+
+inline size_t getNumWriteThreads(DCTX(ctx)) {
+    if (ctx != nullptr && ctx->getUserConfig().numberOfThreads > 0)
+        return ctx->getUserConfig().numberOfThreads;
+    return 0;
+}
+
+/**
+ * @brief Returns a builder for the MNC sketch of the given matrix, if the user
+ * asked for storing the sketches of written matrices, or null otherwise.
+ */
+template<typename VT>
+std::unique_ptr<MncSketchBuilder> createMncSketchBuilder(const DenseMatrix<VT> * arg, DCTX(ctx)) {
+    if (ctx == nullptr || !ctx->getUserConfig().write_mnc_sketch)
+        return nullptr;
+    return std::make_unique<MncSketchBuilder>(arg->getNumRows(), arg->getNumCols());
+}
+
+/**
+ * @brief Writes the meta data of the given matrix after its values have been
+ * written.
+ *
+ * If a sketch was collected while writing the values, the number of non-zeros
+ * is stored in the meta data and the MNC sketch in a separate file (see
+ * `writeMncSketch`), such that the compiler can estimate the sparsity of
+ * computations on the matrix when it is read again. Otherwise, a sketch left
+ * over from a previous version of the file is removed.
+ */
+template<typename VT>
+void writeMatrixMetaData(const DenseMatrix<VT> * arg, const char * filename, MncSketchBuilder * sketchBuilder) {
+    if (sketchBuilder) {
+        MncSketch sketch = sketchBuilder->build();
+        writeMncSketch(filename, sketch);
+        MetaDataParser::writeMetaData(filename, FileMetaData(arg->getNumRows(), arg->getNumCols(), true,
+                ValueTypeUtils::codeFor<VT>, static_cast<ssize_t>(sketch.nnz)));
+    }
+    else {
+        std::error_code ec;
+        std::filesystem::remove(getMncSketchFilename(filename), ec);
+        MetaDataParser::writeMetaData(filename, FileMetaData(arg->getNumRows(), arg->getNumCols(), true,
+                ValueTypeUtils::codeFor<VT>));
+    }
+}
 
 // ****************************************************************************
 // Struct for partial template specialization
@@ -62,14 +116,29 @@ struct Write<DenseMatrix<VT>> {
 	std::string ext(fn.substr(pos+1)) ;
 	if (ext == "csv") {
 		File * file = openFileForWrite(filename);
-		FileMetaData metaData(arg->getNumRows(), arg->getNumCols(), true, ValueTypeUtils::codeFor<VT>);
-		MetaDataParser::writeMetaData(filename, metaData);
-		writeCsv(arg, file);
+		auto sketch = createMncSketchBuilder(arg, ctx);
+		WriteCsv<DenseMatrix<VT>>::apply(arg, file, ctx != nullptr && ctx->getUserConfig().csv_full_precision,
+				getNumWriteThreads(ctx), sketch.get());
 		closeFile(file);
+		writeMatrixMetaData(arg, filename, sketch.get());
 	} else if (ext == "dbdf") {
-        FileMetaData metaData(arg->getNumRows(), arg->getNumCols(), true, ValueTypeUtils::codeFor<VT>);
-        MetaDataParser::writeMetaData(filename, metaData);
-		writeDaphne(arg, filename);
+		auto sketch = createMncSketchBuilder(arg, ctx);
+		if (ctx != nullptr && ctx->getUserConfig().dbdf_block_rows)
+			writeDaphneBlocked(arg, filename, ctx->getUserConfig().dbdf_block_rows, getNumWriteThreads(ctx), sketch.get());
+		else {
+			writeDaphne(arg, filename);
+			// The single-block format is written sequentially, so the sketch
+			// is collected in a separate parallel pass.
+			if (sketch) {
+				const size_t numRows = arg->getNumRows();
+				const size_t rowsPerBlock = std::max<size_t>(1, CSV_WRITE_BLOCK_CELLS / std::max<size_t>(1, arg->getNumCols()));
+				parallelForEach((numRows + rowsPerBlock - 1) / rowsPerBlock, getNumWriteThreads(ctx), [&](size_t b) {
+					const size_t rowBegin = b * rowsPerBlock;
+					sketch->addRows(arg->getValues(), arg->getRowSkip(), rowBegin, std::min(rowBegin + rowsPerBlock, numRows));
+				});
+			}
+		}
+		writeMatrixMetaData(arg, filename, sketch.get());
     } else {
       throw std::runtime_error( "[Write.h] - unsupported file extension in write kernel.");
     }
@@ -92,7 +161,7 @@ struct Write<Frame> {
         }
         FileMetaData metaData(arg->getNumRows(), arg->getNumCols(), false, vtcs, labels);
         MetaDataParser::writeMetaData(filename, metaData);
-        writeCsv(arg, file);
+        writeCsv(arg, file, ctx != nullptr && ctx->getUserConfig().csv_full_precision, getNumWriteThreads(ctx));
         closeFile(file);
     }
 };
@@ -111,7 +180,7 @@ struct Write<Matrix<VT>> {
         File * file = openFileForWrite(filename);
         FileMetaData metaData(arg->getNumRows(), arg->getNumCols(), true, ValueTypeUtils::codeFor<VT>);
         MetaDataParser::writeMetaData(filename, metaData);
-        writeCsv(arg, file);
+        writeCsv(arg, file, ctx != nullptr && ctx->getUserConfig().csv_full_precision, getNumWriteThreads(ctx));
         closeFile(file);
     } else {
         throw std::runtime_error( "[Write.h] - generic Matrix type currently only supports csv file extension.");
@@ -0,0 +1,172 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_RUNTIME_LOCAL_KERNELS_WSLOSS_H
+#define SRC_RUNTIME_LOCAL_KERNELS_WSLOSS_H
+
+#include <runtime/local/context/DaphneContext.h>
+#include <runtime/local/datastructures/CSRMatrix.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/kernels/Dot.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <cmath>
+#include <cstddef>
+
+// ****************************************************************************
+// Struct for partial template specialization
+// ****************************************************************************
+
+template<typename VTRes, class DTW, class DTX, class DTU, class DTV>
+struct WsLoss {
+    static VTRes apply(const DTW * w, const DTX * x, const DTU * u, const DTV * v, DCTX(ctx)) = delete;
+};
+
+// ****************************************************************************
+// Convenience function
+// ****************************************************************************
+
+/**
+ * @brief Computes the weighted squared loss `sum(w * (x - u @ t(v))^2)` of a
+ * low-rank factorization `u @ t(v)` of `x`.
+ *
+ * The product `u @ t(v)` has the shape of `x` and is typically much larger
+ * than the factors. It is not materialized; instead, only the cells where
+ * `w` is non-zero are computed, as dot products of a row of `u` and a row of
+ * `v`. For a sparse `w`, the cost is thus proportional to its number of
+ * non-zeros times the rank.
+ *
+ * As in the unfused computation, a zero in a dense `w` does not mask a
+ * non-finite difference (`0 * nan` and `0 * inf` are `nan`), if it stems from
+ * a non-finite value in `x`, `u`, or `v`. The cells not stored in a sparse
+ * `w` are ignored, like by the element-wise multiplication with a sparse
+ * matrix.
+ */
+template<typename VTRes, class DTW, class DTX, class DTU, class DTV>
+VTRes wsLoss(const DTW * w, const DTX * x, const DTU * u, const DTV * v, DCTX(ctx)) {
+    return WsLoss<VTRes, DTW, DTX, DTU, DTV>::apply(w, x, u, v, ctx);
+}
+
+// ****************************************************************************
+// (Partial) template specializations for different data/value types
+// ****************************************************************************
+
+template<typename VT>
+void checkWsLossShapes(const Matrix<VT> * w, const DenseMatrix<VT> * x, const DenseMatrix<VT> * u, const DenseMatrix<VT> * v) {
+    if(w->getNumRows() != x->getNumRows() || w->getNumCols() != x->getNumCols())
+        throw std::runtime_error("WsLoss: w and x must have the same shape");
+    if(u->getNumRows() != x->getNumRows() || v->getNumRows() != x->getNumCols())
+        throw std::runtime_error("WsLoss: u must have as many rows as x, v as many rows as x has columns");
+    if(u->getNumCols() != v->getNumCols())
+        throw std::runtime_error("WsLoss: u and v must have the same number of columns");
+}
+
+/**
+ * @brief Returns for each row of the given matrix whether it contains a
+ * non-finite value.
+ */
+template<typename VT>
+std::vector<bool> getNonFiniteRows(const DenseMatrix<VT> * m) {
+    const size_t numCols = m->getNumCols();
+    std::vector<bool> res(m->getNumRows(), false);
+    const VT * values = m->getValues();
+    for(size_t r = 0; r < res.size(); r++, values += m->getRowSkip())
+        res[r] = !std::all_of(values, values + numCols, [](VT val) { return std::isfinite(val); });
+    return res;
+}
+
+// ----------------------------------------------------------------------------
+// scalar <- DenseMatrix, DenseMatrix, DenseMatrix, DenseMatrix
+// ----------------------------------------------------------------------------
+
+template<typename VT>
+struct WsLoss<VT, DenseMatrix<VT>, DenseMatrix<VT>, DenseMatrix<VT>, DenseMatrix<VT>> {
+    static VT apply(const DenseMatrix<VT> * w, const DenseMatrix<VT> * x, const DenseMatrix<VT> * u,
+                    const DenseMatrix<VT> * v, DCTX(ctx)) {
+        checkWsLossShapes<VT>(w, x, u, v);
+        const size_t numRows = x->getNumRows();
+        const size_t numCols = x->getNumCols();
+        const size_t rank = u->getNumCols();
+
+        // A cell of u @ t(v) is non-finite if the row of u or the row of v it
+        // is computed from contains a non-finite value.
+        const std::vector<bool> nonFiniteU = getNonFiniteRows(u);
+        const std::vector<bool> nonFiniteV = getNonFiniteRows(v);
+
+        // The product is only computed where w is non-zero (or the difference
+        // is non-finite), the cost of a dense w is thus estimated as if it had
+        // no zeros.
+        return sumRowBlocks<VT>(numRows, numRows * numCols * std::max<size_t>(1, rank), ctx,
+                [&](size_t rowBeg, size_t rowEnd) {
+            const VT * valuesW = w->getValues() + rowBeg * w->getRowSkip();
+            const VT * valuesX = x->getValues() + rowBeg * x->getRowSkip();
+            const VT * valuesU = u->getValues() + rowBeg * u->getRowSkip();
+            VT res = 0;
+            for(size_t r = rowBeg; r < rowEnd; r++) {
+                for(size_t c = 0; c < numCols; c++) {
+                    const VT wrc = valuesW[c];
+                    if(wrc == 0 && std::isfinite(valuesX[c]) && !nonFiniteU[r] && !nonFiniteV[c])
+                        continue;
+                    const VT d = valuesX[c] - dotContiguous(valuesU, v->getValues() + c * v->getRowSkip(), rank);
+                    res += wrc * d * d;
+                }
+                valuesW += w->getRowSkip();
+                valuesX += x->getRowSkip();
+                valuesU += u->getRowSkip();
+            }
+            return res;
+        });
+    }
+};
+
+// ----------------------------------------------------------------------------
+// scalar <- CSRMatrix, DenseMatrix, DenseMatrix, DenseMatrix
+// ----------------------------------------------------------------------------
+
+template<typename VT>
+struct WsLoss<VT, CSRMatrix<VT>, DenseMatrix<VT>, DenseMatrix<VT>, DenseMatrix<VT>> {
+    static VT apply(const CSRMatrix<VT> * w, const DenseMatrix<VT> * x, const DenseMatrix<VT> * u,
+                    const DenseMatrix<VT> * v, DCTX(ctx)) {
+        checkWsLossShapes<VT>(w, x, u, v);
+        const size_t numRows = x->getNumRows();
+        const size_t rank = u->getNumCols();
+
+        return sumRowBlocks<VT>(numRows, w->getNumNonZeros() * std::max<size_t>(1, rank), ctx,
+                [&](size_t rowBeg, size_t rowEnd) {
+            const VT * valuesX = x->getValues() + rowBeg * x->getRowSkip();
+            const VT * valuesU = u->getValues() + rowBeg * u->getRowSkip();
+            VT res = 0;
+            for(size_t r = rowBeg; r < rowEnd; r++) {
+                const size_t rowNumNonZeros = w->getNumNonZeros(r);
+                const size_t * rowColIdxs = w->getColIdxs(r);
+                const VT * rowValues = w->getValues(r);
+                for(size_t i = 0; i < rowNumNonZeros; i++) {
+                    const size_t c = rowColIdxs[i];
+                    const VT d = valuesX[c] - dotContiguous(valuesU, v->getValues() + c * v->getRowSkip(), rank);
+                    res += rowValues[i] * d * d;
+                }
+                valuesX += x->getRowSkip();
+                valuesU += u->getRowSkip();
+            }
+            return res;
+        });
+    }
+};
+
+#endif //SRC_RUNTIME_LOCAL_KERNELS_WSLOSS_H
@@ -54,7 +54,48 @@ def toCppType(t):
     else:
         return t
 
-def generateKernelInstantiation(kernelTemplateInfo, templateValues, opCodes, outFile, catalogEntries, API):
+# Prefixes of the C++ types of DAPHNE data objects.
+DATA_OBJECT_TYPES = ("DenseMatrix<", "CSRMatrix<", "Matrix<", "Frame", "Structure", "ContiguousTensor<", "ChunkedTensor<")
+
+
+def tracedOperandExpr(rp):
+    """
+    Returns the C++ expression of the data object passed in the given run-time
+    parameter, or None if the parameter is not a single data object.
+    """
+    t = rp["type"].replace("const ", "").strip()
+    if not t.startswith(DATA_OBJECT_TYPES) or ("isVariadic" in rp and rp["isVariadic"]):
+        return None
+    if t.endswith("**"):
+        # Output parameters are dereferenced, other double pointers are variadic.
+        return "*" + rp["name"] if rp["isOutput"] else None
+    if t.endswith("*"):
+        return rp["name"]
+    return None
+
+
+def bufferOperandExprs(runtimeParams):
+    """
+    Returns the C++ expressions of the data objects passed in the given
+    run-time parameters, for announcing them to the buffer manager. Arrays of
+    data objects followed by their length are wrapped by bufferArray().
+    """
+    exprs = []
+    for i, rp in enumerate(runtimeParams):
+        t = rp["type"].replace("const ", "").strip()
+        if not t.startswith(DATA_OBJECT_TYPES) or ("isVariadic" in rp and rp["isVariadic"]):
+            continue
+        if t.endswith("**"):
+            if rp["isOutput"]:
+                exprs.append("*" + rp["name"])
+            elif i + 1 < len(runtimeParams) and runtimeParams[i + 1]["type"] == "size_t":
+                exprs.append("bufferArray({}, {})".format(rp["name"], runtimeParams[i + 1]["name"]))
+        elif t.endswith("*"):
+            exprs.append(rp["name"])
+    return exprs
+
+
+def generateKernelInstantiation(kernelTemplateInfo, templateValues, opCodes, outFile, catalogEntries, API, variants=None):
     # Extract some information.
     opName = kernelTemplateInfo["opName"]
     returnType = kernelTemplateInfo["returnType"]
@@ -185,12 +226,29 @@ def generateKernelInstantiation(kernelTemplateInfo, templateValues, opCodes, out
             opCodeWord = opCodeType[:-len("OpCode")]
             callTemplateParams = ["{}::{}".format(opCodeWord if API == "CPP" else API + "::" + opCodeWord, opCode)] + callTemplateParams
 
+        # Data objects passed to/returned from the kernel, whose shapes and sizes are recorded when tracing.
+        tracedOperands = [e for e in (tracedOperandExpr(rp) for rp in extendedRuntimeParams) if e is not None]
+        tracedOperandsList = "{{{}}}".format(", ".join("traceOperand({})".format(e) for e in tracedOperands))
+
+        def writePostKernelInstrumentation(kIdExpr, nameArg):
+            # The traced operands are only inspected if tracing is enabled,
+            # since that involves virtual calls and dynamic casts per operand.
+            if not tracedOperands and not nameArg:
+                outFile.write(3 * INDENT + f"postKernelInstrumentation({kIdExpr}, ctx);\n")
+                return
+            outFile.write(3 * INDENT + "if(ctx->getUserConfig().enable_tracing)\n")
+            outFile.write(4 * INDENT + f"postKernelInstrumentation({kIdExpr}, ctx, {tracedOperandsList}{nameArg});\n")
+            outFile.write(3 * INDENT + "else\n")
+            outFile.write(4 * INDENT + f"postKernelInstrumentation({kIdExpr}, ctx);\n")
+
         nonInstrumentedOps = ["map", "createDaphneContext","destroyDaphneContext"]
         # Body of that function: delegate to the kernel instantiation.
-        outFile.write(2 * INDENT)
+        level = 2
         if not isCreateDaphneContext:
             # try
+            outFile.write(2 * INDENT)
             outFile.write(f"try{{\n")
+            level = 3
             if opName in nonInstrumentedOps:
                 outFile.write("")
             elif isVectorizedOrDistributed:
@@ -199,35 +257,80 @@ def generateKernelInstantiation(kernelTemplateInfo, templateValues, opCodes, out
             else:
                 outFile.write(3 * INDENT)
                 outFile.write(f"preKernelInstrumentation(kId, ctx);\n")
-            outFile.write(3 * INDENT)
 
         #  import pdb;pdb.set_trace()
         #  insertPreKernelInstrumentation(outFile)
-        if returnType != "void":
-            outFile.write("*{} = ".format(DEFAULT_NEWRESPARAM))
-
-        kernelCallString = "{}{}::apply({});\n" if opCodeAsTemplateParam else "{}{}({});\n"
-
-        outFile.write(kernelCallString.format(
-            opName if API == "CPP" else (API + "::" + opName),
-            # Template parameters, if the kernel is a template:
-            "<{}>".format(", ".join(callTemplateParams)) if len(templateValues) else "",
-            # Run-time parameters, possibly including DaphneContext:
-            ", ".join(callParams + ([] if isCreateDaphneContext else ["ctx"])),
-        ))
+        def kernelCall(kernelOpName):
+            kernelCallString = "{}{}::apply({});" if opCodeAsTemplateParam else "{}{}({});"
+            return ("*{} = ".format(DEFAULT_NEWRESPARAM) if returnType != "void" else "") + kernelCallString.format(
+                kernelOpName if API == "CPP" else (API + "::" + kernelOpName),
+                # Template parameters, if the kernel is a template:
+                "<{}>".format(", ".join(callTemplateParams)) if len(templateValues) else "",
+                # Run-time parameters, possibly including DaphneContext:
+                ", ".join(callParams + ([] if isCreateDaphneContext else ["ctx"])),
+            )
+
+        # The data objects accessed by the kernel are announced to the buffer
+        # manager, which restores them if they were spilled to disk.
+        bufferOperands = bufferOperandExprs(extendedRuntimeParams) \
+                if API == "CPP" and not isCreateDaphneContext and opName != "destroyDaphneContext" else []
+        if bufferOperands:
+            outFile.write(level * INDENT + "BufferAccess ba({});\n".format(", ".join(["ctx"] + bufferOperands)))
+
+        # Kernels marked for lineage-based reuse look up their result in the
+        # lineage cache first and are only called if it is not there.
+        inParams = [rp for rp in extendedRuntimeParams if not rp["isOutput"]]
+        outParams = [rp for rp in extendedRuntimeParams if rp["isOutput"]]
+        lineageReuse = kernelTemplateInfo.get("lineageReuse", False) and API == "CPP" and returnType == "void" \
+                and len(outParams) == 1 and outParams[0]["type"].endswith("**") \
+                and not any(rp["type"].endswith("**") for rp in inParams)
+        if lineageReuse:
+            lineageArgs = ", ".join(['"{}{}"'.format(funcName, typesForName)] + [rp["name"] for rp in inParams])
+            outFile.write(level * INDENT + f"LineageReuse lr(ctx, {lineageArgs});\n")
+            outFile.write(level * INDENT + f"if(!lr.tryReuse({outParams[0]['name']})) {{\n")
+            level += 1
+
+        # Kernels with several variants select one of them per call, based on
+        # the sizes of the inputs and the past execution times of the variants.
+        hasVariants = bool(variants) and API == "CPP" and not isVectorizedOrDistributed and not isCreateDaphneContext
+        if hasVariants:
+            hints = ", ".join(
+                "{{\"{}\", {}, {}, {}}}".format(
+                    v["name"],
+                    v.get("costHint", {}).get("minCells", 0),
+                    v.get("costHint", {}).get("maxCells", "SIZE_MAX"),
+                    float(v.get("costHint", {}).get("maxSparsity", 1.0)))
+                for v in variants)
+            variantArgs = ", ".join(["variants", "kId", "ctx"] + [rp["name"] for rp in inParams if not rp["type"].endswith("**")])
+            outFile.write(level * INDENT + f"static KernelVariantSelector variants({{{hints}}});\n")
+            outFile.write(level * INDENT + f"KernelVariantDispatch vd({variantArgs});\n")
+            outFile.write(level * INDENT + "switch(vd.select()) {\n")
+            for i, v in enumerate(variants):
+                outFile.write(level * INDENT + f"case {i}:\n")
+                outFile.write((level + 1) * INDENT + kernelCall(v.get("opName", opName)) + "\n")
+                outFile.write((level + 1) * INDENT + "break;\n")
+            outFile.write(level * INDENT + "}\n")
+            outFile.write(level * INDENT + "vd.finish();\n")
+        else:
+            outFile.write(level * INDENT + kernelCall(opName) + "\n")
+
+        if lineageReuse:
+            outFile.write(level * INDENT + f"lr.store(*{outParams[0]['name']});\n")
+            level -= 1
+            outFile.write(level * INDENT + "}\n")
+        if bufferOperands:
+            outFile.write(level * INDENT + "ba.finish({});\n".format(", ".join(bufferOperands)))
         if not isCreateDaphneContext:
 
             if opName in nonInstrumentedOps:
                 outFile.write(2 * INDENT)
                 outFile.write(f"}} catch(std::exception &e) {{\n{3*INDENT}throw ErrorHandler::runtimeError(0, e.what(), &(ctx->dispatchMapping));\n{2*INDENT}}}\n")
             elif isVectorizedOrDistributed:
-                outFile.write(3 * INDENT)
-                outFile.write(f"postKernelInstrumentation(0, ctx);\n")
+                writePostKernelInstrumentation("0", f", \"{funcName}\"")
                 outFile.write(2 * INDENT)
                 outFile.write(f"}} catch(std::exception &e) {{\n{3*INDENT}throw ErrorHandler::runtimeError(-1, e.what(), &(ctx->dispatchMapping));\n{2*INDENT}}}\n")
             else:
-                outFile.write(3 * INDENT)
-                outFile.write(f"postKernelInstrumentation(kId, ctx);\n")
+                writePostKernelInstrumentation("kId", "")
                 outFile.write(2 * INDENT)
                 outFile.write(f"}} catch(std::exception &e) {{\n{3*INDENT}throw ErrorHandler::runtimeError(kId, e.what(), &(ctx->dispatchMapping));\n{2*INDENT}}}\n")
         outFile.write(INDENT + "}\n")
@@ -243,7 +346,7 @@ def generateKernelInstantiation(kernelTemplateInfo, templateValues, opCodes, out
             argTypesTmp.append(t)
         argTypes = argTypesTmp
 
-        catalogEntries.append({
+        catalogEntry = {
             "opMnemonic": concreteOpName,
             "kernelFuncName": funcName + typesForName,
             "resTypes": resTypes,
@@ -252,7 +355,10 @@ def generateKernelInstantiation(kernelTemplateInfo, templateValues, opCodes, out
             # Assumes that the generated catalog file is saved in
             # the same directory as the kernels libraries.
             "libPath": "libAllKernels.so" if API == "CPP" else f"lib{API}Kernels.so"
-        })
+        }
+        if hasVariants:
+            catalogEntry["variants"] = [{"name": v["name"], "costHint": v.get("costHint", {})} for v in variants]
+        catalogEntries.append(catalogEntry)
 
     # Generate the function(s).
     if opCodes is None:
@@ -316,7 +422,8 @@ if __name__ == "__main__":
                             outBuf = io.StringIO()
                             for instantiation in api["instantiations"]:
                                 generateKernelInstantiation(kernelTemplateInfo, instantiation,
-                                                            api.get("opCodes", None), outBuf, catalog_entries, API)
+                                                            api.get("opCodes", None), outBuf, catalog_entries, API,
+                                                            api.get("variants", None))
                             ops_inst_str += outBuf.getvalue()
             else:
                 if API == "CPP":
@@ -331,7 +438,8 @@ if __name__ == "__main__":
                     opCodes = kernelInfo.get("opCodes", None)
                     outBuf = io.StringIO()
                     for instantiation in kernelInfo["instantiations"]:
-                        generateKernelInstantiation(kernelTemplateInfo, instantiation, opCodes, outBuf, catalog_entries, API)
+                        generateKernelInstantiation(kernelTemplateInfo, instantiation, opCodes, outBuf, catalog_entries, API,
+                                                    kernelInfo.get("variants", None))
                     ops_inst_str += outBuf.getvalue()
 
 
@@ -341,7 +449,11 @@ if __name__ == "__main__":
         outFile.write("#include <runtime/local/context/DaphneContext.h>\n")
         outFile.write("#include <stdexcept>\n")
         outFile.write("#include <util/ErrorHandler.h>\n")
+        if API == "CPP":
+            outFile.write("#include <runtime/local/instrumentation/BufferAccess.h>\n")
         outFile.write("#include <runtime/local/instrumentation/KernelInstrumentation.h>\n")
+        outFile.write("#include <runtime/local/instrumentation/KernelVariants.h>\n")
+        outFile.write("#include <runtime/local/instrumentation/LineageReuse.h>\n")
         outFile.write(header_str)
         outFile.write("\nextern \"C\" {\n")
         outFile.write(ops_inst_str)
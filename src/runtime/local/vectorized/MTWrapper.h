@@ -21,7 +21,9 @@
 #endif
 
 #include <ir/daphneir/Daphne.h>
+#include <runtime/local/datastructures/ValueTypeUtils.h>
 #include <runtime/local/vectorized/LoadPartitioning.h>
+#include <runtime/local/vectorized/SchedulingAutotuner.h>
 #include <runtime/local/vectorized/VectorizedDataSink.h>
 #include <runtime/local/vectorized/WorkerCPU.h>
 #include <runtime/local/vectorized/WorkerGPU.h>
@@ -30,8 +32,10 @@
 
 #include <fstream>
 #include <functional>
+#include <iostream>
 #include <queue>
 #include <set>
+#include <sstream>
 
 #include <hwloc.h>
 
@@ -69,6 +73,11 @@ protected:
                 len = std::max(len, inputs[i]->getNumRows());
                 mem_required += inputs[i]->getNumItems() * sizeof(typename DT::VT);
             }
+            else if (splits[i] == mlir::daphne::VectorSplit::COLS) {
+                // the tasks of a pipeline splitting its inputs by columns cover ranges of columns
+                len = std::max(len, inputs[i]->getNumCols());
+                mem_required += inputs[i]->getNumItems() * sizeof(typename DT::VT);
+            }
         }
         return std::make_pair(len, mem_required);
     }
@@ -180,6 +189,63 @@ protected:
             w->join();
     }
 
+    /**
+     * @brief Identifies a pipeline for the scheduling autotuner by its value type, splits, combines and
+     * the order of magnitude of its number of rows.
+     */
+    std::string pipelineKey(Structure** inputs, size_t numInputs, VectorSplit* splits, size_t numOutputs,
+            VectorCombine* combines, size_t len) {
+        std::stringstream key;
+        key << ValueTypeUtils::cppNameFor<typename DT::VT> << ":";
+        for(size_t i = 0; i < numInputs; ++i)
+            key << (splits[i] == VectorSplit::ROWS ? 'R' : splits[i] == VectorSplit::COLS ? 'C' : 'B');
+        key << "->";
+        for(size_t i = 0; i < numOutputs; ++i)
+            key << (combines[i] == VectorCombine::ROWS ? 'R' : combines[i] == VectorCombine::COLS ? 'C' : 'A');
+        size_t cols = 0;
+        for(size_t i = 0; i < numInputs; ++i)
+            if(splits[i] == VectorSplit::ROWS)
+                cols += inputs[i]->getNumCols();
+            else if(splits[i] == VectorSplit::COLS)
+                cols += inputs[i]->getNumRows();
+        key << ":r2^" << (len ? 63 - __builtin_clzll(len) : 0) << ":c" << cols;
+        return key.str();
+    }
+
+    SchedulingParams getSchedulingParams(const std::string& key) {
+        if(_ctx->getUserConfig().autotune_scheduling)
+            return SchedulingAutotuner::get(_ctx->getUserConfig().autotune_file).suggest(key);
+        SchedulingParams params;
+        params.scheme = _ctx->config.taskPartitioningScheme;
+        params.minimumTaskSize = std::max(1, _ctx->config.minimumTaskSize);
+        return params;
+    }
+
+    /**
+     * @brief Collects the telemetry of the CPU workers after they were joined, prints it and/or feeds it
+     * to the scheduling autotuner.
+     */
+    void finishPipeline(const std::string& key, const SchedulingParams& params, uint32_t batchSize, uint64_t numRows,
+            WorkerTelemetry::Clock::time_point begin) {
+        const auto& config = _ctx->getUserConfig();
+        if(!config.scheduling_telemetry && !config.autotune_scheduling)
+            return;
+        PipelineTelemetry telemetry;
+        telemetry.key = key;
+        telemetry.params = params;
+        telemetry.batchSize = batchSize;
+        telemetry.numRows = numRows;
+        telemetry.elapsedNs = WorkerTelemetry::elapsedNs(begin, WorkerTelemetry::Clock::now());
+        for(auto& w : cpp_workers)
+            telemetry.workers.push_back(static_cast<WorkerCPU*>(w.get())->getTelemetry());
+        if(config.scheduling_telemetry) {
+            telemetry.print(std::cerr);
+            std::cerr << std::endl;
+        }
+        if(config.autotune_scheduling)
+            SchedulingAutotuner::get(config.autotune_file).record(telemetry);
+    }
+
 public:
     explicit MTWrapperBase(uint32_t numFunctions, DCTX(ctx)) : _ctx(ctx) {
         _ctx->logger->debug("Querying cpu topology");
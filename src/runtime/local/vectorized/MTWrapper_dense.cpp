@@ -26,17 +26,20 @@ template<typename VT>
         std::vector<std::function<typename MTWrapper<DenseMatrix<VT>>::PipelineFunc>> funcs, DenseMatrix<VT> ***res,
         const bool* isScalar, Structure **inputs, size_t numInputs, size_t numOutputs, int64_t *outRows, int64_t *outCols,
         VectorSplit *splits, VectorCombine *combines, DCTX(ctx), const bool verbose) {
+    auto begin = WorkerTelemetry::Clock::now();
     auto inputProps = this->getInputProperties(inputs, numInputs, splits);
     auto len = inputProps.first;
     auto mem_required = inputProps.second;
     mem_required += this->allocateOutput(res, numOutputs, outRows, outCols, combines);
     auto row_mem = mem_required / len;
+    auto key = this->pipelineKey(inputs, numInputs, splits, numOutputs, combines, len);
+    auto params = this->getSchedulingParams(key);
 
     // create task queue (w/o size-based blocking)
     std::unique_ptr<TaskQueue> q = std::make_unique<BlockingTaskQueue>(len);
 
     std::vector<TaskQueue*> tmp_q{q.get()};
-    auto batchSize8M = std::max(100ul, static_cast<size_t>(std::ceil(8388608 / row_mem)));
+    auto batchSize8M = params.applyBatchSizeShift(std::max(100ul, static_cast<size_t>(std::ceil(8388608 / row_mem))));
     this->initCPPWorkers(tmp_q, batchSize8M, verbose, 1, 0, false);
 
 #ifdef USE_CUDA
@@ -55,10 +58,8 @@ template<typename VT>
     // create tasks and close input
     uint64_t startChunk = 0;
     uint64_t endChunk = 0;
-    int method=ctx->config.taskPartitioningScheme;
-    int chunkParam = ctx->config.minimumTaskSize;
-    if(chunkParam<=0)
-        chunkParam=1;
+    int method = params.scheme;
+    int chunkParam = params.minimumTaskSize;
     bool autoChunk=false;
     if(method==AUTO)
         autoChunk = true;
@@ -73,6 +74,7 @@ template<typename VT>
     q->closeInput();
 
     this->joinAll();
+    this->finishPipeline(key, params, batchSize8M, len, begin);
 }
 
 template<typename VT>
@@ -80,11 +82,14 @@ template<typename VT>
         std::vector<std::function<typename MTWrapper<DenseMatrix<VT>>::PipelineFunc>> funcs, DenseMatrix<VT> ***res,
         const bool* isScalar, Structure **inputs, size_t numInputs, size_t numOutputs, int64_t *outRows, int64_t *outCols,
         VectorSplit *splits, VectorCombine *combines, DCTX(ctx), bool verbose) {
+    auto begin = WorkerTelemetry::Clock::now();
     auto inputProps = this->getInputProperties(inputs, numInputs, splits);
     auto len = inputProps.first;
     auto mem_required = inputProps.second;
     mem_required += this->allocateOutput(res, numOutputs, outRows, outCols, combines);
     auto row_mem = mem_required / len;
+    auto key = this->pipelineKey(inputs, numInputs, splits, numOutputs, combines, len);
+    auto params = this->getSchedulingParams(key);
 
     std::vector<std::unique_ptr<TaskQueue>> q;
     std::vector<TaskQueue*> qvector;
@@ -106,7 +111,7 @@ template<typename VT>
         }
     }
 
-    auto batchSize8M = std::max(100ul, static_cast<size_t>(std::ceil(8388608 / row_mem)));
+    auto batchSize8M = params.applyBatchSizeShift(std::max(100ul, static_cast<size_t>(std::ceil(8388608 / row_mem))));
     this->initCPPWorkers(qvector, batchSize8M, verbose, this->_numQueues, this->_queueMode, ctx->getUserConfig().pinWorkers);
 
     // lock for aggregation combine
@@ -118,10 +123,8 @@ template<typename VT>
     uint64_t endChunk = 0;
     uint64_t currentItr = 0;
     uint64_t target;
-    int method=ctx->config.taskPartitioningScheme;
-    int chunkParam = ctx->config.minimumTaskSize;
-    if(chunkParam<=0)
-        chunkParam=1;
+    int method = params.scheme;
+    int chunkParam = params.minimumTaskSize;
     if (ctx->getUserConfig().prePartitionRows) {
         uint64_t oneChunk = len/this->_numQueues;
         int remainder = len - (oneChunk * this->_numQueues);
@@ -183,6 +186,7 @@ template<typename VT>
     }
 
     this->joinAll();
+    this->finishPipeline(key, params, batchSize8M, len, begin);
 }
 
 template<typename VT>
@@ -190,13 +194,16 @@ template<typename VT>
         std::vector<std::function<typename MTWrapper<DenseMatrix<VT>>::PipelineFunc>> funcs, DenseMatrix<VT> ***res,
         const bool* isScalar, Structure **inputs, size_t numInputs, size_t numOutputs, int64_t *outRows, int64_t *outCols,
         VectorSplit *splits, VectorCombine *combines, DCTX(ctx), bool verbose) {
+    auto begin = WorkerTelemetry::Clock::now();
     size_t device_task_len = 0ul;
     auto inputProps = this->getInputProperties(inputs, numInputs, splits);
     auto len = inputProps.first;
     auto mem_required = inputProps.second;
     mem_required += this->allocateOutput(res, numOutputs, outRows, outCols, combines);
     auto row_mem = mem_required / len;
-    auto batchSize8M = std::max(100ul, static_cast<size_t>(std::ceil(8388608 / row_mem)));
+    auto key = this->pipelineKey(inputs, numInputs, splits, numOutputs, combines, len);
+    auto params = this->getSchedulingParams(key);
+    auto batchSize8M = params.applyBatchSizeShift(std::max(100ul, static_cast<size_t>(std::ceil(8388608 / row_mem))));
     // lock for aggregation combine
     // TODO: multiple locks per output
     std::mutex resLock;
@@ -282,10 +289,8 @@ template<typename VT>
         uint64_t endChunk = device_task_len;
         uint64_t currentItr = 0;
         uint64_t target;
-        int method=ctx->config.taskPartitioningScheme;
-        int chunkParam = ctx->config.minimumTaskSize;
-        if(chunkParam<=0)
-            chunkParam=1;
+        int method = params.scheme;
+        int chunkParam = params.minimumTaskSize;
         bool autoChunk=false;
         if(method==AUTO)
             autoChunk = true;
@@ -305,6 +310,7 @@ template<typename VT>
         }
     }
     this->joinAll();
+    this->finishPipeline(key, params, batchSize8M, cpu_task_len, begin);
 
 #ifdef USE_CUDA
     this->combineOutputs(res, res_cuda, numOutputs, combines, ctx);
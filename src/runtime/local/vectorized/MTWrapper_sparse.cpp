@@ -23,11 +23,14 @@ void MTWrapper<CSRMatrix<VT>>::executeCpuQueues(std::vector<std::function<void(C
         size_t numOutputs, const int64_t *outRows, const int64_t *outCols, VectorSplit *splits, VectorCombine *combines,
         DCTX(ctx), const bool verbose) {
 //     TODO: reduce code duplication
+    auto begin = WorkerTelemetry::Clock::now();
     auto inputProps = this->getInputProperties(inputs, numInputs, splits);
     auto len = inputProps.first;
     auto mem_required = inputProps.second;
     // TODO: sparse output mem requirements
     auto row_mem = mem_required / len;
+    auto key = this->pipelineKey(inputs, numInputs, splits, numOutputs, combines, len);
+    auto params = this->getSchedulingParams(key);
 
     std::vector<std::unique_ptr<TaskQueue>> q;
     std::vector<TaskQueue*> qvector;
@@ -49,7 +52,7 @@ void MTWrapper<CSRMatrix<VT>>::executeCpuQueues(std::vector<std::function<void(C
         }
     }
 
-    auto batchSize8M = std::max(100ul, static_cast<size_t>(std::ceil(8388608 / row_mem)));
+    auto batchSize8M = params.applyBatchSizeShift(std::max(100ul, static_cast<size_t>(std::ceil(8388608 / row_mem))));
     this->initCPPWorkers(qvector, batchSize8M, verbose, this->_numQueues, this->_queueMode,
             ctx->getUserConfig().pinWorkers);
 
@@ -68,10 +71,8 @@ void MTWrapper<CSRMatrix<VT>>::executeCpuQueues(std::vector<std::function<void(C
     uint64_t endChunk = 0;
     uint64_t currentItr = 0;
     uint64_t target;
-    int method=ctx->config.taskPartitioningScheme;
-    int chunkParam = ctx->config.minimumTaskSize;
-    if(chunkParam<=0)
-        chunkParam=1;
+    int method = params.scheme;
+    int chunkParam = params.minimumTaskSize;
     if (ctx->getUserConfig().prePartitionRows) {
         uint64_t oneChunk = len/this->_numQueues;
         int remainder = len - (oneChunk * this->_numQueues);
@@ -134,6 +135,7 @@ void MTWrapper<CSRMatrix<VT>>::executeCpuQueues(std::vector<std::function<void(C
     }
 
     this->joinAll();
+    this->finishPipeline(key, params, batchSize8M, len, begin);
     for(size_t i = 0; i < numOutputs; i++) {
         *(res[i]) = dataSinks[i]->consume();
         delete dataSinks[i];
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <runtime/local/vectorized/LoadPartitioningDefs.h>
+#include <runtime/local/vectorized/SchedulingAutotuner.h>
+
+#include <nlohmannjson/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <fstream>
+#include <memory>
+
+const std::vector<int> SchedulingAutotuner::CANDIDATE_SCHEMES = {STATIC, GSS, TSS, FAC2, TFSS, MFSC, AUTO};
+const std::vector<int> SchedulingAutotuner::CANDIDATE_BATCH_SIZE_SHIFTS = {0, -2, -1, 1, 2};
+const std::vector<int> SchedulingAutotuner::CANDIDATE_MINIMUM_TASK_SIZES = {1, 16, 256, 4096};
+
+SchedulingAutotuner &SchedulingAutotuner::get(const std::string &filename) {
+    static std::mutex instancesMtx;
+    static std::map<std::string, std::unique_ptr<SchedulingAutotuner>> instances;
+    std::lock_guard<std::mutex> lock(instancesMtx);
+    auto &instance = instances[filename];
+    if (!instance)
+        instance = std::make_unique<SchedulingAutotuner>(filename);
+    return *instance;
+}
+
+SchedulingAutotuner::SchedulingAutotuner(const std::string &filename) : filename(filename) { load(); }
+
+SchedulingAutotuner::~SchedulingAutotuner() { flush(); }
+
+std::vector<SchedulingParams> SchedulingAutotuner::candidates(size_t stage, const SchedulingParams &best) {
+    std::vector<SchedulingParams> res;
+    switch (stage) {
+    case 0:
+        for (int scheme : CANDIDATE_SCHEMES)
+            res.push_back({scheme, 1, 0});
+        break;
+    case 1:
+        for (int shift : CANDIDATE_BATCH_SIZE_SHIFTS)
+            res.push_back({best.scheme, best.minimumTaskSize, shift});
+        break;
+    case 2:
+        for (int minimumTaskSize : CANDIDATE_MINIMUM_TASK_SIZES)
+            res.push_back({best.scheme, minimumTaskSize, best.batchSizeShift});
+        break;
+    }
+    return res;
+}
+
+bool SchedulingAutotuner::getBest(const std::map<SchedulingParams, Observation> &obs, SchedulingParams &best) {
+    bool found = false;
+    double bestNsPerRow = 0;
+    for (auto &[params, o] : obs)
+        if (o.count && (!found || o.nsPerRow < bestNsPerRow)) {
+            best = params;
+            bestNsPerRow = o.nsPerRow;
+            found = true;
+        }
+    return found;
+}
+
+SchedulingParams SchedulingAutotuner::suggest(const std::string &key) {
+    std::lock_guard<std::mutex> lock(mtx);
+    const auto &obs = history[key];
+    // Each stage varies one parameter of the best candidate of the previous
+    // stages.
+    SchedulingParams best;
+    std::map<SchedulingParams, Observation> explored;
+    for (size_t stage = 0; stage < 3; stage++) {
+        for (auto &c : candidates(stage, best)) {
+            auto it = obs.find(c);
+            if (it == obs.end() || it->second.count == 0)
+                return c;
+            explored[c] = it->second;
+        }
+        getBest(explored, best);
+    }
+    return best;
+}
+
+void SchedulingAutotuner::record(const PipelineTelemetry &telemetry) {
+    if (telemetry.numRows == 0)
+        return;
+    std::lock_guard<std::mutex> lock(mtx);
+    Observation &o = history[telemetry.key][telemetry.params];
+    const double nsPerRow = static_cast<double>(telemetry.elapsedNs) / telemetry.numRows;
+    o.nsPerRow = o.count ? (1 - SMOOTHING) * o.nsPerRow + SMOOTHING * nsPerRow : nsPerRow;
+    o.count++;
+    dirty = true;
+}
+
+void SchedulingAutotuner::flush() {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (dirty && !filename.empty())
+        save();
+    dirty = false;
+}
+
+void SchedulingAutotuner::load() {
+    std::ifstream ifs(filename);
+    if (!ifs.good())
+        return;
+    try {
+        nlohmann::json j = nlohmann::json::parse(ifs);
+        for (auto &[key, entries] : j.items())
+            for (auto &e : entries) {
+                SchedulingParams params{e.at("scheme").get<int>(), e.at("minimum_task_size").get<int>(),
+                                        e.at("batch_size_shift").get<int>()};
+                history[key][params] = {e.at("count").get<size_t>(), e.at("ns_per_row").get<double>()};
+            }
+    } catch (std::exception &e) {
+        spdlog::warn("SchedulingAutotuner: ignoring invalid history file {}: {}", filename, e.what());
+        history.clear();
+    }
+}
+
+void SchedulingAutotuner::save() {
+    nlohmann::json j = nlohmann::json::object();
+    for (auto &[key, obs] : history) {
+        nlohmann::json entries = nlohmann::json::array();
+        for (auto &[params, o] : obs)
+            entries.push_back({{"scheme", params.scheme},
+                               {"minimum_task_size", params.minimumTaskSize},
+                               {"batch_size_shift", params.batchSizeShift},
+                               {"count", o.count},
+                               {"ns_per_row", o.nsPerRow}});
+        j[key] = entries;
+    }
+    std::ofstream ofs(filename);
+    if (!ofs.good()) {
+        spdlog::warn("SchedulingAutotuner: could not write history file {}", filename);
+        return;
+    }
+    ofs << j.dump(2) << std::endl;
+}
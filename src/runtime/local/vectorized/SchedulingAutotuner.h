@@ -0,0 +1,108 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <runtime/local/vectorized/SchedulingTelemetry.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Chooses the scheduling parameters (partitioning scheme, minimum task
+ * size and batch size) of vectorized pipelines based on the run times observed
+ * for earlier executions of the same pipeline.
+ *
+ * Pipelines are identified by a key describing their inputs and outputs (see
+ * `MTWrapperBase::pipelineKey`). The parameters are tuned one at a time: first
+ * all candidate schemes are tried with the default minimum task size and batch
+ * size, then all batch sizes with the best scheme, and finally all minimum task
+ * sizes with the best scheme and batch size. Afterwards, the parameters with the
+ * lowest mean time per row are used. The history is persisted in a JSON file,
+ * such that tuning continues across runs. To keep the file I/O out of the
+ * pipelines, it is only written by `flush()` and when the autotuner is
+ * destroyed (for the process-wide autotuners, at process exit).
+ */
+class SchedulingAutotuner {
+  public:
+    struct Observation {
+        size_t count = 0;
+        /**
+         * @brief Exponential moving average of the time per row, to follow
+         * changes of the system load.
+         */
+        double nsPerRow = 0;
+    };
+
+    static const std::vector<int> CANDIDATE_SCHEMES;
+    static const std::vector<int> CANDIDATE_BATCH_SIZE_SHIFTS;
+    static const std::vector<int> CANDIDATE_MINIMUM_TASK_SIZES;
+
+  private:
+    std::mutex mtx;
+    std::string filename;
+    std::map<std::string, std::map<SchedulingParams, Observation>> history;
+    /**
+     * @brief Whether the history changed since it was last saved.
+     */
+    bool dirty = false;
+
+    static std::vector<SchedulingParams> candidates(size_t stage, const SchedulingParams &best);
+
+    static bool getBest(const std::map<SchedulingParams, Observation> &obs, SchedulingParams &best);
+
+  public:
+    /**
+     * @brief The weight of a new observation in the moving average.
+     */
+    static constexpr double SMOOTHING = 0.3;
+
+    /**
+     * @brief Returns the process-wide autotuner of the given history file,
+     * which loads the history on first use.
+     */
+    static SchedulingAutotuner &get(const std::string &filename);
+
+    SchedulingAutotuner() = default;
+    explicit SchedulingAutotuner(const std::string &filename);
+    ~SchedulingAutotuner();
+
+    SchedulingAutotuner(const SchedulingAutotuner &) = delete;
+    SchedulingAutotuner &operator=(const SchedulingAutotuner &) = delete;
+
+    /**
+     * @brief Returns the parameters to use for the next execution of the
+     * given pipeline.
+     */
+    SchedulingParams suggest(const std::string &key);
+
+    /**
+     * @brief Records the run time of an execution of the given pipeline.
+     */
+    void record(const PipelineTelemetry &telemetry);
+
+    /**
+     * @brief Persists the history (if a file is set and it changed).
+     */
+    void flush();
+
+    const std::map<SchedulingParams, Observation> &getHistory(const std::string &key) { return history[key]; }
+
+    void load();
+    void save();
+};
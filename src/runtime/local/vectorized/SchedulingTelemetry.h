@@ -0,0 +1,142 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The parameters of the vectorized engine's task scheduling, which the
+ * `SchedulingAutotuner` chooses per pipeline.
+ */
+struct SchedulingParams {
+    /**
+     * @brief The `SelfSchedulingScheme` for partitioning the rows into tasks.
+     */
+    int scheme = 0;
+    /**
+     * @brief The minimum number of rows per task.
+     */
+    int minimumTaskSize = 1;
+    /**
+     * @brief The number of rows a task processes per call of the pipeline
+     * function is the default (see `MTWrapperBase::defaultBatchSize`) times
+     * `2^batchSizeShift`.
+     */
+    int batchSizeShift = 0;
+
+    bool operator==(const SchedulingParams &rhs) const {
+        return scheme == rhs.scheme && minimumTaskSize == rhs.minimumTaskSize && batchSizeShift == rhs.batchSizeShift;
+    }
+
+    bool operator<(const SchedulingParams &rhs) const {
+        if (scheme != rhs.scheme)
+            return scheme < rhs.scheme;
+        if (minimumTaskSize != rhs.minimumTaskSize)
+            return minimumTaskSize < rhs.minimumTaskSize;
+        return batchSizeShift < rhs.batchSizeShift;
+    }
+
+    uint32_t applyBatchSizeShift(uint32_t batchSize) const {
+        const uint64_t res = batchSizeShift >= 0 ? uint64_t(batchSize) << batchSizeShift : batchSize >> -batchSizeShift;
+        return static_cast<uint32_t>(std::clamp<uint64_t>(res, 1, std::numeric_limits<uint32_t>::max()));
+    }
+};
+
+/**
+ * @brief What a single worker of the vectorized engine did during a pipeline.
+ */
+struct WorkerTelemetry {
+    using Clock = std::chrono::steady_clock;
+
+    size_t numTasks = 0;
+    uint64_t numRows = 0;
+    uint64_t minTaskRows = std::numeric_limits<uint64_t>::max();
+    uint64_t maxTaskRows = 0;
+    /**
+     * @brief Time spent executing tasks.
+     */
+    uint64_t busyNs = 0;
+    /**
+     * @brief Time spent waiting for tasks from the queues.
+     */
+    uint64_t waitNs = 0;
+    size_t stealAttempts = 0;
+    size_t stealSuccesses = 0;
+
+    static uint64_t elapsedNs(Clock::time_point begin, Clock::time_point end) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+    }
+
+    void addTask(uint64_t taskRows, uint64_t taskNs) {
+        numTasks++;
+        numRows += taskRows;
+        minTaskRows = std::min(minTaskRows, taskRows);
+        maxTaskRows = std::max(maxTaskRows, taskRows);
+        busyNs += taskNs;
+    }
+};
+
+/**
+ * @brief What the vectorized engine did during a pipeline.
+ */
+struct PipelineTelemetry {
+    std::string key;
+    SchedulingParams params;
+    uint32_t batchSize = 0;
+    uint64_t numRows = 0;
+    uint64_t elapsedNs = 0;
+    std::vector<WorkerTelemetry> workers;
+
+    /**
+     * @brief The maximum busy time of a worker divided by the mean busy time
+     * of all workers; 1 means perfectly balanced.
+     */
+    double imbalance() const {
+        uint64_t maxBusy = 0;
+        uint64_t sumBusy = 0;
+        for (auto &w : workers) {
+            maxBusy = std::max(maxBusy, w.busyNs);
+            sumBusy += w.busyNs;
+        }
+        return sumBusy ? static_cast<double>(maxBusy) * workers.size() / sumBusy : 1;
+    }
+
+    /**
+     * @brief Writes this telemetry as a single-line JSON object.
+     */
+    void print(std::ostream &os) const {
+        os << "{\"pipeline\": \"" << key << "\", \"scheme\": " << params.scheme
+           << ", \"minimum_task_size\": " << params.minimumTaskSize << ", \"batch_size\": " << batchSize
+           << ", \"rows\": " << numRows << ", \"seconds\": " << elapsedNs / 1e9
+           << ", \"imbalance\": " << imbalance() << ", \"workers\": [";
+        for (size_t i = 0; i < workers.size(); i++) {
+            const WorkerTelemetry &w = workers[i];
+            os << (i ? ", " : "") << "{\"tasks\": " << w.numTasks << ", \"rows\": " << w.numRows
+               << ", \"min_task_rows\": " << (w.numTasks ? w.minTaskRows : 0) << ", \"max_task_rows\": " << w.maxTaskRows
+               << ", \"busy_seconds\": " << w.busyNs / 1e9 << ", \"wait_seconds\": " << w.waitNs / 1e9
+               << ", \"steal_attempts\": " << w.stealAttempts << ", \"steal_successes\": " << w.stealSuccesses << "}";
+        }
+        os << "]}";
+    }
+};
@@ -16,9 +16,11 @@
 
 #include "runtime/local/vectorized/Tasks.h"
 #include "runtime/local/kernels/EwBinaryMat.h"
+#include "util/Tracer.h"
 
 template<typename VT>
 void CompiledPipelineTask<DenseMatrix<VT>>::execute(uint32_t fid, uint32_t batchSize) {
+    TraceTaskScope traceScope(_data._ctx->getUserConfig().enable_tracing, "task", _data._rl, _data._ru, fid);
     // local add aggregation to minimize locking
     std::vector<DenseMatrix<VT>*> localAddRes(_data._numOutputs);
     std::vector<DenseMatrix<VT>*> localResults(_data._numOutputs);
@@ -123,6 +125,7 @@ void CompiledPipelineTask<DenseMatrix<VT>>::accumulateOutputs(std::vector<DenseM
 
 template<typename VT>
 void CompiledPipelineTask<CSRMatrix<VT>>::execute(uint32_t fid, uint32_t batchSize) {
+    TraceTaskScope traceScope(_data._ctx->getUserConfig().enable_tracing, "task", _data._rl, _data._ru, fid);
     std::vector<size_t> localResNumRows(_data._numOutputs);
     std::vector<size_t> localResNumCols(_data._numOutputs);
     for(size_t i = 0; i < _data._numOutputs; i++) {
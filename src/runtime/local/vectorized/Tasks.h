@@ -85,9 +85,11 @@ public:
 
 protected:
     bool isBroadcast(mlir::daphne::VectorSplit splitMethod, Structure *input) {
-        return splitMethod == VectorSplit::NONE || (splitMethod == VectorSplit::ROWS && input->getNumRows() == 1);
+        return splitMethod == VectorSplit::NONE || (splitMethod == VectorSplit::ROWS && input->getNumRows() == 1) ||
+               (splitMethod == VectorSplit::COLS && input->getNumCols() == 1);
     }
 
+    // For inputs split by columns, the range of the task refers to columns.
     std::vector<Structure *> createFuncInputs(uint64_t rowStart, uint64_t rowEnd) {
         std::vector<Structure *> linputs;
         for(auto i = 0u ; i < _data._numInputs ; i++) {
@@ -106,6 +108,9 @@ protected:
             else if (VectorSplit::ROWS == _data._splits[i]) {
                 linputs.push_back(_data._inputs[i]->sliceRow(rowStart, rowEnd));
             }
+            else if (VectorSplit::COLS == _data._splits[i]) {
+                linputs.push_back(_data._inputs[i]->sliceCol(rowStart, rowEnd));
+            }
             else {
                 llvm_unreachable("Not all vector splits handled");
             }
@@ -17,7 +17,9 @@
 #pragma once
 
 #include "Worker.h"
+#include <runtime/local/vectorized/SchedulingTelemetry.h>
 #include <runtime/local/vectorized/TaskQueues.h>
+#include <util/KernelThreads.h>
 
 #include <spdlog/spdlog.h>
 
@@ -34,6 +36,27 @@ class WorkerCPU : public Worker {
     int _queueMode;
     int _stealLogic;
     bool _pinWorkers;
+    WorkerTelemetry _telemetry;
+
+    Task* dequeue(int queue, bool steal) {
+        auto begin = WorkerTelemetry::Clock::now();
+        Task* t = _q[queue]->dequeueTask();
+        _telemetry.waitNs += WorkerTelemetry::elapsedNs(begin, WorkerTelemetry::Clock::now());
+        if( steal ) {
+            _telemetry.stealAttempts++;
+            if( !isEOF(t) )
+                _telemetry.stealSuccesses++;
+        }
+        return t;
+    }
+
+    void executeTask(Task* t) {
+        auto begin = WorkerTelemetry::Clock::now();
+        t->execute(_fid, _batchSize);
+        _telemetry.addTask(t->getTaskSize(), WorkerTelemetry::elapsedNs(begin, WorkerTelemetry::Clock::now()));
+        delete t;
+    }
+
 public:
     // ToDo: remove compile-time verbose parameter and use logger
     WorkerCPU(std::vector<TaskQueue*> deques, std::vector<int> physical_ids, std::vector<int> unique_threads,
@@ -48,7 +71,13 @@ public:
 
     ~WorkerCPU() override = default;
 
+    /**
+     * @brief Returns what this worker did; only valid after it was joined.
+     */
+    const WorkerTelemetry& getTelemetry() const { return _telemetry; }
+
     void run() override {
+        VectorizedWorkerScope workerScope;
         if (_pinWorkers) {
             // pin worker to CPU core
             cpu_set_t cpuset;
@@ -70,16 +99,15 @@ public:
         }
         int startingQueue = targetQueue;
 
-        Task* t = _q[targetQueue]->dequeueTask();
+        Task* t = dequeue(targetQueue, false);
 
         while( !isEOF(t) ) {
             //execute self-contained task
             if( _verbose )
                 ctx->logger->trace("WorkerCPU: executing task.");
-            t->execute(_fid, _batchSize);
-            delete t;
+            executeTask(t);
             //get next tasks (blocking)
-            t = _q[targetQueue]->dequeueTask();
+            t = dequeue(targetQueue, false);
         }
 
         // All tasks from own queue have completed. Now stealing from other queues.
@@ -91,12 +119,11 @@ public:
                 targetQueue = (targetQueue+1)%_numQueues;
 
                 while ( targetQueue != startingQueue ) {
-                    t = _q[targetQueue]->dequeueTask();
+                    t = dequeue(targetQueue, true);
                     if( isEOF(t) ) {
                         targetQueue = (targetQueue+1)%_numQueues;
                     } else {
-                        t->execute(_fid, _batchSize);
-                        delete t;
+                        executeTask(t);
                     }
                 }
             } else if ( _stealLogic == 1) {
@@ -106,12 +133,11 @@ public:
 
                     while ( targetQueue != startingQueue ) {
                         if ( _physical_ids[targetQueue] == currentDomain ){
-                            t = _q[targetQueue]->dequeueTask();
+                            t = dequeue(targetQueue, true);
                             if( isEOF(t) ) {
                                 targetQueue = (targetQueue+1)%_numQueues;
                             } else {
-                                t->execute(_fid, _batchSize);
-                                delete t;
+                                executeTask(t);
                             }
                         } else {
                             targetQueue = (targetQueue+1)%_numQueues;
@@ -124,12 +150,11 @@ public:
                 targetQueue = (targetQueue+1)%_numQueues;
 
                 while ( targetQueue != startingQueue ) {
-                    t = _q[targetQueue]->dequeueTask();
+                    t = dequeue(targetQueue, true);
                     if( isEOF(t) ) {
                         targetQueue = (targetQueue+1)%_numQueues;
                     } else {
-                        t->execute(_fid, _batchSize);
-                        delete t;
+                        executeTask(t);
                     }
                 }
             } else if( _stealLogic == 2) {
@@ -139,13 +164,12 @@ public:
                 while( std::accumulate(eofWorkers.begin(), eofWorkers.end(), 0) < _numQueues ) {
                     targetQueue = rand() % _numQueues;
                     if( eofWorkers[targetQueue] == false ) {
-                        t = _q[targetQueue]->dequeueTask();
+                        t = dequeue(targetQueue, true);
                         //std::cout << "Execute task stolen from: " << targetQueue << std::endl;
                         if( isEOF(t) ) {
                             eofWorkers[targetQueue] = true;
                         } else {
-                            t->execute(_fid, _batchSize);
-                            delete t;
+                            executeTask(t);
                         }
                     }
                 }
@@ -165,12 +189,11 @@ public:
                         targetQueue = rand() % _numQueues;
                         if( _physical_ids[targetQueue] == currentDomain) {
                             if( eofWorkers[targetQueue] == false ) {
-                                t = _q[targetQueue]->dequeueTask();
+                                t = dequeue(targetQueue, true);
                                 if( isEOF(t) ) {
                                     eofWorkers[targetQueue] = true;
                                 } else {
-                                    t->execute(_fid, _batchSize);
-                                    delete t;
+                                    executeTask(t);
                                 }
                             }
                         }
@@ -184,12 +207,11 @@ public:
                     targetQueue = rand() % _numQueues;
                     // no need to check if they are on the other domain, because otherwise they would be EOF anyway
                     if( eofWorkers[targetQueue] == false ) {
-                        t = _q[targetQueue]->dequeueTask();
+                        t = dequeue(targetQueue, true);
                         if( isEOF(t) ) {
                             eofWorkers[targetQueue] = true;
                         } else {
-                            t->execute(_fid, _batchSize);
-                            delete t;
+                            executeTask(t);
                         }
                     }
                 }
@@ -0,0 +1,240 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BufferManager.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+BufferManager &BufferManager::instance() {
+    static BufferManager INSTANCE;
+    return INSTANCE;
+}
+
+void BufferManager::configure(size_t budget, const std::string &spillDir) {
+    std::lock_guard<std::mutex> lg(mtx);
+    this->budget = budget;
+    this->spillDir = spillDir.empty() ? std::filesystem::temp_directory_path().string() : spillDir;
+}
+
+std::vector<BufferManager::PendingSpill> BufferManager::selectVictims(const std::vector<const Structure *> &skip) {
+    std::vector<PendingSpill> victims;
+    if (liveBytes <= budget)
+        return victims;
+    std::vector<std::pair<uint64_t, const Structure *>> candidates;
+    for (auto &[obj, e] : entries)
+        if (e.numPins == 0 && e.spillPath.empty() && !e.spilling &&
+            std::find(skip.begin(), skip.end(), obj) == skip.end())
+            candidates.emplace_back(e.lastAccess, obj);
+    std::sort(candidates.begin(), candidates.end());
+    for (auto &[lastAccess, obj] : candidates) {
+        if (liveBytes <= budget)
+            break;
+        Entry &e = entries.at(obj);
+        const std::string path = (std::filesystem::path(spillDir) /
+                                  ("daphne-spill-" + std::to_string(getpid()) + "-" +
+                                   std::to_string(nextSpillFileId++) + ".dbdf"))
+                                     .string();
+        // Account for the bytes right away, such that concurrent callers do
+        // not select further victims for the same excess.
+        e.spilling = true;
+        liveBytes -= e.bytes;
+        numPendingSpills++;
+        victims.push_back({obj, path, e.spill});
+    }
+    return victims;
+}
+
+void BufferManager::spillVictims(std::vector<PendingSpill> victims) {
+    // The data objects that cannot be spilled at the moment; their bytes are
+    // made up for by further victims.
+    std::vector<const Structure *> failed;
+    while (!victims.empty()) {
+        const size_t numFailed = failed.size();
+        for (const PendingSpill &v : victims) {
+            bool spilled = false;
+            try {
+                spilled = v.spill(v.obj, v.path);
+            } catch (const std::exception &e) {
+                spdlog::warn("buffer manager: could not spill a data object to {}: {}", v.path, e.what());
+                std::filesystem::remove(v.path);
+            }
+            std::lock_guard<std::mutex> lg(mtx);
+            // Spilling entries are neither released nor cleared, so the entry
+            // still exists.
+            Entry &e = entries.at(v.obj);
+            e.spilling = false;
+            if (spilled) {
+                e.spillPath = v.path;
+                spilledBytes += e.bytes;
+                numSpills++;
+            } else {
+                liveBytes += e.bytes;
+                failed.push_back(v.obj);
+            }
+            numPendingSpills--;
+            spillDone.notify_all();
+        }
+        if (failed.size() == numFailed)
+            break;
+        std::lock_guard<std::mutex> lg(mtx);
+        victims = selectVictims(failed);
+    }
+}
+
+void BufferManager::restore(const Structure *obj, Entry &entry) {
+    entry.restore(obj, entry.spillPath);
+    std::filesystem::remove(entry.spillPath);
+    entry.spillPath.clear();
+    liveBytes += entry.bytes;
+    peakLiveBytes = std::max(peakLiveBytes, liveBytes);
+    numRestores++;
+}
+
+void BufferManager::track(const Structure *obj, size_t bytes, SpillFn spill, RestoreFn restore) {
+    std::vector<PendingSpill> victims;
+    {
+        std::lock_guard<std::mutex> lg(mtx);
+        auto it = entries.find(obj);
+        if (it != entries.end()) {
+            it->second.lastAccess = ++accessClock;
+            return;
+        }
+        obj->increaseRefCounter();
+        entries.emplace(obj, Entry{bytes, ++accessClock, 0, "", false, spill, restore});
+        liveBytes += bytes;
+        peakLiveBytes = std::max(peakLiveBytes, liveBytes);
+        victims = selectVictims();
+    }
+    spillVictims(std::move(victims));
+}
+
+bool BufferManager::pin(const Structure *obj) {
+    std::vector<PendingSpill> victims;
+    {
+        std::unique_lock<std::mutex> lk(mtx);
+        auto it = entries.find(obj);
+        if (it == entries.end())
+            return false;
+        it->second.numPins++;
+        it->second.lastAccess = ++accessClock;
+        // The pin keeps the entry from being released or spilled again, but
+        // a spill already in progress must finish before we can restore.
+        spillDone.wait(lk, [&] { return !entries.at(obj).spilling; });
+        Entry &e = entries.at(obj);
+        if (!e.spillPath.empty()) {
+            restore(obj, e);
+            victims = selectVictims();
+        }
+    }
+    spillVictims(std::move(victims));
+    return true;
+}
+
+void BufferManager::unpin(const Structure *obj) {
+    std::lock_guard<std::mutex> lg(mtx);
+    auto it = entries.find(obj);
+    if (it != entries.end() && it->second.numPins)
+        it->second.numPins--;
+}
+
+void BufferManager::releaseUnused() {
+    std::vector<const Structure *> released;
+    {
+        std::lock_guard<std::mutex> lg(mtx);
+        for (auto it = entries.begin(); it != entries.end();) {
+            // Nobody else can obtain a new reference to a data object only
+            // the buffer manager holds a reference to.
+            if (it->second.numPins == 0 && !it->second.spilling && it->first->getRefCounter() == 1) {
+                if (it->second.spillPath.empty())
+                    liveBytes -= it->second.bytes;
+                else
+                    std::filesystem::remove(it->second.spillPath);
+                released.push_back(it->first);
+                it = entries.erase(it);
+            } else
+                ++it;
+        }
+    }
+    // Release the data objects outside the critical section.
+    for (const Structure *obj : released)
+        DataObjectFactory::destroy(obj);
+}
+
+void BufferManager::clear() {
+    std::unordered_map<const Structure *, Entry> released;
+    {
+        std::unique_lock<std::mutex> lk(mtx);
+        spillDone.wait(lk, [&] { return numPendingSpills == 0; });
+        for (auto &[obj, e] : entries)
+            if (!e.spillPath.empty()) {
+                // The data object may still be used after the run (e.g., as
+                // a DaphneLib result).
+                if (obj->getRefCounter() > 1)
+                    restore(obj, e);
+                else
+                    std::filesystem::remove(e.spillPath);
+            }
+        released.swap(entries);
+        liveBytes = 0;
+        peakLiveBytes = 0;
+        numSpills = 0;
+        numRestores = 0;
+        spilledBytes = 0;
+    }
+    for (auto &[obj, e] : released)
+        DataObjectFactory::destroy(obj);
+}
+
+size_t BufferManager::getNumEntries() {
+    std::lock_guard<std::mutex> lg(mtx);
+    return entries.size();
+}
+
+size_t BufferManager::getLiveBytes() {
+    std::lock_guard<std::mutex> lg(mtx);
+    return liveBytes;
+}
+
+size_t BufferManager::getNumSpills() {
+    std::lock_guard<std::mutex> lg(mtx);
+    return numSpills;
+}
+
+size_t BufferManager::getNumRestores() {
+    std::lock_guard<std::mutex> lg(mtx);
+    return numRestores;
+}
+
+bool BufferManager::isSpilled(const Structure *obj) {
+    std::lock_guard<std::mutex> lg(mtx);
+    auto it = entries.find(obj);
+    return it != entries.end() && !it->second.spillPath.empty();
+}
+
+void BufferManager::dumpStatistics() {
+    std::lock_guard<std::mutex> lg(mtx);
+    spdlog::set_level(spdlog::level::info);
+    spdlog::info("DAPHNE buffer manager: budget {} bytes, peak {} bytes in memory, {} spills ({} bytes), {} restores.",
+                 budget, peakLiveBytes, numSpills, spilledBytes, numRestores);
+}
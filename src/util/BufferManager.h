@@ -0,0 +1,184 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <runtime/local/datastructures/Structure.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief The BufferManager keeps the host memory occupied by large data
+ * objects within a budget, when --memory-budget is specified by the user.
+ *
+ * The generated kernel wrappers announce the data objects passed to and
+ * returned from each kernel (see `BufferAccess`). Data objects of at least
+ * `MIN_TRACKED_BYTES` bytes are tracked: the buffer manager holds a reference
+ * to them and records their size and their last access. When the tracked
+ * bytes in memory exceed the budget, the least recently accessed data objects
+ * that are not in use by a running kernel are spilled to a file in the spill
+ * directory and their values are released. A spilled data object is restored
+ * transparently when it is passed to a kernel again. Data objects no longer
+ * referenced by anyone but the buffer manager are released at the next kernel
+ * call.
+ *
+ * All methods may be called concurrently. The spill files are written outside
+ * the critical section, such that other threads are only blocked by a spill
+ * when they need the data object being spilled.
+ */
+class BufferManager {
+  public:
+    /**
+     * @brief Writes the values of the given data object to the given file and
+     * releases them from memory.
+     *
+     * @return `false` if the data object cannot be spilled at the moment
+     * (e.g., because its values are shared with other data objects).
+     */
+    using SpillFn = bool (*)(const Structure *obj, const std::string &path);
+
+    /**
+     * @brief Reads the values of the given data object back from the given
+     * file.
+     */
+    using RestoreFn = void (*)(const Structure *obj, const std::string &path);
+
+    /**
+     * @brief Smaller data objects are not tracked, since spilling them would
+     * not be worth the I/O.
+     */
+    static constexpr size_t MIN_TRACKED_BYTES = size_t(1) << 20;
+
+  private:
+    struct Entry {
+        size_t bytes;
+        uint64_t lastAccess;
+        size_t numPins;
+        // The path of the spill file, empty if the values are in memory.
+        std::string spillPath;
+        // Whether the values are being written to a spill file right now.
+        bool spilling;
+        SpillFn spill;
+        RestoreFn restore;
+    };
+
+    struct PendingSpill {
+        const Structure *obj;
+        std::string path;
+        SpillFn spill;
+    };
+
+    std::mutex mtx;
+    // Notified whenever a spill has finished.
+    std::condition_variable spillDone;
+    size_t numPendingSpills = 0;
+    std::unordered_map<const Structure *, Entry> entries;
+    size_t budget = 0;
+    std::string spillDir;
+    uint64_t accessClock = 0;
+    size_t nextSpillFileId = 0;
+
+    size_t liveBytes = 0;
+    size_t peakLiveBytes = 0;
+    size_t numSpills = 0;
+    size_t numRestores = 0;
+    size_t spilledBytes = 0;
+
+    /**
+     * @brief Selects the least recently accessed unpinned data objects to
+     * spill until the tracked bytes in memory fit into the budget (if
+     * possible) and marks them as being spilled.
+     *
+     * Must be called while holding the mutex.
+     *
+     * @param skip Data objects not to select, e.g., because they could not be
+     * spilled before.
+     */
+    std::vector<PendingSpill> selectVictims(const std::vector<const Structure *> &skip = {});
+
+    /**
+     * @brief Spills the given data objects and records the outcome. Selects
+     * further victims for the data objects that could not be spilled.
+     *
+     * Must be called without holding the mutex.
+     */
+    void spillVictims(std::vector<PendingSpill> victims);
+
+    void restore(const Structure *obj, Entry &entry);
+
+  public:
+    static BufferManager &instance();
+
+    /**
+     * @brief Sets the budget in bytes and the directory for the spill files.
+     *
+     * @param budget The maximum number of bytes of the tracked data objects
+     * in memory.
+     * @param spillDir The directory for the spill files, the system's
+     * temporary directory if empty.
+     */
+    void configure(size_t budget, const std::string &spillDir);
+
+    /**
+     * @brief Starts tracking the given data object, or records an access to
+     * it, if it is already tracked.
+     *
+     * @param obj The data object; its reference counter is increased if it is
+     * newly tracked.
+     * @param bytes The size of the data object's values in bytes.
+     * @param spill The function for spilling the data object.
+     * @param restore The function for restoring the data object.
+     */
+    void track(const Structure *obj, size_t bytes, SpillFn spill, RestoreFn restore);
+
+    /**
+     * @brief Restores the given data object, if it is tracked and spilled,
+     * and protects it from being spilled until `unpin()` is called.
+     *
+     * @return `true` if the data object is tracked and was pinned, `false`
+     * otherwise.
+     */
+    bool pin(const Structure *obj);
+
+    void unpin(const Structure *obj);
+
+    /**
+     * @brief Stops tracking and releases the data objects nobody else holds a
+     * reference to.
+     */
+    void releaseUnused();
+
+    /**
+     * @brief Restores all spilled data objects that are still referenced
+     * elsewhere, stops tracking all data objects, and removes all spill
+     * files.
+     */
+    void clear();
+
+    size_t getNumEntries();
+    size_t getLiveBytes();
+    size_t getNumSpills();
+    size_t getNumRestores();
+    bool isSpilled(const Structure *obj);
+
+    void dumpStatistics();
+};
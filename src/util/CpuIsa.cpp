@@ -0,0 +1,102 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CpuIsa.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+
+#include <cstdint>
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 12
+// GCC knows the feature sets of the levels.
+static bool supportsX86_64_v2() { return __builtin_cpu_supports("x86-64-v2"); }
+static bool supportsX86_64_v3() { return __builtin_cpu_supports("x86-64-v3"); }
+static bool supportsX86_64_v4() { return __builtin_cpu_supports("x86-64-v4"); }
+#else
+// The feature sets of the x86-64 psABI micro-architecture levels, queried via
+// cpuid, since __builtin_cpu_supports cannot query all of them.
+
+static bool hasBits(unsigned reg, unsigned bits) { return (reg & bits) == bits; }
+
+/**
+ * @brief Whether the OS saves the given state components (XCR0 bits) on
+ * context switches, which is required for using AVX and AVX-512.
+ */
+static bool osSavesState(uint64_t components) {
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !hasBits(ecx, bit_OSXSAVE))
+        return false;
+    uint32_t xcr0Lo, xcr0Hi;
+    __asm__("xgetbv" : "=a"(xcr0Lo), "=d"(xcr0Hi) : "c"(0));
+    return ((uint64_t(xcr0Hi) << 32 | xcr0Lo) & components) == components;
+}
+
+static bool supportsX86_64_v2() {
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) ||
+        !hasBits(ecx, bit_SSE3 | bit_SSSE3 | bit_CMPXCHG16B | bit_SSE4_1 | bit_SSE4_2 | bit_POPCNT))
+        return false;
+    return __get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx) && hasBits(ecx, bit_LAHF_LM);
+}
+
+static bool supportsX86_64_v3() {
+    unsigned eax, ebx, ecx, edx;
+    if (!supportsX86_64_v2() || !__get_cpuid(1, &eax, &ebx, &ecx, &edx) ||
+        !hasBits(ecx, bit_FMA | bit_MOVBE | bit_XSAVE | bit_OSXSAVE | bit_AVX | bit_F16C))
+        return false;
+    if (!__get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx) || !hasBits(ecx, bit_ABM)) // LZCNT
+        return false;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) || !hasBits(ebx, bit_BMI | bit_AVX2 | bit_BMI2))
+        return false;
+    // SSE and AVX state.
+    return osSavesState(0x6);
+}
+
+static bool supportsX86_64_v4() {
+    unsigned eax, ebx, ecx, edx;
+    if (!supportsX86_64_v3() || !__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) ||
+        !hasBits(ebx, bit_AVX512F | bit_AVX512BW | bit_AVX512CD | bit_AVX512DQ | bit_AVX512VL))
+        return false;
+    // SSE, AVX, and AVX-512 (opmask, upper halves of ZMM0-15, ZMM16-31) state.
+    return osSavesState(0xe6);
+}
+#endif
+#endif
+
+std::vector<std::string> getHostIsaLevels() {
+    std::vector<std::string> levels;
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (supportsX86_64_v4())
+        levels.emplace_back("x86-64-v4");
+    if (supportsX86_64_v3())
+        levels.emplace_back("x86-64-v3");
+    if (supportsX86_64_v2())
+        levels.emplace_back("x86-64-v2");
+#endif
+    return levels;
+}
+
+std::vector<std::string> getKernelIsaCandidates(const std::string &kernelIsa) {
+    if (kernelIsa == "auto")
+        return getHostIsaLevels();
+    if (kernelIsa == "generic" || kernelIsa.empty())
+        return {};
+    return {kernelIsa};
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Returns the x86-64 micro-architecture levels (`x86-64-v4`,
+ * `x86-64-v3`, `x86-64-v2`) supported by the CPU this process runs on, best
+ * level first.
+ *
+ * The result is empty on other architectures and on CPUs supporting only the
+ * baseline level.
+ */
+std::vector<std::string> getHostIsaLevels();
+
+/**
+ * @brief Returns the ISA levels to try for loading kernel libraries, best
+ * level first.
+ *
+ * @param kernelIsa Either `"auto"` (all levels supported by the host CPU),
+ * `"generic"` (none, i.e., always the baseline libraries), or the name of one
+ * particular level (e.g., `"x86-64-v3"`).
+ */
+std::vector<std::string> getKernelIsaCandidates(const std::string &kernelIsa);
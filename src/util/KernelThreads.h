@@ -0,0 +1,114 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include <cstddef>
+
+/**
+ * @brief Returns whether the calling thread is a worker of the vectorized
+ * engine, i.e., executes the bodies of vectorized pipelines.
+ *
+ * Kernels called from a worker must not spawn threads of their own, since
+ * the workers already occupy all cores, and must not hand their (per-task)
+ * results to process-wide facilities like the `BufferManager`, since the
+ * worker combines them outside of any kernel call.
+ */
+inline bool &isVectorizedWorkerThread() {
+    thread_local bool isWorker = false;
+    return isWorker;
+}
+
+/**
+ * @brief Marks the calling thread as a worker of the vectorized engine for
+ * the lifetime of this object.
+ */
+class VectorizedWorkerScope {
+    bool wasWorker;
+
+  public:
+    VectorizedWorkerScope() : wasWorker(isVectorizedWorkerThread()) { isVectorizedWorkerThread() = true; }
+    ~VectorizedWorkerScope() { isVectorizedWorkerThread() = wasWorker; }
+
+    VectorizedWorkerScope(const VectorizedWorkerScope &) = delete;
+    VectorizedWorkerScope &operator=(const VectorizedWorkerScope &) = delete;
+};
+
+/**
+ * @brief Returns the number of threads a kernel shall use.
+ *
+ * @param numThreads The number of threads configured by the user (e.g.,
+ * `DaphneUserConfig::numberOfThreads`), or a non-positive value for one per
+ * hardware thread.
+ * @return `1` on the workers of the vectorized engine, the configured number
+ * of threads otherwise.
+ */
+inline size_t getNumKernelThreads(int numThreads) {
+    if(isVectorizedWorkerThread())
+        return 1;
+    if(numThreads > 0)
+        return numThreads;
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * @brief Calls `func(i)` for all `i` in `[0, numItems)` using up to
+ * `numThreads` threads, which pick the items dynamically.
+ *
+ * On the workers of the vectorized engine, all calls are made by the calling
+ * thread, since the workers already occupy all cores.
+ *
+ * The first exception thrown by any call is rethrown in the calling thread
+ * after all threads have finished.
+ *
+ * @param numThreads The number of threads, `0` for one per hardware thread.
+ */
+template<typename Func>
+void parallelForEach(size_t numItems, size_t numThreads, Func func) {
+    numThreads = std::min(getNumKernelThreads(static_cast<int>(numThreads)), numItems);
+    if(numThreads <= 1) {
+        for(size_t i = 0; i < numItems; i++)
+            func(i);
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    std::vector<std::exception_ptr> errors(numThreads);
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads);
+    for(size_t t = 0; t < numThreads; t++)
+        threads.emplace_back([&, t]() {
+            try {
+                for(size_t i = next++; i < numItems; i = next++)
+                    func(i);
+            }
+            catch(...) {
+                errors[t] = std::current_exception();
+                next = numItems;
+            }
+        });
+    for(auto & thread : threads)
+        thread.join();
+    for(auto & error : errors)
+        if(error)
+            std::rethrow_exception(error);
+}
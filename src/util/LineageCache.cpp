@@ -0,0 +1,132 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LineageCache.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+LineageCache &LineageCache::instance() {
+    static LineageCache INSTANCE;
+    return INSTANCE;
+}
+
+const Structure *LineageCache::lookup(uint64_t lineage) {
+    std::lock_guard<std::mutex> lg(mtx);
+    auto it = entries.find(lineage);
+    if (it == entries.end()) {
+        numMisses++;
+        return nullptr;
+    }
+    numHits++;
+    it->second.hits++;
+    it->second.obj->increaseRefCounter();
+    return it->second.obj;
+}
+
+bool LineageCache::put(uint64_t lineage, const Structure *obj, size_t bytes, double seconds, size_t capacity) {
+    if (bytes > capacity)
+        return false;
+
+    std::vector<const Structure *> evicted;
+    {
+        std::lock_guard<std::mutex> lg(mtx);
+        if (entries.count(lineage))
+            return false;
+
+        const Entry entry{obj, bytes, seconds, 0};
+        if (usedBytes + bytes > capacity) {
+            // Determine the entries with the lowest benefit that need to be
+            // evicted to make room, and give up if the new entry has a lower
+            // benefit than any of them.
+            std::vector<std::pair<double, uint64_t>> candidates;
+            for (auto &[l, e] : entries)
+                candidates.emplace_back(e.benefit(), l);
+            std::sort(candidates.begin(), candidates.end());
+            size_t numVictims = 0;
+            size_t freedBytes = 0;
+            while (usedBytes - freedBytes + bytes > capacity) {
+                if (candidates[numVictims].first >= entry.benefit())
+                    return false;
+                freedBytes += entries[candidates[numVictims].second].bytes;
+                numVictims++;
+            }
+            for (size_t i = 0; i < numVictims; i++) {
+                auto it = entries.find(candidates[i].second);
+                evicted.push_back(it->second.obj);
+                usedBytes -= it->second.bytes;
+                entries.erase(it);
+            }
+            numEvictions += numVictims;
+        }
+        obj->increaseRefCounter();
+        entries.emplace(lineage, entry);
+        usedBytes += bytes;
+    }
+    // Release the evicted data objects outside the critical section.
+    for (const Structure *e : evicted)
+        DataObjectFactory::destroy(e);
+    return true;
+}
+
+size_t LineageCache::getNumEntries() {
+    std::lock_guard<std::mutex> lg(mtx);
+    return entries.size();
+}
+
+size_t LineageCache::getUsedBytes() {
+    std::lock_guard<std::mutex> lg(mtx);
+    return usedBytes;
+}
+
+size_t LineageCache::getNumHits() {
+    std::lock_guard<std::mutex> lg(mtx);
+    return numHits;
+}
+
+size_t LineageCache::getNumMisses() {
+    std::lock_guard<std::mutex> lg(mtx);
+    return numMisses;
+}
+
+size_t LineageCache::getNumEvictions() {
+    std::lock_guard<std::mutex> lg(mtx);
+    return numEvictions;
+}
+
+void LineageCache::clear() {
+    std::unordered_map<uint64_t, Entry> released;
+    {
+        std::lock_guard<std::mutex> lg(mtx);
+        released.swap(entries);
+        usedBytes = 0;
+        numHits = 0;
+        numMisses = 0;
+        numEvictions = 0;
+    }
+    for (auto &[l, e] : released)
+        DataObjectFactory::destroy(e.obj);
+}
+
+void LineageCache::dumpStatistics() {
+    std::lock_guard<std::mutex> lg(mtx);
+    spdlog::set_level(spdlog::level::info);
+    spdlog::info("DAPHNE lineage cache: {} hits, {} misses, {} evictions, {} entries ({} bytes).", numHits, numMisses,
+                 numEvictions, entries.size(), usedBytes);
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <runtime/local/datastructures/Structure.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+// ****************************************************************************
+// Lineage hashes
+// ****************************************************************************
+
+/**
+ * @brief Combines two lineage hashes into one, depending on their order.
+ */
+inline uint64_t combineLineage(uint64_t seed, uint64_t value) {
+    // Mixing as in splitmix64, to spread small differences (e.g., consecutive
+    // unique ids) over all bits.
+    uint64_t h = seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+    return h ^ (h >> 31);
+}
+
+inline uint64_t lineageOf(const Structure *arg) {
+    return arg ? arg->getLineage() : 0;
+}
+
+inline uint64_t lineageOf(const char *arg) {
+    return arg ? std::hash<std::string_view>{}(arg) : 0;
+}
+
+template<typename VT>
+std::enable_if_t<std::is_arithmetic_v<VT> || std::is_enum_v<VT>, uint64_t> lineageOf(VT arg) {
+    static_assert(sizeof(VT) <= sizeof(uint64_t));
+    uint64_t bits = 0;
+    std::memcpy(&bits, &arg, sizeof(VT));
+    return bits;
+}
+
+// ****************************************************************************
+// Lineage cache
+// ****************************************************************************
+
+/**
+ * @brief The LineageCache keeps the results of expensive kernel calls, keyed
+ * by their lineage, for reuse when --lineage-reuse is specified by the user.
+ *
+ * The lineage of a result is a hash of the kernel (including its type
+ * instantiation), the lineages of its input data objects, and its scalar
+ * arguments. Thus, repeating the same computation on the same data (e.g.,
+ * loop-invariant computations inside a loop or function calls with the same
+ * arguments) yields the same lineage, while data objects of unknown origin
+ * get unique lineages.
+ *
+ * The cache holds a reference to each of its data objects and is bounded by a
+ * number of bytes. When a new result does not fit, the entries with the
+ * lowest benefit (compute time times one plus the number of hits, per byte)
+ * are evicted, unless the new result itself has the lowest benefit, in which
+ * case it is not cached.
+ *
+ * All methods may be called concurrently.
+ */
+class LineageCache {
+  private:
+    struct Entry {
+        const Structure *obj;
+        size_t bytes;
+        double seconds;
+        size_t hits;
+
+        double benefit() const { return seconds * (1 + hits) / (bytes ? bytes : 1); }
+    };
+
+    std::mutex mtx;
+    std::unordered_map<uint64_t, Entry> entries;
+    size_t usedBytes = 0;
+    size_t numHits = 0;
+    size_t numMisses = 0;
+    size_t numEvictions = 0;
+
+  public:
+    static LineageCache &instance();
+
+    /**
+     * @brief Returns the cached data object of the given lineage with an
+     * increased reference counter, or `nullptr` if there is none.
+     */
+    const Structure *lookup(uint64_t lineage);
+
+    /**
+     * @brief Offers a data object of the given lineage to the cache.
+     *
+     * @param lineage The lineage of the data object.
+     * @param obj The data object; its reference counter is increased if it is
+     * cached.
+     * @param bytes The size of the data object in bytes.
+     * @param seconds The time it took to compute the data object.
+     * @param capacity The maximum number of bytes of all cached data objects.
+     * @return `true` if the data object was cached, `false` otherwise.
+     */
+    bool put(uint64_t lineage, const Structure *obj, size_t bytes, double seconds, size_t capacity);
+
+    size_t getNumEntries();
+    size_t getUsedBytes();
+    size_t getNumHits();
+    size_t getNumMisses();
+    size_t getNumEvictions();
+
+    /**
+     * @brief Releases all cached data objects and resets the counters.
+     */
+    void clear();
+
+    /**
+     * @brief Prints the hits, misses, and evictions of the cache.
+     */
+    void dumpStatistics();
+};
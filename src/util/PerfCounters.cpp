@@ -0,0 +1,297 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PerfCounters.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+#ifdef __linux__
+struct PerfEventConfig {
+    uint32_t type;
+    uint64_t config;
+};
+
+// In the order of PerfEvent.
+const PerfEventConfig perfEventConfigs[NUM_PERF_EVENTS] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE,
+     PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+};
+
+int openPerfEvent(const PerfEventConfig &cfg, int groupFd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = cfg.type;
+    attr.config = cfg.config;
+    attr.disabled = groupFd == -1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    // Count the calling thread on any CPU.
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+#endif
+
+std::string formatCount(bool available, uint64_t value) {
+    return available ? std::to_string(value) : "n/a";
+}
+
+std::string formatMetric(bool available, double value) {
+    return available ? fmt::format("{:.2f}", value) : "n/a";
+}
+} // namespace
+
+PerfCounters::ThreadCounters::ThreadCounters(size_t tid) : tid(tid) {
+    fds.fill(-1);
+    slots.fill(-1);
+#ifdef __linux__
+    // The first event that can be opened becomes the group leader, such that
+    // all events are scheduled together.
+    for (size_t i = 0; i < NUM_PERF_EVENTS; i++) {
+        int fd = openPerfEvent(perfEventConfigs[i], groupFd);
+        if (fd == -1)
+            continue;
+        if (groupFd == -1)
+            groupFd = fd;
+        fds[i] = fd;
+        slots[i] = static_cast<int>(numSlots++);
+    }
+    if (groupFd != -1) {
+        ioctl(groupFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(groupFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+PerfCounters::ThreadCounters::~ThreadCounters() {
+#ifdef __linux__
+    for (int fd : fds)
+        if (fd != -1)
+            close(fd);
+#endif
+}
+
+std::array<uint64_t, NUM_PERF_EVENTS> PerfCounters::ThreadCounters::read() const {
+    std::array<uint64_t, NUM_PERF_EVENTS> values{};
+#ifdef __linux__
+    if (groupFd == -1)
+        return values;
+    // Layout of a group read: the number of events, followed by their values.
+    uint64_t buf[1 + NUM_PERF_EVENTS];
+    if (::read(groupFd, buf, sizeof(buf)) < static_cast<ssize_t>((1 + numSlots) * sizeof(uint64_t)))
+        return values;
+    for (size_t i = 0; i < NUM_PERF_EVENTS; i++)
+        if (slots[i] != -1)
+            values[i] = buf[1 + slots[i]];
+#endif
+    return values;
+}
+
+PerfCounters &PerfCounters::instance() {
+    static PerfCounters INSTANCE;
+    return INSTANCE;
+}
+
+const char *PerfCounters::eventName(PerfEvent event) {
+    switch (event) {
+    case CYCLES:
+        return "cycles";
+    case INSTRUCTIONS:
+        return "instructions";
+    case LLC_MISSES:
+        return "LLC-misses";
+    case BRANCH_MISSES:
+        return "branch-misses";
+    case PAGE_FAULTS:
+        return "page-faults";
+    default:
+        return "unknown";
+    }
+}
+
+struct PerfCounters::ThreadCountersHolder {
+    std::unique_ptr<ThreadCounters> counters;
+
+    ~ThreadCountersHolder() {
+        if (counters)
+            PerfCounters::instance().retire(counters.get());
+    }
+};
+
+PerfCounters::ThreadCounters &PerfCounters::threadCounters() {
+    thread_local ThreadCountersHolder holder;
+    if (!holder.counters) {
+        std::lock_guard<std::mutex> lg(m_threads);
+        holder.counters = std::make_unique<ThreadCounters>(numThreadsStarted++);
+        threads.push_back(holder.counters.get());
+        if (holder.counters->groupFd == -1 && holder.counters->tid == 0)
+            spdlog::warn("could not open any performance counters (perf_event_open), check "
+                         "/proc/sys/kernel/perf_event_paranoid");
+    }
+    return *holder.counters;
+}
+
+void PerfCounters::retire(ThreadCounters *tc) {
+    std::lock_guard<std::mutex> lg(m_threads);
+    threads.erase(std::find(threads.begin(), threads.end(), tc));
+    for (auto &[kId, counts] : tc->countsPerKernel) {
+        exitedCountsPerKernel[kId] += counts;
+        exitedCounts += counts;
+    }
+    for (size_t i = 0; i < NUM_PERF_EVENTS; i++)
+        exitedAvailable[i] = exitedAvailable[i] || tc->slots[i] != -1;
+}
+
+void PerfCounters::startKernel([[maybe_unused]] int kId) {
+    ThreadCounters &tc = threadCounters();
+    tc.openKernels.emplace_back(tc.read(), Clock::now());
+}
+
+void PerfCounters::stopKernel(int kId) {
+    ThreadCounters &tc = threadCounters();
+    const auto values = tc.read();
+    const auto stopTime = Clock::now();
+    if (tc.openKernels.empty())
+        return;
+    const auto &[startValues, startTime] = tc.openKernels.back();
+
+    PerfCounts &counts = tc.countsPerKernel[kId];
+    for (size_t i = 0; i < NUM_PERF_EVENTS; i++)
+        counts.values[i] += values[i] - startValues[i];
+    counts.timeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(stopTime - startTime).count();
+    counts.count++;
+    tc.openKernels.pop_back();
+}
+
+bool PerfCounters::isAvailable(PerfEvent event) {
+    std::lock_guard<std::mutex> lg(m_threads);
+    return exitedAvailable[event] ||
+           std::any_of(threads.begin(), threads.end(), [event](auto *tc) { return tc->slots[event] != -1; });
+}
+
+std::map<int, PerfCounts> PerfCounters::getCountsPerKernel() {
+    std::lock_guard<std::mutex> lg(m_threads);
+    std::map<int, PerfCounts> res = exitedCountsPerKernel;
+    for (auto *tc : threads)
+        for (auto &[kId, counts] : tc->countsPerKernel)
+            res[kId] += counts;
+    return res;
+}
+
+std::vector<PerfCounts> PerfCounters::getCountsPerThread() {
+    std::lock_guard<std::mutex> lg(m_threads);
+    std::vector<PerfCounts> res;
+    for (auto *tc : threads) {
+        PerfCounts total;
+        for (auto &[kId, counts] : tc->countsPerKernel)
+            total += counts;
+        res.push_back(total);
+    }
+    if (numThreadsStarted > threads.size())
+        res.push_back(exitedCounts);
+    return res;
+}
+
+void PerfCounters::clear() {
+    std::lock_guard<std::mutex> lg(m_threads);
+    // The running threads keep their counters open.
+    for (auto *tc : threads) {
+        tc->countsPerKernel.clear();
+        tc->openKernels.clear();
+    }
+    exitedCountsPerKernel.clear();
+    exitedCounts = PerfCounts();
+}
+
+void PerfCounters::dumpCounters(KernelDispatchMapping &kdm) {
+    std::array<bool, NUM_PERF_EVENTS> avail;
+    for (size_t i = 0; i < NUM_PERF_EVENTS; i++)
+        avail[i] = isAvailable(static_cast<PerfEvent>(i));
+    const bool ipcAvail = avail[CYCLES] && avail[INSTRUCTIONS];
+    const bool mpkiAvail = avail[LLC_MISSES] && avail[INSTRUCTIONS];
+
+    std::unordered_map<int, KDMInfo> kernels(kdm.begin(), kdm.end());
+    std::vector<std::pair<int, PerfCounts>> perKernel;
+    for (auto &p : getCountsPerKernel())
+        perKernel.push_back(p);
+    std::sort(perKernel.begin(), perKernel.end(), [&](auto const &a, auto const &b) {
+        return avail[CYCLES] ? a.second.values[CYCLES] > b.second.values[CYCLES] : a.second.timeNs > b.second.timeNs;
+    });
+
+    size_t maxLen = 13;
+    for (auto const &[kId, kdmInfo] : kernels)
+        maxLen = std::max(maxLen, kdmInfo.kernelName.length());
+
+    spdlog::set_level(spdlog::level::info);
+    spdlog::info("DAPHNE operator hardware counters (perf_event_open).");
+    spdlog::info("{:<2}  {:<{}}  {:>9}  {:>14}  {:>14}  {:>6}  {:>12}  {:>8}  {:>12}  {:>10}  {:>9}  {}", "#",
+                 "Operator Name", maxLen, "Time(s)", "Cycles", "Instructions", "IPC", "LLC-misses", "MPKI",
+                 "Branch-miss", "Mem(GB/s)", "Bytes/Ins", "File:Line:Column");
+    int i = 0;
+    for (auto const &[kId, c] : perKernel) {
+        auto it = kernels.find(kId);
+        spdlog::info("{:<2}  {:<{}}  {:>9.4f}  {:>14}  {:>14}  {:>6}  {:>12}  {:>8}  {:>12}  {:>10}  {:>9}  {}", i++,
+                     it != kernels.end() ? it->second.kernelName : fmt::format("kernel {}", kId), maxLen,
+                     c.timeNs / 1e9, formatCount(avail[CYCLES], c.values[CYCLES]),
+                     formatCount(avail[INSTRUCTIONS], c.values[INSTRUCTIONS]), formatMetric(ipcAvail, c.ipc()),
+                     formatCount(avail[LLC_MISSES], c.values[LLC_MISSES]), formatMetric(mpkiAvail, c.mpki()),
+                     formatCount(avail[BRANCH_MISSES], c.values[BRANCH_MISSES]),
+                     formatMetric(avail[LLC_MISSES], c.memBandwidth()),
+                     formatMetric(mpkiAvail, c.bytesPerInstruction()),
+                     it != kernels.end() ? fmt::format("{}:{}:{}", it->second.fileName, it->second.line,
+                                                       it->second.column)
+                                         : "");
+        if (i >= MAX_STATS_COUNT)
+            break;
+    }
+
+    spdlog::info("DAPHNE hardware counters per thread.");
+    spdlog::info("{:<6}  {:>9}  {:>14}  {:>14}  {:>6}  {:>12}  {:>10}  {:>12}", "Thread", "Time(s)", "Cycles",
+                 "Instructions", "IPC", "LLC-misses", "Mem(GB/s)", "Page-faults");
+    const auto perThread = getCountsPerThread();
+    size_t numRunning;
+    {
+        std::lock_guard<std::mutex> lg(m_threads);
+        numRunning = threads.size();
+    }
+    // The exited threads are summed up in the last row.
+    size_t tid = 0;
+    for (auto const &c : perThread) {
+        const std::string thread = tid < numRunning ? std::to_string(tid) : "exited";
+        tid++;
+        spdlog::info("{:<6}  {:>9.4f}  {:>14}  {:>14}  {:>6}  {:>12}  {:>10}  {:>12}", thread, c.timeNs / 1e9,
+                     formatCount(avail[CYCLES], c.values[CYCLES]),
+                     formatCount(avail[INSTRUCTIONS], c.values[INSTRUCTIONS]), formatMetric(ipcAvail, c.ipc()),
+                     formatCount(avail[LLC_MISSES], c.values[LLC_MISSES]),
+                     formatMetric(avail[LLC_MISSES], c.memBandwidth()),
+                     formatCount(avail[PAGE_FAULTS], c.values[PAGE_FAULTS]));
+    }
+}
@@ -0,0 +1,197 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <util/KernelDispatchMapping.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief The hardware (and software) events counted per kernel.
+ */
+enum PerfEvent : size_t {
+    CYCLES,
+    INSTRUCTIONS,
+    LLC_MISSES,
+    BRANCH_MISSES,
+    PAGE_FAULTS,
+    NUM_PERF_EVENTS
+};
+
+/**
+ * @brief Counter values accumulated over a number of kernel calls.
+ */
+struct PerfCounts {
+    std::array<uint64_t, NUM_PERF_EVENTS> values{};
+    uint64_t timeNs = 0;
+    size_t count = 0;
+
+    PerfCounts &operator+=(const PerfCounts &rhs) {
+        for (size_t i = 0; i < NUM_PERF_EVENTS; i++)
+            values[i] += rhs.values[i];
+        timeNs += rhs.timeNs;
+        count += rhs.count;
+        return *this;
+    }
+
+    /**
+     * @brief Instructions per cycle.
+     */
+    double ipc() const { return values[CYCLES] ? static_cast<double>(values[INSTRUCTIONS]) / values[CYCLES] : 0; }
+
+    /**
+     * @brief Last-level cache misses per thousand instructions.
+     */
+    double mpki() const {
+        return values[INSTRUCTIONS] ? 1000.0 * values[LLC_MISSES] / values[INSTRUCTIONS] : 0;
+    }
+
+    /**
+     * @brief Estimated bytes transferred from memory, assuming that every
+     * last-level cache miss loads one cache line.
+     */
+    uint64_t memBytes() const { return values[LLC_MISSES] * CACHE_LINE_SIZE; }
+
+    /**
+     * @brief Estimated memory bandwidth in GB/s.
+     */
+    double memBandwidth() const { return timeNs ? static_cast<double>(memBytes()) / timeNs : 0; }
+
+    /**
+     * @brief Estimated bytes transferred from memory per instruction; high
+     * values indicate memory-bound kernels.
+     */
+    double bytesPerInstruction() const {
+        return values[INSTRUCTIONS] ? static_cast<double>(memBytes()) / values[INSTRUCTIONS] : 0;
+    }
+
+    static constexpr uint64_t CACHE_LINE_SIZE = 64;
+};
+
+/**
+ * @brief The PerfCounters class counts hardware events per kernel call via
+ * Linux `perf_event_open`, when --perf-counters is specified by the user.
+ *
+ * Each thread opens its own group of counters (for the thread itself) on its
+ * first kernel call and accumulates the counts per kernel ID without any
+ * synchronization. When a thread exits, it closes its counters and folds its
+ * counts into an aggregate of all exited threads. Events the platform does not
+ * support (e.g., hardware events inside virtual machines) are reported as
+ * unavailable. Since the counters of a thread only count that thread, the
+ * counts of a vectorized pipeline kernel exclude its workers, whose own kernel
+ * calls are counted separately.
+ *
+ * Like `Statistics`, PerfCounters is a singleton and its results may only be
+ * read while no thread is counting.
+ */
+class PerfCounters {
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int MAX_STATS_COUNT = 10;
+
+    struct ThreadCounters {
+        size_t tid;
+        int groupFd = -1;
+        std::array<int, NUM_PERF_EVENTS> fds;
+        /**
+         * @brief The position of each event in a group read, or -1 if the
+         * event is not available.
+         */
+        std::array<int, NUM_PERF_EVENTS> slots;
+        size_t numSlots = 0;
+        /**
+         * @brief Counter values and start times of the currently running
+         * (possibly nested) kernels of this thread.
+         */
+        std::vector<std::pair<std::array<uint64_t, NUM_PERF_EVENTS>, Clock::time_point>> openKernels;
+        std::unordered_map<int, PerfCounts> countsPerKernel;
+
+        explicit ThreadCounters(size_t tid);
+        ~ThreadCounters();
+
+        std::array<uint64_t, NUM_PERF_EVENTS> read() const;
+    };
+
+    /**
+     * @brief Owns the counters of a thread and retires them on thread exit.
+     */
+    struct ThreadCountersHolder;
+
+    std::mutex m_threads;
+    /**
+     * @brief The counters of the running threads, owned by the threads.
+     */
+    std::vector<ThreadCounters *> threads;
+    size_t numThreadsStarted = 0;
+
+    /**
+     * @brief The counts and available events of all exited threads.
+     */
+    std::map<int, PerfCounts> exitedCountsPerKernel;
+    PerfCounts exitedCounts;
+    std::array<bool, NUM_PERF_EVENTS> exitedAvailable{};
+
+    ThreadCounters &threadCounters();
+
+    void retire(ThreadCounters *tc);
+
+  public:
+    static PerfCounters &instance();
+
+    static const char *eventName(PerfEvent event);
+
+    void startKernel(int kId);
+    void stopKernel(int kId);
+
+    /**
+     * @brief Returns whether the given event could be counted on any thread.
+     */
+    bool isAvailable(PerfEvent event);
+
+    /**
+     * @brief Returns the counts per kernel ID, summed over all threads.
+     */
+    std::map<int, PerfCounts> getCountsPerKernel();
+
+    /**
+     * @brief Returns the counts of all kernels per running thread, in the
+     * order the threads started counting, followed by the sum over all exited
+     * threads, if any.
+     */
+    std::vector<PerfCounts> getCountsPerThread();
+
+    /**
+     * @brief Discards all counts.
+     */
+    void clear();
+
+    /**
+     * @brief Prints the counts and derived metrics of the kernels with the
+     * most cycles (or time, if cycles are not available) and of each thread.
+     */
+    void dumpCounters(KernelDispatchMapping &kdm);
+};
@@ -23,6 +23,11 @@ void Statistics::stopKernelTimer(int kId) {
     kernelExecutionTimes.push_back({kId, kernelTime});
 }
 
+void Statistics::recordKernelVariant(int kId, const char *variant) {
+    std::lock_guard<std::mutex> lg(m_times);
+    kernelVariantCounts[{kId, variant}]++;
+}
+
 size_t getMaxKernelNameLength(KernelDispatchMapping &kdm) {
     auto maxLen = 0ul;
     for (auto const &[kId, kdmInfo] : kdm) {
@@ -76,4 +81,19 @@ void Statistics::dumpStatistics(KernelDispatchMapping &kdm) {
         if (i > Statistics::MAX_STATS_COUNT)
             break;
     }
+
+    if (!kernelVariantCounts.empty()) {
+        spdlog::info("DAPHNE kernel variant selection.");
+        spdlog::info("{:<2}  {:<{}}  {:<10}{:<11}  {}", "#", "Operator Name",
+                     maxLen, "Variant", "Count", "File:Line:Column");
+        i = 0;
+        for (auto const &[key, count] : kernelVariantCounts) {
+            auto const &[kId, variant] = key;
+            KDMInfo kdmInfo = kdm.getKernelDispatchInfo(kId);
+            spdlog::info("{:<2}  {:<{}}  {:<10}{:<13}{}", i++,
+                         kdmInfo.kernelName, maxLen, variant, count,
+                         fmt::format("{}:{}:{}", kdmInfo.fileName, kdmInfo.line,
+                                     kdmInfo.column));
+        }
+    }
 }
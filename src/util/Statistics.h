@@ -3,6 +3,7 @@
 #include <util/KernelDispatchMapping.h>
 
 #include <chrono>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -80,6 +81,7 @@ class Statistics {
     std::mutex m_times;
     KernelStats kernelExecutionTimes;
     std::unordered_map<int, Time> startTimes;
+    std::map<std::pair<int, std::string>, size_t> kernelVariantCounts;
 
     std::vector<OperatorStatistics>
     processStatisticsPerOperator(KernelDispatchMapping &kdm);
@@ -88,5 +90,10 @@ class Statistics {
     static Statistics &instance();
     void startKernelTimer(int kId);
     void stopKernelTimer(int kId);
+    /**
+     * @brief Records that the given variant was selected for a call of the
+     * kernel with the given ID (see `KernelVariantSelector`).
+     */
+    void recordKernelVariant(int kId, const char *variant);
     void dumpStatistics(KernelDispatchMapping &kdm);
 };
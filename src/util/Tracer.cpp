@@ -0,0 +1,175 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Tracer.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <unordered_map>
+
+Tracer &Tracer::instance() {
+    static Tracer INSTANCE;
+    return INSTANCE;
+}
+
+Tracer::ThreadBuffer &Tracer::threadBuffer() {
+    thread_local ThreadBuffer *buffer = nullptr;
+    if (buffer == nullptr) {
+        std::lock_guard<std::mutex> lg(m_buffers);
+        buffers.push_back(std::make_unique<ThreadBuffer>(buffers.size()));
+        buffer = buffers.back().get();
+    }
+    return *buffer;
+}
+
+void Tracer::endKernel(int kId, std::initializer_list<TracedOperand> operands, const char *name) {
+    const uint64_t endNs = nowNs();
+    ThreadBuffer &buffer = threadBuffer();
+    if (buffer.openKernels.empty())
+        return;
+    const uint64_t startNs = buffer.openKernels.back();
+    buffer.openKernels.pop_back();
+
+    TraceEvent &e = buffer.append();
+    e.kind = TraceEvent::Kind::KERNEL;
+    e.kId = kId;
+    e.name = name;
+    e.startNs = startNs;
+    e.durNs = endNs - startNs;
+    e.numOperands = std::min(operands.size(), TraceEvent::MAX_OPERANDS);
+    std::copy_n(operands.begin(), e.numOperands, e.operands.begin());
+    e.args = {0, 0, 0};
+}
+
+void Tracer::recordTask(const char *name, uint64_t startNs, int64_t arg0, int64_t arg1, int64_t arg2) {
+    const uint64_t endNs = nowNs();
+    TraceEvent &e = threadBuffer().append();
+    e.kind = TraceEvent::Kind::TASK;
+    e.kId = -1;
+    e.name = name;
+    e.startNs = startNs;
+    e.durNs = endNs - startNs;
+    e.numOperands = 0;
+    e.args = {arg0, arg1, arg2};
+}
+
+size_t Tracer::getNumEvents() {
+    std::lock_guard<std::mutex> lg(m_buffers);
+    size_t numEvents = 0;
+    for (auto &buffer : buffers)
+        numEvents += buffer->numEvents;
+    return numEvents;
+}
+
+void Tracer::clear() {
+    std::lock_guard<std::mutex> lg(m_buffers);
+    // The buffers themselves are kept, since threads hold pointers to them.
+    for (auto &buffer : buffers) {
+        buffer->numEvents = 0;
+        buffer->openKernels.clear();
+    }
+}
+
+static void writeJsonString(std::ostream &os, const std::string &s) {
+    os << '"';
+    for (char c : s) {
+        switch (c) {
+        case '"':
+            os << "\\\"";
+            break;
+        case '\\':
+            os << "\\\\";
+            break;
+        case '\n':
+            os << "\\n";
+            break;
+        case '\t':
+            os << "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+                os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec
+                   << std::setfill(' ');
+            else
+                os << c;
+        }
+    }
+    os << '"';
+}
+
+// Chrome trace timestamps are given in microseconds.
+static void writeMicros(std::ostream &os, uint64_t ns) {
+    os << ns / 1000 << '.' << std::setw(3) << std::setfill('0') << ns % 1000 << std::setfill(' ');
+}
+
+void Tracer::writeChromeTrace(std::ostream &os, KernelDispatchMapping &kdm) {
+    std::unordered_map<int, KDMInfo> kernels(kdm.begin(), kdm.end());
+
+    std::lock_guard<std::mutex> lg(m_buffers);
+    os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (auto &buffer : buffers) {
+        if (buffer->numEvents == 0)
+            continue;
+        os << (first ? "" : ",") << "\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->tid
+           << ",\"args\":{\"name\":\"thread " << buffer->tid << "\"}}";
+        first = false;
+
+        for (size_t i = 0; i < buffer->numEvents; i++) {
+            const TraceEvent &e = buffer->at(i);
+            os << ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid << ",\"ts\":";
+            writeMicros(os, e.startNs);
+            os << ",\"dur\":";
+            writeMicros(os, e.durNs);
+            if (e.kind == TraceEvent::Kind::KERNEL) {
+                auto it = e.name ? kernels.end() : kernels.find(e.kId);
+                os << ",\"cat\":\"kernel\",\"name\":";
+                if (e.name)
+                    writeJsonString(os, e.name);
+                else
+                    writeJsonString(os, it != kernels.end() ? it->second.kernelName : "kernel " + std::to_string(e.kId));
+                os << ",\"args\":{\"kId\":" << e.kId;
+                if (it != kernels.end()) {
+                    os << ",\"loc\":";
+                    writeJsonString(os, it->second.fileName + ":" + std::to_string(it->second.line) + ":" +
+                                            std::to_string(it->second.column));
+                }
+                size_t bytes = 0;
+                os << ",\"shapes\":[";
+                for (size_t j = 0; j < e.numOperands; j++) {
+                    os << (j ? "," : "") << '"' << e.operands[j].numRows << 'x' << e.operands[j].numCols << '"';
+                    bytes += e.operands[j].bytes;
+                }
+                os << "],\"bytes\":" << bytes << "}}";
+            } else {
+                os << ",\"cat\":\"task\",\"name\":";
+                writeJsonString(os, e.name);
+                os << ",\"args\":{\"rowBegin\":" << e.args[0] << ",\"rowEnd\":" << e.args[1]
+                   << ",\"fid\":" << e.args[2] << "}}";
+            }
+        }
+    }
+    os << "\n]}\n";
+}
+
+void Tracer::exportChromeTrace(const std::string &filename, KernelDispatchMapping &kdm) {
+    std::ofstream ofs(filename);
+    if (!ofs)
+        throw std::runtime_error("could not open trace file " + filename);
+    writeChromeTrace(ofs, kdm);
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <util/KernelDispatchMapping.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Shape and approximate size of a data object passed to or returned
+ * from a traced kernel call.
+ */
+struct TracedOperand {
+    size_t numRows = 0;
+    size_t numCols = 0;
+    size_t bytes = 0;
+};
+
+/**
+ * @brief A single event recorded by the `Tracer`.
+ *
+ * Kernel events refer to their kernel via the kernel ID, the name and source
+ * location are only looked up in the `KernelDispatchMapping` on export (unless
+ * a static name is given). Task events carry a static name and up to three
+ * integer arguments.
+ */
+struct TraceEvent {
+    static constexpr size_t MAX_OPERANDS = 4;
+
+    enum class Kind : uint8_t { KERNEL, TASK };
+
+    Kind kind;
+    uint8_t numOperands;
+    int kId;
+    const char *name;
+    uint64_t startNs;
+    uint64_t durNs;
+    std::array<TracedOperand, MAX_OPERANDS> operands;
+    std::array<int64_t, 3> args;
+};
+
+/**
+ * @brief The Tracer records one event per kernel invocation and per
+ * vectorized task, and exports them in the Chrome trace event format, which
+ * can be inspected in Perfetto (https://ui.perfetto.dev) or chrome://tracing.
+ *
+ * Like `Statistics`, the Tracer is a singleton. Each thread appends to its own
+ * buffer without any synchronization; only the first event of a thread takes
+ * a lock to register the buffer. Thus, the events may only be exported (or
+ * cleared) while no thread is recording.
+ */
+class Tracer {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+  private:
+    static constexpr size_t EVENTS_PER_CHUNK = 4096;
+
+    struct ThreadBuffer {
+        size_t tid;
+        std::vector<std::unique_ptr<TraceEvent[]>> chunks;
+        size_t numEvents = 0;
+        /**
+         * @brief Start times of the currently running (possibly nested)
+         * kernels of this thread.
+         */
+        std::vector<uint64_t> openKernels;
+
+        explicit ThreadBuffer(size_t tid) : tid(tid) {}
+
+        TraceEvent &append() {
+            if (numEvents == chunks.size() * EVENTS_PER_CHUNK)
+                chunks.emplace_back(new TraceEvent[EVENTS_PER_CHUNK]);
+            TraceEvent &e = chunks[numEvents / EVENTS_PER_CHUNK][numEvents % EVENTS_PER_CHUNK];
+            numEvents++;
+            return e;
+        }
+
+        const TraceEvent &at(size_t i) const { return chunks[i / EVENTS_PER_CHUNK][i % EVENTS_PER_CHUNK]; }
+    };
+
+    const Clock::time_point epoch = Clock::now();
+    std::mutex m_buffers;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+    ThreadBuffer &threadBuffer();
+
+  public:
+    static Tracer &instance();
+
+    uint64_t nowNs() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch).count();
+    }
+
+    /**
+     * @brief Marks the start of the kernel call with the given ID on the
+     * calling thread.
+     */
+    void beginKernel([[maybe_unused]] int kId) { threadBuffer().openKernels.push_back(nowNs()); }
+
+    /**
+     * @brief Records the kernel call started by the last unmatched
+     * `beginKernel` on the calling thread.
+     *
+     * @param operands The data objects involved in the call; only the first
+     * `TraceEvent::MAX_OPERANDS` are recorded.
+     * @param name A static name overriding the kernel name from the
+     * `KernelDispatchMapping`, for kernels without an own kernel ID.
+     */
+    void endKernel(int kId, std::initializer_list<TracedOperand> operands = {}, const char *name = nullptr);
+
+    /**
+     * @brief Records an event that started at `startNs` (see `nowNs`) and
+     * ends now, e.g., a task executed by a vectorized worker.
+     */
+    void recordTask(const char *name, uint64_t startNs, int64_t arg0 = 0, int64_t arg1 = 0, int64_t arg2 = 0);
+
+    /**
+     * @brief Returns the number of recorded events of all threads.
+     */
+    size_t getNumEvents();
+
+    /**
+     * @brief Discards all recorded events.
+     */
+    void clear();
+
+    /**
+     * @brief Writes all recorded events as a Chrome trace JSON object.
+     */
+    void writeChromeTrace(std::ostream &os, KernelDispatchMapping &kdm);
+
+    /**
+     * @brief Writes all recorded events as a Chrome trace JSON file.
+     */
+    void exportChromeTrace(const std::string &filename, KernelDispatchMapping &kdm);
+};
+
+/**
+ * @brief Records a task event covering the lifetime of this object, if
+ * tracing is enabled.
+ */
+class TraceTaskScope {
+    const char *name;
+    uint64_t startNs;
+    int64_t arg0, arg1, arg2;
+    bool enabled;
+
+  public:
+    TraceTaskScope(bool enabled, const char *name, int64_t arg0 = 0, int64_t arg1 = 0, int64_t arg2 = 0)
+        : name(name), startNs(enabled ? Tracer::instance().nowNs() : 0), arg0(arg0), arg1(arg1), arg2(arg2),
+          enabled(enabled) {}
+
+    ~TraceTaskScope() {
+        if (enabled)
+            Tracer::instance().recordTask(name, startNs, arg0, arg1, arg2);
+    }
+};
@@ -52,3 +52,9 @@ MAKE_TEST_CASE("untyped", 4)
 MAKE_TEST_CASE("mixtyped", 2)
 MAKE_TEST_CASE("early_return", 3)
 MAKE_INVALID_TEST_CASE("invalid_parser", 11, StatusCode::PARSER_ERROR)
+
+TEST_CASE("adaptive_recompilation", TAG_FUNCTIONS) {
+    // The same results are expected with and without adaptive recompilation.
+    compareDaphneToRefSimple(dirPath, "adaptive_recompilation", 1);
+    compareDaphneToRefSimple(dirPath, "adaptive_recompilation", 1, "--adaptive-recompilation");
+}
@@ -40,10 +40,13 @@ MAKE_TEST_CASE("bin", 2)
 MAKE_TEST_CASE("cbind", 1)
 MAKE_TEST_CASE("createFrame", 1)
 MAKE_TEST_CASE("ctable", 1)
+MAKE_TEST_CASE("fusedOps", 1)
 MAKE_TEST_CASE("gemv", 1)
 MAKE_TEST_CASE("idxMax", 1)
 MAKE_TEST_CASE("idxMin", 1)
+MAKE_TEST_CASE("matmulChain", 1)
 MAKE_TEST_CASE("mean", 1)
+MAKE_TEST_CASE("multiAgg", 1)
 MAKE_TEST_CASE("operator_at", 2)
 MAKE_TEST_CASE("operator_eq", 2)
 MAKE_TEST_CASE("operator_minus", 1)
@@ -20,13 +20,19 @@
 
 #include <catch.hpp>
 
+#include <parser/metadata/CsvMetaDataInference.h>
 #include <parser/metadata/MetaDataParser.h>
 #include <runtime/local/datagen/GenGivenVals.h>
 #include <runtime/local/datastructures/Frame.h>
 
+#include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 
 const std::string dirPath = "test/api/cli/parser/metadataFiles/";
+// For the files created by the tests.
+const std::string tmpDirPath = std::filesystem::temp_directory_path().string() + "/";
 
 TEST_CASE("Proper meta data file for Matrix", TAG_PARSER)
 {
@@ -127,3 +133,135 @@ TEST_CASE("Write proper meta data file for Frame", TAG_PARSER)
         std::filesystem::remove(metaDataFile);
     }
 }
+
+TEST_CASE("Infer meta data of a CSV file without meta data file", TAG_PARSER)
+{
+    const std::string csvFile = dirPath + "InferMatrix.csv";
+    const std::filesystem::path metaDataFile(csvFile + ".meta");
+
+    FileMetaData fmd = MetaDataParser::readMetaData(csvFile);
+    CHECK(fmd.numRows == 4);
+    CHECK(fmd.numCols == 3);
+    CHECK(fmd.isSingleValueType);
+    CHECK(fmd.schema[0] == ValueTypeCode::SI64);
+
+    // No meta data file is written by default.
+    CHECK_FALSE(std::filesystem::exists(metaDataFile));
+}
+
+TEST_CASE("Inferred meta data are cached in a meta data file if enabled", TAG_PARSER)
+{
+    const std::string csvFile = tmpDirPath + "InferMatrixCached.csv";
+    const std::filesystem::path metaDataFile(csvFile + ".meta");
+    std::filesystem::copy_file(dirPath + "InferMatrix.csv", csvFile, std::filesystem::copy_options::overwrite_existing);
+
+    MetaDataParser::setWriteInferredMetaData(true);
+    FileMetaData fmd = MetaDataParser::readMetaData(csvFile);
+    MetaDataParser::setWriteInferredMetaData(false);
+    CHECK(fmd.numRows == 4);
+    REQUIRE(std::filesystem::exists(metaDataFile));
+    FileMetaData cached = MetaDataParser::readMetaData(csvFile);
+    CHECK(cached.numRows == 4);
+    CHECK(cached.numCols == 3);
+    CHECK(cached.schema[0] == ValueTypeCode::SI64);
+
+    // cleanup
+    std::filesystem::remove(csvFile);
+    std::filesystem::remove(metaDataFile);
+}
+
+TEST_CASE("Infer meta data of a CSV file with mixed value types", TAG_PARSER)
+{
+    const std::string csvFile = dirPath + "InferFrame.csv";
+    const std::filesystem::path metaDataFile(csvFile + ".meta");
+
+    FileMetaData fmd = MetaDataParser::readMetaData(csvFile);
+    CHECK(fmd.numRows == 3);
+    CHECK(fmd.numCols == 2);
+    CHECK_FALSE(fmd.isSingleValueType);
+    CHECK(fmd.schema == std::vector<ValueTypeCode>{ValueTypeCode::SI64, ValueTypeCode::F64});
+    CHECK(fmd.labels == std::vector<std::string>{"col_0", "col_1"});
+
+    // cleanup
+    if(std::filesystem::exists(metaDataFile))
+        std::filesystem::remove(metaDataFile);
+}
+
+TEST_CASE("Infer meta data of a CSV file with non-numeric values", TAG_PARSER)
+{
+    const std::string csvFile = dirPath + "InferNonNumeric.csv";
+    REQUIRE_THROWS(MetaDataParser::readMetaData(csvFile));
+    CHECK_FALSE(std::filesystem::exists(csvFile + ".meta"));
+}
+
+TEST_CASE("Inferred meta data are updated when the CSV file changes", TAG_PARSER)
+{
+    const std::string csvFile = tmpDirPath + "InferChanged.csv";
+    const std::filesystem::path metaDataFile(csvFile + ".meta");
+
+    std::ofstream(csvFile) << "1,2\n3,4\n";
+    CHECK(MetaDataParser::readMetaData(csvFile).numRows == 2);
+    std::ofstream(csvFile) << "1.5,2\n3,4\n5,6\n";
+    FileMetaData fmd = MetaDataParser::readMetaData(csvFile);
+    CHECK(fmd.numRows == 3);
+    CHECK(fmd.schema[0] == ValueTypeCode::F64);
+
+    // cleanup
+    std::filesystem::remove(csvFile);
+    if(std::filesystem::exists(metaDataFile))
+        std::filesystem::remove(metaDataFile);
+}
+
+TEST_CASE("Inferred meta data are cached in-process", TAG_PARSER)
+{
+    const std::string csvFile = tmpDirPath + "InferInProcess.csv";
+    const std::filesystem::path metaDataFile(csvFile + ".meta");
+
+    std::ofstream(csvFile) << "100,2\n3,4\n";
+    CHECK(MetaDataParser::readMetaData(csvFile).schema[0] == ValueTypeCode::SI64);
+
+    // With a file of the same size and modification time, the meta data are
+    // not inferred again.
+    const auto fileTime = std::filesystem::last_write_time(csvFile);
+    std::ofstream(csvFile) << "1.5,2\n3,4\n";
+    std::filesystem::last_write_time(csvFile, fileTime);
+    CHECK(MetaDataParser::readMetaData(csvFile).schema[0] == ValueTypeCode::SI64);
+
+    // Once the modification time changes, they are.
+    std::filesystem::last_write_time(csvFile, fileTime + std::chrono::seconds(1));
+    CHECK(MetaDataParser::readMetaData(csvFile).schema[0] == ValueTypeCode::F64);
+
+    // cleanup
+    std::filesystem::remove(csvFile);
+    if(std::filesystem::exists(metaDataFile))
+        std::filesystem::remove(metaDataFile);
+}
+
+TEST_CASE("Infer meta data of a CSV file using several threads", TAG_PARSER)
+{
+    const std::string csvFile = tmpDirPath + "InferLarge.csv";
+
+    // Large enough for several blocks, value types only differ at the end.
+    const size_t numRows = 200000;
+    {
+        std::ofstream ofs(csvFile);
+        for(size_t r = 0; r < numRows - 1; r++)
+            ofs << r << ',' << r * 2 << ",12345\n";
+        ofs << "1,2,3.5\n";
+    }
+    FileMetaData fmd = CsvMetaDataInference::inferMetaData(csvFile, 4, 10);
+    CHECK(fmd.numRows == numRows);
+    CHECK(fmd.numCols == 3);
+    // The sample does not cover the whole file, so the integer columns could
+    // hold floating-point values elsewhere.
+    CHECK(fmd.isSingleValueType);
+    CHECK(fmd.schema[0] == ValueTypeCode::F64);
+
+    // A sample covering the whole file allows integer columns.
+    FileMetaData fmdFull = CsvMetaDataInference::inferMetaData(csvFile, 4, numRows);
+    CHECK(fmdFull.numRows == numRows);
+    CHECK(fmdFull.schema == std::vector<ValueTypeCode>{ValueTypeCode::SI64, ValueTypeCode::SI64, ValueTypeCode::F64});
+
+    // cleanup
+    std::filesystem::remove(csvFile);
+}
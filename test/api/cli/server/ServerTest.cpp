@@ -0,0 +1,90 @@
+/*
+ *  Copyright 2024 The DAPHNE Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <api/cli/StatusCode.h>
+#include <api/cli/Utils.h>
+
+#include <tags.h>
+
+#include <catch.hpp>
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+const std::string dirPath = "test/api/cli/server/";
+
+TEST_CASE("Server mode with resident data objects and cached scripts", TAG_SERVER) {
+    const std::string socketPath = "/tmp/daphne-server-test-" + std::to_string(getpid()) + ".sock";
+    const std::string storeScript = dirPath + "server_store.daphne";
+    const std::string loadScript = dirPath + "server_load.daphne";
+
+    // Redirect server output to null
+    int nullFd = open("/dev/null", O_WRONLY);
+    auto pid = runProgramInBackground(nullFd, nullFd, "bin/daphne", "daphne", "--server", socketPath.c_str());
+
+    // Wait until the server listens.
+    for(int i = 0; i < 100 && access(socketPath.c_str(), F_OK) != 0; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    REQUIRE(access(socketPath.c_str(), F_OK) == 0);
+
+    // The data objects are not resident yet.
+    {
+        std::stringstream out;
+        std::stringstream err;
+        int status = runDaphne(out, err, "--connect", socketPath.c_str(), loadScript.c_str(), "factor=2");
+        CHECK(status != StatusCode::SUCCESS);
+    }
+
+    {
+        std::stringstream out;
+        std::stringstream err;
+        int status = runDaphne(out, err, "--connect", socketPath.c_str(), storeScript.c_str());
+        CHECK(status == StatusCode::SUCCESS);
+        CHECK(out.str() == "");
+    }
+
+    for(const char * factor : {"2", "3", "2"}) {
+        std::stringstream out;
+        std::stringstream err;
+        const std::string arg = std::string("factor=") + factor;
+        int status = runDaphne(out, err, "--connect", socketPath.c_str(), loadScript.c_str(), arg.c_str());
+        CHECK(status == StatusCode::SUCCESS);
+        CHECK(out.str() == readTextFile(dirPath + "server_load_" + factor + ".txt"));
+    }
+
+    // The compiled script is reused for the same arguments.
+    {
+        std::stringstream out;
+        std::stringstream err;
+        int status = runDaphne(out, err, "--timing", "--connect", socketPath.c_str(), loadScript.c_str(), "factor=3");
+        CHECK(status == StatusCode::SUCCESS);
+        CHECK(err.str().find("\"cache_hit\": 1") != std::string::npos);
+    }
+
+    kill(pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+    unlink(socketPath.c_str());
+    close(nullFd);
+}
@@ -20,6 +20,9 @@
 
 #include <catch.hpp>
 
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 #include <string>
 
 const std::string dirPath = "test/api/cli/vectorized/";
@@ -65,4 +68,43 @@ void compareDaphneToDaphneOtherArgs(const std::string &scriptFilePath) {
         } \
     }
 
-MAKE_TEST_CASE("pipeline", 7)
\ No newline at end of file
+MAKE_TEST_CASE("pipeline", 9)
+
+TEST_CASE("streaming", TAG_VECTORIZED) {
+    const std::string scriptFilePath = dirPath + "streaming_1.daphne";
+
+    std::stringstream outV;
+    std::stringstream errV;
+    int statusV = runDaphne(outV, errV, "--vec", scriptFilePath.c_str());
+
+    // Chunks smaller than the file, with a partial last chunk.
+    std::stringstream outS;
+    std::stringstream errS;
+    int statusS = runDaphne(outS, errS, "--vec", "--streaming", "--streaming-chunk-rows", "3",
+                            scriptFilePath.c_str());
+
+    CHECK(statusV == StatusCode::SUCCESS);
+    CHECK(statusS == StatusCode::SUCCESS);
+    CHECK(outV.str() == outS.str());
+    CHECK(errV.str() == errS.str());
+}
+
+TEST_CASE("tracing", TAG_VECTORIZED) {
+    const std::string scriptFilePath = dirPath + "pipeline_1.daphne";
+    const std::string traceFilePath = dirPath + "pipeline_1_trace.json";
+
+    std::stringstream out;
+    std::stringstream err;
+    int status = runDaphne(out, err, "--vec", "--trace", traceFilePath.c_str(), scriptFilePath.c_str());
+    CHECK(status == StatusCode::SUCCESS);
+
+    std::ifstream traceFile(traceFilePath);
+    REQUIRE(traceFile.good());
+    std::stringstream trace;
+    trace << traceFile.rdbuf();
+    CHECK(trace.str().rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0) == 0);
+    CHECK(trace.str().find("\"cat\":\"kernel\"") != std::string::npos);
+    CHECK(trace.str().find("\"name\":\"_vectorizedPipeline\"") != std::string::npos);
+    CHECK(trace.str().find("\"cat\":\"task\"") != std::string::npos);
+    std::remove(traceFilePath.c_str());
+}
@@ -63,6 +63,11 @@ const std::string dirPath = "test/api/python/";
 
 MAKE_TEST_CASE("data_transfer_numpy_1")
 MAKE_TEST_CASE("data_transfer_numpy_2")
+MAKE_TEST_CASE("data_transfer_numpy_session")
+MAKE_TEST_CASE("persist_intermediate")
+MAKE_TEST_CASE("persist_intermediate_session")
+MAKE_TEST_CASE("persist_intermediate_reuse")
+MAKE_TEST_CASE("persist_intermediate_close")
 MAKE_TEST_CASE("data_transfer_pandas_1")
 MAKE_TEST_CASE("data_transfer_pandas_2")
 MAKE_TEST_CASE("data_transfer_pandas_3_series")
@@ -0,0 +1,38 @@
+#!/usr/bin/python
+
+# -------------------------------------------------------------
+#
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+#
+# -------------------------------------------------------------
+
+# Closing a context without session removes the files of persisted results.
+
+import os
+
+from daphne.context.daphne_context import DaphneContext
+
+dctx = DaphneContext()
+
+X = dctx.seq(1, 6, 1).reshape(2, 3)
+G = (X.t() @ X).persist()
+G.sum().compute()
+path = G._persist_path()
+print(int(os.path.exists(path)))
+dctx.close()
+print(int(os.path.exists(path) or os.path.exists(path + ".meta")))
@@ -0,0 +1,52 @@
+#!/usr/bin/python
+
+# -------------------------------------------------------------
+#
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+#
+# -------------------------------------------------------------
+
+
+# A persisted intermediate result must not be recomputed from its sources:
+# after overwriting the input file, the persisted result still reflects the
+# original data.
+
+import os
+import tempfile
+
+from daphne.context.daphne_context import DaphneContext
+
+def writeInput(path, rows):
+    with open(path, "w") as f:
+        f.write("".join(",".join(str(v) for v in row) + "\n" for row in rows))
+    with open(path + ".meta", "w") as f:
+        f.write('{"numRows": %d, "numCols": %d, "valueType": "f64"}' % (len(rows), len(rows[0])))
+
+with tempfile.TemporaryDirectory() as tmpDir:
+    path = os.path.join(tmpDir, "X.csv")
+    writeInput(path, [[1, 2, 3], [4, 5, 6]])
+
+    dctx = DaphneContext()
+    X = dctx.readMatrix(path)
+    G = (X.t() @ X).persist()
+    G.sum().print().compute()
+
+    writeInput(path, [[0, 0, 0], [0, 0, 0]])
+    G.sum().print().compute()
+    (G + 1.0).print().compute()
+    G.unpersist()
@@ -0,0 +1,39 @@
+#!/usr/bin/python
+
+# -------------------------------------------------------------
+#
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+#
+# -------------------------------------------------------------
+
+# Reuse of a persisted intermediate result across several computations, kept
+# in the persistent session.
+
+from daphne.context.daphne_context import DaphneContext
+
+dctx = DaphneContext(use_session=True)
+
+X = dctx.seq(1, 6, 1).reshape(2, 3)
+G = (X.t() @ X).persist()
+
+(G + 1.0).print().compute()
+G.sum().print().compute()
+G.unpersist()
+(G * 2.0).print().compute()
+
+dctx.close()
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "../run_benchmarks.h"
+
+#include <runtime/local/datastructures/CSRMatrix.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/io/DaphneSerializer.h>
+#include <runtime/local/kernels/RandMatrix.h>
+
+#include <tags.h>
+
+#include <catch.hpp>
+
+#include <vector>
+
+#define DATA_TYPES DenseMatrix, CSRMatrix
+#define VALUE_TYPES double, int64_t
+
+TEMPLATE_PRODUCT_TEST_CASE("DaphneSerializer", TAG_BENCHMARK TAG_IO, (DATA_TYPES), (VALUE_TYPES)) {
+    using DT = TestType;
+    using VT = typename DT::VT;
+    auto dctx = setupBenchmarkContext();
+    const size_t numRows = benchmarkSize(1 << 16);
+    const size_t numCols = 64;
+    const double sparsity = std::is_same<DT, CSRMatrix<VT>>::value ? 0.01 : 1.0;
+
+    DT *arg = nullptr;
+    randMatrix<DT, VT>(arg, numRows, numCols, VT(1), VT(100), sparsity, 1, dctx.get());
+    std::vector<char> buffer;
+    const size_t length = DaphneSerializer<DT>::serialize(arg, buffer);
+
+    setBenchmarkBytes(length);
+    BENCHMARK("serialize " + shapeName(numRows, numCols)) {
+        return DaphneSerializer<DT>::serialize(arg, buffer);
+    };
+    setBenchmarkBytes(length);
+    BENCHMARK("deserialize " + shapeName(numRows, numCols)) {
+        DT *res = DaphneSerializer<DT>::deserialize(buffer);
+        DataObjectFactory::destroy(res);
+    };
+
+    DataObjectFactory::destroy(arg);
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "../run_benchmarks.h"
+
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/io/ReadCsv.h>
+
+#include <tags.h>
+
+#include <catch.hpp>
+
+#include <fstream>
+#include <random>
+#include <string>
+
+#include <cstdint>
+#include <cstdio>
+
+TEMPLATE_TEST_CASE("ReadCsv dense", TAG_BENCHMARK TAG_IO, double, int64_t) {
+    using VT = TestType;
+    const size_t numRows = benchmarkSize(1 << 16);
+    const size_t numCols = GENERATE(4, 64);
+    const std::string filename = "ReadCsvBenchmark_" + shapeName(numRows, numCols) + ".csv";
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-1000, 1000);
+    {
+        std::ofstream ofs(filename);
+        for (size_t r = 0; r < numRows; r++)
+            for (size_t c = 0; c < numCols; c++)
+                ofs << static_cast<VT>(dist(gen)) << (c + 1 < numCols ? ',' : '\n');
+    }
+    std::ifstream ifs(filename, std::ios::binary | std::ios::ate);
+    setBenchmarkBytes(static_cast<size_t>(ifs.tellg()));
+
+    BENCHMARK(shapeName(numRows, numCols)) {
+        DenseMatrix<VT> *res = nullptr;
+        readCsv(res, filename.c_str(), numRows, numCols, ',');
+        DataObjectFactory::destroy(res);
+    };
+
+    std::remove(filename.c_str());
+}
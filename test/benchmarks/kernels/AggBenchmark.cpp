@@ -0,0 +1,81 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "../run_benchmarks.h"
+
+#include <runtime/local/datastructures/CSRMatrix.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/kernels/AggAll.h>
+#include <runtime/local/kernels/AggCol.h>
+#include <runtime/local/kernels/AggOpCode.h>
+#include <runtime/local/kernels/AggRow.h>
+#include <runtime/local/kernels/RandMatrix.h>
+
+#include <tags.h>
+
+#include <catch.hpp>
+
+template<class DTArg>
+void benchmarkAggs(const DTArg *arg, const std::string &name, size_t bytes, DaphneContext *ctx) {
+    using VT = typename DTArg::VT;
+    DenseMatrix<VT> *resRow = nullptr, *resCol = nullptr;
+    for(AggOpCode opCode : {AggOpCode::SUM, AggOpCode::MAX}) {
+        const std::string op = opCode == AggOpCode::SUM ? "SUM " : "MAX ";
+        setBenchmarkBytes(bytes);
+        BENCHMARK("aggRow " + op + name) {
+            aggRow(opCode, resRow, arg, ctx);
+            return resRow;
+        };
+        setBenchmarkBytes(bytes);
+        BENCHMARK("aggCol " + op + name) {
+            aggCol(opCode, resCol, arg, ctx);
+            return resCol;
+        };
+        setBenchmarkBytes(bytes);
+        BENCHMARK("aggAll " + op + name) {
+            return aggAll<VT>(opCode, arg, ctx);
+        };
+    }
+    destroyAllocated(resRow, resCol);
+}
+
+TEMPLATE_TEST_CASE("Agg dense", TAG_BENCHMARK TAG_KERNELS, double, float, int64_t) {
+    using VT = TestType;
+    auto dctx = setupBenchmarkContext();
+    const size_t numRows = benchmarkSize(1 << 16);
+    const size_t numCols = GENERATE(1, 16, 256);
+
+    DenseMatrix<VT> *arg = nullptr;
+    randMatrix<DenseMatrix<VT>, VT>(arg, numRows, numCols, VT(1), VT(100), 1.0, 1, dctx.get());
+    benchmarkAggs(arg, shapeName(numRows, numCols), numRows * numCols * sizeof(VT), dctx.get());
+    DataObjectFactory::destroy(arg);
+}
+
+TEMPLATE_TEST_CASE("Agg sparse", TAG_BENCHMARK TAG_KERNELS, double) {
+    using VT = TestType;
+    auto dctx = setupBenchmarkContext();
+    const size_t numRows = benchmarkSize(1 << 16);
+    const size_t numCols = 256;
+    const double sparsity = GENERATE(0.001, 0.01, 0.1);
+
+    CSRMatrix<VT> *arg = nullptr;
+    randMatrix<CSRMatrix<VT>, VT>(arg, numRows, numCols, VT(1), VT(100), sparsity, 1, dctx.get());
+    benchmarkAggs(arg, shapeName(numRows, numCols) + " sparsity " + std::to_string(sparsity),
+                  arg->getNumNonZeros() * (sizeof(VT) + sizeof(size_t)), dctx.get());
+    DataObjectFactory::destroy(arg);
+}
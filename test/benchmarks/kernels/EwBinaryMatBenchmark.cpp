@@ -0,0 +1,101 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "../run_benchmarks.h"
+
+#include <runtime/local/datastructures/CSRMatrix.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/kernels/BinaryOpCode.h>
+#include <runtime/local/kernels/EwBinaryMat.h>
+#include <runtime/local/kernels/RandMatrix.h>
+
+#include <tags.h>
+
+#include <catch.hpp>
+
+TEMPLATE_TEST_CASE("EwBinaryMat dense", TAG_BENCHMARK TAG_KERNELS, double, float, int64_t) {
+    using VT = TestType;
+    using DT = DenseMatrix<VT>;
+    auto dctx = setupBenchmarkContext();
+    const size_t numRows = benchmarkSize(1 << 16);
+    const size_t numCols = GENERATE(1, 16, 256);
+    const std::string shape = shapeName(numRows, numCols);
+
+    DT *lhs = nullptr, *rhs = nullptr, *row = nullptr, *res = nullptr;
+    randMatrix<DT, VT>(lhs, numRows, numCols, VT(1), VT(100), 1.0, 1, dctx.get());
+    randMatrix<DT, VT>(rhs, numRows, numCols, VT(1), VT(100), 1.0, 2, dctx.get());
+    randMatrix<DT, VT>(row, 1, numCols, VT(1), VT(100), 1.0, 3, dctx.get());
+    ewBinaryMat(BinaryOpCode::ADD, res, lhs, rhs, dctx.get());
+    const size_t bytes = 3 * numRows * numCols * sizeof(VT);
+
+    setBenchmarkBytes(bytes);
+    BENCHMARK("ADD " + shape) {
+        ewBinaryMat(BinaryOpCode::ADD, res, lhs, rhs, dctx.get());
+        return res;
+    };
+    setBenchmarkBytes(bytes);
+    BENCHMARK("MUL " + shape) {
+        ewBinaryMat(BinaryOpCode::MUL, res, lhs, rhs, dctx.get());
+        return res;
+    };
+    setBenchmarkBytes(bytes);
+    BENCHMARK("LT " + shape) {
+        ewBinaryMat(BinaryOpCode::LT, res, lhs, rhs, dctx.get());
+        return res;
+    };
+    setBenchmarkBytes(2 * numRows * numCols * sizeof(VT));
+    BENCHMARK("ADD row broadcast " + shape) {
+        ewBinaryMat(BinaryOpCode::ADD, res, lhs, row, dctx.get());
+        return res;
+    };
+
+    destroyAllocated(lhs, rhs, row, res);
+}
+
+TEMPLATE_TEST_CASE("EwBinaryMat sparse", TAG_BENCHMARK TAG_KERNELS, double) {
+    using VT = TestType;
+    auto dctx = setupBenchmarkContext();
+    const size_t numRows = benchmarkSize(1 << 16);
+    const size_t numCols = 256;
+    const double sparsity = GENERATE(0.001, 0.01, 0.1);
+    const std::string name = shapeName(numRows, numCols) + " sparsity " + std::to_string(sparsity);
+
+    CSRMatrix<VT> *lhs = nullptr, *rhs = nullptr;
+    DenseMatrix<VT> *dense = nullptr;
+    randMatrix<CSRMatrix<VT>, VT>(lhs, numRows, numCols, VT(1), VT(100), sparsity, 1, dctx.get());
+    randMatrix<CSRMatrix<VT>, VT>(rhs, numRows, numCols, VT(1), VT(100), sparsity, 2, dctx.get());
+    randMatrix<DenseMatrix<VT>, VT>(dense, numRows, numCols, VT(1), VT(100), 1.0, 3, dctx.get());
+
+    BENCHMARK("ADD CSR, CSR " + name) {
+        CSRMatrix<VT> *res = nullptr;
+        ewBinaryMat(BinaryOpCode::ADD, res, lhs, rhs, dctx.get());
+        DataObjectFactory::destroy(res);
+    };
+    BENCHMARK("MUL CSR, CSR " + name) {
+        CSRMatrix<VT> *res = nullptr;
+        ewBinaryMat(BinaryOpCode::MUL, res, lhs, rhs, dctx.get());
+        DataObjectFactory::destroy(res);
+    };
+    BENCHMARK("MUL CSR, Dense " + name) {
+        CSRMatrix<VT> *res = nullptr;
+        ewBinaryMat(BinaryOpCode::MUL, res, lhs, dense, dctx.get());
+        DataObjectFactory::destroy(res);
+    };
+
+    DataObjectFactory::destroy(lhs, rhs, dense);
+}
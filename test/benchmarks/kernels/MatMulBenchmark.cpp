@@ -0,0 +1,113 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "../run_benchmarks.h"
+
+#include <runtime/local/datastructures/CSRMatrix.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/kernels/MatMul.h>
+#include <runtime/local/kernels/RandMatrix.h>
+
+#include <tags.h>
+
+#include <catch.hpp>
+
+// The FLOP count of the product of an m x k and a k x n matrix.
+static size_t matMulFlops(size_t m, size_t k, size_t n) { return 2 * m * k * n; }
+
+TEMPLATE_TEST_CASE("MatMul Dense, Dense", TAG_BENCHMARK TAG_KERNELS, double, float, int64_t) {
+    using VT = TestType;
+    using DT = DenseMatrix<VT>;
+    auto dctx = setupBenchmarkContext();
+    const size_t n = benchmarkSize(512);
+    const size_t tall = benchmarkSize(1 << 16);
+    const size_t numCols = 64;
+
+    DT *square1 = nullptr, *square2 = nullptr, *x = nullptr, *v = nullptr, *resSquare = nullptr, *resGemv = nullptr,
+       *resSyrk = nullptr;
+    randMatrix<DT, VT>(square1, n, n, VT(1), VT(10), 1.0, 1, dctx.get());
+    randMatrix<DT, VT>(square2, n, n, VT(1), VT(10), 1.0, 2, dctx.get());
+    randMatrix<DT, VT>(x, tall, numCols, VT(1), VT(10), 1.0, 3, dctx.get());
+    randMatrix<DT, VT>(v, numCols, 1, VT(1), VT(10), 1.0, 4, dctx.get());
+
+    // The names report the FLOPs, the throughput is reported in bytes.
+    BENCHMARK("gemm " + shapeName(n, n) + " @ " + shapeName(n, n) + " flops " + std::to_string(matMulFlops(n, n, n))) {
+        matMul(resSquare, square1, square2, false, false, dctx.get());
+        return resSquare;
+    };
+    BENCHMARK("gemm transb " + shapeName(n, n) + " @ t(" + shapeName(n, n) + ")") {
+        matMul(resSquare, square1, square2, false, true, dctx.get());
+        return resSquare;
+    };
+    setBenchmarkBytes(x->getNumItems() * sizeof(VT));
+    BENCHMARK("gemv " + shapeName(tall, numCols) + " @ " + shapeName(numCols, 1)) {
+        matMul(resGemv, x, v, false, false, dctx.get());
+        return resGemv;
+    };
+    setBenchmarkBytes(x->getNumItems() * sizeof(VT));
+    BENCHMARK("t(X) @ X " + shapeName(tall, numCols)) {
+        matMul(resSyrk, x, x, true, false, dctx.get());
+        return resSyrk;
+    };
+
+    destroyAllocated(square1, square2, x, v, resSquare, resGemv, resSyrk);
+}
+
+TEMPLATE_TEST_CASE("MatMul CSR, Dense", TAG_BENCHMARK TAG_KERNELS, double, float) {
+    using VT = TestType;
+    auto dctx = setupBenchmarkContext();
+    const size_t numRows = benchmarkSize(1 << 16);
+    const size_t numCols = 1024;
+    const size_t numColsRhs = GENERATE(1, 16);
+    const double sparsity = GENERATE(0.001, 0.01);
+
+    CSRMatrix<VT> *lhs = nullptr;
+    DenseMatrix<VT> *rhs = nullptr, *res = nullptr;
+    randMatrix<CSRMatrix<VT>, VT>(lhs, numRows, numCols, VT(1), VT(10), sparsity, 1, dctx.get());
+    randMatrix<DenseMatrix<VT>, VT>(rhs, numCols, numColsRhs, VT(1), VT(10), 1.0, 2, dctx.get());
+
+    setBenchmarkBytes(lhs->getNumNonZeros() * (sizeof(VT) + sizeof(size_t)));
+    BENCHMARK(shapeName(numRows, numCols) + " sparsity " + std::to_string(sparsity) + " @ " +
+              shapeName(numCols, numColsRhs)) {
+        matMul(res, lhs, rhs, false, false, dctx.get());
+        return res;
+    };
+
+    destroyAllocated(lhs, rhs, res);
+}
+
+TEMPLATE_TEST_CASE("MatMul Matrix, Matrix", TAG_BENCHMARK TAG_KERNELS, double) {
+    using VT = TestType;
+    auto dctx = setupBenchmarkContext();
+    const size_t n = benchmarkSize(128);
+
+    DenseMatrix<VT> *lhs = nullptr, *rhs = nullptr;
+    randMatrix<DenseMatrix<VT>, VT>(lhs, n, n, VT(1), VT(10), 1.0, 1, dctx.get());
+    randMatrix<DenseMatrix<VT>, VT>(rhs, n, n, VT(1), VT(10), 1.0, 2, dctx.get());
+    const Matrix<VT> *lhsMat = lhs;
+    const Matrix<VT> *rhsMat = rhs;
+
+    // The generic kernel working on any matrix representation via get/append.
+    BENCHMARK(shapeName(n, n) + " @ " + shapeName(n, n)) {
+        Matrix<VT> *res = nullptr;
+        matMul(res, lhsMat, rhsMat, false, false, dctx.get());
+        DataObjectFactory::destroy(res);
+    };
+
+    DataObjectFactory::destroy(lhs, rhs);
+}
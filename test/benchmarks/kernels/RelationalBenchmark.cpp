@@ -0,0 +1,119 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "../run_benchmarks.h"
+
+#include <ir/daphneir/Daphne.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/datastructures/Frame.h>
+#include <runtime/local/kernels/Group.h>
+#include <runtime/local/kernels/InnerJoin.h>
+#include <runtime/local/kernels/Order.h>
+#include <runtime/local/kernels/RandMatrix.h>
+
+#include <tags.h>
+
+#include <catch.hpp>
+
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+// A frame with an int64_t key column "k" in [0, numKeys) and a double value
+// column "v".
+static Frame *genKeyValueFrame(size_t numRows, size_t numKeys, int64_t seed, const std::string &suffix,
+                               DaphneContext *ctx) {
+    DenseMatrix<int64_t> *keys = nullptr;
+    DenseMatrix<double> *values = nullptr;
+    randMatrix<DenseMatrix<int64_t>, int64_t>(keys, numRows, 1, 0, numKeys - 1, 1.0, seed, ctx);
+    randMatrix<DenseMatrix<double>, double>(values, numRows, 1, 0.0, 1.0, 1.0, seed + 1, ctx);
+    std::vector<Structure *> cols = {keys, values};
+    std::string labels[] = {"k" + suffix, "v" + suffix};
+    auto res = DataObjectFactory::create<Frame>(cols, labels);
+    DataObjectFactory::destroy(keys, values);
+    return res;
+}
+
+TEST_CASE("Group", TAG_BENCHMARK TAG_KERNELS) {
+    auto dctx = setupBenchmarkContext();
+    const size_t numRows = benchmarkSize(1 << 18);
+    const size_t numGroups = GENERATE(16, 4096, 1 << 16);
+
+    Frame *arg = genKeyValueFrame(numRows, numGroups, 1, "", dctx.get());
+    const char *keyCols[] = {"k"};
+    const char *aggCols[] = {"v"};
+    mlir::daphne::GroupEnum aggFuncs[] = {mlir::daphne::GroupEnum::SUM};
+
+    setBenchmarkBytes(numRows * (sizeof(int64_t) + sizeof(double)));
+    BENCHMARK("SUM " + std::to_string(numRows) + " rows " + std::to_string(numGroups) + " groups") {
+        Frame *res = nullptr;
+        group(res, arg, keyCols, 1, aggCols, 1, aggFuncs, 1, dctx.get());
+        DataObjectFactory::destroy(res);
+    };
+
+    DataObjectFactory::destroy(arg);
+}
+
+TEST_CASE("InnerJoin", TAG_BENCHMARK TAG_KERNELS) {
+    auto dctx = setupBenchmarkContext();
+    // The kernel allocates numRowsLhs * numRowsRhs rows for its result.
+    const size_t numRowsLhs = benchmarkSize(1 << 12);
+    const size_t numRowsRhs = benchmarkSize(1 << 8);
+    const size_t numKeys = GENERATE(1 << 8, 1 << 12);
+
+    Frame *lhs = genKeyValueFrame(numRowsLhs, numKeys, 1, "l", dctx.get());
+    Frame *rhs = genKeyValueFrame(numRowsRhs, numKeys, 3, "r", dctx.get());
+
+    BENCHMARK(std::to_string(numRowsLhs) + " x " + std::to_string(numRowsRhs) + " rows " + std::to_string(numKeys) +
+              " keys") {
+        Frame *res = nullptr;
+        innerJoin(res, lhs, rhs, "kl", "kr", dctx.get());
+        DataObjectFactory::destroy(res);
+    };
+
+    DataObjectFactory::destroy(lhs, rhs);
+}
+
+TEST_CASE("Order", TAG_BENCHMARK TAG_KERNELS) {
+    auto dctx = setupBenchmarkContext();
+    const size_t numRows = benchmarkSize(1 << 18);
+
+    Frame *arg = genKeyValueFrame(numRows, 1024, 1, "", dctx.get());
+    size_t colIdxs[] = {0, 1};
+    bool ascending[] = {true, false};
+
+    setBenchmarkBytes(numRows * (sizeof(int64_t) + sizeof(double)));
+    BENCHMARK("1 key column " + std::to_string(numRows) + " rows") {
+        Frame *res = nullptr;
+        order(res, arg, colIdxs + 1, 1, ascending, 1, false, dctx.get());
+        DataObjectFactory::destroy(res);
+    };
+    setBenchmarkBytes(numRows * (sizeof(int64_t) + sizeof(double)));
+    BENCHMARK("2 key columns " + std::to_string(numRows) + " rows") {
+        Frame *res = nullptr;
+        order(res, arg, colIdxs, 2, ascending, 2, false, dctx.get());
+        DataObjectFactory::destroy(res);
+    };
+    BENCHMARK("1 key column, indexes " + std::to_string(numRows) + " rows") {
+        DenseMatrix<uint64_t> *res = nullptr;
+        order(res, arg, colIdxs + 1, 1, ascending, 1, true, dctx.get());
+        DataObjectFactory::destroy(res);
+    };
+
+    DataObjectFactory::destroy(arg);
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "../run_benchmarks.h"
+
+#include <runtime/local/datastructures/CSRMatrix.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/kernels/RandMatrix.h>
+#include <runtime/local/kernels/Transpose.h>
+
+#include <tags.h>
+
+#include <catch.hpp>
+
+TEMPLATE_TEST_CASE("Transpose dense", TAG_BENCHMARK TAG_KERNELS, double, float) {
+    using VT = TestType;
+    auto dctx = setupBenchmarkContext();
+    const size_t numRows = benchmarkSize(1 << 16);
+    const size_t numCols = GENERATE(1, 16, 256);
+
+    DenseMatrix<VT> *arg = nullptr, *res = nullptr;
+    randMatrix<DenseMatrix<VT>, VT>(arg, numRows, numCols, VT(1), VT(100), 1.0, 1, dctx.get());
+
+    setBenchmarkBytes(2 * numRows * numCols * sizeof(VT));
+    BENCHMARK(shapeName(numRows, numCols)) {
+        transpose(res, arg, dctx.get());
+        return res;
+    };
+
+    destroyAllocated(arg, res);
+}
+
+TEMPLATE_TEST_CASE("Transpose sparse", TAG_BENCHMARK TAG_KERNELS, double) {
+    using VT = TestType;
+    auto dctx = setupBenchmarkContext();
+    const size_t numRows = benchmarkSize(1 << 16);
+    const size_t numCols = 256;
+    const double sparsity = GENERATE(0.001, 0.01, 0.1);
+
+    CSRMatrix<VT> *arg = nullptr;
+    randMatrix<CSRMatrix<VT>, VT>(arg, numRows, numCols, VT(1), VT(100), sparsity, 1, dctx.get());
+
+    setBenchmarkBytes(2 * arg->getNumNonZeros() * (sizeof(VT) + sizeof(size_t)));
+    BENCHMARK(shapeName(numRows, numCols) + " sparsity " + std::to_string(sparsity)) {
+        CSRMatrix<VT> *res = nullptr;
+        transpose(res, arg, dctx.get());
+        DataObjectFactory::destroy(res);
+    };
+
+    DataObjectFactory::destroy(arg);
+}
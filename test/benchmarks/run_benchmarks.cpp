@@ -0,0 +1,126 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_MAIN // make catch2 generate a main-function
+#include <catch.hpp>
+
+#include "run_benchmarks.h"
+
+#include <api/cli/DaphneUserConfig.h>
+#include <runtime/local/kernels/CreateDaphneContext.h>
+#include <util/KernelDispatchMapping.h>
+#include <util/Statistics.h>
+
+#include <nlohmannjson/json.hpp>
+#include <spdlog/cfg/env.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <utility>
+
+#include <cstdlib>
+
+namespace {
+DaphneUserConfig user_config{};
+std::unique_ptr<DaphneLogger> logger;
+size_t benchmarkBytes = 0;
+} // namespace
+
+std::unique_ptr<DaphneContext> setupBenchmarkContext() {
+    if (not logger) {
+        logger = std::make_unique<DaphneLogger>(user_config);
+        user_config.log_ptr->registerLoggers();
+        spdlog::cfg::load_env_levels();
+    }
+
+    DaphneContext *dctx_;
+    createDaphneContext(dctx_, reinterpret_cast<uint64_t>(&user_config),
+                        reinterpret_cast<uint64_t>(&KernelDispatchMapping::instance()),
+                        reinterpret_cast<uint64_t>(&Statistics::instance()));
+    return std::unique_ptr<DaphneContext>(dctx_);
+}
+
+size_t benchmarkSize(size_t defaultSize) {
+    static const double scale = [] {
+        const char *env = std::getenv("DAPHNE_BENCHMARK_SCALE");
+        return env ? std::atof(env) : 1.0;
+    }();
+    return std::max<size_t>(1, static_cast<size_t>(defaultSize * scale));
+}
+
+void setBenchmarkBytes(size_t bytes) { benchmarkBytes = bytes; }
+
+size_t takeBenchmarkBytes() { return std::exchange(benchmarkBytes, 0); }
+
+std::string shapeName(size_t numRows, size_t numCols) {
+    return std::to_string(numRows) + "x" + std::to_string(numCols);
+}
+
+/**
+ * @brief A catch2 reporter writing the results of all benchmarks as one JSON
+ * document (`run_benchmarks -r json -o results.json`), such that the results of
+ * different builds can be compared by scripts.
+ */
+class JsonBenchmarkReporter : public Catch::StreamingReporterBase<JsonBenchmarkReporter> {
+    nlohmann::json results = nlohmann::json::array();
+    size_t bytes = 0;
+
+  public:
+    explicit JsonBenchmarkReporter(const Catch::ReporterConfig &config) : StreamingReporterBase(config) {}
+
+    static std::string getDescription() { return "Reports the results of benchmarks as JSON"; }
+
+    void assertionStarting(const Catch::AssertionInfo &) override {}
+
+    bool assertionEnded(const Catch::AssertionStats &) override { return true; }
+
+    void benchmarkStarting(const Catch::BenchmarkInfo &) override { bytes = takeBenchmarkBytes(); }
+
+    void benchmarkEnded(const Catch::BenchmarkStats<> &stats) override {
+        const double meanNs = stats.mean.point.count();
+        nlohmann::json r = {
+            {"test_case", currentTestCaseInfo->name},
+            {"name", stats.info.name},
+            {"samples", stats.info.samples},
+            {"iterations", stats.info.iterations},
+            {"mean_ns", meanNs},
+            {"mean_lower_ns", stats.mean.lower_bound.count()},
+            {"mean_upper_ns", stats.mean.upper_bound.count()},
+            {"std_dev_ns", stats.standardDeviation.point.count()},
+        };
+        if (bytes) {
+            r["bytes"] = bytes;
+            r["throughput_gb_per_s"] = meanNs > 0 ? bytes / meanNs : 0;
+        }
+        results.push_back(r);
+    }
+
+    void testRunEnded(const Catch::TestRunStats &stats) override {
+        const auto now = std::chrono::system_clock::now().time_since_epoch();
+        nlohmann::json doc = {
+            {"timestamp", std::chrono::duration_cast<std::chrono::seconds>(now).count()},
+            {"hardware_concurrency", std::thread::hardware_concurrency()},
+            {"benchmarks", results},
+        };
+        stream << doc.dump(2) << std::endl;
+        StreamingReporterBase::testRunEnded(stats);
+    }
+};
+
+CATCH_REGISTER_REPORTER("json", JsonBenchmarkReporter)
+
+// Nothing else to do here, the individual benchmarks are in separate cpp-files.
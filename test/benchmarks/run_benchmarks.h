@@ -0,0 +1,59 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <runtime/local/context/DaphneContext.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+
+#include <memory>
+#include <string>
+
+#include <cstddef>
+
+std::unique_ptr<DaphneContext> setupBenchmarkContext();
+
+/**
+ * @brief Scales a default problem size by the environment variable
+ * `DAPHNE_BENCHMARK_SCALE` (default 1), such that the benchmarks can be run
+ * quickly in CI and with realistic sizes on dedicated machines.
+ */
+size_t benchmarkSize(size_t defaultSize);
+
+/**
+ * @brief Sets the number of bytes the next `BENCHMARK` reads and writes per
+ * run, such that the JSON reporter can derive its throughput.
+ */
+void setBenchmarkBytes(size_t bytes);
+
+/**
+ * @brief Returns and resets the number of bytes set by `setBenchmarkBytes`.
+ */
+size_t takeBenchmarkBytes();
+
+/**
+ * @brief Formats a shape as part of a benchmark name, e.g., "4096x64".
+ */
+std::string shapeName(size_t numRows, size_t numCols);
+
+/**
+ * @brief Destroys the given data objects, skipping those that were never
+ * allocated because their benchmark was skipped (`--skip-benchmarks`).
+ */
+template<class... DT>
+void destroyAllocated(const DT *...objs) {
+    ((objs ? DataObjectFactory::destroy(objs) : void()), ...);
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "../run_benchmarks.h"
+
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/kernels/EwBinaryMat.h>
+#include <runtime/local/kernels/RandMatrix.h>
+#include <runtime/local/vectorized/LoadPartitioningDefs.h>
+#include <runtime/local/vectorized/MTWrapper.h>
+
+#include <tags.h>
+
+#include <catch.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+template<class DT>
+void funAdd(DT*** outputs, Structure** inputs, DCTX(ctx)) {
+    ewBinaryMat(BinaryOpCode::ADD, *outputs[0], reinterpret_cast<DT*>(inputs[0]), reinterpret_cast<DT*>(inputs[1]), ctx);
+}
+
+static const char *schemeName(SelfSchedulingScheme scheme) {
+    switch(scheme) {
+        case STATIC: return "STATIC";
+        case SS: return "SS";
+        case GSS: return "GSS";
+        case TSS: return "TSS";
+        case FAC2: return "FAC2";
+        case TFSS: return "TFSS";
+        case FISS: return "FISS";
+        case VISS: return "VISS";
+        case PLS: return "PLS";
+        case MSTATIC: return "MSTATIC";
+        case MFSC: return "MFSC";
+        case PSS: return "PSS";
+        case AUTO: return "AUTO";
+        default: return "INVALID";
+    }
+}
+
+TEST_CASE("MTWrapper X+Y", TAG_BENCHMARK TAG_VECTORIZED) {
+    using DT = DenseMatrix<double>;
+    auto dctx = setupBenchmarkContext();
+    const size_t numRows = benchmarkSize(1 << 18);
+    const size_t numCols = 16;
+    const auto scheme = static_cast<SelfSchedulingScheme>(
+            GENERATE(STATIC, SS, GSS, TSS, FAC2, TFSS, FISS, VISS, PLS, MSTATIC, MFSC, PSS, AUTO));
+    const auto queueSetup = static_cast<QueueTypeOption>(GENERATE(CENTRALIZED, PERCPU));
+
+    DT *m1 = nullptr, *m2 = nullptr;
+    randMatrix<DT, double>(m1, numRows, numCols, 0.0, 1.0, 1.0, 1, dctx.get());
+    randMatrix<DT, double>(m2, numRows, numCols, 0.0, 1.0, 1.0, 2, dctx.get());
+
+    // The context refers to the config shared by all benchmarks.
+    const auto oldScheme = dctx->config.taskPartitioningScheme;
+    const auto oldQueueSetup = dctx->config.queueSetupScheme;
+    dctx->config.taskPartitioningScheme = scheme;
+    dctx->config.queueSetupScheme = queueSetup;
+
+    bool isScalar[] = {false, false};
+    Structure *inputs[] = {m1, m2};
+    int64_t outRows[] = {static_cast<int64_t>(numRows)};
+    int64_t outCols[] = {static_cast<int64_t>(numCols)};
+    VectorSplit splits[] = {VectorSplit::ROWS, VectorSplit::ROWS};
+    VectorCombine combines[] = {VectorCombine::ROWS};
+    std::vector<std::function<void(DT ***, Structure **, DCTX(ctx))>> funcs;
+    funcs.push_back(std::function<void(DT***, Structure**, DCTX(ctx))>(reinterpret_cast<void (*)(DT***, Structure **,
+            DCTX(ctx))>(reinterpret_cast<void*>(&funAdd<DT>))));
+
+    setBenchmarkBytes(3 * numRows * numCols * sizeof(double));
+    BENCHMARK(std::string(schemeName(scheme)) + (queueSetup == PERCPU ? " PERCPU " : " CENTRALIZED ") +
+              shapeName(numRows, numCols)) {
+        DT *res = nullptr;
+        DT **outputs[] = {&res};
+        auto wrapper = std::make_unique<MTWrapper<DT>>(1, dctx.get());
+        wrapper->executeCpuQueues(funcs, outputs, isScalar, inputs, 2, 1, outRows, outCols, splits, combines,
+                dctx.get(), false);
+        DataObjectFactory::destroy(res);
+    };
+
+    dctx->config.taskPartitioningScheme = oldScheme;
+    dctx->config.queueSetupScheme = oldQueueSetup;
+    DataObjectFactory::destroy(m1, m2);
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <runtime/local/datagen/GenGivenVals.h>
+#include <runtime/local/datastructures/CSRMatrix.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/datastructures/MncSketch.h>
+#include <runtime/local/io/MncSketchFile.h>
+
+#include <tags.h>
+
+#include <catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <cstddef>
+
+TEMPLATE_PRODUCT_TEST_CASE("MncSketch of a matrix", TAG_DATASTRUCTURES, (DenseMatrix, CSRMatrix), (double, int64_t)) {
+    using DT = TestType;
+
+    auto m = genGivenVals<DT>(3, {
+        0, 3, 0, 1,
+        0, 0, 0, 0,
+        2, 5, 0, 0,
+    });
+
+    MncSketch sketch = createMncSketch(m);
+    CHECK(sketch.numRows == 3);
+    CHECK(sketch.numCols == 4);
+    CHECK(sketch.rowNnz == std::vector<size_t>({2, 0, 2}));
+    CHECK(sketch.colNnz == std::vector<size_t>({1, 2, 0, 1}));
+    CHECK(sketch.nnz == 4);
+    CHECK(sketch.maxRowNnz == 2);
+    CHECK(sketch.maxColNnz == 2);
+    CHECK(sketch.numNonEmptyRows == 2);
+    CHECK(sketch.numNonEmptyCols == 3);
+    CHECK(sketch.getSparsity() == Approx(4.0 / 12));
+
+    MncSketch t = sketch.transposed();
+    CHECK(t.numRows == 4);
+    CHECK(t.rowNnz == sketch.colNnz);
+    CHECK(t.colNnz == sketch.rowNnz);
+
+    DataObjectFactory::destroy(m);
+}
+
+TEST_CASE("MncSketch estimates the product with a selection matrix exactly", TAG_DATASTRUCTURES) {
+    // A selection matrix (one non-zero per row) picking rows 2, 0, and 2.
+    MncSketch sel(3, 3, {1, 1, 1}, {1, 0, 2});
+    MncSketch x(3, 4, {4, 0, 2}, {2, 1, 2, 1});
+
+    CHECK(estimateNnzMatMul(sel, x) == 8);
+
+    MncSketch res = propagateMncMatMul(sel, x);
+    CHECK(res.numRows == 3);
+    CHECK(res.numCols == 4);
+    // The propagated histograms are only scaled, and thus, approximate.
+    CHECK(res.getSparsity() == Approx(8.0 / 12).epsilon(0.2));
+}
+
+TEST_CASE("MncSketch exploits empty rows and columns", TAG_DATASTRUCTURES) {
+    // 100x100 matrices, whose non-zeros are confined to the first 10 rows
+    // (lhs) and the first 10 columns (rhs) and which have 2 non-zeros per row
+    // (lhs) and column (rhs).
+    std::vector<size_t> lhsRowNnz(100, 0);
+    std::vector<size_t> rhsColNnz(100, 0);
+    for(size_t i = 0; i < 10; i++)
+        lhsRowNnz[i] = rhsColNnz[i] = 20;
+    std::vector<size_t> lhsColNnz(100, 2);
+    std::vector<size_t> rhsRowNnz(100, 2);
+    MncSketch lhs(100, 100, lhsRowNnz, lhsColNnz);
+    MncSketch rhs(100, 100, rhsRowNnz, rhsColNnz);
+
+    const double nnz = estimateNnzMatMul(lhs, rhs);
+    // At most the 10x10 block can be non-zero, while the metadata-only
+    // estimator expects non-zeros everywhere.
+    CHECK(nnz <= 100);
+    CHECK(nnz > 90);
+    CHECK(estimateSparsityMatMul(lhs.getSparsity(), rhs.getSparsity(), 100) * 100 * 100 > 100);
+}
+
+TEST_CASE("MncSketch propagation through element-wise ops, bind, and aggregation", TAG_DATASTRUCTURES) {
+    MncSketch a(2, 4, {4, 0}, {1, 1, 1, 1});
+    MncSketch b(2, 4, {2, 2}, {2, 2, 0, 0});
+
+    MncSketch mul = propagateMncEw(a, b, true);
+    CHECK(mul.rowNnz == std::vector<size_t>({2, 0}));
+    MncSketch add = propagateMncEw(a, b, false);
+    CHECK(add.rowNnz == std::vector<size_t>({4, 2}));
+
+    MncSketch rb = propagateMncBind(a, b, true);
+    CHECK(rb.numRows == 4);
+    CHECK(rb.rowNnz == std::vector<size_t>({4, 0, 2, 2}));
+    CHECK(rb.colNnz == std::vector<size_t>({3, 3, 1, 1}));
+    MncSketch cb = propagateMncBind(a, b, false);
+    CHECK(cb.numCols == 8);
+    CHECK(cb.rowNnz == std::vector<size_t>({6, 2}));
+
+    MncSketch rowSum = propagateMncAgg(a, true);
+    CHECK(rowSum.numCols == 1);
+    CHECK(rowSum.rowNnz == std::vector<size_t>({1, 0}));
+    CHECK(rowSum.colNnz == std::vector<size_t>({1}));
+    MncSketch colSum = propagateMncAgg(b, false);
+    CHECK(colSum.numRows == 1);
+    CHECK(colSum.colNnz == std::vector<size_t>({1, 1, 0, 0}));
+
+    CHECK_THROWS(propagateMncEw(a, rb, true));
+}
+
+TEMPLATE_TEST_CASE("MncSketch collected from row ranges", TAG_DATASTRUCTURES, double, int64_t) {
+    using VT = TestType;
+
+    auto m = genGivenVals<DenseMatrix<VT>>(3, {
+        0, 3, 0, 1,
+        0, 0, 0, 0,
+        2, 5, 0, 0,
+    });
+    // A view, such that the row skip differs from the number of columns.
+    auto view = DataObjectFactory::create<DenseMatrix<VT>>(m, 0, 3, 1, 4);
+
+    MncSketchBuilder builder(3, 3);
+    builder.addRows(view->getValues(), view->getRowSkip(), 2, 3);
+    builder.addRows(view->getValues(), view->getRowSkip(), 0, 2);
+    MncSketch sketch = builder.build();
+    CHECK(sketch.rowNnz == std::vector<size_t>({2, 0, 1}));
+    CHECK(sketch.colNnz == std::vector<size_t>({2, 0, 1}));
+    CHECK(sketch.nnz == 3);
+
+    DataObjectFactory::destroy(m, view);
+}
+
+TEST_CASE("MncSketch file", TAG_DATASTRUCTURES) {
+    const std::string filename = (std::filesystem::temp_directory_path() / "MncSketchFileTest.csv").string();
+    const std::string sketchFilename = getMncSketchFilename(filename);
+
+    CHECK(readMncSketch(filename) == nullptr);
+
+    const MncSketch sketch(3, 2, {1, 0, 2}, {2, 1});
+    writeMncSketch(filename, sketch);
+    // 4 bytes per count.
+    CHECK(std::filesystem::file_size(sketchFilename) == sizeof(MncSketchFileHeader) + 5 * 4);
+    auto res = readMncSketch(filename);
+    REQUIRE(res != nullptr);
+    CHECK(res->numRows == 3);
+    CHECK(res->numCols == 2);
+    CHECK(res->rowNnz == sketch.rowNnz);
+    CHECK(res->colNnz == sketch.colNnz);
+    CHECK(res->nnz == 3);
+
+    std::filesystem::resize_file(sketchFilename, sizeof(MncSketchFileHeader) + 4);
+    CHECK_THROWS(readMncSketch(filename));
+
+    std::filesystem::remove(sketchFilename);
+}
+
+TEST_CASE("Metadata-only sparsity estimation", TAG_DATASTRUCTURES) {
+    CHECK(estimateSparsityMatMul(-1.0, 0.5, 10) == -1.0);
+    CHECK(estimateSparsityMatMul(0.5, 0.5, -1) == -1.0);
+    CHECK(estimateSparsityMatMul(1.0, 1.0, 3) == Approx(1.0));
+    CHECK(estimateSparsityMatMul(0.1, 0.1, 1) == Approx(0.01));
+    CHECK(estimateSparsityEwAnd(0.5, 0.2) == Approx(0.1));
+    CHECK(estimateSparsityEwOr(0.5, 0.2) == Approx(0.6));
+    CHECK(estimateSparsityAgg(0.5, 2) == Approx(0.75));
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <runtime/local/datastructures/ChunkedTensor.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/io/io_uring/AsyncIOService.h>
+#include <runtime/local/io/io_uring/ReadaheadFile.h>
+
+#include <tags.h>
+
+#include <catch.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+const char *filename = "./test/runtime/local/io/AsyncIOServiceTest.txt";
+
+// Writes lines of varying lengths (some much longer than a buffer) and returns
+// the expected file contents.
+std::string writeLines(size_t numLines) {
+    std::string content;
+    for (size_t i = 0; i < numLines; i++) {
+        content += std::to_string(i) + ",";
+        content += std::string(i % 97 == 0 ? AsyncIOService::BUFFER_SIZE + 7 : i % 1000, 'x');
+        content += "\n";
+    }
+    content += "last line without newline";
+    std::ofstream(filename, std::ios::binary) << content;
+    return content;
+}
+} // namespace
+
+TEMPLATE_TEST_CASE("AsyncIOService readFully", TAG_IO, std::true_type, std::false_type) {
+    AsyncIOService service(8, 2, TestType::value);
+    const std::string content = writeLines(5000);
+
+    int fd = open(filename, O_RDONLY);
+    REQUIRE(fd != -1);
+
+    std::vector<char> buf(content.size());
+    service.readFully(fd, buf.data(), buf.size(), 0);
+    CHECK(std::string(buf.begin(), buf.end()) == content);
+
+    std::vector<char> part(1000);
+    service.readFully(fd, part.data(), part.size(), 12345);
+    CHECK(std::string(part.begin(), part.end()) == content.substr(12345, 1000));
+
+    // Reading beyond the end of the file.
+    CHECK_THROWS(service.readFully(fd, buf.data(), buf.size(), 1));
+
+    close(fd);
+    std::remove(filename);
+}
+
+TEMPLATE_TEST_CASE("AsyncIOService error", TAG_IO, std::true_type, std::false_type) {
+    AsyncIOService service(8, 2, TestType::value);
+    char buf[16];
+    std::atomic<bool> done = false;
+    IO_STATUS status = IO_STATUS::SUCCESS;
+    service.submitRead(-1, buf, sizeof(buf), 0, [&](IO_STATUS s, size_t) {
+        status = s;
+        done = true;
+    });
+    service.flush();
+    while (!done)
+        std::this_thread::yield();
+    CHECK(status == IO_STATUS::BAD_FD);
+}
+
+TEST_CASE("ReadaheadFile getLine", TAG_IO) {
+    const std::string content = writeLines(3000);
+
+    ReadaheadFile *f = ReadaheadFile::open(filename, 3);
+    REQUIRE(f != nullptr);
+    std::string res;
+    char *line = nullptr;
+    size_t cap = 0;
+    ssize_t n;
+    while ((n = f->getLine(&line, &cap)) != -1)
+        res.append(line, n);
+    CHECK(res == content);
+    free(line);
+    delete f;
+
+    std::remove(filename);
+}
+
+TEST_CASE("ReadaheadFile read", TAG_IO) {
+    const std::string content = writeLines(2000);
+
+    ReadaheadFile *f = ReadaheadFile::open(filename);
+    REQUIRE(f != nullptr);
+    std::vector<char> buf(content.size() + 10);
+    CHECK(f->read(buf.data(), 5) == 5);
+    CHECK(f->read(buf.data() + 5, buf.size() - 5) == content.size() - 5);
+    CHECK(std::string(buf.begin(), buf.begin() + content.size()) == content);
+    delete f;
+
+    // Closing the file before reading everything.
+    f = ReadaheadFile::open(filename);
+    REQUIRE(f != nullptr);
+    delete f;
+
+    CHECK(ReadaheadFile::open("./test/runtime/local/io/does_not_exist.txt") == nullptr);
+
+    std::remove(filename);
+}
+
+TEST_CASE("ChunkedTensor AsyncLoadChunks", TAG_IO) {
+    // Four 2x2 chunks, stored one after another.
+    std::vector<double> values(16);
+    for (size_t i = 0; i < values.size(); i++)
+        values[i] = i;
+    std::ofstream(filename, std::ios::binary).write(reinterpret_cast<const char *>(values.data()),
+                                                   values.size() * sizeof(double));
+
+    auto t = DataObjectFactory::create<ChunkedTensor<double>>(std::vector<size_t>{4, 4}, std::vector<size_t>{2, 2},
+                                                              InitCode::NONE);
+    int fd = open(filename, O_RDONLY);
+    REQUIRE(fd != -1);
+    std::vector<std::pair<std::vector<size_t>, uint64_t>> chunks;
+    for (size_t c = 0; c < 4; c++)
+        chunks.push_back({{c % 2, c / 2}, c * 4 * sizeof(double)});
+    t->AsyncLoadChunks(fd, chunks);
+
+    for (size_t c = 0; c < 4; c++) {
+        const std::vector<size_t> chunkIds = chunks[c].first;
+        while (!t->PollChunkMaterializationAndIOStatus(chunkIds))
+            std::this_thread::yield();
+        double *chunk = t->getPtrToChunk(chunkIds);
+        for (size_t i = 0; i < 4; i++)
+            CHECK(chunk[i] == values[c * 4 + i]);
+    }
+
+    close(fd);
+    DataObjectFactory::destroy(t);
+    std::remove(filename);
+}
@@ -22,9 +22,13 @@
 
 #include <catch.hpp>
 
+#include <cstdint>
 #include <vector>
 
 #include <runtime/local/io/ReadDaphne.h>
+#include <runtime/local/io/WriteDaphne.h>
+#include <runtime/local/datagen/GenGivenVals.h>
+#include <runtime/local/kernels/CheckEq.h>
 
 TEMPLATE_PRODUCT_TEST_CASE("ReadDaphne CIG", TAG_IO, (DenseMatrix), (int32_t)) {
   using DT = TestType;
@@ -529,6 +533,86 @@ TEST_CASE("ReadDaphne CPS (Frame)", TAG_IO) {
   DataObjectFactory::destroy(m);
 }
 
+TEMPLATE_PRODUCT_TEST_CASE("ReadDaphne mmap", TAG_IO, (DenseMatrix), (double, int64_t, uint8_t)) {
+  using DT = TestType;
+  using VT = typename DT::VT;
+
+  auto exp = genGivenVals<DT>(3, {
+    1, 2, 3, 4,
+    5, 6, 7, 8,
+    9, 10, 11, 12,
+  });
+
+  char filename[] = "./test/runtime/local/io/mmap.dbdf";
+  writeDaphne(exp, filename);
+
+  DT *m = nullptr;
+  readDaphne(m, filename, true);
+
+  // The values are used in place and aligned.
+  CHECK(reinterpret_cast<uintptr_t>(m->getValues()) % DF_PAYLOAD_ALIGNMENT == 0);
+  CHECK(*m == *exp);
+
+  // Modifications are copy-on-write and never reach the file.
+  m->set(1, 1, VT(42));
+  DT *copy = nullptr;
+  readDaphne(copy, filename);
+  CHECK(*copy == *exp);
+  CHECK(m->get(1, 1) == VT(42));
+
+  DataObjectFactory::destroy(exp, m, copy);
+}
+
+TEMPLATE_PRODUCT_TEST_CASE("ReadDaphne blocked", TAG_IO, (DenseMatrix), (double, int32_t)) {
+  using DT = TestType;
+
+  // The first two row blocks are sparse, the others dense.
+  auto exp = genGivenVals<DT>(7, {
+    0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0,
+    0, 0, 0, 4, 0, 0,
+    1, 2, 3, 4, 5, 6,
+    7, 8, 9, 10, 11, 12,
+    13, 14, 15, 16, 17, 18,
+  });
+
+  char filename[] = "./test/runtime/local/io/blocked.dbdf";
+  writeDaphneBlocked(exp, filename, 2, 3);
+
+  SECTION("all rows") {
+    DT *m = nullptr;
+    readDaphne(m, filename);
+    CHECK(*m == *exp);
+    DataObjectFactory::destroy(m);
+  }
+  SECTION("row range") {
+    auto expRange = genGivenVals<DT>(4, {
+      0, 0, 0, 0, 0, 0,
+      0, 0, 0, 4, 0, 0,
+      1, 2, 3, 4, 5, 6,
+      7, 8, 9, 10, 11, 12,
+    });
+    DT *m = nullptr;
+    readDaphneRows(m, filename, 2, 6);
+    CHECK(*m == *expRange);
+    DataObjectFactory::destroy(m, expRange);
+  }
+  SECTION("row range of a single block file") {
+    writeDaphne(exp, filename);
+    auto expRange = genGivenVals<DT>(2, {
+      0, 0, 0, 4, 0, 0,
+      1, 2, 3, 4, 5, 6,
+    });
+    DT *m = nullptr;
+    readDaphneRows(m, filename, 3, 5);
+    CHECK(*m == *expRange);
+    DataObjectFactory::destroy(m, expRange);
+  }
+
+  DataObjectFactory::destroy(exp);
+}
+
 TEST_CASE("ReadDaphne AIK (Frame)", TAG_IO) {
   using DT = Frame;
   DT *m = nullptr;
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2021 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <runtime/local/datagen/GenGivenVals.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/io/RowChunkReader.h>
+#include <runtime/local/io/WriteDaphne.h>
+#include <runtime/local/kernels/CheckEq.h>
+
+#include <tags.h>
+
+#include <catch.hpp>
+
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+TEST_CASE("RowChunkReader csv", TAG_IO) {
+    RowChunkReader<double> reader("./test/runtime/local/io/ReadCsv1.csv", 2, 4, 1);
+
+    size_t rowOffset = 99;
+    auto chunk0 = reader.next(rowOffset);
+    REQUIRE(chunk0 != nullptr);
+    CHECK(rowOffset == 0);
+    auto exp0 = genGivenVals<DenseMatrix<double>>(1, {-0.1, -0.2, 0.1, 0.2});
+    CHECK(*chunk0 == *exp0);
+
+    auto chunk1 = reader.next(rowOffset);
+    REQUIRE(chunk1 != nullptr);
+    CHECK(rowOffset == 1);
+    auto exp1 = genGivenVals<DenseMatrix<double>>(1, {3.14, 5.41, 6.22216, 5});
+    CHECK(*chunk1 == *exp1);
+
+    CHECK(reader.next(rowOffset) == nullptr);
+
+    DataObjectFactory::destroy(chunk0, chunk1, exp0, exp1);
+}
+
+TEST_CASE("RowChunkReader dbdf", TAG_IO) {
+    const char * filename = "./test/runtime/local/io/RowChunkReaderTest.dbdf";
+    auto m = genGivenVals<DenseMatrix<int64_t>>(5, {
+        1, 2,
+        3, 4,
+        5, 6,
+        7, 8,
+        9, 10,
+    });
+    writeDaphne(m, filename);
+
+    RowChunkReader<int64_t> reader(filename, 5, 2, 2);
+    std::vector<size_t> offsets;
+    size_t rowOffset;
+    while(auto chunk = reader.next(rowOffset)) {
+        auto exp = m->sliceRow(rowOffset, rowOffset + chunk->getNumRows());
+        CHECK(*chunk == *exp);
+        offsets.push_back(rowOffset);
+        DataObjectFactory::destroy(chunk, exp);
+    }
+    CHECK(offsets == std::vector<size_t>{0, 2, 4});
+
+    DataObjectFactory::destroy(m);
+}
+
+TEST_CASE("RowChunkReader stop early", TAG_IO) {
+    // Destroying the reader discards the chunk read in the background.
+    RowChunkReader<double> reader("./test/runtime/local/io/ReadCsv1.csv", 2, 4, 1);
+    size_t rowOffset;
+    auto chunk = reader.next(rowOffset);
+    REQUIRE(chunk != nullptr);
+    DataObjectFactory::destroy(chunk);
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2021 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <runtime/local/datagen/GenGivenVals.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/datastructures/Frame.h>
+#include <runtime/local/io/File.h>
+#include <runtime/local/io/WriteCsv.h>
+#include <runtime/local/kernels/CreateFrame.h>
+
+#include <tags.h>
+
+#include <catch.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+#include <cstdio>
+
+static std::string readWholeFile(const char * filename) {
+    std::ifstream ifs(filename);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    return ss.str();
+}
+
+template<class DT>
+static std::string writeCsvToString(const DT * arg, bool fullPrecision = false, size_t numThreads = 0) {
+    const char * filename = "./test/runtime/local/io/WriteCsvTest.csv";
+    File * file = openFileForWrite(filename);
+    writeCsv(arg, file, fullPrecision, numThreads);
+    closeFile(file);
+    std::string res = readWholeFile(filename);
+    std::remove(filename);
+    return res;
+}
+
+TEMPLATE_PRODUCT_TEST_CASE("WriteCsv", TAG_IO, (DenseMatrix), (int8_t, uint64_t, int64_t)) {
+    using DT = TestType;
+
+    auto m = genGivenVals<DT>(2, {
+        1, 2, 3,
+        4, 5, 100,
+    });
+    CHECK(writeCsvToString(m) == "1,2,3\n4,5,100\n");
+
+    DataObjectFactory::destroy(m);
+}
+
+TEST_CASE("WriteCsv floating-point precision", TAG_IO) {
+    auto m = genGivenVals<DenseMatrix<double>>(2, {
+        0.1, 1.0,
+        -2.5, 1234567.0123456789,
+    });
+
+    SECTION("default") {
+        CHECK(writeCsvToString(m) == "0.100000,1.000000\n-2.500000,1234567.012346\n");
+    }
+    SECTION("full precision") {
+        CHECK(writeCsvToString(m, true) == "0.1,1\n-2.5,1234567.0123456789\n");
+    }
+
+    DataObjectFactory::destroy(m);
+}
+
+TEST_CASE("WriteCsv many rows in order", TAG_IO) {
+    const size_t numRows = 2 * CSV_WRITE_BLOCK_CELLS + 3;
+    auto m = DataObjectFactory::create<DenseMatrix<int64_t>>(numRows, 1, false);
+    std::string exp;
+    for(size_t r = 0; r < numRows; r++) {
+        m->set(r, 0, r);
+        exp += std::to_string(r) + "\n";
+    }
+
+    CHECK(writeCsvToString(m, false, 4) == exp);
+
+    DataObjectFactory::destroy(m);
+}
+
+TEST_CASE("WriteCsv Frame", TAG_IO) {
+    auto c0 = genGivenVals<DenseMatrix<int64_t>>(2, {1, -2});
+    auto c1 = genGivenVals<DenseMatrix<double>>(2, {0.5, 3.0});
+    auto c2 = genGivenVals<DenseMatrix<uint8_t>>(2, {7, 255});
+    std::vector<Structure *> cols = {c0, c1, c2};
+    Frame * f = nullptr;
+    createFrame(f, cols.data(), cols.size(), nullptr, 0, nullptr);
+
+    CHECK(writeCsvToString(f) == "1,0.500000,7\n-2,3.000000,255\n");
+    CHECK(writeCsvToString(f, true) == "1,0.5,7\n-2,3,255\n");
+
+    DataObjectFactory::destroy(f, c0, c1, c2);
+}
@@ -182,6 +182,61 @@ TEMPLATE_PRODUCT_TEST_CASE("castObj, matrix to frame and back, multi-column", TA
     DataObjectFactory::destroy(m2, f2, res2);
 }
 
+TEMPLATE_PRODUCT_TEST_CASE("castObj, matrix to frame and back, large", TAG_KERNELS, (DenseMatrix), (double, int64_t, uint32_t)) {
+    using DT = TestType;
+    using VT = typename DT::VT;
+
+    // Large enough for several row blocks and multiple threads.
+    const size_t numRows = 70000;
+    const size_t numCols = 17;
+    auto m = DataObjectFactory::create<DT>(numRows, numCols, false);
+    for(size_t r = 0; r < numRows; r++)
+        for(size_t c = 0; c < numCols; c++)
+            m->set(r, c, VT(r % 1000 + c));
+
+    Frame * f = nullptr;
+    castObj<Frame, DT>(f, m, nullptr);
+    REQUIRE(f->getNumRows() == numRows);
+    REQUIRE(f->getNumCols() == numCols);
+    bool colsOk = true;
+    for(size_t c = 0; c < numCols; c++) {
+        const VT * colVals = static_cast<const VT *>(f->getColumnRaw(c));
+        for(size_t r = 0; r < numRows; r++)
+            colsOk = colsOk && colVals[r] == VT(r % 1000 + c);
+    }
+    CHECK(colsOk);
+
+    DT * res = nullptr;
+    castObj<DT, Frame>(res, f, nullptr);
+    CHECK(*res == *m);
+
+    DataObjectFactory::destroy(m, f, res);
+}
+
+TEMPLATE_PRODUCT_TEST_CASE("castObj, matrix view to frame", TAG_KERNELS, (DenseMatrix), (double, int64_t, uint32_t)) {
+    using DT = TestType;
+    using VT = typename DT::VT;
+
+    auto m = genGivenVals<DT>(3, {
+        VT(1), VT(2), VT(3), VT(4),
+        VT(5), VT(6), VT(7), VT(8),
+        VT(9), VT(10), VT(11), VT(12),
+    });
+    // A view on the middle columns, whose rows are not contiguous.
+    auto view = DataObjectFactory::create<DT>(m, 0, 3, 1, 3);
+
+    auto c0 = genGivenVals<DT>(3, {VT(2), VT(6), VT(10)});
+    auto c1 = genGivenVals<DT>(3, {VT(3), VT(7), VT(11)});
+    std::vector<Structure *> cols = {c0, c1};
+    auto exp = DataObjectFactory::create<Frame>(cols, nullptr);
+
+    Frame * res = nullptr;
+    castObj<Frame, DT>(res, view, nullptr);
+    CHECK(*res == *exp);
+
+    DataObjectFactory::destroy(m, view, c0, c1, exp, res);
+}
+
 TEMPLATE_PRODUCT_TEST_CASE("castObj, matrix to matrix, multi-column", TAG_KERNELS, (DenseMatrix), (double, int64_t, uint32_t)) {
     using DTRes = TestType;
     using VTRes = typename DTRes::VT;
@@ -0,0 +1,240 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <runtime/local/datagen/GenGivenVals.h>
+#include <runtime/local/datastructures/CSRMatrix.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/kernels/CheckEq.h>
+#include <runtime/local/kernels/Dot.h>
+#include <runtime/local/kernels/EwMulPosMask.h>
+#include <runtime/local/kernels/MMChain.h>
+#include <runtime/local/kernels/RowDot.h>
+#include <runtime/local/kernels/RowSoftmax.h>
+#include <runtime/local/kernels/Sigmoid.h>
+#include <runtime/local/kernels/SumSqDiff.h>
+#include <runtime/local/kernels/WsLoss.h>
+#include <util/KernelThreads.h>
+
+#include <tags.h>
+
+#include <catch.hpp>
+
+#include <cmath>
+
+// The fused kernels are checked against hand-computed results of the
+// compositions they replace.
+
+#define TEST_NAME(opName) "FusedOps (" opName ")"
+#define VALUE_TYPES float, double
+
+TEMPLATE_TEST_CASE(TEST_NAME("element-wise products and differences"), TAG_KERNELS, VALUE_TYPES) {
+    using VT = TestType;
+    using DT = DenseMatrix<VT>;
+
+    auto x = genGivenVals<DT>(2, {
+        1, -2, 3,
+        0, 4, -1,
+    });
+    auto y = genGivenVals<DT>(2, {
+        2, 1, 0,
+        -1, 1, 3,
+    });
+
+    // sum(x * y)
+    CHECK(dot<VT>(x, y, nullptr) == 1);
+    // sum((x - y)^2)
+    CHECK(sumSqDiff<VT>(x, y, nullptr) == 45);
+
+    // sum(x * y, 0)
+    auto expRowDot = genGivenVals<DT>(2, {0, 1});
+    DT * resRowDot = nullptr;
+    rowDot(resRowDot, x, y, nullptr);
+    CHECK(*resRowDot == *expRowDot);
+
+    // x * (y > 0)
+    auto expMask = genGivenVals<DT>(2, {
+        1, -2, 0,
+        0, 4, -1,
+    });
+    DT * resMask = nullptr;
+    ewMulPosMask(resMask, x, y, nullptr);
+    CHECK(*resMask == *expMask);
+
+    auto z = genGivenVals<DT>(1, {1, 2});
+    CHECK_THROWS(dot<VT>(x, z, nullptr));
+
+    DataObjectFactory::destroy(x, y, z, expRowDot, resRowDot, expMask, resMask);
+}
+
+TEMPLATE_TEST_CASE(TEST_NAME("mmChain"), TAG_KERNELS, VALUE_TYPES) {
+    using DT = DenseMatrix<TestType>;
+
+    auto x = genGivenVals<DT>(2, {
+        1, -2, 3,
+        0, 4, -1,
+    });
+    auto v = genGivenVals<DT>(3, {1, 1, 1});
+    // t(x) @ (x @ v) = t(x) @ [2, 3]
+    auto exp = genGivenVals<DT>(3, {2, 8, 3});
+
+    DT * res = nullptr;
+    mmChain(res, x, v, nullptr);
+    CHECK(*res == *exp);
+
+    DataObjectFactory::destroy(x, v, exp, res);
+}
+
+TEMPLATE_TEST_CASE(TEST_NAME("wsLoss"), TAG_KERNELS, VALUE_TYPES) {
+    using VT = TestType;
+    using DT = DenseMatrix<VT>;
+
+    auto x = genGivenVals<DT>(2, {
+        1, -2, 3,
+        0, 4, -1,
+    });
+    auto u = genGivenVals<DT>(2, {1, 2});
+    auto v = genGivenVals<DT>(3, {1, 0, 1});
+    // (x - u @ t(v))^2 = [0, 4, 4; 4, 16, 9]
+    auto wDense = genGivenVals<DT>(2, {
+        1, 0, 2,
+        0, 1, 0,
+    });
+    auto wSparse = genGivenVals<CSRMatrix<VT>>(2, {
+        1, 0, 2,
+        0, 1, 0,
+    });
+
+    CHECK(wsLoss<VT>(wDense, x, u, v, nullptr) == 24);
+    CHECK(wsLoss<VT>(wSparse, x, u, v, nullptr) == 24);
+    CHECK_THROWS(wsLoss<VT>(wDense, x, v, v, nullptr));
+
+    // As in the unfused computation, a zero weight does not mask non-finite
+    // values in a dense w, but cells not stored in a sparse w are ignored.
+    auto xNan = genGivenVals<DT>(2, {
+        1, NAN, 3,
+        0, 4, -1,
+    });
+    auto vInf = genGivenVals<DT>(3, {1, 0, INFINITY});
+    CHECK(std::isnan(wsLoss<VT>(wDense, xNan, u, v, nullptr)));
+    CHECK(std::isnan(wsLoss<VT>(wDense, x, u, vInf, nullptr)));
+    CHECK(wsLoss<VT>(wSparse, xNan, u, v, nullptr) == 24);
+
+    DataObjectFactory::destroy(x, u, v, wDense, wSparse, xNan, vInf);
+}
+
+TEMPLATE_TEST_CASE(TEST_NAME("aggregations of large inputs"), TAG_KERNELS, VALUE_TYPES) {
+    using VT = TestType;
+    using DT = DenseMatrix<VT>;
+
+    // Large enough to be split into blocks of rows for several threads. The
+    // small integer values make the sums exact regardless of their order.
+    const size_t numRows = 1500;
+    const size_t numCols = 1000;
+    const size_t rank = 2;
+    auto x = DataObjectFactory::create<DT>(numRows, numCols, false);
+    auto y = DataObjectFactory::create<DT>(numRows, numCols, false);
+    auto w = DataObjectFactory::create<DT>(numRows, numCols, false);
+    auto u = DataObjectFactory::create<DT>(numRows, rank, false);
+    auto v = DataObjectFactory::create<DT>(numCols, rank, false);
+    for(size_t r = 0; r < numRows; r++)
+        for(size_t c = 0; c < numCols; c++) {
+            x->set(r, c, static_cast<VT>((r + c) % 3) - 1);
+            y->set(r, c, static_cast<VT>((r * c) % 4));
+            w->set(r, c, static_cast<VT>((r + 2 * c) % 5 == 0));
+        }
+    for(size_t r = 0; r < numRows; r++)
+        for(size_t k = 0; k < rank; k++)
+            u->set(r, k, static_cast<VT>((r + k) % 2));
+    for(size_t c = 0; c < numCols; c++)
+        for(size_t k = 0; k < rank; k++)
+            v->set(c, k, static_cast<VT>((c * k) % 2));
+    auto wSparse = DataObjectFactory::create<CSRMatrix<VT>>(numRows, numCols, numRows * numCols, false);
+    {
+        size_t * rowOffsets = wSparse->getRowOffsets();
+        size_t pos = 0;
+        rowOffsets[0] = 0;
+        for(size_t r = 0; r < numRows; r++) {
+            for(size_t c = 0; c < numCols; c++)
+                if(w->get(r, c) != 0) {
+                    wSparse->getColIdxs()[pos] = c;
+                    wSparse->getValues()[pos] = w->get(r, c);
+                    pos++;
+                }
+            rowOffsets[r + 1] = pos;
+        }
+    }
+
+    VT expDot = 0, expSumSqDiff = 0, expWsLoss = 0;
+    for(size_t r = 0; r < numRows; r++)
+        for(size_t c = 0; c < numCols; c++) {
+            const VT xrc = x->get(r, c);
+            const VT yrc = y->get(r, c);
+            expDot += xrc * yrc;
+            expSumSqDiff += (xrc - yrc) * (xrc - yrc);
+            VT uvrc = 0;
+            for(size_t k = 0; k < rank; k++)
+                uvrc += u->get(r, k) * v->get(c, k);
+            expWsLoss += w->get(r, c) * (xrc - uvrc) * (xrc - uvrc);
+        }
+
+    CHECK(dot<VT>(x, y, nullptr) == expDot);
+    CHECK(sumSqDiff<VT>(x, y, nullptr) == expSumSqDiff);
+    CHECK(wsLoss<VT>(w, x, u, v, nullptr) == expWsLoss);
+    CHECK(wsLoss<VT>(wSparse, x, u, v, nullptr) == expWsLoss);
+
+    // Inside vectorized pipelines, the kernels do not spawn threads.
+    {
+        VectorizedWorkerScope workerScope;
+        CHECK(getNumKernelThreads(8) == 1);
+        CHECK(dot<VT>(x, y, nullptr) == expDot);
+        CHECK(wsLoss<VT>(wSparse, x, u, v, nullptr) == expWsLoss);
+    }
+    CHECK(getNumKernelThreads(8) == 8);
+
+    DataObjectFactory::destroy(x, y, w, u, v, wSparse);
+}
+
+TEMPLATE_TEST_CASE(TEST_NAME("sigmoid and rowSoftmax"), TAG_KERNELS, VALUE_TYPES) {
+    using VT = TestType;
+    using DT = DenseMatrix<VT>;
+
+    auto x = genGivenVals<DT>(2, {
+        0, 1,
+        0, static_cast<VT>(std::log(3.0)),
+    });
+
+    DT * resSig = nullptr;
+    sigmoid(resSig, x, nullptr);
+    for(size_t r = 0; r < 2; r++)
+        for(size_t c = 0; c < 2; c++)
+            CHECK(resSig->get(r, c) == Approx(1.0 / (1.0 + std::exp(-x->get(r, c)))));
+
+    DT * resSoft = nullptr;
+    rowSoftmax(resSoft, x, nullptr);
+    CHECK(resSoft->get(0, 0) == Approx(1.0 / (1.0 + std::exp(1.0))));
+    CHECK(resSoft->get(0, 1) == Approx(std::exp(1.0) / (1.0 + std::exp(1.0))));
+    CHECK(resSoft->get(1, 0) == Approx(0.25));
+    CHECK(resSoft->get(1, 1) == Approx(0.75));
+
+    // Large values must not overflow.
+    auto big = genGivenVals<DT>(1, {1000, 1000});
+    DT * resBig = nullptr;
+    rowSoftmax(resBig, big, nullptr);
+    CHECK(resBig->get(0, 0) == Approx(0.5));
+    CHECK(resBig->get(0, 1) == Approx(0.5));
+
+    DataObjectFactory::destroy(x, resSig, resSoft, big, resBig);
+}
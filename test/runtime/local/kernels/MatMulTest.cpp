@@ -19,6 +19,7 @@
 #include <cstdint>
 #include <runtime/local/context/DaphneContext.h>
 #include <runtime/local/datagen/GenGivenVals.h>
+#include <runtime/local/datastructures/CSRMatrix.h>
 #include <runtime/local/datastructures/DenseMatrix.h>
 #include <runtime/local/kernels/CheckEq.h>
 #include <runtime/local/kernels/MatMul.h>
@@ -30,6 +31,7 @@
 
 #include <catch.hpp>
 
+#include <type_traits>
 #include <vector>
 
 #define DATA_TYPES DenseMatrix, Matrix
@@ -41,6 +43,14 @@ void checkMatMul(const DT * lhs, const DT * rhs, const DT * exp, DCTX(dctx), boo
     matMul<DT, DT, DT>(res, lhs, rhs, transa, transb, dctx);
     CHECK(*res == *exp);
     DataObjectFactory::destroy(res);
+
+    if constexpr(std::is_same_v<DT, DenseMatrix<typename DT::VT>>) {
+        // The naive variant selected at run-time for small matrices.
+        res = nullptr;
+        matMulNaive<DT, DT, DT>(res, lhs, rhs, transa, transb, dctx);
+        CHECK(*res == *exp);
+        DataObjectFactory::destroy(res);
+    }
 }
 
 TEMPLATE_PRODUCT_TEST_CASE("MatMul", TAG_KERNELS, (DATA_TYPES), (VALUE_TYPES)) {
@@ -271,3 +281,64 @@ TEMPLATE_PRODUCT_TEST_CASE("MatMul after slicing", TAG_KERNELS "[new]", (DenseMa
     DataObjectFactory::destroy(resMatrix3x3);
 }
 
+
+TEMPLATE_TEST_CASE("MatMul sparse lhs transposed", TAG_KERNELS, float, double, int32_t, int64_t) {
+    using VT = TestType;
+    using DTSparse = CSRMatrix<VT>;
+    using DTDense = DenseMatrix<VT>;
+    auto dctx = setupContextAndLogger();
+
+    auto lhs = genGivenVals<DTSparse>(4, {
+        0, 1,
+        2, 0,
+        1, 1,
+        0, 0,
+    });
+    auto rhs0 = genGivenVals<DTDense>(4, {
+        0, 1,
+        2, 0,
+        1, 1,
+        0, 0,
+    });
+    auto rhs1 = genGivenVals<DTDense>(3, {
+        1, 0,
+        0, 1,
+        1, 1,
+    });
+    auto rhs2 = genGivenVals<DTDense>(3, {
+        1, 0, 0, 1,
+        0, 1, 0, 0,
+        1, 1, 1, 1,
+    });
+    auto exp0 = genGivenVals<DTDense>(2, {
+        5, 1,
+        1, 2,
+    });
+    auto exp1 = genGivenVals<DTDense>(4, {
+        0, 1, 1,
+        2, 0, 2,
+        1, 1, 2,
+        0, 0, 0,
+    });
+    auto exp2 = genGivenVals<DTDense>(2, {
+        0, 2, 3,
+        1, 0, 2,
+    });
+
+    DTDense * res = nullptr;
+    matMul(res, lhs, rhs0, true, false, dctx.get());
+    CHECK(*res == *exp0);
+    DataObjectFactory::destroy(res);
+
+    res = nullptr;
+    matMul(res, lhs, rhs1, false, true, dctx.get());
+    CHECK(*res == *exp1);
+    DataObjectFactory::destroy(res);
+
+    res = nullptr;
+    matMul(res, lhs, rhs2, true, true, dctx.get());
+    CHECK(*res == *exp2);
+    DataObjectFactory::destroy(res);
+
+    DataObjectFactory::destroy(lhs, rhs0, rhs1, rhs2, exp0, exp1, exp2);
+}
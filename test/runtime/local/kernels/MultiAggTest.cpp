@@ -0,0 +1,160 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <runtime/local/datagen/GenGivenVals.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/kernels/AggCol.h>
+#include <runtime/local/kernels/AggOpCode.h>
+#include <runtime/local/kernels/AggRow.h>
+#include <runtime/local/kernels/CheckEqApprox.h>
+#include <runtime/local/kernels/MultiAgg.h>
+#include <runtime/local/kernels/RandMatrix.h>
+#include <runtime/local/kernels/SliceCol.h>
+#include <runtime/local/kernels/SliceRow.h>
+
+#include <tags.h>
+
+#include <catch.hpp>
+
+#include <vector>
+
+#include <cstdint>
+
+#define TEST_NAME(opName) "MultiAgg (" opName ")"
+#define VALUE_TYPES double, float, int64_t
+
+namespace {
+const std::vector<AggOpCode> STATS = {AggOpCode::SUM,    AggOpCode::MIN,  AggOpCode::MAX,
+                                      AggOpCode::IDXMIN, AggOpCode::IDXMAX, AggOpCode::MEAN,
+                                      AggOpCode::STDDEV, AggOpCode::VAR};
+
+int64_t allStats() {
+    int64_t aggs = 0;
+    for(AggOpCode opCode : STATS)
+        aggs |= AggOpCodeUtils::getMultiAggBit(opCode);
+    return aggs;
+}
+} // namespace
+
+TEMPLATE_TEST_CASE(TEST_NAME("col, given values"), TAG_KERNELS, VALUE_TYPES) {
+    using VTArg = TestType;
+    using DTArg = DenseMatrix<VTArg>;
+    using DTRes = DenseMatrix<double>;
+
+    auto arg = genGivenVals<DTArg>(4, {
+        3, 0, 2,
+        1, 0, 2,
+        5, 0, 2,
+        -1, 4, 2,
+    });
+    const int64_t aggs = AggOpCodeUtils::getMultiAggBit(AggOpCode::SUM) |
+                         AggOpCodeUtils::getMultiAggBit(AggOpCode::IDXMAX) |
+                         AggOpCodeUtils::getMultiAggBit(AggOpCode::VAR) |
+                         AggOpCodeUtils::getMultiAggBit(AggOpCode::NNZ);
+    auto exp = genGivenVals<DTRes>(4, {
+        8, 4, 8,
+        2, 3, 0,
+        5, 3, 0,
+        4, 1, 4,
+    });
+
+    DTRes * res = nullptr;
+    multiAggCol(res, arg, aggs, nullptr);
+    CHECK(*res == *exp);
+
+    DataObjectFactory::destroy(arg, exp, res);
+}
+
+TEMPLATE_TEST_CASE(TEST_NAME("row, given values"), TAG_KERNELS, VALUE_TYPES) {
+    using VTArg = TestType;
+    using DTArg = DenseMatrix<VTArg>;
+    using DTRes = DenseMatrix<double>;
+
+    auto arg = genGivenVals<DTArg>(2, {
+        3, 1, 5, -1,
+        0, 0, 0, 4,
+    });
+    const int64_t aggs = AggOpCodeUtils::getMultiAggBit(AggOpCode::PROD) |
+                         AggOpCodeUtils::getMultiAggBit(AggOpCode::MIN) |
+                         AggOpCodeUtils::getMultiAggBit(AggOpCode::IDXMIN) |
+                         AggOpCodeUtils::getMultiAggBit(AggOpCode::MEAN) |
+                         AggOpCodeUtils::getMultiAggBit(AggOpCode::NNZ);
+    auto exp = genGivenVals<DTRes>(2, {
+        -15, -1, 3, 2, 4,
+        0, 0, 0, 1, 1,
+    });
+
+    DTRes * res = nullptr;
+    multiAggRow(res, arg, aggs, nullptr);
+    CHECK(*res == *exp);
+
+    DataObjectFactory::destroy(arg, exp, res);
+}
+
+TEST_CASE(TEST_NAME("agrees with the individual aggregations"), TAG_KERNELS) {
+    using DT = DenseMatrix<double>;
+
+    // More columns than one tile of multiAggCol.
+    DT * arg = nullptr;
+    randMatrix<DT, double>(arg, 257, 1100, -100.0, 100.0, 1.0, 42, nullptr);
+
+    DT * resCol = nullptr;
+    multiAggCol(resCol, arg, allStats(), nullptr);
+    DT * resRow = nullptr;
+    multiAggRow(resRow, arg, allStats(), nullptr);
+
+    for(size_t i = 0; i < STATS.size(); i++) {
+        DYNAMIC_SECTION("aggregation " << static_cast<int>(STATS[i])) {
+            DT * expCol = nullptr;
+            aggCol(STATS[i], expCol, arg, nullptr);
+            DT * gotCol = nullptr;
+            sliceRow(gotCol, resCol, i, i + 1, nullptr);
+            CHECK(checkEqApprox(gotCol, expCol, 1e-6, nullptr));
+
+            DT * expRow = nullptr;
+            aggRow(STATS[i], expRow, arg, nullptr);
+            DT * gotRow = nullptr;
+            sliceCol(gotRow, resRow, i, i + 1, nullptr);
+            CHECK(checkEqApprox(gotRow, expRow, 1e-6, nullptr));
+
+            DataObjectFactory::destroy(expCol, gotCol, expRow, gotRow);
+        }
+    }
+
+    DataObjectFactory::destroy(arg, resCol, resRow);
+}
+
+TEST_CASE(TEST_NAME("numerically stable variance"), TAG_KERNELS) {
+    // A large offset with a small spread, where E[X^2] - E[X]^2 would cancel.
+    const size_t numRows = 10000;
+    auto arg = DataObjectFactory::create<DenseMatrix<double>>(numRows, 1, false);
+    for(size_t r = 0; r < numRows; r++)
+        arg->set(r, 0, 1e9 + (r % 2 ? 1.0 : -1.0));
+
+    DenseMatrix<double> * res = nullptr;
+    multiAggCol(res, arg, AggOpCodeUtils::getMultiAggBit(AggOpCode::VAR), nullptr);
+    CHECK(res->get(0, 0) == Approx(1.0));
+
+    DataObjectFactory::destroy(arg, res);
+}
+
+TEST_CASE(TEST_NAME("invalid aggregations"), TAG_KERNELS) {
+    auto arg = genGivenVals<DenseMatrix<double>>(1, {1, 2});
+    DenseMatrix<double> * res = nullptr;
+    CHECK_THROWS(multiAggCol(res, arg, 0, nullptr));
+    CHECK_THROWS(multiAggRow(res, arg, int64_t(1) << 40, nullptr));
+    DataObjectFactory::destroy(arg);
+}
@@ -17,6 +17,7 @@
 #include <run_tests.h>
 
 #include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/kernels/AggCol.h>
 #include <runtime/local/kernels/CheckEqApprox.h>
 #include <runtime/local/kernels/EwBinaryMat.h>
 #include <runtime/local/kernels/RandMatrix.h>
@@ -46,6 +47,14 @@ void funMul(DT*** outputs, Structure** inputs, DCTX(ctx)) {
         ctx);
 }
 
+template<class DT>
+void funColSum(DT*** outputs, Structure** inputs, DCTX(ctx)) {
+    aggCol(AggOpCode::SUM,
+        *outputs[0],
+        reinterpret_cast<DT*>(inputs[0]),
+        ctx);
+}
+
 TEMPLATE_PRODUCT_TEST_CASE("Multi-threaded-scheduling", TAG_VECTORIZED, (DATA_TYPES), (VALUE_TYPES)){
     using DT = TestType;
     using VT = typename DT::VT;
@@ -149,3 +158,35 @@ TEMPLATE_PRODUCT_TEST_CASE("Multi-threaded X*Y", TAG_VECTORIZED, (DATA_TYPES), (
     DataObjectFactory::destroy(r1);
     DataObjectFactory::destroy(r2);
 }
+
+TEMPLATE_PRODUCT_TEST_CASE("Multi-threaded colSums split by columns", TAG_VECTORIZED, (DATA_TYPES), (VALUE_TYPES)) { // NOLINT(cert-err58-cpp)
+    using DT = TestType;
+    using VT = typename DT::VT;
+    auto dctx = setupContextAndLogger();
+
+    DT *m1 = nullptr;
+    randMatrix<DT, VT>(m1, 10, 1234, 0.0, 1.0, 1.0, 7, dctx.get());
+
+    DT *r1 = nullptr, *r2 = nullptr;
+    aggCol<DT, DT>(AggOpCode::SUM, r1, m1, dctx.get()); //single-threaded
+
+    auto wrapper = std::make_unique<MTWrapper<DT>>(1, dctx.get());
+    DT **outputs[] = {&r2};
+    bool isScalar[] = {false};
+    Structure *inputs[] = {m1};
+    int64_t outRows[] = {1};
+    int64_t outCols[] = {1234};
+    VectorSplit splits[] = {VectorSplit::COLS};
+    VectorCombine combines[] = {VectorCombine::COLS};
+
+    std::vector<std::function<void(DT ***, Structure **, DCTX(ctx))>> funcs;
+    funcs.push_back(std::function<void(DT***, Structure**, DCTX(ctx))>(reinterpret_cast<void (*)(DT***, Structure **,
+            DCTX(ctx))>(reinterpret_cast<void*>(&funColSum<DT>))));
+    wrapper->executeCpuQueues(funcs, outputs, isScalar, inputs, 1, 1, outRows, outCols, splits, combines, dctx.get(), false);
+
+    CHECK(checkEqApprox(r1, r2, 1e-6, dctx.get()));
+
+    DataObjectFactory::destroy(m1);
+    DataObjectFactory::destroy(r1);
+    DataObjectFactory::destroy(r2);
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <runtime/local/vectorized/LoadPartitioningDefs.h>
+#include <runtime/local/vectorized/SchedulingAutotuner.h>
+
+#include <tags.h>
+
+#include <catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+
+namespace {
+// A synthetic pipeline whose run time depends on the scheduling parameters;
+// the optimum is GSS with a doubled batch size and a minimum task size of 256.
+PipelineTelemetry run(const std::string &key, const SchedulingParams &params) {
+    PipelineTelemetry t;
+    t.key = key;
+    t.params = params;
+    t.numRows = 1000;
+    t.elapsedNs = 10000;
+    if (params.scheme == GSS)
+        t.elapsedNs -= 5000;
+    if (params.batchSizeShift == 1)
+        t.elapsedNs -= 2000;
+    if (params.minimumTaskSize == 256)
+        t.elapsedNs -= 1000;
+    return t;
+}
+} // namespace
+
+TEST_CASE("SchedulingAutotuner converges to the best parameters", TAG_VECTORIZED) {
+    SchedulingAutotuner tuner;
+    const std::string key = "double:RR->R:r2^10:c20";
+
+    const size_t numCandidates = SchedulingAutotuner::CANDIDATE_SCHEMES.size() +
+                                 SchedulingAutotuner::CANDIDATE_BATCH_SIZE_SHIFTS.size() +
+                                 SchedulingAutotuner::CANDIDATE_MINIMUM_TASK_SIZES.size();
+    std::set<SchedulingParams> tried;
+    for (size_t i = 0; i < numCandidates; i++) {
+        SchedulingParams params = tuner.suggest(key);
+        tried.insert(params);
+        tuner.record(run(key, params));
+    }
+    // The default of each stage was already tried in the previous stage.
+    CHECK(tried.size() == numCandidates - 2);
+
+    SchedulingParams best = tuner.suggest(key);
+    CHECK(best.scheme == GSS);
+    CHECK(best.batchSizeShift == 1);
+    CHECK(best.minimumTaskSize == 256);
+
+    // Other pipelines are tuned independently.
+    CHECK(tuner.suggest("float:R->A:r2^20:c1").scheme == SchedulingAutotuner::CANDIDATE_SCHEMES.front());
+}
+
+TEST_CASE("SchedulingAutotuner averages and persists its history", TAG_VECTORIZED) {
+    const std::string filename = "SchedulingAutotunerTest_history.json";
+    std::remove(filename.c_str());
+    const std::string key = "double:R->A:r2^4:c2";
+    SchedulingParams params{TSS, 16, -1};
+
+    {
+        SchedulingAutotuner tuner(filename);
+        PipelineTelemetry t = run(key, params);
+        tuner.record(t);
+        t.elapsedNs *= 2;
+        tuner.record(t);
+        auto &obs = tuner.getHistory(key).at(params);
+        CHECK(obs.count == 2);
+        CHECK(obs.nsPerRow == Approx(10 * (1 + SchedulingAutotuner::SMOOTHING)));
+    }
+    {
+        SchedulingAutotuner tuner(filename);
+        auto &history = tuner.getHistory(key);
+        REQUIRE(history.count(params) == 1);
+        CHECK(history.at(params).count == 2);
+        CHECK(history.at(params).nsPerRow == Approx(10 * (1 + SchedulingAutotuner::SMOOTHING)));
+    }
+    std::remove(filename.c_str());
+}
+
+TEST_CASE("SchedulingAutotuner writes its history only when flushed", TAG_VECTORIZED) {
+    const std::string filename = "SchedulingAutotunerTest_flush.json";
+    const std::string otherFilename = "SchedulingAutotunerTest_flush_other.json";
+    std::remove(filename.c_str());
+    std::remove(otherFilename.c_str());
+
+    // There is one process-wide autotuner per history file.
+    SchedulingAutotuner &tuner = SchedulingAutotuner::get(filename);
+    CHECK(&SchedulingAutotuner::get(filename) == &tuner);
+    CHECK(&SchedulingAutotuner::get(otherFilename) != &tuner);
+
+    tuner.record(run("double:R->A:r2^4:c2", {TSS, 16, -1}));
+    CHECK_FALSE(std::ifstream(filename).good());
+    tuner.flush();
+    CHECK(std::ifstream(filename).good());
+    CHECK_FALSE(std::ifstream(otherFilename).good());
+
+    std::remove(filename.c_str());
+}
+
+TEST_CASE("Scheduling telemetry", TAG_VECTORIZED) {
+    SchedulingParams params{STATIC, 1, -2};
+    CHECK(params.applyBatchSizeShift(100) == 25);
+    CHECK(params.applyBatchSizeShift(2) == 1);
+    params.batchSizeShift = 2;
+    CHECK(params.applyBatchSizeShift(100) == 400);
+
+    WorkerTelemetry w1, w2;
+    w1.addTask(10, 300);
+    w1.addTask(30, 300);
+    w2.addTask(20, 200);
+    w2.stealAttempts = 3;
+    w2.stealSuccesses = 1;
+    CHECK(w1.numTasks == 2);
+    CHECK(w1.numRows == 40);
+    CHECK(w1.minTaskRows == 10);
+    CHECK(w1.maxTaskRows == 30);
+
+    PipelineTelemetry t;
+    t.key = "double:R->R:r2^5:c1";
+    t.numRows = 60;
+    t.workers = {w1, w2};
+    CHECK(t.imbalance() == Approx(1.5));
+
+    std::stringstream ss;
+    t.print(ss);
+    const std::string json = ss.str();
+    CHECK(json.find("\"pipeline\": \"double:R->R:r2^5:c1\"") != std::string::npos);
+    CHECK(json.find("\"steal_attempts\": 3, \"steal_successes\": 1") != std::string::npos);
+    CHECK(json.find('\n') == std::string::npos);
+}
@@ -23,6 +23,7 @@
 // "[b]", then TAG_A TAG_B is "[a]" "[b]", which is equivalent to "[a][b]".
 
 #define TAG_ALGORITHMS "[algorithms]"
+#define TAG_BENCHMARK "[benchmark]"
 #define TAG_CAST "[cast]"
 #define TAG_CODEGEN "[codegen]"
 #define TAG_MATMUL "[matmul]"
@@ -38,6 +39,7 @@
 #define TAG_INDEXING "[indexing]"
 #define TAG_INFERENCE "[inference]"
 #define TAG_IMPORT "[import]"
+#define TAG_INSTRUMENTATION "[instrumentation]"
 #define TAG_IO "[io]"
 #define TAG_KERNELS "[kernels]"
 #define TAG_DNN "[dnn]"
@@ -51,5 +53,6 @@
 #define TAG_SYNTAX "[syntax]"
 #define TAG_VECTORIZED "[vectorized]"
 #define TAG_DAPHNELIB "[daphnelib]"
+#define TAG_SERVER "[server]"
 
 #endif //TEST_TAGS_H
@@ -0,0 +1,178 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <api/cli/DaphneUserConfig.h>
+#include <runtime/local/context/DaphneContext.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/instrumentation/BufferAccess.h>
+#include <util/BufferManager.h>
+#include <util/KernelThreads.h>
+
+#include <run_tests.h>
+#include <tags.h>
+
+#include <catch.hpp>
+
+#include <filesystem>
+
+#include <cstddef>
+
+namespace {
+// 1 MiB per matrix.
+const size_t numRows = 512;
+const size_t numCols = 256;
+const size_t matBytes = numRows * numCols * sizeof(double);
+
+DenseMatrix<double> *genMat(double v) {
+    auto m = DataObjectFactory::create<DenseMatrix<double>>(numRows, numCols, false);
+    double *values = m->getValues();
+    for (size_t i = 0; i < numRows * numCols; i++)
+        values[i] = v + i;
+    return m;
+}
+
+bool hasValues(const DenseMatrix<double> *m, double v) {
+    if (!m->getValuesSharedPtr())
+        return false;
+    const double *values = m->getValues();
+    for (size_t i = 0; i < numRows * numCols; i++)
+        if (values[i] != v + i)
+            return false;
+    return true;
+}
+
+BufferManager *spillingBufferManager = nullptr;
+size_t numEntriesWhileSpilling = 0;
+
+// Queries the buffer manager while spilling, which would deadlock if the spill
+// file was written inside the buffer manager's critical section.
+bool querySpill(const Structure *obj, const std::string &path) {
+    numEntriesWhileSpilling = spillingBufferManager->getNumEntries();
+    return spillDenseMatrix<double>(obj, path);
+}
+
+// Simulates a kernel call accessing the given data objects.
+template <typename... Args> void access(DaphneContext *ctx, Args... objs) {
+    BufferAccess ba(ctx, objs...);
+    ba.finish(objs...);
+}
+} // namespace
+
+TEST_CASE("BufferManager spills the least recently used data objects", TAG_INSTRUMENTATION) {
+    auto dctx = setupContextAndLogger();
+    BufferManager bm;
+    bm.configure(2 * matBytes, std::filesystem::temp_directory_path().string());
+    DaphneUserConfig cfg{};
+    cfg.buffer_manager = &bm;
+    DaphneContext ctx(cfg, dctx->dispatchMapping, dctx->stats);
+
+    auto m1 = genMat(1);
+    auto m2 = genMat(2);
+    auto m3 = genMat(3);
+    access(&ctx, m1);
+    access(&ctx, m2);
+    CHECK(bm.getNumEntries() == 2);
+    CHECK(m1->getRefCounter() == 2);
+    CHECK(bm.getNumSpills() == 0);
+
+    // The third matrix exceeds the budget, the least recently used one is spilled.
+    access(&ctx, m3);
+    CHECK(bm.isSpilled(m1));
+    CHECK_FALSE(m1->getValuesSharedPtr());
+    CHECK(bm.getLiveBytes() == 2 * matBytes);
+
+    // Accessing the spilled matrix restores it and spills the next one.
+    access(&ctx, m1);
+    CHECK(hasValues(m1, 1));
+    CHECK(bm.isSpilled(m2));
+    CHECK(bm.getNumRestores() == 1);
+
+    // Matrices only referenced by the buffer manager are released.
+    DataObjectFactory::destroy(m3);
+    access(&ctx, m1);
+    CHECK(bm.getNumEntries() == 2);
+
+    // Small matrices and matrices sharing their values are not tracked/spilled.
+    auto small = DataObjectFactory::create<DenseMatrix<double>>(2, 2, true);
+    access(&ctx, small);
+    CHECK(bm.getNumEntries() == 2);
+    auto m4 = genMat(4);
+    access(&ctx, m4);
+    auto view = DataObjectFactory::create<DenseMatrix<double>>(m1, 0, numRows / 2, 0, numCols);
+    access(&ctx, m2, view);
+    CHECK(hasValues(m2, 2));
+    CHECK_FALSE(bm.isSpilled(m1));
+    CHECK(bm.isSpilled(m4));
+
+    // Clearing restores the spilled matrices that are still referenced.
+    bm.clear();
+    CHECK(bm.getNumEntries() == 0);
+    CHECK(hasValues(m1, 1));
+    CHECK(hasValues(m2, 2));
+    CHECK(hasValues(m4, 4));
+    CHECK(m1->getRefCounter() == 1);
+    CHECK(m2->getRefCounter() == 1);
+
+    DataObjectFactory::destroy(m1, m2, m4, small, view);
+}
+
+TEST_CASE("BufferManager writes spill files outside its critical section", TAG_INSTRUMENTATION) {
+    BufferManager bm;
+    bm.configure(matBytes, std::filesystem::temp_directory_path().string());
+    spillingBufferManager = &bm;
+
+    auto m1 = genMat(1);
+    auto m2 = genMat(2);
+    bm.track(m1, matBytes, &querySpill, &restoreDenseMatrix<double>);
+    bm.track(m2, matBytes, &querySpill, &restoreDenseMatrix<double>);
+    CHECK(numEntriesWhileSpilling == 2);
+    CHECK(bm.isSpilled(m1));
+    CHECK(bm.getLiveBytes() == matBytes);
+
+    // Pinning restores the spilled matrix and spills the other one.
+    CHECK(bm.pin(m1));
+    CHECK(hasValues(m1, 1));
+    CHECK(bm.isSpilled(m2));
+    bm.unpin(m1);
+
+    bm.clear();
+    CHECK(hasValues(m2, 2));
+    DataObjectFactory::destroy(m1, m2);
+}
+
+TEST_CASE("BufferManager ignores kernel calls inside vectorized pipelines", TAG_INSTRUMENTATION) {
+    auto dctx = setupContextAndLogger();
+    BufferManager bm;
+    bm.configure(matBytes, std::filesystem::temp_directory_path().string());
+    DaphneUserConfig cfg{};
+    cfg.buffer_manager = &bm;
+    DaphneContext ctx(cfg, dctx->dispatchMapping, dctx->stats);
+
+    auto m1 = genMat(1);
+    auto m2 = genMat(2);
+    {
+        VectorizedWorkerScope workerScope;
+        access(&ctx, m1, m2);
+    }
+    CHECK(bm.getNumEntries() == 0);
+    CHECK(m1->getRefCounter() == 1);
+    access(&ctx, m1, m2);
+    CHECK(bm.getNumEntries() == 2);
+
+    bm.clear();
+    DataObjectFactory::destroy(m1, m2);
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <compiler/catalog/KernelCatalog.h>
+#include <ir/daphneir/Daphne.h>
+#include <parser/catalog/KernelCatalogParser.h>
+#include <util/CpuIsa.h>
+
+#include <tags.h>
+
+#include <catch.hpp>
+
+#include <mlir/IR/MLIRContext.h>
+#include <llvm/Support/DynamicLibrary.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <dlfcn.h>
+
+TEST_CASE("Host ISA levels are ordered from best to worst", TAG_CONFIG) {
+    const std::vector<std::string> levels = getHostIsaLevels();
+    const std::vector<std::string> all = {"x86-64-v4", "x86-64-v3", "x86-64-v2"};
+    // Each supported level implies all lower levels.
+    for (size_t i = 0; i < levels.size(); i++)
+        CHECK(levels[i] == all[all.size() - levels.size() + i]);
+}
+
+TEST_CASE("Kernel ISA candidates", TAG_CONFIG) {
+    CHECK(getKernelIsaCandidates("auto") == getHostIsaLevels());
+    CHECK(getKernelIsaCandidates("generic").empty());
+    CHECK(getKernelIsaCandidates("x86-64-v3") == std::vector<std::string>{"x86-64-v3"});
+}
+
+TEST_CASE("Kernel functions are served by the resolved kernel library", TAG_CONFIG) {
+    mlir::MLIRContext mctx;
+    mctx.getOrLoadDialect<mlir::daphne::DaphneDialect>();
+    KernelCatalog kc;
+    KernelCatalogParser(&mctx).parseKernelCatalog("lib/catalog.json", kc);
+
+    const std::vector<KernelInfo> kernelInfos = kc.getKernelInfos("sumAll");
+    REQUIRE_FALSE(kernelInfos.empty());
+    const std::string libPath = kernelInfos[0].libPath;
+    const std::string kernelFuncName = kernelInfos[0].kernelFuncName;
+
+    // Like the JIT, load the kernel library into the global scope of the
+    // process and look the kernel function up there. If any other library in
+    // the process (e.g., the generic kernel library linked into the executable)
+    // defined the kernel function as well, that definition would be found.
+    std::string errMsg;
+    REQUIRE_FALSE(llvm::sys::DynamicLibrary::LoadLibraryPermanently(libPath.c_str(), &errMsg));
+    void * sym = dlsym(RTLD_DEFAULT, kernelFuncName.c_str());
+    REQUIRE(sym != nullptr);
+    Dl_info info;
+    REQUIRE(dladdr(sym, &info) != 0);
+    CHECK(std::filesystem::equivalent(info.dli_fname, libPath));
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <runtime/local/datagen/GenGivenVals.h>
+#include <runtime/local/datastructures/CSRMatrix.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/instrumentation/KernelVariants.h>
+
+#include <tags.h>
+
+#include <catch.hpp>
+
+#include <cstdint>
+
+TEST_CASE("KernelVariantSelector explores and exploits variants", TAG_INSTRUMENTATION) {
+    KernelVariantSelector selector({{"a", 0, SIZE_MAX, 1.0}, {"b", 0, SIZE_MAX, 1.0}});
+    const size_t cells = 1000;
+
+    // Each variant is tried first.
+    for (size_t i = 0; i < 4; i++) {
+        const size_t v = selector.select(cells, 1.0);
+        selector.update(v, cells, v == 1 ? 0.001 : 0.1);
+    }
+    CHECK(selector.getNumTrials(0, cells) == 2);
+    CHECK(selector.getNumTrials(1, cells) == 2);
+
+    // Then, the faster variant is used, apart from periodic exploration.
+    size_t numFast = 0;
+    for (size_t i = 0; i < 64; i++) {
+        const size_t v = selector.select(cells, 1.0);
+        selector.update(v, cells, v == 1 ? 0.001 : 0.1);
+        numFast += v == 1;
+    }
+    CHECK(numFast >= 60);
+    CHECK(numFast < 64);
+
+    // Calls on inputs of a different size are decided independently.
+    CHECK(selector.getNumTrials(0, 1000000) == 0);
+}
+
+TEST_CASE("KernelVariantSelector respects the cost hints", TAG_INSTRUMENTATION) {
+    KernelVariantSelector selector({{"general", 0, SIZE_MAX, 1.0}, {"small", 0, 100, 1.0}, {"sparse", 0, SIZE_MAX, 0.1}});
+
+    for (size_t i = 0; i < 10; i++) {
+        CHECK(selector.select(1000, 1.0) == 0);
+        CHECK(selector.select(1000, 0.01) != 1);
+        CHECK(selector.select(10, 1.0) != 2);
+    }
+    CHECK(selector.getName(1) == std::string("small"));
+}
+
+TEST_CASE("KernelVariantFeatures of data objects and scalars", TAG_INSTRUMENTATION) {
+    auto dense = genGivenVals<DenseMatrix<double>>(2, {1, 0, 0, 0});
+    auto csr = genGivenVals<CSRMatrix<double>>(2, {1, 0, 0, 0});
+
+    KernelVariantFeatures f;
+    addVariantFeatures(f, dense);
+    addVariantFeatures(f, static_cast<const Matrix<double> *>(csr));
+    addVariantFeatures(f, true);
+    addVariantFeatures(f, 3.0);
+    CHECK(f.cells == 8);
+    CHECK(f.nonZeros == 5);
+
+    DataObjectFactory::destroy(dense, csr);
+}
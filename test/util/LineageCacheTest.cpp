@@ -0,0 +1,129 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <api/cli/DaphneUserConfig.h>
+#include <runtime/local/context/DaphneContext.h>
+#include <runtime/local/datagen/GenGivenVals.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/instrumentation/LineageReuse.h>
+#include <runtime/local/kernels/CheckEq.h>
+#include <runtime/local/kernels/MatMul.h>
+#include <util/LineageCache.h>
+
+#include <run_tests.h>
+#include <tags.h>
+
+#include <catch.hpp>
+
+#include <cstdint>
+
+TEST_CASE("Lineage of data objects", TAG_INSTRUMENTATION) {
+    auto m1 = genGivenVals<DenseMatrix<double>>(2, {1, 2, 3, 4});
+    auto m2 = genGivenVals<DenseMatrix<double>>(2, {1, 2, 3, 4});
+
+    // Data objects of unknown origin get distinct, stable lineages.
+    CHECK(m1->getLineage() != 0);
+    CHECK(m1->getLineage() == m1->getLineage());
+    CHECK(m1->getLineage() != m2->getLineage());
+
+    m2->setLineage(m1->getLineage());
+    CHECK(lineageOf(m1) == lineageOf(m2));
+
+    CHECK(lineageOf(1.0) == lineageOf(1.0));
+    CHECK(lineageOf(1.0) != lineageOf(2.0));
+    CHECK(lineageOf("_matMul") == lineageOf("_matMul"));
+    CHECK(combineLineage(1, 2) != combineLineage(2, 1));
+
+    DataObjectFactory::destroy(m1, m2);
+}
+
+TEST_CASE("LineageCache evicts the entries with the lowest benefit", TAG_INSTRUMENTATION) {
+    LineageCache cache;
+    auto m1 = genGivenVals<DenseMatrix<double>>(1, {1});
+    auto m2 = genGivenVals<DenseMatrix<double>>(1, {2});
+    auto m3 = genGivenVals<DenseMatrix<double>>(1, {3});
+
+    CHECK(cache.lookup(1) == nullptr);
+    CHECK(cache.put(1, m1, 100, 1.0, 200));
+    CHECK(m1->getRefCounter() == 2);
+    CHECK_FALSE(cache.put(1, m1, 100, 1.0, 200));
+
+    const Structure *hit = cache.lookup(1);
+    CHECK(hit == m1);
+    CHECK(m1->getRefCounter() == 3);
+    DataObjectFactory::destroy(hit);
+
+    // The second entry is cheaper to compute and evicted first.
+    CHECK(cache.put(2, m2, 100, 0.1, 200));
+    CHECK(cache.put(3, m3, 100, 0.5, 200));
+    CHECK(cache.lookup(2) == nullptr);
+    CHECK(m2->getRefCounter() == 1);
+    CHECK(cache.getNumEvictions() == 1);
+    CHECK(cache.getUsedBytes() == 200);
+
+    // A new entry with a lower benefit than all others is not cached.
+    CHECK_FALSE(cache.put(2, m2, 100, 0.01, 200));
+    // Neither is an entry larger than the capacity.
+    CHECK_FALSE(cache.put(2, m2, 300, 10.0, 200));
+    CHECK(cache.getNumEntries() == 2);
+    CHECK(cache.getNumHits() == 1);
+    CHECK(cache.getNumMisses() == 2);
+
+    cache.clear();
+    CHECK(cache.getNumEntries() == 0);
+    CHECK(m1->getRefCounter() == 1);
+    CHECK(m3->getRefCounter() == 1);
+
+    DataObjectFactory::destroy(m1, m2, m3);
+}
+
+TEST_CASE("LineageReuse skips repeated kernel calls", TAG_INSTRUMENTATION) {
+    auto dctx = setupContextAndLogger();
+    LineageCache cache;
+    DaphneUserConfig cfg{};
+    cfg.use_lineage_reuse = true;
+    cfg.lineage_cache = &cache;
+    DaphneContext ctx(cfg, dctx->dispatchMapping, dctx->stats);
+
+    auto a = genGivenVals<DenseMatrix<double>>(2, {1, 2, 3, 4});
+    auto exp = genGivenVals<DenseMatrix<double>>(2, {7, 10, 15, 22});
+
+    auto call = [&](DenseMatrix<double> **res, bool transb) {
+        LineageReuse lr(&ctx, "_matMul", a, a, false, transb);
+        if (!lr.tryReuse(res)) {
+            matMul(*res, a, a, false, transb, &ctx);
+            lr.store(*res);
+            return false;
+        }
+        return true;
+    };
+
+    DenseMatrix<double> *res1 = nullptr;
+    DenseMatrix<double> *res2 = nullptr;
+    DenseMatrix<double> *res3 = nullptr;
+    CHECK_FALSE(call(&res1, false));
+    CHECK(call(&res2, false));
+    CHECK(res1 == res2);
+    CHECK(*res2 == *exp);
+    // Different scalar arguments yield a different lineage.
+    CHECK_FALSE(call(&res3, true));
+    CHECK(res3 != res1);
+    CHECK(res3->getLineage() != res1->getLineage());
+
+    cache.clear();
+    DataObjectFactory::destroy(a, exp, res1, res2, res3);
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <util/KernelDispatchMapping.h>
+#include <util/PerfCounters.h>
+
+#include <tags.h>
+
+#include <catch.hpp>
+
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+#include <cstring>
+
+TEST_CASE("PerfCounters per kernel and thread", TAG_INSTRUMENTATION) {
+    PerfCounters &pc = PerfCounters::instance();
+    pc.clear();
+
+    const size_t numThreads = 3;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < numThreads; t++)
+        threads.emplace_back([&pc]() {
+            for (size_t i = 0; i < 10; i++) {
+                pc.startKernel(1);
+                // Touch fresh memory to cause page faults.
+                std::vector<char> v(1 << 20);
+                std::memset(v.data(), 1, v.size());
+                pc.stopKernel(1);
+            }
+            pc.startKernel(2);
+            pc.stopKernel(2);
+        });
+    for (auto &thread : threads)
+        thread.join();
+
+    auto perKernel = pc.getCountsPerKernel();
+    REQUIRE(perKernel.size() == 2);
+    CHECK(perKernel[1].count == numThreads * 10);
+    CHECK(perKernel[2].count == numThreads);
+    CHECK(perKernel[1].timeNs > 0);
+    for (size_t e = 0; e < NUM_PERF_EVENTS; e++) {
+        if (pc.isAvailable(static_cast<PerfEvent>(e))) {
+            INFO(PerfCounters::eventName(static_cast<PerfEvent>(e)));
+            CHECK(perKernel[1].values[e] > 0);
+        }
+        else
+            CHECK(perKernel[1].values[e] == 0);
+    }
+
+    size_t numCalls = 0;
+    for (auto &c : pc.getCountsPerThread())
+        numCalls += c.count;
+    CHECK(numCalls == numThreads * 11);
+
+    CHECK_NOTHROW(pc.dumpCounters(KernelDispatchMapping::instance()));
+
+    pc.clear();
+    CHECK(pc.getCountsPerKernel().empty());
+}
+
+TEST_CASE("PerfCounters of exited threads", TAG_INSTRUMENTATION) {
+    PerfCounters &pc = PerfCounters::instance();
+    pc.clear();
+
+    auto numOpenFds = []() {
+        auto it = std::filesystem::directory_iterator("/proc/self/fd");
+        return std::distance(std::filesystem::begin(it), std::filesystem::end(it));
+    };
+    const auto numFdsBefore = numOpenFds();
+    for (size_t t = 0; t < 10; t++)
+        std::thread([&pc]() {
+            pc.startKernel(3);
+            pc.stopKernel(3);
+        }).join();
+
+    // The exited threads closed their counters, but their counts remain.
+    CHECK(numOpenFds() == numFdsBefore);
+    auto perKernel = pc.getCountsPerKernel();
+    REQUIRE(perKernel.size() == 1);
+    CHECK(perKernel[3].count == 10);
+    auto perThread = pc.getCountsPerThread();
+    REQUIRE(!perThread.empty());
+    CHECK(perThread.back().count == 10);
+
+    pc.clear();
+    CHECK(pc.getCountsPerKernel().empty());
+}
+
+TEST_CASE("PerfCounts derived metrics", TAG_INSTRUMENTATION) {
+    PerfCounts c;
+    CHECK(c.ipc() == 0);
+    CHECK(c.mpki() == 0);
+    c.values[CYCLES] = 1000;
+    c.values[INSTRUCTIONS] = 2000;
+    c.values[LLC_MISSES] = 10;
+    c.timeNs = 640;
+    CHECK(c.ipc() == 2);
+    CHECK(c.mpki() == 5);
+    CHECK(c.memBytes() == 640);
+    CHECK(c.memBandwidth() == 1);
+    CHECK(c.bytesPerInstruction() == 0.32);
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2024 The DAPHNE Consortium
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <runtime/local/datagen/GenGivenVals.h>
+#include <runtime/local/datastructures/DataObjectFactory.h>
+#include <runtime/local/datastructures/DenseMatrix.h>
+#include <runtime/local/instrumentation/KernelInstrumentation.h>
+#include <util/KernelDispatchMapping.h>
+#include <util/Tracer.h>
+
+#include <tags.h>
+
+#include <catch.hpp>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Tracer records kernels and tasks per thread", TAG_INSTRUMENTATION) {
+    Tracer &tracer = Tracer::instance();
+    tracer.clear();
+
+    auto m = genGivenVals<DenseMatrix<double>>(2, {1, 2, 3, 4, 5, 6});
+
+    const size_t numThreads = 4;
+    const size_t numEvents = 5000; // more than one chunk of events per thread
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < numThreads; t++)
+        threads.emplace_back([&, t]() {
+            for (size_t i = 0; i < numEvents; i++) {
+                tracer.beginKernel(123456);
+                tracer.endKernel(123456, {traceOperand(m), traceOperand<DenseMatrix<double>>(nullptr)});
+            }
+            TraceTaskScope scope(true, "task", t, t + 1, 0);
+        });
+    for (auto &thread : threads)
+        thread.join();
+
+    TraceTaskScope disabled(false, "task");
+
+    CHECK(tracer.getNumEvents() == numThreads * (numEvents + 1));
+
+    std::stringstream trace;
+    tracer.writeChromeTrace(trace, KernelDispatchMapping::instance());
+    const std::string s = trace.str();
+    CHECK(s.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0) == 0);
+    CHECK(s.find("\"name\":\"kernel 123456\"") != std::string::npos);
+    CHECK(s.find("\"shapes\":[\"2x3\",\"0x0\"],\"bytes\":48") != std::string::npos);
+    CHECK(s.find("\"cat\":\"task\",\"name\":\"task\",\"args\":{\"rowBegin\":2,\"rowEnd\":3,\"fid\":0}") !=
+          std::string::npos);
+
+    tracer.clear();
+    CHECK(tracer.getNumEvents() == 0);
+
+    DataObjectFactory::destroy(m);
+}
+
+TEST_CASE("Tracer handles nested kernels", TAG_INSTRUMENTATION) {
+    Tracer &tracer = Tracer::instance();
+    tracer.clear();
+
+    tracer.beginKernel(1);
+    tracer.beginKernel(2);
+    tracer.endKernel(2, {}, "inner");
+    tracer.endKernel(1, {}, "outer");
+    // Unmatched ends are ignored.
+    tracer.endKernel(3);
+
+    std::stringstream trace;
+    tracer.writeChromeTrace(trace, KernelDispatchMapping::instance());
+    const std::string s = trace.str();
+    CHECK(tracer.getNumEvents() == 2);
+    CHECK(s.find("\"name\":\"inner\"") < s.find("\"name\":\"outer\""));
+    tracer.clear();
+}